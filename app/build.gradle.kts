@@ -15,6 +15,14 @@ android {
         versionCode = 1
         versionName = "1.0.0"
 
+        // 插桩测试在 Application.onCreate 之前挂上 StrictMode 违规收集（见 app/src/androidTest）
+        testInstrumentationRunner = "com.hx.nekomimi.strictmode.StrictModeTestRunner"
+
+        externalNativeBuild {
+            cmake {
+                arguments += "-DANDROID_STL=c++_static"
+            }
+        }
     }
 
     signingConfigs {
@@ -58,6 +66,47 @@ android {
         jvmTarget = "17"
     }
 
+    // 原生 DSP 核心（app/src/main/cpp）
+    externalNativeBuild {
+        cmake {
+            path = file("src/main/cpp/CMakeLists.txt")
+            version = "3.22.1"
+        }
+    }
+
+    testOptions {
+        // JVM 单元测试中 android.util.Log 等桩方法返回默认值，而不是抛出 "not mocked"
+        unitTests.isReturnDefaultValues = true
+    }
+}
+
+// ========== 主机端原生 DSP（JVM 单元测试通过 JNI 调用与设备上同一份 C++ 代码） ==========
+
+val hostDspDir = layout.buildDirectory.dir("host-dsp")
+
+val buildHostDsp by tasks.registering(Exec::class) {
+    description = "在主机上编译 libnekodsp，供 JVM 单元测试加载"
+    val sourceDir = file("src/main/cpp")
+    val outputDir = hostDspDir.get().asFile
+    inputs.dir(sourceDir)
+    outputs.dir(outputDir)
+    // CMake 通过 JAVA_HOME 查找 jni.h，使用运行 Gradle 的 JDK
+    environment("JAVA_HOME", System.getProperty("java.home"))
+    commandLine(
+        "sh", "-c",
+        "cmake -S '$sourceDir' -B '$outputDir' -DCMAKE_BUILD_TYPE=Release -DNEKO_WITH_WHISPER=OFF" +
+            " && cmake --build '$outputDir' --target nekodsp"
+    )
+}
+
+tasks.withType<Test>().configureEach {
+    dependsOn(buildHostDsp)
+    systemProperty("java.library.path", hostDspDir.get().asFile.absolutePath)
+    // ./gradlew testDebugUnitTest -PupdateAudioGolden：重新生成音频处理链的基准 WAV（见 AudioChainGoldenTest）
+    if (project.hasProperty("updateAudioGolden")) {
+        systemProperty("neko.audioGoldenDir", file("src/test/resources/audio").absolutePath)
+        outputs.upToDateWhen { false }
+    }
 }
 
 dependencies {
@@ -84,6 +133,13 @@ dependencies {
     implementation("androidx.media3:media3-exoplayer:1.4.1")
     implementation("androidx.media3:media3-session:1.4.1")
     implementation("androidx.media3:media3-ui:1.4.1")
+    // WebDAV 书库：OkHttp 发送 Range 请求
+    implementation("androidx.media3:media3-datasource-okhttp:1.4.1")
+    // FFmpeg 音频解码扩展（可选，由 scripts/build-ffmpeg-decoder.sh 构建到 libs/，运行时反射加载）
+    implementation(fileTree(mapOf("dir" to "libs", "include" to listOf("*.aar"))))
+
+    // HTTP 客户端（WebDAV 列目录 / 字幕下载）
+    implementation("com.squareup.okhttp3:okhttp:4.12.0")
 
     // 协程
     implementation("org.jetbrains.kotlinx:kotlinx-coroutines-android:1.8.1")
@@ -92,10 +148,25 @@ dependencies {
     implementation("androidx.activity:activity-ktx:1.9.3")
     implementation("androidx.fragment:fragment-ktx:1.8.5")
 
+    // 设置持久化（替代 SharedPreferences，读写不阻塞主线程）
+    implementation("androidx.datastore:datastore-preferences:1.1.1")
+
+    // Perfetto / systrace 埋点（util/Tracing.kt）
+    implementation("androidx.tracing:tracing-ktx:1.2.0")
+
     // DocumentFile (SAF)
     implementation("androidx.documentfile:documentfile:1.0.1")
 
     // Glide 图片加载（封面）
     implementation("com.github.bumptech.glide:glide:4.16.0")
     ksp("com.github.bumptech.glide:ksp:4.16.0")
+
+    // JVM 单元测试（app/src/test）
+    testImplementation("junit:junit:4.13.2")
+
+    // 插桩测试（app/src/androidTest）
+    androidTestImplementation("androidx.test:runner:1.6.2")
+    androidTestImplementation("androidx.test:core-ktx:1.6.1")
+    androidTestImplementation("androidx.test.ext:junit-ktx:1.2.1")
+    androidTestImplementation("com.squareup.okhttp3:mockwebserver:4.12.0")
 }
@@ -22,3 +22,8 @@
 
 # JNI (libass)
 -keep class com.hx.nekomimi.subtitle.NativeAssRenderer { *; }
+
+# JNI (原生 DSP 核心)
+-keepclasseswithmembernames class com.hx.nekomimi.audio.dsp.** {
+    native <methods>;
+}
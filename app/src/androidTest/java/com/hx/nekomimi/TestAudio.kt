@@ -0,0 +1,20 @@
+package com.hx.nekomimi
+
+import java.io.File
+import java.nio.ByteBuffer
+import java.nio.ByteOrder
+import kotlin.math.PI
+import kotlin.math.sin
+
+/** 写一段 44.1 kHz 单声道 PCM16 正弦 WAV（插桩测试用的播放素材） */
+fun writeTone(file: File, seconds: Int) {
+    val sampleRate = 44100
+    val samples = sampleRate * seconds
+    val buffer = ByteBuffer.allocate(44 + samples * 2).order(ByteOrder.LITTLE_ENDIAN)
+    buffer.put("RIFF".toByteArray()).putInt(36 + samples * 2).put("WAVE".toByteArray())
+    buffer.put("fmt ".toByteArray()).putInt(16).putShort(1).putShort(1)
+        .putInt(sampleRate).putInt(sampleRate * 2).putShort(2).putShort(16)
+    buffer.put("data".toByteArray()).putInt(samples * 2)
+    for (i in 0 until samples) buffer.putShort((8000 * sin(2 * PI * 220 * i / sampleRate)).toInt().toShort())
+    file.writeBytes(buffer.array())
+}
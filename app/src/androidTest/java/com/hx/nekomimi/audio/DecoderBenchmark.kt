@@ -0,0 +1,349 @@
+package com.hx.nekomimi.audio
+
+import android.content.Context
+import android.media.MediaCodec
+import android.media.MediaCodecList
+import android.media.MediaFormat
+import android.media.MediaMuxer
+import android.net.Uri
+import android.os.Handler
+import android.os.SystemClock
+import android.util.Log
+import androidx.annotation.OptIn
+import androidx.media3.common.MediaItem
+import androidx.media3.common.PlaybackException
+import androidx.media3.common.Player
+import androidx.media3.common.util.UnstableApi
+import androidx.media3.exoplayer.ExoPlayer
+import androidx.media3.exoplayer.Renderer
+import androidx.media3.exoplayer.RenderersFactory
+import androidx.media3.exoplayer.audio.AudioRendererEventListener
+import androidx.media3.exoplayer.audio.AudioSink
+import androidx.media3.exoplayer.audio.DefaultAudioSink
+import androidx.media3.exoplayer.audio.ForwardingAudioSink
+import androidx.test.core.app.ApplicationProvider
+import androidx.test.ext.junit.runners.AndroidJUnit4
+import androidx.test.platform.app.InstrumentationRegistry
+import org.junit.Assert.assertTrue
+import org.junit.Assume.assumeTrue
+import org.junit.Test
+import org.junit.runner.RunWith
+import java.io.File
+import java.nio.ByteBuffer
+import java.nio.ByteOrder
+import java.util.concurrent.CountDownLatch
+import java.util.concurrent.TimeUnit
+import kotlin.math.PI
+import kotlin.math.sin
+
+/**
+ * 本机各音频解码器的解码速度（倍实时）
+ *
+ * 先用本机编码器把 30 秒类人声 PCM 编码成压缩帧（不经过封装），再用每个声明支持该格式的解码器
+ * （硬件 / 厂商实现和 c2.android 软件实现）解码同一组帧，取 3 次中最快的一次。
+ * FFmpeg 扩展的解码器只能通过渲染器驱动：把同一组帧封装成文件，用只有 FfmpegAudioRenderer、输出直接丢弃的 ExoPlayer
+ * 从 prepare 播放到结束计时（包含解封装和渲染循环的调度间隔，是解码速度的下限）；没有打包扩展时跳过。
+ * 结果打印到 logcat（tag: DecoderBenchmark），用于判断在这台设备上平台解码器优先（EXTENSION_RENDERER_MODE_ON）是否合适。
+ *
+ * `./gradlew connectedDebugAndroidTest -Pandroid.testInstrumentationRunnerArguments.class=com.hx.nekomimi.audio.DecoderBenchmark`
+ */
+@OptIn(UnstableApi::class)
+@RunWith(AndroidJUnit4::class)
+class DecoderBenchmark {
+
+    private class Frame(val data: ByteArray, val ptsUs: Long, val flags: Int)
+
+    private class Encoded(val format: MediaFormat, val frames: List<Frame>, val pcmBytes: Int)
+
+    companion object {
+        private const val TAG = "DecoderBenchmark"
+        private const val SAMPLE_RATE = 44100
+        private const val CHANNELS = 2
+        private const val SECONDS = 30
+        private const val RUNS = 3
+        private const val TIMEOUT_US = 10_000L
+        private const val PLAYER_TIMEOUT_S = 60L
+
+        private const val FFMPEG_RENDERER = "androidx.media3.decoder.ffmpeg.FfmpegAudioRenderer"
+        private const val FFMPEG_LIBRARY = "androidx.media3.decoder.ffmpeg.FfmpegLibrary"
+    }
+
+    private val context = ApplicationProvider.getApplicationContext<Context>()
+
+    @Test
+    fun aac() = benchmark(MediaFormat.MIMETYPE_AUDIO_AAC)
+
+    @Test
+    fun flac() = benchmark(MediaFormat.MIMETYPE_AUDIO_FLAC)
+
+    @Test
+    fun ffmpegAac() = benchmarkFfmpeg(MediaFormat.MIMETYPE_AUDIO_AAC)
+
+    @Test
+    fun ffmpegFlac() = benchmarkFfmpeg(MediaFormat.MIMETYPE_AUDIO_FLAC)
+
+    private fun benchmark(mime: String) {
+        val encoded = encode(mime, speechLikePcm())
+        val decoders = MediaCodecList(MediaCodecList.ALL_CODECS).codecInfos
+            .filter { !it.isEncoder && it.supportedTypes.any { type -> type.equals(mime, ignoreCase = true) } }
+            .map { it.name }
+        assumeTrue("没有 $mime 解码器", decoders.isNotEmpty())
+
+        for (name in decoders) {
+            var bestMs = Long.MAX_VALUE
+            var outputBytes = 0
+            repeat(RUNS) {
+                val startedAt = SystemClock.elapsedRealtime()
+                outputBytes = decode(name, encoded)
+                bestMs = minOf(bestMs, SystemClock.elapsedRealtime() - startedAt)
+            }
+            val factor = SECONDS * 1000.0 / bestMs.coerceAtLeast(1)
+            Log.i(TAG, "$mime $name: ${bestMs}ms / ${SECONDS}s 音频，${"%.1f".format(factor)}x 实时")
+            // 编码器首尾的填充帧让输出长度略有出入
+            assertTrue("$name 输出 $outputBytes 字节，应约为 ${encoded.pcmBytes}", outputBytes >= encoded.pcmBytes * 0.95)
+        }
+    }
+
+    private fun benchmarkFfmpeg(mime: String) {
+        val rendererClass = try {
+            Class.forName(FFMPEG_RENDERER)
+        } catch (e: ClassNotFoundException) {
+            null
+        }
+        assumeTrue("没有打包 FFmpeg 扩展（scripts/build-ffmpeg-decoder.sh）", rendererClass != null)
+        assumeTrue("FFmpeg 原生库不可用", Class.forName(FFMPEG_LIBRARY).getMethod("isAvailable").invoke(null) == true)
+
+        val file = writeContainer(mime, encode(mime, speechLikePcm()))
+        try {
+            var bestMs = Long.MAX_VALUE
+            repeat(RUNS) { bestMs = minOf(bestMs, playThroughFfmpeg(rendererClass!!, file)) }
+            val factor = SECONDS * 1000.0 / bestMs.coerceAtLeast(1)
+            Log.i(TAG, "$mime ffmpeg: ${bestMs}ms / ${SECONDS}s 音频，${"%.1f".format(factor)}x 实时（含解封装）")
+        } finally {
+            file.delete()
+        }
+    }
+
+    /**
+     * 同一组编码帧封装成 ExoPlayer 能读取的文件：AAC 用 MediaMuxer 写 MP4；
+     * FLAC 编码器的 csd-0 就是 fLaC 标记和 STREAMINFO，后面直接拼接帧即为 .flac 文件
+     */
+    private fun writeContainer(mime: String, encoded: Encoded): File {
+        if (mime == MediaFormat.MIMETYPE_AUDIO_AAC) {
+            val file = File(context.cacheDir, "decoder-benchmark.m4a")
+            val muxer = MediaMuxer(file.path, MediaMuxer.OutputFormat.MUXER_OUTPUT_MPEG_4)
+            try {
+                val track = muxer.addTrack(encoded.format)
+                muxer.start()
+                val info = MediaCodec.BufferInfo()
+                for (frame in encoded.frames) {
+                    info.set(0, frame.data.size, frame.ptsUs, frame.flags)
+                    muxer.writeSampleData(track, ByteBuffer.wrap(frame.data), info)
+                }
+                muxer.stop()
+            } finally {
+                muxer.release()
+            }
+            return file
+        }
+
+        val csd = encoded.format.getByteBuffer("csd-0")?.duplicate()
+        val header = csd?.let { ByteArray(it.remaining()).also { bytes -> it.get(bytes) } }
+        assumeTrue("$mime 编码器没有输出 fLaC 头", header != null && String(header, 0, minOf(4, header.size), Charsets.US_ASCII) == "fLaC")
+        val file = File(context.cacheDir, "decoder-benchmark.flac")
+        file.outputStream().buffered().use { out ->
+            out.write(header!!)
+            encoded.frames.forEach { out.write(it.data) }
+        }
+        return file
+    }
+
+    /** @return 从 prepare 到播放结束的毫秒数 */
+    private fun playThroughFfmpeg(rendererClass: Class<*>, file: File): Long {
+        val instrumentation = InstrumentationRegistry.getInstrumentation()
+        val done = CountDownLatch(1)
+        var error: PlaybackException? = null
+        var startedAt = 0L
+        var endedAt = 0L
+        lateinit var player: ExoPlayer
+        instrumentation.runOnMainSync {
+            val renderersFactory = RenderersFactory { _, _, _, _, _ ->
+                val sink = DiscardingAudioSink(DefaultAudioSink.Builder(context).build())
+                val renderer = rendererClass
+                    .getConstructor(Handler::class.java, AudioRendererEventListener::class.java, AudioSink::class.java)
+                    .newInstance(null, null, sink)
+                arrayOf(renderer as Renderer)
+            }
+            player = ExoPlayer.Builder(context, renderersFactory).build()
+            player.addListener(object : Player.Listener {
+                override fun onPlaybackStateChanged(playbackState: Int) {
+                    if (playbackState != Player.STATE_ENDED) return
+                    endedAt = SystemClock.elapsedRealtime()
+                    done.countDown()
+                }
+
+                override fun onPlayerError(e: PlaybackException) {
+                    error = e
+                    done.countDown()
+                }
+            })
+            player.setMediaItem(MediaItem.fromUri(Uri.fromFile(file)))
+            startedAt = SystemClock.elapsedRealtime()
+            player.prepare()
+            player.play()
+        }
+        try {
+            assertTrue("FFmpeg ${PLAYER_TIMEOUT_S}s 内没有播放完", done.await(PLAYER_TIMEOUT_S, TimeUnit.SECONDS))
+            error?.let { throw AssertionError("FFmpeg 解码失败", it) }
+            return endedAt - startedAt
+        } finally {
+            instrumentation.runOnMainSync { player.release() }
+        }
+    }
+
+    /** 丢弃全部输出的 AudioSink：不创建 AudioTrack，立即接受每一块数据，位置取最后一块的时间戳 */
+    private class DiscardingAudioSink(sink: AudioSink) : ForwardingAudioSink(sink) {
+
+        private var positionUs = AudioSink.CURRENT_POSITION_NOT_SET
+        private var ended = false
+
+        override fun handleBuffer(buffer: ByteBuffer, presentationTimeUs: Long, encodedAccessUnitCount: Int): Boolean {
+            buffer.position(buffer.limit())
+            positionUs = presentationTimeUs
+            ended = false
+            return true
+        }
+
+        override fun getCurrentPositionUs(sourceEnded: Boolean): Long = positionUs
+
+        override fun hasPendingData(): Boolean = false
+
+        override fun playToEndOfStream() {
+            ended = true
+        }
+
+        override fun isEnded(): Boolean = ended
+
+        override fun flush() {
+            positionUs = AudioSink.CURRENT_POSITION_NOT_SET
+            ended = false
+            super.flush()
+        }
+    }
+
+    /** 带谐波的基音 + 4 Hz 音节包络，16 位交错立体声 */
+    private fun speechLikePcm(): ByteArray {
+        val frames = SAMPLE_RATE * SECONDS
+        val buffer = ByteBuffer.allocate(frames * CHANNELS * 2).order(ByteOrder.LITTLE_ENDIAN)
+        for (i in 0 until frames) {
+            val t = i.toDouble() / SAMPLE_RATE
+            val phase = 2 * PI * 160.0 * t
+            val voice = (sin(phase) + 0.5 * sin(2 * phase) + 0.25 * sin(3 * phase)) / 1.75
+            val sample = (0.3 * (0.5 - 0.5 * sin(2 * PI * 4.0 * t)) * voice * 32767).toInt().toShort()
+            repeat(CHANNELS) { buffer.putShort(sample) }
+        }
+        return buffer.array()
+    }
+
+    private fun encode(mime: String, pcm: ByteArray): Encoded {
+        val format = MediaFormat.createAudioFormat(mime, SAMPLE_RATE, CHANNELS).apply {
+            setInteger(MediaFormat.KEY_BIT_RATE, 128_000)
+            setInteger(MediaFormat.KEY_MAX_INPUT_SIZE, 16 * 1024)
+        }
+        val name = MediaCodecList(MediaCodecList.REGULAR_CODECS).findEncoderForFormat(format)
+        assumeTrue("没有 $mime 编码器", name != null)
+
+        val codec = MediaCodec.createByCodecName(name!!)
+        val frames = mutableListOf<Frame>()
+        val csd = mutableListOf<ByteArray>()
+        var outputFormat: MediaFormat? = null
+        try {
+            codec.configure(format, null, null, MediaCodec.CONFIGURE_FLAG_ENCODE)
+            codec.start()
+            val frameBytes = CHANNELS * 2
+            var offset = 0
+            var inputDone = false
+            val info = MediaCodec.BufferInfo()
+            while (true) {
+                if (!inputDone) {
+                    val index = codec.dequeueInputBuffer(TIMEOUT_US)
+                    if (index >= 0) {
+                        val input = codec.getInputBuffer(index)!!
+                        val size = minOf(input.remaining() / frameBytes * frameBytes, pcm.size - offset)
+                        val ptsUs = offset.toLong() / frameBytes * 1_000_000 / SAMPLE_RATE
+                        if (size <= 0) {
+                            codec.queueInputBuffer(index, 0, 0, ptsUs, MediaCodec.BUFFER_FLAG_END_OF_STREAM)
+                            inputDone = true
+                        } else {
+                            input.put(pcm, offset, size)
+                            codec.queueInputBuffer(index, 0, size, ptsUs, 0)
+                            offset += size
+                        }
+                    }
+                }
+                val index = codec.dequeueOutputBuffer(info, TIMEOUT_US)
+                if (index == MediaCodec.INFO_OUTPUT_FORMAT_CHANGED) outputFormat = codec.outputFormat
+                if (index < 0) continue
+                val bytes = ByteArray(info.size)
+                codec.getOutputBuffer(index)!!.apply { position(info.offset) }.get(bytes)
+                if (info.flags and MediaCodec.BUFFER_FLAG_CODEC_CONFIG != 0) {
+                    csd += bytes
+                } else if (bytes.isNotEmpty()) {
+                    frames += Frame(bytes, info.presentationTimeUs, info.flags and MediaCodec.BUFFER_FLAG_KEY_FRAME)
+                }
+                codec.releaseOutputBuffer(index, false)
+                if (info.flags and MediaCodec.BUFFER_FLAG_END_OF_STREAM != 0) break
+            }
+        } finally {
+            codec.release()
+        }
+
+        // 解码器格式：编码器输出格式里的 csd-N 优先，没有时用编码器输出的配置帧
+        val decoderFormat = MediaFormat.createAudioFormat(mime, SAMPLE_RATE, CHANNELS)
+        val known = outputFormat
+        if (known != null && known.containsKey("csd-0")) {
+            var i = 0
+            while (known.containsKey("csd-$i")) {
+                decoderFormat.setByteBuffer("csd-$i", known.getByteBuffer("csd-$i"))
+                i++
+            }
+        } else {
+            csd.forEachIndexed { i, bytes -> decoderFormat.setByteBuffer("csd-$i", ByteBuffer.wrap(bytes)) }
+        }
+        return Encoded(decoderFormat, frames, pcm.size)
+    }
+
+    /** @return 解码输出的 PCM 字节数 */
+    private fun decode(name: String, encoded: Encoded): Int {
+        val codec = MediaCodec.createByCodecName(name)
+        try {
+            codec.configure(encoded.format, null, null, 0)
+            codec.start()
+            var next = 0
+            var outputBytes = 0
+            val info = MediaCodec.BufferInfo()
+            while (true) {
+                if (next <= encoded.frames.size) {
+                    val index = codec.dequeueInputBuffer(TIMEOUT_US)
+                    if (index >= 0) {
+                        if (next == encoded.frames.size) {
+                            codec.queueInputBuffer(index, 0, 0, 0, MediaCodec.BUFFER_FLAG_END_OF_STREAM)
+                        } else {
+                            val frame = encoded.frames[next]
+                            codec.getInputBuffer(index)!!.put(frame.data)
+                            codec.queueInputBuffer(index, 0, frame.data.size, frame.ptsUs, frame.flags)
+                        }
+                        next++
+                    }
+                }
+                val index = codec.dequeueOutputBuffer(info, TIMEOUT_US)
+                if (index < 0) continue
+                outputBytes += info.size
+                codec.releaseOutputBuffer(index, false)
+                if (info.flags and MediaCodec.BUFFER_FLAG_END_OF_STREAM != 0) return outputBytes
+            }
+        } finally {
+            codec.release()
+        }
+    }
+}
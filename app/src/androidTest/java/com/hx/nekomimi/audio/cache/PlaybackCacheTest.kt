@@ -0,0 +1,166 @@
+package com.hx.nekomimi.audio.cache
+
+import android.content.Context
+import android.net.Uri
+import android.util.Log
+import androidx.annotation.OptIn
+import androidx.media3.common.C
+import androidx.media3.common.util.UnstableApi
+import androidx.media3.database.StandaloneDatabaseProvider
+import androidx.media3.datasource.BaseDataSource
+import androidx.media3.datasource.DataSpec
+import androidx.media3.datasource.cache.CacheDataSource
+import androidx.media3.datasource.cache.NoOpCacheEvictor
+import androidx.media3.datasource.cache.SimpleCache
+import androidx.test.core.app.ApplicationProvider
+import androidx.test.ext.junit.runners.AndroidJUnit4
+import org.junit.After
+import org.junit.Assert.assertEquals
+import org.junit.Assert.assertTrue
+import org.junit.Before
+import org.junit.Test
+import org.junit.runner.RunWith
+import java.io.File
+
+/**
+ * 预取在慢速来源上的行为：长度取自打开数据源的结果，每个文件只打开一次；预取后起播（打开 + 跳转 + 读取）不再等待来源
+ */
+@OptIn(UnstableApi::class)
+@RunWith(AndroidJUnit4::class)
+class PlaybackCacheTest {
+
+    /** 模拟慢速 Provider / WebDAV：每次打开都要等 [openDelayMs]，[reportLength] 为 false 时不告知长度（无 Content-Length） */
+    private class SlowDataSource(
+        private val data: ByteArray,
+        private val openDelayMs: Long,
+        private val reportLength: Boolean
+    ) : BaseDataSource(true) {
+        var opens = 0
+        private var uri: Uri? = null
+        private var position = 0
+        private var remaining = 0L
+
+        override fun open(dataSpec: DataSpec): Long {
+            opens++
+            transferInitializing(dataSpec)
+            Thread.sleep(openDelayMs)
+            uri = dataSpec.uri
+            position = dataSpec.position.toInt()
+            val available = (data.size - position).toLong()
+            remaining = if (dataSpec.length == C.LENGTH_UNSET.toLong()) available else minOf(dataSpec.length, available)
+            transferStarted(dataSpec)
+            return if (reportLength) remaining else C.LENGTH_UNSET.toLong()
+        }
+
+        override fun read(buffer: ByteArray, offset: Int, length: Int): Int {
+            if (length == 0) return 0
+            if (remaining == 0L) return C.RESULT_END_OF_INPUT
+            val n = minOf(length.toLong(), remaining).toInt()
+            System.arraycopy(data, position, buffer, offset, n)
+            position += n
+            remaining -= n
+            bytesTransferred(n)
+            return n
+        }
+
+        override fun getUri(): Uri? = uri
+
+        override fun close() {
+            if (uri != null) {
+                uri = null
+                transferEnded()
+            }
+        }
+    }
+
+    private lateinit var dir: File
+    private lateinit var cache: SimpleCache
+    private val uri = Uri.parse("https://dav.example.invalid/book/01.mp3")
+
+    @Before
+    fun setUp() {
+        val context = ApplicationProvider.getApplicationContext<Context>()
+        dir = File(context.cacheDir, "playback_cache_test").apply { deleteRecursively() }
+        cache = SimpleCache(dir, NoOpCacheEvictor(), StandaloneDatabaseProvider(context))
+    }
+
+    @After
+    fun tearDown() {
+        cache.release()
+        dir.deleteRecursively()
+    }
+
+    @Test
+    fun stopsAtLimitAfterSingleOpen() {
+        val source = SlowDataSource(ByteArray(1 shl 20) { it.toByte() }, OPEN_DELAY_MS, reportLength = true)
+        val limit = 256L shl 10
+
+        val startedAt = System.nanoTime()
+        val bytes = PlaybackCache.cacheHead(CacheDataSource(cache, source), uri, limit)
+        val elapsedMs = (System.nanoTime() - startedAt) / 1_000_000
+
+        assertEquals("慢速来源只应打开一次（不额外查询大小）", 1, source.opens)
+        assertTrue("到达上限后应停止：$bytes", bytes in limit until (1L shl 20))
+        assertEquals(bytes, cache.getCachedBytes(uri.toString(), 0, C.LENGTH_UNSET.toLong()))
+        assertTrue("预取耗时 ${elapsedMs}ms，超过一次打开的延迟太多", elapsedMs < OPEN_DELAY_MS * 2)
+    }
+
+    @Test
+    fun cachesWholeFileWhenLengthUnknown() {
+        val size = 100 shl 10
+        val source = SlowDataSource(ByteArray(size) { (it * 7).toByte() }, OPEN_DELAY_MS, reportLength = false)
+
+        val bytes = PlaybackCache.cacheHead(CacheDataSource(cache, source), uri, 256L shl 10)
+
+        assertEquals(1, source.opens)
+        assertEquals(size.toLong(), bytes)
+        assertEquals(size.toLong(), cache.getCachedBytes(uri.toString(), 0, C.LENGTH_UNSET.toLong()))
+    }
+
+    @Test
+    fun warmHeadSkipsSourceOpen() {
+        val data = ByteArray(1 shl 20) { (it * 3).toByte() }
+        val cold = SlowDataSource(data, OPEN_DELAY_MS, reportLength = true)
+        val coldMs = openSeekRead(CacheDataSource(cache, cold))
+        assertEquals(1, cold.opens)
+
+        PlaybackCache.cacheHead(CacheDataSource(cache, SlowDataSource(data, OPEN_DELAY_MS, reportLength = true)), uri, 256L shl 10)
+
+        val warm = SlowDataSource(data, OPEN_DELAY_MS, reportLength = true)
+        val warmMs = openSeekRead(CacheDataSource(cache, warm))
+        Log.i(TAG, "打开 + 跳转 + 读取：冷缓存 ${coldMs}ms，预取后 ${warmMs}ms")
+
+        assertTrue("冷缓存应等待来源打开：${coldMs}ms", coldMs >= OPEN_DELAY_MS)
+        assertEquals("预取范围内不应打开来源", 0, warm.opens)
+        assertTrue("预取后仍耗时 ${warmMs}ms", warmMs < OPEN_DELAY_MS)
+    }
+
+    /** 跳转到 [SEEK_POSITION] 打开并读取 [READ_BYTES]，返回耗时（毫秒） */
+    private fun openSeekRead(dataSource: CacheDataSource): Long {
+        val startedAt = System.nanoTime()
+        val spec = DataSpec.Builder().setUri(uri).setPosition(SEEK_POSITION).setLength(READ_BYTES.toLong()).build()
+        try {
+            dataSource.open(spec)
+            val buffer = ByteArray(READ_BYTES)
+            var read = 0
+            while (read < READ_BYTES) {
+                val n = dataSource.read(buffer, read, READ_BYTES - read)
+                if (n == C.RESULT_END_OF_INPUT) break
+                read += n
+            }
+            assertEquals(READ_BYTES, read)
+        } finally {
+            dataSource.close()
+        }
+        return (System.nanoTime() - startedAt) / 1_000_000
+    }
+
+    private companion object {
+        const val TAG = "PlaybackCacheTest"
+        const val OPEN_DELAY_MS = 500L
+
+        /** 落在预取的开头范围内 */
+        const val SEEK_POSITION = 64L shl 10
+        const val READ_BYTES = 32 shl 10
+    }
+}
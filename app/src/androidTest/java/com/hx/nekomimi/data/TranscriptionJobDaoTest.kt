@@ -0,0 +1,67 @@
+package com.hx.nekomimi.data
+
+import androidx.room.Room
+import androidx.test.core.app.ApplicationProvider
+import androidx.test.ext.junit.runners.AndroidJUnit4
+import com.hx.nekomimi.data.entity.Book
+import com.hx.nekomimi.data.entity.Chapter
+import com.hx.nekomimi.data.entity.TranscriptionJob
+import kotlinx.coroutines.runBlocking
+import org.junit.After
+import org.junit.Assert.assertEquals
+import org.junit.Assert.assertNull
+import org.junit.Before
+import org.junit.Test
+import org.junit.runner.RunWith
+
+@RunWith(AndroidJUnit4::class)
+class TranscriptionJobDaoTest {
+
+    private lateinit var db: AppDatabase
+    private var bookId = 0L
+    private val chapterIds = mutableListOf<Long>()
+
+    @Before
+    fun setUp() = runBlocking {
+        db = Room.inMemoryDatabaseBuilder(ApplicationProvider.getApplicationContext(), AppDatabase::class.java).build()
+        bookId = db.bookDao().insert(Book(name = "书"))
+        repeat(4) {
+            chapterIds += db.chapterDao().insert(Chapter(bookId = bookId, title = "第${it + 1}章", fileUri = "file:///$it.mp3"))
+        }
+    }
+
+    @After
+    fun tearDown() {
+        db.close()
+    }
+
+    @Test
+    fun requeueResetsOnlyFinishedJobs() = runBlocking {
+        val dao = db.transcriptionJobDao()
+        val (pending, running, done, failed) = chapterIds
+        dao.insertAll(
+            listOf(
+                TranscriptionJob(pending, bookId, TranscriptionJob.STATE_PENDING),
+                TranscriptionJob(running, bookId, TranscriptionJob.STATE_RUNNING, processedMs = 60_000),
+                TranscriptionJob(done, bookId, TranscriptionJob.STATE_DONE, processedMs = 120_000, realTimeFactor = 0.2f),
+                TranscriptionJob(failed, bookId, TranscriptionJob.STATE_FAILED, processedMs = 30_000, error = "解码失败")
+            )
+        )
+
+        // 与 TranscriptionQueue.enqueueBook 相同：插入被忽略，已结束的任务重新排队
+        dao.insertAll(chapterIds.map { TranscriptionJob(chapterId = it, bookId = bookId) })
+        dao.requeueFinished(chapterIds)
+
+        assertEquals(TranscriptionJob.STATE_PENDING, dao.getByChapterId(pending)!!.state)
+        dao.getByChapterId(running)!!.let {
+            assertEquals(TranscriptionJob.STATE_RUNNING, it.state)
+            assertEquals(60_000L, it.processedMs) // 保留断点
+        }
+        for (id in listOf(done, failed)) {
+            val job = dao.getByChapterId(id)!!
+            assertEquals(TranscriptionJob.STATE_PENDING, job.state)
+            assertEquals(0L, job.processedMs)
+            assertNull(job.error)
+        }
+    }
+}
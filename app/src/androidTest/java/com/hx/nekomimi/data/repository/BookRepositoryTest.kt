@@ -0,0 +1,70 @@
+package com.hx.nekomimi.data.repository
+
+import androidx.room.Room
+import androidx.test.core.app.ApplicationProvider
+import androidx.test.ext.junit.runners.AndroidJUnit4
+import com.hx.nekomimi.data.AppDatabase
+import com.hx.nekomimi.data.entity.Book
+import com.hx.nekomimi.data.entity.Chapter
+import com.hx.nekomimi.data.entity.TranscriptionJob
+import kotlinx.coroutines.runBlocking
+import org.junit.After
+import org.junit.Assert.assertEquals
+import org.junit.Assert.assertNull
+import org.junit.Before
+import org.junit.Test
+import org.junit.runner.RunWith
+
+@RunWith(AndroidJUnit4::class)
+class BookRepositoryTest {
+
+    private lateinit var db: AppDatabase
+    private lateinit var repository: BookRepository
+    private var bookId = 0L
+
+    @Before
+    fun setUp() = runBlocking {
+        db = Room.inMemoryDatabaseBuilder(ApplicationProvider.getApplicationContext(), AppDatabase::class.java).build()
+        repository = BookRepository(db)
+        bookId = db.bookDao().insert(Book(name = "书"))
+    }
+
+    @After
+    fun tearDown() {
+        db.close()
+    }
+
+    private fun scanned(vararg names: String) = names.mapIndexed { i, name ->
+        Chapter(bookId = bookId, title = name, fileUri = "file:///$name.mp3", sortOrder = i)
+    }
+
+    /** 重新扫描不应级联删除未变化章节的进度和转写任务 */
+    @Test
+    fun rescanKeepsProgressAndJobsOfUnchangedChapters() = runBlocking {
+        repository.replaceChapters(bookId, scanned("01", "02", "03"), emptyList())
+        val (first, second, third) = db.chapterDao().getChaptersByBookIdList(bookId).map { it.id }
+        db.playbackProgressDao().upsert(bookId, second, 42_000L)
+        db.transcriptionJobDao().insertAll(
+            listOf(
+                TranscriptionJob(first, bookId, TranscriptionJob.STATE_DONE),
+                TranscriptionJob(second, bookId, TranscriptionJob.STATE_RUNNING, processedMs = 60_000),
+                TranscriptionJob(third, bookId, TranscriptionJob.STATE_PENDING)
+            )
+        )
+
+        // 03 被删除，04 是新文件
+        repository.replaceChapters(bookId, scanned("01", "02", "04"), emptyList())
+
+        val chapters = db.chapterDao().getChaptersByBookIdList(bookId)
+        assertEquals(listOf("01", "02", "04"), chapters.map { it.title })
+        assertEquals(listOf(first, second), chapters.take(2).map { it.id })
+        db.playbackProgressDao().getProgressByBookId(bookId)!!.let {
+            assertEquals(second, it.chapterId)
+            assertEquals(42_000L, it.positionMs)
+        }
+        val jobs = db.transcriptionJobDao()
+        assertEquals(TranscriptionJob.STATE_DONE, jobs.getByChapterId(first)!!.state)
+        assertEquals(60_000L, jobs.getByChapterId(second)!!.processedMs)
+        assertNull(jobs.getByChapterId(third))
+    }
+}
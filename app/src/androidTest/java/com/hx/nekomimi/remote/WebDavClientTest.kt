@@ -0,0 +1,94 @@
+package com.hx.nekomimi.remote
+
+import android.content.Context
+import androidx.test.core.app.ApplicationProvider
+import androidx.test.ext.junit.runners.AndroidJUnit4
+import kotlinx.coroutines.runBlocking
+import okhttp3.Credentials
+import okhttp3.mockwebserver.MockResponse
+import okhttp3.mockwebserver.MockWebServer
+import org.junit.After
+import org.junit.Assert.assertEquals
+import org.junit.Assert.assertNull
+import org.junit.Assert.assertTrue
+import org.junit.Before
+import org.junit.Test
+import org.junit.runner.RunWith
+import java.io.IOException
+
+/**
+ * 对本地 MockWebServer 发 PROPFIND：检查请求方法 / Depth / 认证头，以及 207 响应的解析
+ */
+@RunWith(AndroidJUnit4::class)
+class WebDavClientTest {
+
+    private val context = ApplicationProvider.getApplicationContext<Context>()
+    private val server = MockWebServer()
+
+    @Before
+    fun setUp() {
+        server.start()
+    }
+
+    @After
+    fun tearDown() = runBlocking {
+        WebDavCredentials.save(context, server.url("/").toString(), "", "")
+        server.shutdown()
+    }
+
+    @Test
+    fun propfindListsChildrenWithSavedCredentials() = runBlocking {
+        val base = server.url("/books/有声书/")
+        WebDavCredentials.save(context, base.toString(), "alice", "secret")
+        server.enqueue(
+            MockResponse().setResponseCode(207)
+                .setHeader("Content-Type", "application/xml; charset=utf-8")
+                .setBody(
+                    """<?xml version="1.0" encoding="utf-8"?>
+<d:multistatus xmlns:d="DAV:">
+  <d:response>
+    <d:href>/books/%E6%9C%89%E5%A3%B0%E4%B9%A6/</d:href>
+    <d:propstat><d:prop><d:resourcetype><d:collection/></d:resourcetype></d:prop></d:propstat>
+  </d:response>
+  <d:response>
+    <d:href>/books/%E6%9C%89%E5%A3%B0%E4%B9%A6/%E7%AC%AC1%E7%AB%A0.mp3</d:href>
+    <d:propstat><d:prop>
+      <d:resourcetype/>
+      <d:getcontentlength>123456</d:getcontentlength>
+      <d:getlastmodified>Sat, 01 Jun 2024 12:00:00 GMT</d:getlastmodified>
+    </d:prop></d:propstat>
+  </d:response>
+  <d:response>
+    <d:href>/books/%E6%9C%89%E5%A3%B0%E4%B9%A6/extra</d:href>
+    <d:propstat><d:prop><d:resourcetype><d:collection/></d:resourcetype></d:prop></d:propstat>
+  </d:response>
+</d:multistatus>"""
+                )
+        )
+
+        val entries = WebDavClient(context).list(base.toString())
+
+        val request = server.takeRequest()
+        assertEquals("PROPFIND", request.method)
+        assertEquals("1", request.getHeader("Depth"))
+        assertEquals(Credentials.basic("alice", "secret"), request.getHeader("Authorization"))
+        assertTrue(request.body.readUtf8().contains("getcontentlength"))
+
+        // 目录自身不列出；子目录地址补上结尾的 /
+        assertEquals(listOf("第1章.mp3", "extra"), entries.map { it.name })
+        val file = entries[0]
+        assertEquals(false, file.isDirectory)
+        assertEquals(123456L, file.size)
+        assertEquals(1717243200000L, file.lastModified)
+        assertTrue(entries[1].isDirectory)
+        assertTrue(entries[1].url.endsWith("/extra/"))
+    }
+
+    @Test
+    fun propfindWithoutCredentialsSendsNoAuthorization() {
+        server.enqueue(MockResponse().setResponseCode(401))
+        val result = runCatching { WebDavClient(context).list(server.url("/private/").toString()) }
+        assertTrue(result.exceptionOrNull() is IOException)
+        assertNull(server.takeRequest().getHeader("Authorization"))
+    }
+}
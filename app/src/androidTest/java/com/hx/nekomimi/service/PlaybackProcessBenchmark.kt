@@ -0,0 +1,299 @@
+package com.hx.nekomimi.service
+
+import android.app.ActivityManager
+import android.content.Intent
+import android.net.Uri
+import android.os.Bundle
+import android.os.Looper
+import android.os.ParcelFileDescriptor
+import android.os.Process
+import android.os.SystemClock
+import android.util.Log
+import android.view.View
+import androidx.annotation.OptIn
+import androidx.media3.common.MediaItem
+import androidx.media3.common.util.UnstableApi
+import androidx.media3.session.MediaController
+import androidx.media3.session.SessionResult
+import androidx.media3.session.SessionToken
+import androidx.test.core.app.ActivityScenario
+import androidx.test.core.app.ApplicationProvider
+import androidx.test.ext.junit.runners.AndroidJUnit4
+import androidx.test.platform.app.InstrumentationRegistry
+import com.google.common.util.concurrent.ListenableFuture
+import com.hx.nekomimi.NekoMimiApp
+import com.hx.nekomimi.ui.MainActivity
+import com.hx.nekomimi.writeTone
+import org.junit.After
+import org.junit.Assert.assertTrue
+import org.junit.Before
+import org.junit.Test
+import org.junit.runner.RunWith
+import java.io.File
+import java.util.concurrent.TimeUnit
+import java.util.concurrent.atomic.AtomicBoolean
+
+/**
+ * 同进程与独立 `:playback` 进程两种播放服务的启动耗时和内存对比
+ *
+ * 每种模式跑 [ROUNDS] 轮，每轮都先停止服务并结束播放进程，从冷启动开始计时：
+ * - 连接：MediaController 连上会话（独立进程模式包含进程启动和 Application.onCreate）
+ * - 起播：setMediaItem + prepare + play 到 isPlaying 为 true
+ * - 内存：播放 [PLAY_MS] 后本应用各进程的 VmRSS（测试本身运行在主进程里，两种模式都包含这部分），
+ *   以及服务所在进程的 Java 堆（同进程模式包含界面和测试本身）
+ * - 欠载：播放期间的音频欠载次数
+ * 堆和欠载次数通过 [PlaybackHealth] 命令从服务取得。播放期间主页保持打开，主线程反复重新布局并分配临时对象，
+ * 模拟界面繁忙（同进程模式下服务与界面共用主线程和堆）。
+ *
+ * [longScreenOffHeap] 在两种模式下各熄屏播放 [SCREEN_OFF_MS]，每分钟记录一次服务进程的堆和欠载次数。
+ *
+ * 结果输出到 logcat（tag: ProcessBenchmark），取中位数；结束后恢复测试前的进程设置。
+ * `./gradlew connectedDebugAndroidTest -Pandroid.testInstrumentationRunnerArguments.class=com.hx.nekomimi.service.PlaybackProcessBenchmark`
+ */
+@OptIn(UnstableApi::class)
+@RunWith(AndroidJUnit4::class)
+class PlaybackProcessBenchmark {
+
+    private class Sample(
+        val connectMs: Long,
+        val startMs: Long,
+        val rssKb: Map<String, Long>,
+        val heapKb: Long,
+        val underruns: Int
+    )
+
+    companion object {
+        private const val TAG = "ProcessBenchmark"
+        private const val ROUNDS = 5
+        private const val PLAY_MS = 5_000L
+        private const val TIMEOUT_MS = 10_000L
+        private const val SCREEN_OFF_MS = 10 * 60_000L
+        private const val SCREEN_OFF_SAMPLE_MS = 60_000L
+
+        /** 界面负载：每次在主线程上占用的时间和两次之间的间隔 */
+        private const val LOAD_BUSY_MS = 40L
+        private const val LOAD_INTERVAL_MS = 60L
+
+        /** 停止服务、结束进程后等待系统回收的时间 */
+        private const val SETTLE_MS = 1_000L
+
+        private fun List<Long>.median(): Long = sorted()[size / 2]
+    }
+
+    private val app = ApplicationProvider.getApplicationContext<NekoMimiApp>()
+    private val instrumentation = InstrumentationRegistry.getInstrumentation()
+    private val audio = File(app.filesDir, "process-benchmark.wav")
+    private var wasSeparate = false
+
+    /** 界面负载分配的字节数，只为让分配不被优化掉 */
+    private var allocated = 0L
+
+    @Before
+    fun setUp() {
+        wasSeparate = PlaybackProcess.isSeparateProcessEnabled(app)
+        writeTone(audio, seconds = 60)
+    }
+
+    @After
+    fun tearDown() {
+        stopPlaybackService()
+        PlaybackProcess.setSeparateProcessEnabled(app, wasSeparate)
+        audio.delete()
+    }
+
+    @Test
+    fun compareSingleAndSeparateProcess() {
+        val results = ActivityScenario.launch(MainActivity::class.java).use { scenario ->
+            withUiLoad(scenario) {
+                listOf(false, true).associateWith { separate ->
+                    PlaybackProcess.setSeparateProcessEnabled(app, separate)
+                    List(ROUNDS) { measure() }
+                }
+            }
+        }
+
+        for ((separate, samples) in results) {
+            val label = if (separate) "独立进程" else "同进程"
+            val perProcess = samples.flatMap { it.rssKb.keys }.distinct().joinToString { name ->
+                "$name=${samples.map { it.rssKb[name] ?: 0L }.median() / 1024}MB"
+            }
+            Log.i(
+                TAG,
+                "$label: 连接 ${samples.map { it.connectMs }.median()}ms，起播 ${samples.map { it.startMs }.median()}ms，" +
+                    "内存合计 ${samples.map { it.rssKb.values.sum() }.median() / 1024}MB（$perProcess），" +
+                    "服务进程堆 ${samples.map { it.heapKb }.median() / 1024}MB，" +
+                    "欠载 ${samples.map { it.underruns.toLong() }.median()} 次（最多 ${samples.maxOf { it.underruns }}）"
+            )
+        }
+        assertTrue(
+            "独立进程模式下没有运行 ${PlaybackProcess.PROCESS_SUFFIX} 进程",
+            results.getValue(true).all { sample -> sample.rssKb.keys.any { it.endsWith(PlaybackProcess.PROCESS_SUFFIX) } }
+        )
+        assertTrue(
+            "同进程模式下不应启动 ${PlaybackProcess.PROCESS_SUFFIX} 进程",
+            results.getValue(false).none { sample -> sample.rssKb.keys.any { it.endsWith(PlaybackProcess.PROCESS_SUFFIX) } }
+        )
+    }
+
+    @Test
+    fun longScreenOffHeap() {
+        try {
+            for (separate in listOf(false, true)) {
+                PlaybackProcess.setSeparateProcessEnabled(app, separate)
+                val label = if (separate) "独立进程" else "同进程"
+                stopPlaybackService()
+                val controller = connect()
+                try {
+                    play(controller)
+                    shell("input keyevent KEYCODE_SLEEP")
+                    var elapsed = 0L
+                    while (elapsed < SCREEN_OFF_MS) {
+                        Thread.sleep(SCREEN_OFF_SAMPLE_MS)
+                        elapsed += SCREEN_OFF_SAMPLE_MS
+                        val health = health(controller)
+                        Log.i(
+                            TAG,
+                            "$label 熄屏 ${elapsed / 60_000} 分钟：服务进程堆 ${health.getLong(PlaybackHealth.KEY_HEAP_KB) / 1024}MB，" +
+                                "欠载 ${health.getInt(PlaybackHealth.KEY_UNDERRUNS)} 次，" +
+                                "内存合计 ${rssByProcess().values.sum() / 1024}MB"
+                        )
+                    }
+                    shell("input keyevent KEYCODE_WAKEUP")
+                } finally {
+                    release(controller)
+                }
+            }
+        } finally {
+            shell("input keyevent KEYCODE_WAKEUP")
+        }
+    }
+
+    private fun measure(): Sample {
+        stopPlaybackService()
+        val startedAt = SystemClock.elapsedRealtime()
+        val controller = connect()
+        val connectMs = SystemClock.elapsedRealtime() - startedAt
+        try {
+            play(controller)
+            val startMs = SystemClock.elapsedRealtime() - startedAt - connectMs
+            Thread.sleep(PLAY_MS)
+            val health = health(controller)
+            return Sample(
+                connectMs,
+                startMs,
+                rssByProcess(),
+                health.getLong(PlaybackHealth.KEY_HEAP_KB),
+                health.getInt(PlaybackHealth.KEY_UNDERRUNS)
+            )
+        } finally {
+            release(controller)
+        }
+    }
+
+    private fun connect(): MediaController {
+        val token = SessionToken(app, PlaybackProcess.sessionComponent(app))
+        lateinit var future: ListenableFuture<MediaController>
+        instrumentation.runOnMainSync {
+            future = MediaController.Builder(app, token).setApplicationLooper(Looper.getMainLooper()).buildAsync()
+        }
+        return future.get(TIMEOUT_MS, TimeUnit.MILLISECONDS)
+    }
+
+    private fun play(controller: MediaController) {
+        instrumentation.runOnMainSync {
+            controller.setMediaItem(MediaItem.fromUri(Uri.fromFile(audio)))
+            controller.prepare()
+            controller.play()
+        }
+        waitUntilPlaying(controller)
+    }
+
+    private fun release(controller: MediaController) {
+        instrumentation.runOnMainSync {
+            controller.stop()
+            controller.release()
+        }
+    }
+
+    /** 向服务查询 Java 堆和欠载次数 */
+    private fun health(controller: MediaController): Bundle {
+        lateinit var future: ListenableFuture<SessionResult>
+        instrumentation.runOnMainSync {
+            future = controller.sendCustomCommand(PlaybackHealth.COMMAND, Bundle.EMPTY)
+        }
+        val result = future.get(TIMEOUT_MS, TimeUnit.MILLISECONDS)
+        check(result.resultCode == SessionResult.RESULT_SUCCESS) { "查询播放健康状况失败：${result.resultCode}" }
+        return result.extras
+    }
+
+    /**
+     * 在 [block] 执行期间让界面主线程保持繁忙：反复强制整棵视图树重新测量布局，并分配短命对象制造 GC 压力
+     */
+    private fun <T> withUiLoad(scenario: ActivityScenario<MainActivity>, block: () -> T): T {
+        val running = AtomicBoolean(true)
+        val load = Thread {
+            while (running.get()) {
+                scenario.onActivity { activity ->
+                    val root = activity.window.decorView
+                    val deadline = SystemClock.elapsedRealtime() + LOAD_BUSY_MS
+                    while (SystemClock.elapsedRealtime() < deadline) {
+                        root.forceLayout()
+                        root.measure(
+                            View.MeasureSpec.makeMeasureSpec(root.width, View.MeasureSpec.EXACTLY),
+                            View.MeasureSpec.makeMeasureSpec(root.height, View.MeasureSpec.EXACTLY)
+                        )
+                        root.layout(root.left, root.top, root.right, root.bottom)
+                        allocated += ByteArray(64 * 1024).size
+                    }
+                }
+                Thread.sleep(LOAD_INTERVAL_MS)
+            }
+        }
+        load.start()
+        try {
+            return block()
+        } finally {
+            running.set(false)
+            load.join()
+        }
+    }
+
+    private fun shell(command: String) {
+        // 读完输出，命令执行结束后再返回
+        ParcelFileDescriptor.AutoCloseInputStream(instrumentation.uiAutomation.executeShellCommand(command)).use { it.readBytes() }
+    }
+
+    private fun waitUntilPlaying(controller: MediaController) {
+        val deadline = SystemClock.elapsedRealtime() + TIMEOUT_MS
+        while (true) {
+            var playing = false
+            instrumentation.runOnMainSync { playing = controller.isPlaying }
+            if (playing) return
+            check(SystemClock.elapsedRealtime() < deadline) { "${TIMEOUT_MS}ms 内没有开始播放" }
+            Thread.sleep(10)
+        }
+    }
+
+    /** 停止两个播放服务并结束独立播放进程，下一轮从冷启动开始 */
+    private fun stopPlaybackService() {
+        app.stopService(Intent(app, MediaPlaybackService::class.java))
+        app.stopService(Intent(app, IsolatedMediaPlaybackService::class.java))
+        appProcesses()
+            .filter { it.processName.endsWith(PlaybackProcess.PROCESS_SUFFIX) }
+            .forEach { Process.killProcess(it.pid) }
+        Thread.sleep(SETTLE_MS)
+    }
+
+    private fun appProcesses(): List<ActivityManager.RunningAppProcessInfo> =
+        app.getSystemService(ActivityManager::class.java).runningAppProcesses.orEmpty()
+            .filter { it.processName.startsWith(app.packageName) }
+
+    /** 进程名 -> VmRSS（KB），同 uid 的 /proc/<pid>/status 可以直接读取 */
+    private fun rssByProcess(): Map<String, Long> = appProcesses().associate { info ->
+        val rss = File("/proc/${info.pid}/status").useLines { lines ->
+            lines.firstOrNull { it.startsWith("VmRSS:") }
+                ?.substringAfter(':')?.trim()?.substringBefore(' ')?.toLongOrNull()
+        }
+        info.processName to (rss ?: 0L)
+    }
+}
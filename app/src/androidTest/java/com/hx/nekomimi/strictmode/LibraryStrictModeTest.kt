@@ -0,0 +1,49 @@
+package com.hx.nekomimi.strictmode
+
+import androidx.appcompat.widget.SearchView
+import androidx.appcompat.widget.Toolbar
+import androidx.test.core.app.ActivityScenario
+import androidx.test.ext.junit.runners.AndroidJUnit4
+import androidx.test.filters.SdkSuppress
+import com.hx.nekomimi.R
+import com.hx.nekomimi.ui.MainActivity
+import org.junit.Rule
+import org.junit.Test
+import org.junit.runner.RunWith
+
+/**
+ * 冷启动和书架界面：主线程不应读写磁盘或访问网络
+ *
+ * 违规回调（penaltyListener）需要 API 28。
+ */
+@SdkSuppress(minSdkVersion = 28)
+@RunWith(AndroidJUnit4::class)
+class LibraryStrictModeTest {
+
+    @get:Rule
+    val strictMode = NoStrictModeViolationsRule()
+
+    @Test
+    fun startupShowsLibrary() {
+        ActivityScenario.launch(MainActivity::class.java).use {
+            settle()
+        }
+    }
+
+    @Test
+    fun refreshAndSearchLibrary() {
+        ActivityScenario.launch(MainActivity::class.java).use { scenario ->
+            settle()
+            scenario.onActivity {
+                it.findViewById<Toolbar>(R.id.toolbar).menu.performIdentifierAction(R.id.action_refresh, 0)
+            }
+            settle()
+            scenario.onActivity {
+                val item = it.findViewById<Toolbar>(R.id.toolbar).menu.findItem(R.id.action_search)
+                item.expandActionView()
+                (item.actionView as SearchView).setQuery("第一章", true)
+            }
+            settle()
+        }
+    }
+}
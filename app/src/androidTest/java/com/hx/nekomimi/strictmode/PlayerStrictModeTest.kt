@@ -0,0 +1,91 @@
+package com.hx.nekomimi.strictmode
+
+import android.content.Intent
+import android.net.Uri
+import android.widget.ImageButton
+import androidx.test.core.app.ActivityScenario
+import androidx.test.core.app.ApplicationProvider
+import androidx.test.ext.junit.runners.AndroidJUnit4
+import androidx.test.filters.SdkSuppress
+import com.hx.nekomimi.NekoMimiApp
+import com.hx.nekomimi.R
+import com.hx.nekomimi.data.entity.Book
+import com.hx.nekomimi.data.entity.Chapter
+import com.hx.nekomimi.ui.BookDetailActivity
+import com.hx.nekomimi.ui.PlayerActivity
+import com.hx.nekomimi.writeTone
+import kotlinx.coroutines.runBlocking
+import org.junit.After
+import org.junit.Before
+import org.junit.Rule
+import org.junit.Test
+import org.junit.runner.RunWith
+import java.io.File
+
+/**
+ * 书籍详情和播放界面：加载章节、字幕、连接播放服务、开始 / 暂停播放时主线程不应读写磁盘
+ *
+ * 测试数据（一本只有一章的书、一段 WAV 和一份 SRT）在测试线程上准备，不计入违规。
+ * 播放服务设置为独立进程时，服务进程里的违规不经过本进程的监听，只记录在 logcat。
+ */
+@SdkSuppress(minSdkVersion = 28)
+@RunWith(AndroidJUnit4::class)
+class PlayerStrictModeTest {
+
+    @get:Rule
+    val strictMode = NoStrictModeViolationsRule()
+
+    private val app = ApplicationProvider.getApplicationContext<NekoMimiApp>()
+    private val dir = File(app.cacheDir, "strictmode-test")
+    private var bookId = 0L
+    private var chapterId = 0L
+
+    @Before
+    fun createBook() = runBlocking {
+        dir.mkdirs()
+        val audio = File(dir, "chapter1.wav").also { writeTone(it, seconds = 10) }
+        val subtitle = File(dir, "chapter1.srt").apply {
+            writeText("1\n00:00:00,500 --> 00:00:03,000\n第一句\n\n2\n00:00:03,500 --> 00:00:08,000\n第二句\n")
+        }
+        bookId = app.database.bookDao().insert(Book(name = "StrictMode 测试书", rootPath = dir.absolutePath))
+        chapterId = app.database.chapterDao().insert(
+            Chapter(
+                bookId = bookId,
+                title = "第一章",
+                filePath = audio.absolutePath,
+                fileUri = Uri.fromFile(audio).toString(),
+                subtitleUri = Uri.fromFile(subtitle).toString(),
+                durationMs = 10_000
+            )
+        )
+    }
+
+    @After
+    fun deleteBook() = runBlocking {
+        app.database.bookDao().deleteById(bookId)
+        dir.deleteRecursively()
+    }
+
+    @Test
+    fun openBookDetail() {
+        val intent = Intent(app, BookDetailActivity::class.java)
+            .putExtra(BookDetailActivity.EXTRA_BOOK_ID, bookId)
+        ActivityScenario.launch<BookDetailActivity>(intent).use {
+            settle()
+        }
+    }
+
+    @Test
+    fun playAndPauseChapter() {
+        val intent = Intent(app, PlayerActivity::class.java)
+            .putExtra(PlayerActivity.EXTRA_BOOK_ID, bookId)
+            .putExtra(PlayerActivity.EXTRA_CHAPTER_ID, chapterId)
+        ActivityScenario.launch<PlayerActivity>(intent).use { scenario ->
+            settle()
+            scenario.onActivity { it.findViewById<ImageButton>(R.id.btnPlayPause).performClick() }
+            settle()
+            scenario.onActivity { it.findViewById<ImageButton>(R.id.btnPlayPause).performClick() }
+            settle()
+        }
+    }
+}
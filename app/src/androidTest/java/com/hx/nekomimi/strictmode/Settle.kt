@@ -0,0 +1,16 @@
+package com.hx.nekomimi.strictmode
+
+import androidx.test.platform.app.InstrumentationRegistry
+
+/** 界面异步加载（协程切回主线程、播放器回调）的等待时间 */
+private const val SETTLE_MS = 1500L
+
+/**
+ * 等待主线程空闲，再给后台任务留出把结果投递回主线程的时间
+ */
+fun settle() {
+    val instrumentation = InstrumentationRegistry.getInstrumentation()
+    instrumentation.waitForIdleSync()
+    Thread.sleep(SETTLE_MS)
+    instrumentation.waitForIdleSync()
+}
@@ -0,0 +1,16 @@
+package com.hx.nekomimi.strictmode
+
+import android.os.Bundle
+import androidx.test.runner.AndroidJUnitRunner
+import com.hx.nekomimi.NekoMimiApp
+
+/**
+ * 在 Application.onCreate 之前挂上违规收集，启动阶段（数据库、设置、缓存登记）的违规也能被测试发现
+ */
+class StrictModeTestRunner : AndroidJUnitRunner() {
+
+    override fun onCreate(arguments: Bundle?) {
+        NekoMimiApp.strictModeListener = StrictModeViolations::record
+        super.onCreate(arguments)
+    }
+}
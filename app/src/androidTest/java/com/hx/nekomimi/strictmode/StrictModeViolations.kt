@@ -0,0 +1,58 @@
+package com.hx.nekomimi.strictmode
+
+import android.util.Log
+import androidx.test.platform.app.InstrumentationRegistry
+import org.junit.rules.TestRule
+import org.junit.runner.Description
+import org.junit.runners.model.Statement
+import java.util.concurrent.ConcurrentLinkedQueue
+
+/**
+ * 收集本应用代码触发的 StrictMode 违规
+ *
+ * 调用栈中没有 com.hx.nekomimi 帧的违规（系统组件或第三方库内部自己触发的）不计入，
+ * 它们不是本应用能修的问题。
+ */
+object StrictModeViolations {
+
+    private const val TAG = "StrictModeViolations"
+    private const val APP_PACKAGE = "com.hx.nekomimi."
+    private const val TEST_PACKAGE = "com.hx.nekomimi.strictmode."
+
+    private val violations = ConcurrentLinkedQueue<Throwable>()
+
+    fun record(violation: Throwable) {
+        val ours = violation.stackTrace.any {
+            it.className.startsWith(APP_PACKAGE) && !it.className.startsWith(TEST_PACKAGE)
+        }
+        if (!ours) return
+        Log.e(TAG, "StrictMode 违规", violation)
+        violations.add(violation)
+    }
+
+    /** 取出并清空已收集的违规 */
+    fun drain(): List<Throwable> = generateSequence { violations.poll() }.toList()
+}
+
+/**
+ * 测试结束（主线程空闲）后检查期间收集到的违规，有任何一条即判定失败
+ *
+ * 第一个运行的测试同时会检查 Application.onCreate 期间的违规。
+ */
+class NoStrictModeViolationsRule : TestRule {
+
+    override fun apply(base: Statement, description: Description): Statement = object : Statement() {
+        override fun evaluate() {
+            base.evaluate()
+            InstrumentationRegistry.getInstrumentation().waitForIdleSync()
+            val violations = StrictModeViolations.drain()
+            if (violations.isNotEmpty()) {
+                val summary = violations.joinToString("\n") { "- ${it.javaClass.simpleName}: ${firstAppFrame(it)}" }
+                throw AssertionError("${description.methodName} 期间主线程出现 ${violations.size} 次 StrictMode 违规：\n$summary", violations.first())
+            }
+        }
+    }
+
+    private fun firstAppFrame(violation: Throwable): String =
+        violation.stackTrace.firstOrNull { it.className.startsWith("com.hx.nekomimi.") }?.toString() ?: "?"
+}
@@ -0,0 +1,105 @@
+#include "dsp/neko_dsp.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+
+namespace neko::dsp {
+
+namespace {
+
+const Kernels& select_kernels() {
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+    return neon_kernels();
+#elif defined(__x86_64__) || defined(__i386__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        return avx2_kernels();
+    }
+    return sse2_kernels();
+#else
+    return scalar_kernels();
+#endif
+}
+
+// 只在首次调用时探测一次 CPU 特性
+const Kernels& active() {
+    static const Kernels& k = select_kernels();
+    return k;
+}
+
+}  // namespace
+
+const char* kernel_name() { return active().name; }
+
+void pcm16_to_float(const int16_t* src, float* dst, int samples) {
+    if (samples > 0) active().pcm16_to_float(src, dst, samples);
+}
+
+void float_to_pcm16(const float* src, int16_t* dst, int samples) {
+    if (samples > 0) active().float_to_pcm16(src, dst, samples);
+}
+
+void gain_ramp(float* buf, int frames, int channels, float start_gain, float end_gain) {
+    if (frames <= 0 || channels <= 0) return;
+    active().gain_ramp(buf, frames, channels, start_gain, end_gain);
+}
+
+int envelope(const float* buf, int frames, int channels, int hop_frames,
+             float* rms_out, float* peak_out) {
+    if (frames <= 0 || channels <= 0 || hop_frames <= 0) return 0;
+    const Kernels& k = active();
+    int points = 0;
+    for (int start = 0; start < frames; start += hop_frames) {
+        const int n = std::min(hop_frames, frames - start) * channels;
+        float sum_sq = 0.0f;
+        float max_abs = 0.0f;
+        k.sum_sq_max_abs(buf + static_cast<int64_t>(start) * channels, n, &sum_sq, &max_abs);
+        if (rms_out) rms_out[points] = std::sqrt(sum_sq / static_cast<float>(n));
+        if (peak_out) peak_out[points] = max_abs;
+        ++points;
+    }
+    return points;
+}
+
+void overlap_add(float* dst, const float* src, const float* window, int n) {
+    if (n > 0) active().overlap_add(dst, src, window, n);
+}
+
+// ========== Biquad ==========
+// IIR 的递推依赖上一采样，无法按时间向量化；按声道独立做紧凑的标量循环
+
+void Biquad::set_coefficients(float nb0, float nb1, float nb2, float na1, float na2) {
+    b0 = nb0;
+    b1 = nb1;
+    b2 = nb2;
+    a1 = na1;
+    a2 = na2;
+}
+
+void Biquad::reset() {
+    std::fill(std::begin(z1), std::end(z1), 0.0f);
+    std::fill(std::begin(z2), std::end(z2), 0.0f);
+}
+
+void Biquad::process(float* buf, int frames, int channels) {
+    // 只保存前 kMaxChannels 个声道的状态，其余声道原样通过；指针步长始终是实际声道数
+    const int filtered = std::min(channels, kMaxChannels);
+    for (int c = 0; c < filtered; ++c) {
+        float s1 = z1[c];
+        float s2 = z2[c];
+        float* p = buf + c;
+        for (int i = 0; i < frames; ++i, p += channels) {
+            const float x = *p;
+            const float y = b0 * x + s1;
+            s1 = b1 * x - a1 * y + s2;
+            s2 = b2 * x - a2 * y;
+            *p = y;
+        }
+        // 防止长时间静音后状态落入非规格化数导致 CPU 飙升
+        z1[c] = std::fabs(s1) < 1e-20f ? 0.0f : s1;
+        z2[c] = std::fabs(s2) < 1e-20f ? 0.0f : s2;
+    }
+}
+
+}  // namespace neko::dsp
@@ -0,0 +1,154 @@
+// 猫耳听书 DSP 核心
+//
+// 面向长时间后台播放的语音处理基础算子：增益渐变、RMS/峰值包络、双二阶滤波、重叠相加。
+// 所有算子均为块处理、无内部分配，调用方负责提供缓冲区。
+// 按 CPU 在运行时选择 NEON / SSE2 / AVX2 / 标量实现，对外只暴露统一的函数接口。
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace neko::dsp {
+
+/**
+ * 当前使用的内核实现名（"neon" / "avx2" / "sse2" / "scalar"）
+ */
+const char* kernel_name();
+
+/**
+ * 交错 PCM16 -> float [-1, 1)
+ */
+void pcm16_to_float(const int16_t* src, float* dst, int samples);
+
+/**
+ * float -> 交错 PCM16（带饱和截断）
+ */
+void float_to_pcm16(const float* src, int16_t* dst, int samples);
+
+/**
+ * 线性增益渐变（原地处理）
+ * 第 i 帧的增益为 start + (end - start) * i / frames，同一帧的所有声道使用相同增益
+ */
+void gain_ramp(float* buf, int frames, int channels, float start_gain, float end_gain);
+
+/**
+ * 按 hop 计算 RMS 与峰值包络（所有声道合并）
+ * @return 写出的包络点数 = frames / hop_frames（向上取整）
+ */
+int envelope(const float* buf, int frames, int channels, int hop_frames,
+             float* rms_out, float* peak_out);
+
+/**
+ * dst[i] += src[i] * window[i]；window 为空时直接相加
+ */
+void overlap_add(float* dst, const float* src, const float* window, int n);
+
+/**
+ * 双二阶滤波器（转置直接 II 型），每个声道独立保存状态
+ * 系数已按 a0 归一化；超过 kMaxChannels 的声道不做滤波，原样通过
+ */
+struct Biquad {
+    static constexpr int kMaxChannels = 8;
+
+    float b0 = 1.0f, b1 = 0.0f, b2 = 0.0f, a1 = 0.0f, a2 = 0.0f;
+    float z1[kMaxChannels] = {};
+    float z2[kMaxChannels] = {};
+
+    void set_coefficients(float nb0, float nb1, float nb2, float na1, float na2);
+    void reset();
+    void process(float* buf, int frames, int channels);
+};
+
+/**
+ * 前瞻式动态范围压缩 / 限幅器（面向语音）
+ *
+ * - 检测器按 kBlockFrames 帧为一块取所有声道的峰值，前瞻窗口内的最大峰值经软拐点增益计算后
+ *   按 attack / release 平滑；块内对增益做线性渐变，每块只算一次 log / exp
+ * - 输出延迟前瞻时长，增益在峰值到达之前就已降下来；限幅保证窗口峰值 × 增益不超过 ceiling
+ * - 缓冲区只在 configure 时分配，process 不分配内存
+ * - set_enabled(false) 不清空延迟线：音频照常经过延迟线（输出延迟不变），增益在 kFadeMs 内平滑回到 1，
+ *   检测器继续运行，重新开启时同样平滑过渡，开关时不会插入静音或丢失采样
+ */
+struct Compressor {
+    static constexpr int kBlockFrames = 16;
+    static constexpr int kMaxLookaheadBlocks = 64;
+    static constexpr float kFadeMs = 20.0f;
+
+    struct Params {
+        float threshold_db = -30.0f;
+        float ratio = 4.0f;
+        float knee_db = 6.0f;
+        float attack_ms = 5.0f;
+        float release_ms = 150.0f;
+        float makeup_db = 9.0f;
+        float ceiling_db = -1.0f;
+    };
+
+    /** 按格式分配延迟线（前瞻时长向上取整到块） */
+    void configure(int sample_rate, int channels, float lookahead_ms);
+    void set_params(const Params& params);
+    /** 开启 / 旁路压缩（旁路时仍经过延迟线，增益渐变到 1） */
+    void set_enabled(bool enabled) { enabled_ = enabled; }
+    /** 清空延迟线和检测器状态（seek / 格式变化时调用） */
+    void reset();
+    /** 原地处理交错 float 块，声道数为 configure 时的值 */
+    void process(float* buf, int frames);
+    /** 当前增益衰减量（dB，≤ 0，不含补偿增益） */
+    float gain_reduction_db() const { return env_db_; }
+    /** 输出相对输入的延迟（帧）；流结束时送入这么多帧静音即可排空延迟线 */
+    int latency_frames() const { return delay_frames_; }
+
+private:
+    float gain_computer_db(float level_db) const;
+    void end_block();
+
+    Params params_;
+    int sample_rate_ = 44100;
+    int channels_ = 2;
+    float attack_coeff_ = 0.0f;
+    float release_coeff_ = 0.0f;
+
+    // 开关过渡：0 = 单位增益，1 = 完全压缩，每块按 mix_step_ 向目标移动
+    bool enabled_ = true;
+    float mix_ = 1.0f;
+    float mix_step_ = 1.0f;
+
+    // 延迟线（交错，lookahead_blocks_ * kBlockFrames 帧）
+    std::vector<float> delay_;
+    int delay_frames_ = kBlockFrames;
+    int delay_pos_ = 0;
+
+    // 检测器：最近 lookahead_blocks_ + 1 块的峰值，覆盖延迟线中所有待输出的帧
+    float block_peaks_[kMaxLookaheadBlocks + 1] = {};
+    int window_blocks_ = 2;
+    int peak_pos_ = 0;
+    float block_peak_ = 0.0f;
+    int block_fill_ = 0;
+
+    float env_db_ = 0.0f;
+    float gain_ = 1.0f;
+    float gain_step_ = 0.0f;
+};
+
+// ========== 各指令集实现（由 neko_dsp.cpp 在运行时分派） ==========
+
+struct Kernels {
+    const char* name;
+    void (*pcm16_to_float)(const int16_t*, float*, int);
+    void (*float_to_pcm16)(const float*, int16_t*, int);
+    void (*gain_ramp)(float*, int, int, float, float);
+    void (*sum_sq_max_abs)(const float*, int, float*, float*);
+    void (*overlap_add)(float*, const float*, const float*, int);
+};
+
+const Kernels& scalar_kernels();
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+const Kernels& neon_kernels();
+#endif
+#if defined(__x86_64__) || defined(__i386__)
+const Kernels& sse2_kernels();
+const Kernels& avx2_kernels();
+#endif
+
+}  // namespace neko::dsp
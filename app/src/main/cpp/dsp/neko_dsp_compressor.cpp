@@ -0,0 +1,122 @@
+#include "dsp/neko_dsp.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+
+namespace neko::dsp {
+
+// ========== Compressor ==========
+// 增益计算在块率上进行（每 kBlockFrames 帧一次），逐帧只做延迟线读写和乘法
+
+namespace {
+
+constexpr float kMinLevel = 1e-6f;  // -120 dB
+
+inline float db_to_gain(float db) { return std::exp(db * 0.11512925f); }  // ln(10) / 20
+
+inline float gain_to_db(float gain) { return 20.0f * std::log10(std::max(gain, kMinLevel)); }
+
+// 一阶平滑系数：时间常数按块率换算
+float smoothing_coeff(float time_ms, int sample_rate) {
+    const float blocks = time_ms * 0.001f * static_cast<float>(sample_rate) / Compressor::kBlockFrames;
+    return blocks <= 0.0f ? 0.0f : std::exp(-1.0f / blocks);
+}
+
+}  // namespace
+
+void Compressor::configure(int sample_rate, int channels, float lookahead_ms) {
+    sample_rate_ = std::max(sample_rate, 1);
+    // 延迟线按实际声道数分配，process 的交错步长也用这个值，不能截断
+    channels_ = std::max(channels, 1);
+
+    const float frames = lookahead_ms * 0.001f * static_cast<float>(sample_rate_);
+    const int blocks = static_cast<int>(std::ceil(frames / kBlockFrames));
+    const int lookahead_blocks = std::clamp(blocks, 1, kMaxLookaheadBlocks);
+    delay_frames_ = lookahead_blocks * kBlockFrames;
+    window_blocks_ = lookahead_blocks + 1;
+    delay_.assign(static_cast<size_t>(delay_frames_) * channels_, 0.0f);
+    mix_step_ = std::min(1.0f, kBlockFrames / (kFadeMs * 0.001f * static_cast<float>(sample_rate_)));
+
+    set_params(params_);
+    reset();
+}
+
+void Compressor::set_params(const Params& params) {
+    params_ = params;
+    params_.ratio = std::max(params_.ratio, 1.0f);
+    params_.knee_db = std::max(params_.knee_db, 0.0f);
+    attack_coeff_ = smoothing_coeff(params_.attack_ms, sample_rate_);
+    release_coeff_ = smoothing_coeff(params_.release_ms, sample_rate_);
+}
+
+void Compressor::reset() {
+    std::fill(delay_.begin(), delay_.end(), 0.0f);
+    std::fill(std::begin(block_peaks_), std::end(block_peaks_), 0.0f);
+    delay_pos_ = 0;
+    peak_pos_ = 0;
+    block_peak_ = 0.0f;
+    block_fill_ = 0;
+    env_db_ = 0.0f;
+    mix_ = enabled_ ? 1.0f : 0.0f;
+    gain_ = 1.0f + mix_ * (db_to_gain(params_.makeup_db) - 1.0f);
+    gain_step_ = 0.0f;
+}
+
+// 软拐点静态曲线，返回增益衰减量（≤ 0 dB）
+float Compressor::gain_computer_db(float level_db) const {
+    const float over = level_db - params_.threshold_db;
+    const float slope = 1.0f / params_.ratio - 1.0f;
+    const float knee = params_.knee_db;
+    if (2.0f * over < -knee) return 0.0f;
+    if (knee > 0.0f && 2.0f * std::fabs(over) <= knee) {
+        const float x = over + knee * 0.5f;
+        return slope * x * x / (2.0f * knee);
+    }
+    return slope * over;
+}
+
+void Compressor::end_block() {
+    block_peaks_[peak_pos_] = block_peak_;
+    peak_pos_ = (peak_pos_ + 1) % window_blocks_;
+    block_peak_ = 0.0f;
+    block_fill_ = 0;
+
+    float window_peak = 0.0f;
+    for (int i = 0; i < window_blocks_; ++i) window_peak = std::max(window_peak, block_peaks_[i]);
+    const float level_db = gain_to_db(window_peak);
+
+    const float target_db = gain_computer_db(level_db);
+    const float coeff = target_db < env_db_ ? attack_coeff_ : release_coeff_;
+    env_db_ = target_db + coeff * (env_db_ - target_db);
+    if (env_db_ > -1e-6f) env_db_ = 0.0f;  // 防止长时间释放后落入非规格化数
+
+    // 限幅：窗口内的峰值乘以本块结束时的增益不超过 ceiling
+    const float total_db = std::min(env_db_ + params_.makeup_db, params_.ceiling_db - level_db);
+
+    // 开关时在压缩增益和单位增益之间按块线性过渡
+    mix_ = enabled_ ? std::min(mix_ + mix_step_, 1.0f) : std::max(mix_ - mix_step_, 0.0f);
+    const float target_gain = 1.0f + mix_ * (db_to_gain(total_db) - 1.0f);
+    gain_step_ = (target_gain - gain_) / kBlockFrames;
+}
+
+void Compressor::process(float* buf, int frames) {
+    const int channels = channels_;
+    float* delay = delay_.data();
+    for (int i = 0; i < frames; ++i, buf += channels) {
+        float* slot = delay + static_cast<size_t>(delay_pos_) * channels;
+        float peak = 0.0f;
+        for (int c = 0; c < channels; ++c) {
+            const float x = buf[c];
+            peak = std::max(peak, std::fabs(x));
+            buf[c] = slot[c] * gain_;
+            slot[c] = x;
+        }
+        if (++delay_pos_ == delay_frames_) delay_pos_ = 0;
+        gain_ += gain_step_;
+        block_peak_ = std::max(block_peak_, peak);
+        if (++block_fill_ == kBlockFrames) end_block();
+    }
+}
+
+}  // namespace neko::dsp
@@ -0,0 +1,183 @@
+// JNI 绑定：com.hx.nekomimi.audio.dsp.NativeDsp
+//
+// 所有缓冲区都是 direct ByteBuffer（native 字节序），通过 GetDirectBufferAddress 零拷贝访问；
+// 偏移量以字节为单位，直接对应 ByteBuffer.position()。
+
+#include <jni.h>
+
+#include "dsp/neko_dsp.h"
+
+namespace {
+
+template <typename T>
+T* address(JNIEnv* env, jobject buffer, jint byte_offset) {
+    if (buffer == nullptr) return nullptr;
+    auto* base = static_cast<uint8_t*>(env->GetDirectBufferAddress(buffer));
+    if (base == nullptr) return nullptr;
+    return reinterpret_cast<T*>(base + byte_offset);
+}
+
+neko::dsp::Biquad* biquad(jlong handle) {
+    return reinterpret_cast<neko::dsp::Biquad*>(handle);
+}
+
+neko::dsp::Compressor* compressor(jlong handle) {
+    return reinterpret_cast<neko::dsp::Compressor*>(handle);
+}
+
+}  // namespace
+
+extern "C" {
+
+JNIEXPORT jstring JNICALL
+Java_com_hx_nekomimi_audio_dsp_NativeDsp_kernelName(JNIEnv* env, jobject) {
+    return env->NewStringUTF(neko::dsp::kernel_name());
+}
+
+JNIEXPORT void JNICALL
+Java_com_hx_nekomimi_audio_dsp_NativeDsp_pcm16ToFloat(
+        JNIEnv* env, jobject, jobject src, jint src_offset, jobject dst, jint dst_offset, jint samples) {
+    const auto* in = address<const int16_t>(env, src, src_offset);
+    auto* out = address<float>(env, dst, dst_offset);
+    if (in && out) neko::dsp::pcm16_to_float(in, out, samples);
+}
+
+JNIEXPORT void JNICALL
+Java_com_hx_nekomimi_audio_dsp_NativeDsp_floatToPcm16(
+        JNIEnv* env, jobject, jobject src, jint src_offset, jobject dst, jint dst_offset, jint samples) {
+    const auto* in = address<const float>(env, src, src_offset);
+    auto* out = address<int16_t>(env, dst, dst_offset);
+    if (in && out) neko::dsp::float_to_pcm16(in, out, samples);
+}
+
+JNIEXPORT void JNICALL
+Java_com_hx_nekomimi_audio_dsp_NativeDsp_gainRamp(
+        JNIEnv* env, jobject, jobject buf, jint offset, jint frames, jint channels,
+        jfloat start_gain, jfloat end_gain) {
+    auto* p = address<float>(env, buf, offset);
+    if (p) neko::dsp::gain_ramp(p, frames, channels, start_gain, end_gain);
+}
+
+JNIEXPORT jint JNICALL
+Java_com_hx_nekomimi_audio_dsp_NativeDsp_envelope(
+        JNIEnv* env, jobject, jobject buf, jint offset, jint frames, jint channels, jint hop_frames,
+        jfloatArray rms_out, jfloatArray peak_out) {
+    const auto* p = address<const float>(env, buf, offset);
+    if (p == nullptr || hop_frames <= 0) return 0;
+
+    // 输出数组容量不足时不写任何数据，返回 0（与 NativeDsp.envelope 的文档一致）
+    const jint needed = (frames + hop_frames - 1) / hop_frames;
+    if (rms_out && env->GetArrayLength(rms_out) < needed) return 0;
+    if (peak_out && env->GetArrayLength(peak_out) < needed) return 0;
+
+    auto* rms = rms_out ? static_cast<float*>(env->GetPrimitiveArrayCritical(rms_out, nullptr)) : nullptr;
+    auto* peak = peak_out ? static_cast<float*>(env->GetPrimitiveArrayCritical(peak_out, nullptr)) : nullptr;
+    const int points = neko::dsp::envelope(p, frames, channels, hop_frames, rms, peak);
+    if (peak) env->ReleasePrimitiveArrayCritical(peak_out, peak, 0);
+    if (rms) env->ReleasePrimitiveArrayCritical(rms_out, rms, 0);
+    return points;
+}
+
+JNIEXPORT void JNICALL
+Java_com_hx_nekomimi_audio_dsp_NativeDsp_overlapAdd(
+        JNIEnv* env, jobject, jobject dst, jint dst_offset, jobject src, jint src_offset,
+        jobject window, jint window_offset, jint n) {
+    auto* d = address<float>(env, dst, dst_offset);
+    const auto* s = address<const float>(env, src, src_offset);
+    const auto* w = address<const float>(env, window, window_offset);
+    if (d && s) neko::dsp::overlap_add(d, s, w, n);
+}
+
+// ========== Biquad ==========
+
+JNIEXPORT jlong JNICALL
+Java_com_hx_nekomimi_audio_dsp_NativeDsp_biquadCreate(JNIEnv*, jobject) {
+    return reinterpret_cast<jlong>(new neko::dsp::Biquad());
+}
+
+JNIEXPORT void JNICALL
+Java_com_hx_nekomimi_audio_dsp_NativeDsp_biquadSetCoefficients(
+        JNIEnv*, jobject, jlong handle, jfloat b0, jfloat b1, jfloat b2, jfloat a1, jfloat a2) {
+    if (handle) biquad(handle)->set_coefficients(b0, b1, b2, a1, a2);
+}
+
+JNIEXPORT void JNICALL
+Java_com_hx_nekomimi_audio_dsp_NativeDsp_biquadReset(JNIEnv*, jobject, jlong handle) {
+    if (handle) biquad(handle)->reset();
+}
+
+JNIEXPORT void JNICALL
+Java_com_hx_nekomimi_audio_dsp_NativeDsp_biquadProcess(
+        JNIEnv* env, jobject, jlong handle, jobject buf, jint offset, jint frames, jint channels) {
+    auto* p = address<float>(env, buf, offset);
+    if (handle && p) biquad(handle)->process(p, frames, channels);
+}
+
+JNIEXPORT void JNICALL
+Java_com_hx_nekomimi_audio_dsp_NativeDsp_biquadRelease(JNIEnv*, jobject, jlong handle) {
+    delete biquad(handle);
+}
+
+// ========== Compressor ==========
+
+JNIEXPORT jlong JNICALL
+Java_com_hx_nekomimi_audio_dsp_NativeDsp_compressorCreate(JNIEnv*, jobject) {
+    return reinterpret_cast<jlong>(new neko::dsp::Compressor());
+}
+
+JNIEXPORT void JNICALL
+Java_com_hx_nekomimi_audio_dsp_NativeDsp_compressorConfigure(
+        JNIEnv*, jobject, jlong handle, jint sample_rate, jint channels, jfloat lookahead_ms) {
+    if (handle) compressor(handle)->configure(sample_rate, channels, lookahead_ms);
+}
+
+JNIEXPORT void JNICALL
+Java_com_hx_nekomimi_audio_dsp_NativeDsp_compressorSetParams(
+        JNIEnv*, jobject, jlong handle, jfloat threshold_db, jfloat ratio, jfloat knee_db,
+        jfloat attack_ms, jfloat release_ms, jfloat makeup_db, jfloat ceiling_db) {
+    if (handle == 0) return;
+    neko::dsp::Compressor::Params params;
+    params.threshold_db = threshold_db;
+    params.ratio = ratio;
+    params.knee_db = knee_db;
+    params.attack_ms = attack_ms;
+    params.release_ms = release_ms;
+    params.makeup_db = makeup_db;
+    params.ceiling_db = ceiling_db;
+    compressor(handle)->set_params(params);
+}
+
+JNIEXPORT void JNICALL
+Java_com_hx_nekomimi_audio_dsp_NativeDsp_compressorSetEnabled(
+        JNIEnv*, jobject, jlong handle, jboolean enabled) {
+    if (handle) compressor(handle)->set_enabled(enabled == JNI_TRUE);
+}
+
+JNIEXPORT void JNICALL
+Java_com_hx_nekomimi_audio_dsp_NativeDsp_compressorReset(JNIEnv*, jobject, jlong handle) {
+    if (handle) compressor(handle)->reset();
+}
+
+JNIEXPORT void JNICALL
+Java_com_hx_nekomimi_audio_dsp_NativeDsp_compressorProcess(
+        JNIEnv* env, jobject, jlong handle, jobject buf, jint offset, jint frames) {
+    auto* p = address<float>(env, buf, offset);
+    if (handle && p) compressor(handle)->process(p, frames);
+}
+
+JNIEXPORT jfloat JNICALL
+Java_com_hx_nekomimi_audio_dsp_NativeDsp_compressorGainReductionDb(JNIEnv*, jobject, jlong handle) {
+    return handle ? compressor(handle)->gain_reduction_db() : 0.0f;
+}
+
+JNIEXPORT jint JNICALL
+Java_com_hx_nekomimi_audio_dsp_NativeDsp_compressorLatencyFrames(JNIEnv*, jobject, jlong handle) {
+    return handle ? compressor(handle)->latency_frames() : 0;
+}
+
+JNIEXPORT void JNICALL
+Java_com_hx_nekomimi_audio_dsp_NativeDsp_compressorRelease(JNIEnv*, jobject, jlong handle) {
+    delete compressor(handle);
+}
+
+}  // extern "C"
@@ -0,0 +1,136 @@
+// ARM NEON 实现（arm64-v8a 为基线；armeabi-v7a 由 NDK 默认开启 NEON）
+
+#include "dsp/neko_dsp.h"
+
+#include <arm_neon.h>
+
+#include <algorithm>
+
+namespace neko::dsp {
+
+namespace {
+
+constexpr float kPcm16Scale = 1.0f / 32768.0f;
+
+const Kernels& tail() { return scalar_kernels(); }
+
+inline float hsum(float32x4_t v) {
+#if defined(__aarch64__)
+    return vaddvq_f32(v);
+#else
+    const float32x2_t s = vadd_f32(vget_low_f32(v), vget_high_f32(v));
+    return vget_lane_f32(vpadd_f32(s, s), 0);
+#endif
+}
+
+inline float hmax(float32x4_t v) {
+#if defined(__aarch64__)
+    return vmaxvq_f32(v);
+#else
+    const float32x2_t m = vmax_f32(vget_low_f32(v), vget_high_f32(v));
+    return vget_lane_f32(vpmax_f32(m, m), 0);
+#endif
+}
+
+inline int32x4_t round_to_s32(float32x4_t v) {
+#if defined(__aarch64__)
+    return vcvtnq_s32_f32(v);
+#else
+    // ARMv7 没有就近取整转换，手动加减 0.5 后截断
+    const float32x4_t half = vbslq_f32(vcltq_f32(v, vdupq_n_f32(0.0f)), vdupq_n_f32(-0.5f), vdupq_n_f32(0.5f));
+    return vcvtq_s32_f32(vaddq_f32(v, half));
+#endif
+}
+
+void pcm16_to_float_neon(const int16_t* src, float* dst, int samples) {
+    int i = 0;
+    for (; i + 8 <= samples; i += 8) {
+        const int16x8_t x = vld1q_s16(src + i);
+        const float32x4_t lo = vcvtq_f32_s32(vmovl_s16(vget_low_s16(x)));
+        const float32x4_t hi = vcvtq_f32_s32(vmovl_s16(vget_high_s16(x)));
+        vst1q_f32(dst + i, vmulq_n_f32(lo, kPcm16Scale));
+        vst1q_f32(dst + i + 4, vmulq_n_f32(hi, kPcm16Scale));
+    }
+    tail().pcm16_to_float(src + i, dst + i, samples - i);
+}
+
+void float_to_pcm16_neon(const float* src, int16_t* dst, int samples) {
+    const float32x4_t lo_limit = vdupq_n_f32(-32768.0f);
+    const float32x4_t hi_limit = vdupq_n_f32(32767.0f);
+    int i = 0;
+    for (; i + 8 <= samples; i += 8) {
+        float32x4_t a = vmulq_n_f32(vld1q_f32(src + i), 32768.0f);
+        float32x4_t b = vmulq_n_f32(vld1q_f32(src + i + 4), 32768.0f);
+        a = vminq_f32(vmaxq_f32(a, lo_limit), hi_limit);
+        b = vminq_f32(vmaxq_f32(b, lo_limit), hi_limit);
+        const int16x8_t packed = vcombine_s16(vqmovn_s32(round_to_s32(a)), vqmovn_s32(round_to_s32(b)));
+        vst1q_s16(dst + i, packed);
+    }
+    tail().float_to_pcm16(src + i, dst + i, samples - i);
+}
+
+void gain_ramp_neon(float* buf, int frames, int channels, float start_gain, float end_gain) {
+    if (channels != 1 && channels != 2) {
+        tail().gain_ramp(buf, frames, channels, start_gain, end_gain);
+        return;
+    }
+    const float step = (end_gain - start_gain) / static_cast<float>(frames);
+    const int frames_per_vec = 4 / channels;
+    static const float kMonoOffset[4] = {0.0f, 1.0f, 2.0f, 3.0f};
+    static const float kStereoOffset[4] = {0.0f, 0.0f, 1.0f, 1.0f};
+    const float32x4_t lane_step = vmulq_n_f32(vld1q_f32(channels == 1 ? kMonoOffset : kStereoOffset), step);
+    int frame = 0;
+    for (; frame + frames_per_vec <= frames; frame += frames_per_vec) {
+        const float32x4_t base = vdupq_n_f32(start_gain + step * static_cast<float>(frame));
+        float* p = buf + frame * channels;
+        vst1q_f32(p, vmulq_f32(vld1q_f32(p), vaddq_f32(base, lane_step)));
+    }
+    if (frame < frames) {
+        tail().gain_ramp(buf + frame * channels, frames - frame, channels,
+                         start_gain + step * static_cast<float>(frame), end_gain);
+    }
+}
+
+void sum_sq_max_abs_neon(const float* buf, int n, float* sum_sq, float* max_abs) {
+    float32x4_t s = vdupq_n_f32(0.0f);
+    float32x4_t m = vdupq_n_f32(0.0f);
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        const float32x4_t v = vld1q_f32(buf + i);
+        s = vmlaq_f32(s, v, v);
+        m = vmaxq_f32(m, vabsq_f32(v));
+    }
+    *sum_sq += hsum(s);
+    *max_abs = std::max(*max_abs, hmax(m));
+    tail().sum_sq_max_abs(buf + i, n - i, sum_sq, max_abs);
+}
+
+void overlap_add_neon(float* dst, const float* src, const float* window, int n) {
+    int i = 0;
+    if (window) {
+        for (; i + 4 <= n; i += 4) {
+            vst1q_f32(dst + i, vmlaq_f32(vld1q_f32(dst + i), vld1q_f32(src + i), vld1q_f32(window + i)));
+        }
+    } else {
+        for (; i + 4 <= n; i += 4) {
+            vst1q_f32(dst + i, vaddq_f32(vld1q_f32(dst + i), vld1q_f32(src + i)));
+        }
+    }
+    tail().overlap_add(dst + i, src + i, window ? window + i : nullptr, n - i);
+}
+
+}  // namespace
+
+const Kernels& neon_kernels() {
+    static const Kernels k{
+        "neon",
+        pcm16_to_float_neon,
+        float_to_pcm16_neon,
+        gain_ramp_neon,
+        sum_sq_max_abs_neon,
+        overlap_add_neon,
+    };
+    return k;
+}
+
+}  // namespace neko::dsp
@@ -0,0 +1,70 @@
+// 标量参考实现，同时作为各 SIMD 版本的尾部处理
+
+#include "dsp/neko_dsp.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace neko::dsp {
+
+namespace {
+
+constexpr float kPcm16Scale = 1.0f / 32768.0f;
+
+void pcm16_to_float_scalar(const int16_t* src, float* dst, int samples) {
+    for (int i = 0; i < samples; ++i) {
+        dst[i] = static_cast<float>(src[i]) * kPcm16Scale;
+    }
+}
+
+void float_to_pcm16_scalar(const float* src, int16_t* dst, int samples) {
+    for (int i = 0; i < samples; ++i) {
+        const float v = std::clamp(src[i] * 32768.0f, -32768.0f, 32767.0f);
+        dst[i] = static_cast<int16_t>(std::lrintf(v));
+    }
+}
+
+void gain_ramp_scalar(float* buf, int frames, int channels, float start_gain, float end_gain) {
+    const float step = (end_gain - start_gain) / static_cast<float>(frames);
+    for (int i = 0; i < frames; ++i) {
+        const float g = start_gain + step * static_cast<float>(i);
+        float* frame = buf + static_cast<int64_t>(i) * channels;
+        for (int c = 0; c < channels; ++c) frame[c] *= g;
+    }
+}
+
+void sum_sq_max_abs_scalar(const float* buf, int n, float* sum_sq, float* max_abs) {
+    float s = 0.0f;
+    float m = 0.0f;
+    for (int i = 0; i < n; ++i) {
+        const float v = buf[i];
+        s += v * v;
+        m = std::max(m, std::fabs(v));
+    }
+    *sum_sq += s;
+    *max_abs = std::max(*max_abs, m);
+}
+
+void overlap_add_scalar(float* dst, const float* src, const float* window, int n) {
+    if (window) {
+        for (int i = 0; i < n; ++i) dst[i] += src[i] * window[i];
+    } else {
+        for (int i = 0; i < n; ++i) dst[i] += src[i];
+    }
+}
+
+}  // namespace
+
+const Kernels& scalar_kernels() {
+    static const Kernels k{
+        "scalar",
+        pcm16_to_float_scalar,
+        float_to_pcm16_scalar,
+        gain_ramp_scalar,
+        sum_sq_max_abs_scalar,
+        overlap_add_scalar,
+    };
+    return k;
+}
+
+}  // namespace neko::dsp
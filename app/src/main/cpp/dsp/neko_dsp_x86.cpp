@@ -0,0 +1,237 @@
+// x86 / x86_64 实现：SSE2 为基线，AVX2+FMA 通过 target 属性编译、运行时按 CPU 选择
+// （Android x86_64 模拟器与主机端基准测试走这里）
+
+#include "dsp/neko_dsp.h"
+
+#include <immintrin.h>
+
+#include <algorithm>
+
+namespace neko::dsp {
+
+namespace {
+
+constexpr float kPcm16Scale = 1.0f / 32768.0f;
+
+const Kernels& tail() { return scalar_kernels(); }
+
+// ========== SSE2 ==========
+
+void pcm16_to_float_sse2(const int16_t* src, float* dst, int samples) {
+    const __m128 scale = _mm_set1_ps(kPcm16Scale);
+    int i = 0;
+    for (; i + 8 <= samples; i += 8) {
+        const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        const __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(x, x), 16);
+        const __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(x, x), 16);
+        _mm_storeu_ps(dst + i, _mm_mul_ps(_mm_cvtepi32_ps(lo), scale));
+        _mm_storeu_ps(dst + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(hi), scale));
+    }
+    tail().pcm16_to_float(src + i, dst + i, samples - i);
+}
+
+void float_to_pcm16_sse2(const float* src, int16_t* dst, int samples) {
+    const __m128 scale = _mm_set1_ps(32768.0f);
+    const __m128 lo_limit = _mm_set1_ps(-32768.0f);
+    const __m128 hi_limit = _mm_set1_ps(32767.0f);
+    int i = 0;
+    for (; i + 8 <= samples; i += 8) {
+        // 先在浮点域截断，避免 cvtps 溢出时得到 0x80000000
+        __m128 a = _mm_mul_ps(_mm_loadu_ps(src + i), scale);
+        __m128 b = _mm_mul_ps(_mm_loadu_ps(src + i + 4), scale);
+        a = _mm_min_ps(_mm_max_ps(a, lo_limit), hi_limit);
+        b = _mm_min_ps(_mm_max_ps(b, lo_limit), hi_limit);
+        const __m128i packed = _mm_packs_epi32(_mm_cvtps_epi32(a), _mm_cvtps_epi32(b));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), packed);
+    }
+    tail().float_to_pcm16(src + i, dst + i, samples - i);
+}
+
+void gain_ramp_sse2(float* buf, int frames, int channels, float start_gain, float end_gain) {
+    // 仅对单声道/立体声做向量化：一个向量恰好容纳整数个帧
+    if (channels != 1 && channels != 2) {
+        tail().gain_ramp(buf, frames, channels, start_gain, end_gain);
+        return;
+    }
+    const float step = (end_gain - start_gain) / static_cast<float>(frames);
+    const int frames_per_vec = 4 / channels;
+    const __m128 lane_offset = channels == 1
+        ? _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f)
+        : _mm_setr_ps(0.0f, 0.0f, 1.0f, 1.0f);
+    const __m128 step_v = _mm_set1_ps(step);
+    int frame = 0;
+    for (; frame + frames_per_vec <= frames; frame += frames_per_vec) {
+        // 每次按帧序号重新计算基准增益，避免长缓冲下累加误差
+        const __m128 base = _mm_set1_ps(start_gain + step * static_cast<float>(frame));
+        const __m128 g = _mm_add_ps(base, _mm_mul_ps(lane_offset, step_v));
+        float* p = buf + frame * channels;
+        _mm_storeu_ps(p, _mm_mul_ps(_mm_loadu_ps(p), g));
+    }
+    if (frame < frames) {
+        tail().gain_ramp(buf + frame * channels, frames - frame, channels,
+                         start_gain + step * static_cast<float>(frame), end_gain);
+    }
+}
+
+inline float hsum_sse(__m128 v) {
+    __m128 shuf = _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1));
+    __m128 sums = _mm_add_ps(v, shuf);
+    shuf = _mm_movehl_ps(shuf, sums);
+    return _mm_cvtss_f32(_mm_add_ss(sums, shuf));
+}
+
+inline float hmax_sse(__m128 v) {
+    __m128 shuf = _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1));
+    __m128 m = _mm_max_ps(v, shuf);
+    shuf = _mm_movehl_ps(shuf, m);
+    return _mm_cvtss_f32(_mm_max_ss(m, shuf));
+}
+
+void sum_sq_max_abs_sse2(const float* buf, int n, float* sum_sq, float* max_abs) {
+    const __m128 abs_mask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+    __m128 s = _mm_setzero_ps();
+    __m128 m = _mm_setzero_ps();
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        const __m128 v = _mm_loadu_ps(buf + i);
+        s = _mm_add_ps(s, _mm_mul_ps(v, v));
+        m = _mm_max_ps(m, _mm_and_ps(v, abs_mask));
+    }
+    *sum_sq += hsum_sse(s);
+    *max_abs = std::max(*max_abs, hmax_sse(m));
+    tail().sum_sq_max_abs(buf + i, n - i, sum_sq, max_abs);
+}
+
+void overlap_add_sse2(float* dst, const float* src, const float* window, int n) {
+    int i = 0;
+    if (window) {
+        for (; i + 4 <= n; i += 4) {
+            const __m128 v = _mm_mul_ps(_mm_loadu_ps(src + i), _mm_loadu_ps(window + i));
+            _mm_storeu_ps(dst + i, _mm_add_ps(_mm_loadu_ps(dst + i), v));
+        }
+    } else {
+        for (; i + 4 <= n; i += 4) {
+            _mm_storeu_ps(dst + i, _mm_add_ps(_mm_loadu_ps(dst + i), _mm_loadu_ps(src + i)));
+        }
+    }
+    tail().overlap_add(dst + i, src + i, window ? window + i : nullptr, n - i);
+}
+
+// ========== AVX2 + FMA ==========
+
+#define NEKO_AVX2 __attribute__((target("avx2,fma")))
+
+NEKO_AVX2 void pcm16_to_float_avx2(const int16_t* src, float* dst, int samples) {
+    const __m256 scale = _mm256_set1_ps(kPcm16Scale);
+    int i = 0;
+    for (; i + 8 <= samples; i += 8) {
+        const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        const __m256i wide = _mm256_cvtepi16_epi32(x);
+        _mm256_storeu_ps(dst + i, _mm256_mul_ps(_mm256_cvtepi32_ps(wide), scale));
+    }
+    tail().pcm16_to_float(src + i, dst + i, samples - i);
+}
+
+NEKO_AVX2 void float_to_pcm16_avx2(const float* src, int16_t* dst, int samples) {
+    const __m256 scale = _mm256_set1_ps(32768.0f);
+    const __m256 lo_limit = _mm256_set1_ps(-32768.0f);
+    const __m256 hi_limit = _mm256_set1_ps(32767.0f);
+    int i = 0;
+    for (; i + 16 <= samples; i += 16) {
+        __m256 a = _mm256_mul_ps(_mm256_loadu_ps(src + i), scale);
+        __m256 b = _mm256_mul_ps(_mm256_loadu_ps(src + i + 8), scale);
+        a = _mm256_min_ps(_mm256_max_ps(a, lo_limit), hi_limit);
+        b = _mm256_min_ps(_mm256_max_ps(b, lo_limit), hi_limit);
+        // packs 按 128 位通道交织，需要再按 64 位重排回顺序
+        const __m256i packed = _mm256_packs_epi32(_mm256_cvtps_epi32(a), _mm256_cvtps_epi32(b));
+        const __m256i ordered = _mm256_permute4x64_epi64(packed, _MM_SHUFFLE(3, 1, 2, 0));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), ordered);
+    }
+    float_to_pcm16_sse2(src + i, dst + i, samples - i);
+}
+
+NEKO_AVX2 void gain_ramp_avx2(float* buf, int frames, int channels, float start_gain, float end_gain) {
+    if (channels != 1 && channels != 2) {
+        tail().gain_ramp(buf, frames, channels, start_gain, end_gain);
+        return;
+    }
+    const float step = (end_gain - start_gain) / static_cast<float>(frames);
+    const int frames_per_vec = 8 / channels;
+    const __m256 lane_offset = channels == 1
+        ? _mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f)
+        : _mm256_setr_ps(0.0f, 0.0f, 1.0f, 1.0f, 2.0f, 2.0f, 3.0f, 3.0f);
+    const __m256 step_v = _mm256_set1_ps(step);
+    int frame = 0;
+    for (; frame + frames_per_vec <= frames; frame += frames_per_vec) {
+        const __m256 base = _mm256_set1_ps(start_gain + step * static_cast<float>(frame));
+        const __m256 g = _mm256_fmadd_ps(lane_offset, step_v, base);
+        float* p = buf + frame * channels;
+        _mm256_storeu_ps(p, _mm256_mul_ps(_mm256_loadu_ps(p), g));
+    }
+    if (frame < frames) {
+        tail().gain_ramp(buf + frame * channels, frames - frame, channels,
+                         start_gain + step * static_cast<float>(frame), end_gain);
+    }
+}
+
+NEKO_AVX2 void sum_sq_max_abs_avx2(const float* buf, int n, float* sum_sq, float* max_abs) {
+    const __m256 abs_mask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+    __m256 s = _mm256_setzero_ps();
+    __m256 m = _mm256_setzero_ps();
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const __m256 v = _mm256_loadu_ps(buf + i);
+        s = _mm256_fmadd_ps(v, v, s);
+        m = _mm256_max_ps(m, _mm256_and_ps(v, abs_mask));
+    }
+    const __m128 s4 = _mm_add_ps(_mm256_castps256_ps128(s), _mm256_extractf128_ps(s, 1));
+    const __m128 m4 = _mm_max_ps(_mm256_castps256_ps128(m), _mm256_extractf128_ps(m, 1));
+    *sum_sq += hsum_sse(s4);
+    *max_abs = std::max(*max_abs, hmax_sse(m4));
+    tail().sum_sq_max_abs(buf + i, n - i, sum_sq, max_abs);
+}
+
+NEKO_AVX2 void overlap_add_avx2(float* dst, const float* src, const float* window, int n) {
+    int i = 0;
+    if (window) {
+        for (; i + 8 <= n; i += 8) {
+            const __m256 d = _mm256_loadu_ps(dst + i);
+            _mm256_storeu_ps(dst + i, _mm256_fmadd_ps(_mm256_loadu_ps(src + i), _mm256_loadu_ps(window + i), d));
+        }
+    } else {
+        for (; i + 8 <= n; i += 8) {
+            _mm256_storeu_ps(dst + i, _mm256_add_ps(_mm256_loadu_ps(dst + i), _mm256_loadu_ps(src + i)));
+        }
+    }
+    tail().overlap_add(dst + i, src + i, window ? window + i : nullptr, n - i);
+}
+
+#undef NEKO_AVX2
+
+}  // namespace
+
+const Kernels& sse2_kernels() {
+    static const Kernels k{
+        "sse2",
+        pcm16_to_float_sse2,
+        float_to_pcm16_sse2,
+        gain_ramp_sse2,
+        sum_sq_max_abs_sse2,
+        overlap_add_sse2,
+    };
+    return k;
+}
+
+const Kernels& avx2_kernels() {
+    static const Kernels k{
+        "avx2",
+        pcm16_to_float_avx2,
+        float_to_pcm16_avx2,
+        gain_ramp_avx2,
+        sum_sq_max_abs_avx2,
+        overlap_add_avx2,
+    };
+    return k;
+}
+
+}  // namespace neko::dsp
@@ -0,0 +1,258 @@
+// 主机端 DSP 单元测试：各 SIMD 内核与标量参考实现逐项比较，并覆盖 Biquad / Compressor 的声道步长和压缩器开关
+//
+// 不依赖测试框架：失败时打印原因，进程以非 0 退出（由 ctest 判定）。
+// 当前 CPU 不支持的指令集（例如没有 AVX2 的机器）自动跳过。
+
+#include "dsp/neko_dsp.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace {
+
+using neko::dsp::Kernels;
+
+int g_failures = 0;
+
+#define EXPECT(cond, ...)                                        \
+    do {                                                         \
+        if (!(cond)) {                                           \
+            std::fprintf(stderr, "FAIL %s:%d: ", __FILE__, __LINE__); \
+            std::fprintf(stderr, __VA_ARGS__);                   \
+            std::fprintf(stderr, "\n");                          \
+            ++g_failures;                                        \
+        }                                                        \
+    } while (0)
+
+// 覆盖向量主循环和各种尾部长度
+const int kLengths[] = {0, 1, 3, 4, 7, 8, 15, 16, 17, 31, 33, 1024, 1027};
+
+std::vector<float> random_floats(int n, float range, uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> dist(-range, range);
+    std::vector<float> v(n);
+    for (auto& x : v) x = dist(rng);
+    return v;
+}
+
+std::vector<const Kernels*> simd_kernels() {
+    std::vector<const Kernels*> result;
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+    result.push_back(&neko::dsp::neon_kernels());
+#endif
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_cpu_init();
+    result.push_back(&neko::dsp::sse2_kernels());
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        result.push_back(&neko::dsp::avx2_kernels());
+    } else {
+        std::printf("skip avx2: not supported by this CPU\n");
+    }
+#endif
+    return result;
+}
+
+void test_pcm16_to_float(const Kernels& ref, const Kernels& k) {
+    std::mt19937 rng(1);
+    for (int n : kLengths) {
+        std::vector<int16_t> src(n);
+        for (auto& x : src) x = static_cast<int16_t>(rng());
+        if (n > 1) {
+            src[0] = -32768;
+            src[1] = 32767;
+        }
+        std::vector<float> expected(n), actual(n);
+        ref.pcm16_to_float(src.data(), expected.data(), n);
+        k.pcm16_to_float(src.data(), actual.data(), n);
+        for (int i = 0; i < n; ++i) {
+            EXPECT(expected[i] == actual[i], "%s pcm16_to_float n=%d i=%d: %g != %g",
+                   k.name, n, i, expected[i], actual[i]);
+        }
+    }
+}
+
+void test_float_to_pcm16(const Kernels& ref, const Kernels& k) {
+    for (int n : kLengths) {
+        // 超出 [-1, 1) 的值检查饱和截断
+        std::vector<float> src = random_floats(n, 1.5f, 2);
+        std::vector<int16_t> expected(n), actual(n);
+        ref.float_to_pcm16(src.data(), expected.data(), n);
+        k.float_to_pcm16(src.data(), actual.data(), n);
+        for (int i = 0; i < n; ++i) {
+            EXPECT(expected[i] == actual[i], "%s float_to_pcm16 n=%d i=%d in=%g: %d != %d",
+                   k.name, n, i, src[i], expected[i], actual[i]);
+        }
+    }
+}
+
+void test_gain_ramp(const Kernels& ref, const Kernels& k) {
+    for (int channels = 1; channels <= 3; ++channels) {
+        for (int frames : kLengths) {
+            if (frames == 0) continue;
+            const std::vector<float> src = random_floats(frames * channels, 1.0f, 3);
+            std::vector<float> expected = src, actual = src;
+            ref.gain_ramp(expected.data(), frames, channels, 0.25f, 1.75f);
+            k.gain_ramp(actual.data(), frames, channels, 0.25f, 1.75f);
+            for (size_t i = 0; i < src.size(); ++i) {
+                EXPECT(std::fabs(expected[i] - actual[i]) <= 1e-6f,
+                       "%s gain_ramp ch=%d frames=%d i=%zu: %g != %g",
+                       k.name, channels, frames, i, expected[i], actual[i]);
+            }
+        }
+    }
+}
+
+void test_sum_sq_max_abs(const Kernels& ref, const Kernels& k) {
+    for (int n : kLengths) {
+        const std::vector<float> src = random_floats(n, 1.0f, 4);
+        float ref_sum = 0.0f, ref_max = 0.0f, sum = 0.0f, max = 0.0f;
+        ref.sum_sq_max_abs(src.data(), n, &ref_sum, &ref_max);
+        k.sum_sq_max_abs(src.data(), n, &sum, &max);
+        // 向量版按通道分组累加，求和顺序不同，只要求相对误差很小
+        EXPECT(std::fabs(ref_sum - sum) <= 1e-5f * std::max(1.0f, ref_sum),
+               "%s sum_sq n=%d: %g != %g", k.name, n, ref_sum, sum);
+        EXPECT(ref_max == max, "%s max_abs n=%d: %g != %g", k.name, n, ref_max, max);
+    }
+}
+
+void test_overlap_add(const Kernels& ref, const Kernels& k) {
+    for (int n : kLengths) {
+        const std::vector<float> src = random_floats(n, 1.0f, 5);
+        const std::vector<float> window = random_floats(n, 1.0f, 6);
+        const std::vector<float> dst = random_floats(n, 1.0f, 7);
+        for (const float* w : {static_cast<const float*>(nullptr), window.data()}) {
+            std::vector<float> expected = dst, actual = dst;
+            ref.overlap_add(expected.data(), src.data(), w, n);
+            k.overlap_add(actual.data(), src.data(), w, n);
+            for (int i = 0; i < n; ++i) {
+                // AVX2 版本用 FMA，只少一次舍入
+                EXPECT(std::fabs(expected[i] - actual[i]) <= 1e-6f,
+                       "%s overlap_add n=%d window=%d i=%d: %g != %g",
+                       k.name, n, w != nullptr, i, expected[i], actual[i]);
+            }
+        }
+    }
+}
+
+// 超过 kMaxChannels 的交错缓冲：前 8 个声道与单声道滤波结果相同，其余声道原样通过
+void test_biquad_many_channels() {
+    constexpr int kChannels = 10;
+    constexpr int kFrames = 257;
+    const std::vector<float> src = random_floats(kFrames * kChannels, 1.0f, 8);
+
+    neko::dsp::Biquad multi;
+    multi.set_coefficients(0.2f, 0.4f, 0.2f, -0.5f, 0.3f);
+    std::vector<float> buf = src;
+    multi.process(buf.data(), kFrames, kChannels);
+
+    for (int c = 0; c < kChannels; ++c) {
+        std::vector<float> mono(kFrames);
+        for (int i = 0; i < kFrames; ++i) mono[i] = src[i * kChannels + c];
+        if (c < neko::dsp::Biquad::kMaxChannels) {
+            neko::dsp::Biquad single;
+            single.set_coefficients(0.2f, 0.4f, 0.2f, -0.5f, 0.3f);
+            single.process(mono.data(), kFrames, 1);
+        }
+        for (int i = 0; i < kFrames; ++i) {
+            EXPECT(buf[i * kChannels + c] == mono[i], "biquad 10ch c=%d i=%d: %g != %g",
+                   c, i, buf[i * kChannels + c], mono[i]);
+        }
+    }
+}
+
+// 压缩器所有声道共用增益：各声道输入相同时，任意声道数的输出都应与单声道一致
+void test_compressor_many_channels() {
+    constexpr int kSampleRate = 16000;
+    constexpr int kFrames = 4000;
+    std::vector<float> mono(kFrames);
+    for (int i = 0; i < kFrames; ++i) {
+        // 前半段小声、后半段大声，让增益发生变化
+        const float level = i < kFrames / 2 ? 0.02f : 0.9f;
+        mono[i] = level * std::sin(2.0f * 3.14159265f * 220.0f * static_cast<float>(i) / kSampleRate);
+    }
+
+    neko::dsp::Compressor reference;
+    reference.configure(kSampleRate, 1, 5.0f);
+    std::vector<float> expected = mono;
+    reference.process(expected.data(), kFrames);
+
+    for (int channels : {2, 9, 12}) {
+        neko::dsp::Compressor compressor;
+        compressor.configure(kSampleRate, channels, 5.0f);
+        std::vector<float> buf(static_cast<size_t>(kFrames) * channels);
+        for (int i = 0; i < kFrames; ++i) {
+            for (int c = 0; c < channels; ++c) buf[i * channels + c] = mono[i];
+        }
+        compressor.process(buf.data(), kFrames);
+        for (int i = 0; i < kFrames; ++i) {
+            for (int c = 0; c < channels; ++c) {
+                EXPECT(buf[i * channels + c] == expected[i], "compressor %dch c=%d i=%d: %g != %g",
+                       channels, c, i, buf[i * channels + c], expected[i]);
+                if (buf[i * channels + c] != expected[i]) return;
+            }
+        }
+    }
+}
+
+// 旁路时仍经过延迟线：输出是输入原样延迟 latency_frames；中途开关不插入静音、不丢采样
+void test_compressor_bypass_keeps_delay() {
+    constexpr int kSampleRate = 16000;
+    constexpr int kFrames = 8000;
+    std::vector<float> src(kFrames);
+    for (int i = 0; i < kFrames; ++i) {
+        src[i] = 0.2f * std::sin(2.0f * 3.14159265f * 220.0f * static_cast<float>(i) / kSampleRate) + 0.5f;
+    }
+
+    neko::dsp::Compressor bypassed;
+    bypassed.configure(kSampleRate, 1, 5.0f);
+    bypassed.set_enabled(false);
+    bypassed.reset();
+    const int latency = bypassed.latency_frames();
+    EXPECT(latency >= kSampleRate * 5 / 1000, "latency %d frames shorter than lookahead", latency);
+    std::vector<float> buf = src;
+    bypassed.process(buf.data(), kFrames);
+    for (int i = latency; i < kFrames; ++i) {
+        EXPECT(buf[i] == src[i - latency], "bypass i=%d: %g != %g", i, buf[i], src[i - latency]);
+        if (buf[i] != src[i - latency]) break;
+    }
+
+    // 每 1000 帧切换一次开关：输入恒为正，延迟之后的输出不应出现 0（没有插入静音）
+    neko::dsp::Compressor toggled;
+    toggled.configure(kSampleRate, 1, 5.0f);
+    buf = src;
+    for (int block = 0; block < kFrames / 1000; ++block) {
+        toggled.set_enabled(block % 2 == 0);
+        toggled.process(buf.data() + block * 1000, 1000);
+    }
+    for (int i = latency; i < kFrames; ++i) {
+        EXPECT(buf[i] > 0.0f, "toggle i=%d: %g", i, buf[i]);
+        if (buf[i] <= 0.0f) break;
+    }
+}
+
+}  // namespace
+
+int main() {
+    const Kernels& ref = neko::dsp::scalar_kernels();
+    for (const Kernels* k : simd_kernels()) {
+        std::printf("checking %s against scalar\n", k->name);
+        test_pcm16_to_float(ref, *k);
+        test_float_to_pcm16(ref, *k);
+        test_gain_ramp(ref, *k);
+        test_sum_sq_max_abs(ref, *k);
+        test_overlap_add(ref, *k);
+    }
+    test_biquad_many_channels();
+    test_compressor_many_channels();
+    test_compressor_bypass_keeps_delay();
+
+    if (g_failures > 0) {
+        std::fprintf(stderr, "%d check(s) failed\n", g_failures);
+        return 1;
+    }
+    std::printf("all checks passed (dispatch: %s)\n", neko::dsp::kernel_name());
+    return 0;
+}
@@ -0,0 +1,98 @@
+// JNI 绑定：com.hx.nekomimi.transcribe.WhisperEngine
+//
+// 纯 CPU 推理。识别结果保存在 whisper_context 中，通过 segment* 系列函数按索引读取，
+// 因此同一个 handle 不能被多个线程同时使用（由 Kotlin 侧的单线程队列保证）。
+
+#include <jni.h>
+#include <android/log.h>
+
+#include <string>
+
+#include "whisper.h"
+
+#define LOG_TAG "NekoWhisper"
+#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
+#define LOGW(...) __android_log_print(ANDROID_LOG_WARN, LOG_TAG, __VA_ARGS__)
+
+namespace {
+
+whisper_context* ctx(jlong handle) {
+    return reinterpret_cast<whisper_context*>(handle);
+}
+
+// whisper 的时间单位是 10ms
+jlong to_ms(int64_t t) { return static_cast<jlong>(t) * 10; }
+
+}  // namespace
+
+extern "C" {
+
+JNIEXPORT jlong JNICALL
+Java_com_hx_nekomimi_transcribe_WhisperEngine_nativeInit(JNIEnv* env, jobject, jstring model_path) {
+    const char* path = env->GetStringUTFChars(model_path, nullptr);
+    whisper_context_params params = whisper_context_default_params();
+    params.use_gpu = false;
+    whisper_context* c = whisper_init_from_file_with_params(path, params);
+    if (c == nullptr) LOGW("模型加载失败: %s", path);
+    env->ReleaseStringUTFChars(model_path, path);
+    return reinterpret_cast<jlong>(c);
+}
+
+JNIEXPORT jint JNICALL
+Java_com_hx_nekomimi_transcribe_WhisperEngine_nativeTranscribe(
+        JNIEnv* env, jobject, jlong handle, jfloatArray samples, jint count,
+        jint threads, jstring language) {
+    if (handle == 0) return -1;
+
+    whisper_full_params params = whisper_full_default_params(WHISPER_SAMPLING_GREEDY);
+    params.n_threads = threads;
+    params.translate = false;
+    params.no_context = true;      // 每个分块独立识别，便于断点续传
+    params.print_progress = false;
+    params.print_realtime = false;
+    params.print_special = false;
+    params.print_timestamps = false;
+    params.suppress_blank = true;
+
+    const char* lang = language ? env->GetStringUTFChars(language, nullptr) : nullptr;
+    params.language = lang ? lang : "auto";
+
+    jfloat* pcm = env->GetFloatArrayElements(samples, nullptr);
+    const int rc = whisper_full(ctx(handle), params, pcm, count);
+    env->ReleaseFloatArrayElements(samples, pcm, JNI_ABORT);
+    if (lang) env->ReleaseStringUTFChars(language, lang);
+
+    if (rc != 0) {
+        LOGW("whisper_full 失败: %d", rc);
+        return -1;
+    }
+    return whisper_full_n_segments(ctx(handle));
+}
+
+JNIEXPORT jlong JNICALL
+Java_com_hx_nekomimi_transcribe_WhisperEngine_nativeSegmentStartMs(JNIEnv*, jobject, jlong handle, jint index) {
+    return to_ms(whisper_full_get_segment_t0(ctx(handle), index));
+}
+
+JNIEXPORT jlong JNICALL
+Java_com_hx_nekomimi_transcribe_WhisperEngine_nativeSegmentEndMs(JNIEnv*, jobject, jlong handle, jint index) {
+    return to_ms(whisper_full_get_segment_t1(ctx(handle), index));
+}
+
+JNIEXPORT jstring JNICALL
+Java_com_hx_nekomimi_transcribe_WhisperEngine_nativeSegmentText(JNIEnv* env, jobject, jlong handle, jint index) {
+    const char* text = whisper_full_get_segment_text(ctx(handle), index);
+    return env->NewStringUTF(text ? text : "");
+}
+
+JNIEXPORT jstring JNICALL
+Java_com_hx_nekomimi_transcribe_WhisperEngine_nativeSystemInfo(JNIEnv* env, jobject) {
+    return env->NewStringUTF(whisper_print_system_info());
+}
+
+JNIEXPORT void JNICALL
+Java_com_hx_nekomimi_transcribe_WhisperEngine_nativeRelease(JNIEnv*, jobject, jlong handle) {
+    if (handle) whisper_free(ctx(handle));
+}
+
+}  // extern "C"
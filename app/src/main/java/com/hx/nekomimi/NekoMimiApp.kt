@@ -3,28 +3,101 @@ package com.hx.nekomimi
 import android.app.Application
 import android.app.NotificationChannel
 import android.app.NotificationManager
+import android.content.ComponentCallbacks2
+import android.content.pm.ApplicationInfo
 import android.os.Build
+import android.os.StrictMode
+import androidx.annotation.VisibleForTesting
 import androidx.appcompat.app.AppCompatDelegate
+import com.hx.nekomimi.cache.CacheRegistry
+import com.hx.nekomimi.cache.CoverImageCache
 import com.hx.nekomimi.data.AppDatabase
+import com.hx.nekomimi.service.PlaybackProcess
+import com.hx.nekomimi.settings.AppSettings
+import com.hx.nekomimi.subtitle.SubtitleLoader
+import com.hx.nekomimi.transcribe.TranscriptionQueue
 
 class NekoMimiApp : Application() {
 
     val database: AppDatabase by lazy { AppDatabase.getInstance(this) }
 
+    /** 调试包（StrictMode、缓存调试页） */
+    val isDebuggable: Boolean get() = applicationInfo.flags and ApplicationInfo.FLAG_DEBUGGABLE != 0
+
     companion object {
         const val CHANNEL_ID_PLAYBACK = "playback_channel"
         lateinit var instance: NekoMimiApp
             private set
+
+        /**
+         * StrictMode 违规的额外回调（API 28+，参数为 android.os.strictmode.Violation）。
+         * 插桩测试在 Application.onCreate 之前设置，违规即判定测试失败（见 androidTest 的 StrictModeTestRunner）
+         */
+        @VisibleForTesting
+        @Volatile
+        var strictModeListener: ((Throwable) -> Unit)? = null
     }
 
     override fun onCreate() {
         super.onCreate()
         instance = this
 
+        if (isDebuggable) enableStrictMode()
+
         // 强制暗色模式，确保通知栏/锁屏栏使用暗色主题
         AppCompatDelegate.setDefaultNightMode(AppCompatDelegate.MODE_NIGHT_YES)
 
         createNotificationChannel()
+
+        // 内存缓存按优先级登记，内存紧张时由 onTrimMemory 统一裁剪。
+        // 字幕缓存两个进程都会用到（播放进程向媒体会话发布字幕），必须在下面提前返回之前登记
+        CacheRegistry.register(SubtitleLoader.memoryCache)
+
+        // 独立播放进程只运行播放服务，不启动转写等界面侧任务
+        if (PlaybackProcess.isPlaybackProcess()) return
+
+        // 后台加载设置，界面只读内存快照
+        AppSettings.init(this)
+
+        // 封面只在界面进程显示
+        CacheRegistry.register(CoverImageCache.install(this))
+
+        // 恢复上次未完成的离线字幕转写任务
+        TranscriptionQueue.start(this)
+    }
+
+    override fun onTrimMemory(level: Int) {
+        super.onTrimMemory(level)
+        CacheRegistry.onTrimMemory(level)
+    }
+
+    override fun onLowMemory() {
+        super.onLowMemory()
+        CacheRegistry.onTrimMemory(ComponentCallbacks2.TRIM_MEMORY_COMPLETE)
+    }
+
+    /**
+     * 调试包中检测主线程磁盘读写和网络访问，违规记录到 logcat（tag: StrictMode），
+     * 设置了 [strictModeListener] 时同时交给它
+     */
+    private fun enableStrictMode() {
+        val threadPolicy = StrictMode.ThreadPolicy.Builder()
+            .detectDiskReads()
+            .detectDiskWrites()
+            .detectNetwork()
+            .penaltyLog()
+        val vmPolicy = StrictMode.VmPolicy.Builder()
+            .detectLeakedClosableObjects()
+            .detectLeakedSqlLiteObjects()
+            .penaltyLog()
+        val listener = strictModeListener
+        if (listener != null && Build.VERSION.SDK_INT >= Build.VERSION_CODES.P) {
+            // 在违规线程上直接回调
+            threadPolicy.penaltyListener(Runnable::run) { listener(it) }
+            vmPolicy.penaltyListener(Runnable::run) { listener(it) }
+        }
+        StrictMode.setThreadPolicy(threadPolicy.build())
+        StrictMode.setVmPolicy(vmPolicy.build())
     }
 
     private fun createNotificationChannel() {
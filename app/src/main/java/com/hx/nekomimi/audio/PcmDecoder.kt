@@ -0,0 +1,232 @@
+package com.hx.nekomimi.audio
+
+import android.content.Context
+import android.media.AudioFormat
+import android.media.MediaCodec
+import android.media.MediaExtractor
+import android.media.MediaFormat
+import android.net.Uri
+import com.hx.nekomimi.remote.RemoteHttp
+import java.nio.ByteOrder
+import kotlin.math.exp
+import kotlin.math.min
+
+/**
+ * 流式 PCM 解码器（MediaExtractor + MediaCodec）
+ *
+ * 按块输出单声道 float 采样，内存占用与音频长度无关，供离线分析使用（波形、对齐、转写）。
+ * 不会经过播放器，也不应在主线程调用。
+ */
+class PcmDecoder(private val context: Context, private val uri: Uri) {
+
+    /**
+     * 解码块回调
+     * @param samples 单声道 float 采样（数组会被复用，回调返回后内容失效）
+     * @param count 有效采样数
+     * @param startMs 本块第一个采样对应的时间
+     * @return false 表示停止解码
+     */
+    fun interface BlockListener {
+        fun onBlock(samples: FloatArray, count: Int, startMs: Long): Boolean
+    }
+
+    /**
+     * @param sampleRate 输出采样率
+     * @param durationMs 音轨时长（来自容器，可能为 0）
+     */
+    data class StreamInfo(val sampleRate: Int, val durationMs: Long)
+
+    /**
+     * 解码 [startMs, endMs) 区间
+     * @param targetSampleRate 输出采样率，0 表示保持原始采样率
+     * @param onInfo 解码开始前回调一次音轨信息
+     */
+    fun decode(
+        startMs: Long = 0L,
+        endMs: Long = Long.MAX_VALUE,
+        targetSampleRate: Int = 0,
+        onInfo: ((StreamInfo) -> Unit)? = null,
+        listener: BlockListener
+    ) {
+        val extractor = MediaExtractor()
+        var codec: MediaCodec? = null
+        try {
+            extractor.setDataSource(context, uri, RemoteHttp.headersFor(context, uri))
+            val trackIndex = (0 until extractor.trackCount).firstOrNull { i ->
+                extractor.getTrackFormat(i).getString(MediaFormat.KEY_MIME)?.startsWith("audio/") == true
+            } ?: throw IllegalStateException("没有音频轨道: $uri")
+
+            extractor.selectTrack(trackIndex)
+            val format = extractor.getTrackFormat(trackIndex)
+            val mime = format.getString(MediaFormat.KEY_MIME)!!
+            val durationMs = if (format.containsKey(MediaFormat.KEY_DURATION)) {
+                format.getLong(MediaFormat.KEY_DURATION) / 1000
+            } else 0L
+
+            if (startMs > 0) {
+                extractor.seekTo(startMs * 1000, MediaExtractor.SEEK_TO_PREVIOUS_SYNC)
+            }
+
+            codec = MediaCodec.createDecoderByType(mime).apply {
+                configure(format, null, null, 0)
+                start()
+            }
+
+            var sourceRate = format.getInteger(MediaFormat.KEY_SAMPLE_RATE)
+            var channels = format.getInteger(MediaFormat.KEY_CHANNEL_COUNT)
+            var floatPcm = false
+            var resampler: MonoResampler? = null
+            var infoSent = false
+
+            val info = MediaCodec.BufferInfo()
+            var mono = FloatArray(0)
+            var inputDone = false
+            var stop = false
+
+            while (!stop) {
+                if (!inputDone) {
+                    val inIndex = codec.dequeueInputBuffer(TIMEOUT_US)
+                    if (inIndex >= 0) {
+                        val buffer = codec.getInputBuffer(inIndex)!!
+                        val size = extractor.readSampleData(buffer, 0)
+                        if (size < 0 || extractor.sampleTime / 1000 >= endMs) {
+                            codec.queueInputBuffer(inIndex, 0, 0, 0, MediaCodec.BUFFER_FLAG_END_OF_STREAM)
+                            inputDone = true
+                        } else {
+                            codec.queueInputBuffer(inIndex, 0, size, extractor.sampleTime, 0)
+                            extractor.advance()
+                        }
+                    }
+                }
+
+                val outIndex = codec.dequeueOutputBuffer(info, TIMEOUT_US)
+                when {
+                    outIndex == MediaCodec.INFO_OUTPUT_FORMAT_CHANGED -> {
+                        val out = codec.outputFormat
+                        sourceRate = out.getInteger(MediaFormat.KEY_SAMPLE_RATE)
+                        channels = out.getInteger(MediaFormat.KEY_CHANNEL_COUNT)
+                        floatPcm = out.containsKey(MediaFormat.KEY_PCM_ENCODING) &&
+                            out.getInteger(MediaFormat.KEY_PCM_ENCODING) == AudioFormat.ENCODING_PCM_FLOAT
+                        resampler = null
+                    }
+                    outIndex >= 0 -> {
+                        val eos = info.flags and MediaCodec.BUFFER_FLAG_END_OF_STREAM != 0
+                        if (info.size > 0) {
+                            if (!infoSent) {
+                                val outRate = if (targetSampleRate > 0) targetSampleRate else sourceRate
+                                onInfo?.invoke(StreamInfo(outRate, durationMs))
+                                infoSent = true
+                            }
+                            val buffer = codec.getOutputBuffer(outIndex)!!.order(ByteOrder.nativeOrder())
+                            buffer.position(info.offset)
+                            buffer.limit(info.offset + info.size)
+
+                            // 下混为单声道
+                            val bytesPerSample = if (floatPcm) 4 else 2
+                            val frames = info.size / (bytesPerSample * channels)
+                            if (mono.size < frames) mono = FloatArray(frames)
+                            if (floatPcm) {
+                                val fb = buffer.asFloatBuffer()
+                                for (i in 0 until frames) {
+                                    var sum = 0f
+                                    for (c in 0 until channels) sum += fb.get()
+                                    mono[i] = sum / channels
+                                }
+                            } else {
+                                val sb = buffer.asShortBuffer()
+                                for (i in 0 until frames) {
+                                    var sum = 0
+                                    for (c in 0 until channels) sum += sb.get()
+                                    mono[i] = sum / (channels * 32768f)
+                                }
+                            }
+
+                            // 丢弃 seek 到前一个同步帧带来的预卷数据
+                            var blockStartMs = info.presentationTimeUs / 1000
+                            var from = 0
+                            if (blockStartMs < startMs) {
+                                from = min(frames.toLong(), (startMs - blockStartMs) * sourceRate / 1000).toInt()
+                                blockStartMs = startMs
+                            }
+                            var count = frames - from
+                            if (blockStartMs + count * 1000L / sourceRate > endMs) {
+                                count = ((endMs - blockStartMs) * sourceRate / 1000).toInt().coerceAtLeast(0)
+                                stop = true
+                            }
+
+                            if (count > 0) {
+                                if (from > 0) System.arraycopy(mono, from, mono, 0, count)
+                                val continueDecoding = if (targetSampleRate > 0 && targetSampleRate != sourceRate) {
+                                    val r = resampler ?: MonoResampler(sourceRate, targetSampleRate).also { resampler = it }
+                                    val outCount = r.process(mono, count)
+                                    outCount == 0 || listener.onBlock(r.output, outCount, blockStartMs)
+                                } else {
+                                    listener.onBlock(mono, count, blockStartMs)
+                                }
+                                if (!continueDecoding) stop = true
+                            }
+                        }
+                        codec.releaseOutputBuffer(outIndex, false)
+                        if (eos) stop = true
+                    }
+                }
+            }
+        } finally {
+            try {
+                codec?.stop()
+            } catch (_: Exception) {
+            }
+            codec?.release()
+            extractor.release()
+        }
+    }
+
+    /**
+     * 流式单声道重采样：一阶低通抗混叠 + 线性插值
+     * 精度足够用于包络分析和语音识别，不用于回放
+     */
+    private class MonoResampler(private val inRate: Int, private val outRate: Int) {
+        var output = FloatArray(0)
+            private set
+
+        private val step = inRate.toDouble() / outRate
+        private val alpha: Float = if (outRate < inRate) {
+            (1.0 - exp(-2.0 * Math.PI * (outRate * 0.45) / inRate)).toFloat()
+        } else 1f
+
+        private var lowpassState = 0f
+        private var previous = 0f
+        private var position = 0.0 // 相对于本块第一个采样的读取位置（可为负，表示落在上一块末尾）
+
+        fun process(input: FloatArray, count: Int): Int {
+            val capacity = (count / step).toInt() + 2
+            if (output.size < capacity) output = FloatArray(capacity)
+
+            // 原地低通
+            var s = lowpassState
+            for (i in 0 until count) {
+                s += alpha * (input[i] - s)
+                input[i] = s
+            }
+            lowpassState = s
+
+            var n = 0
+            while (position < count - 1) {
+                val i = position.toInt()
+                val frac = (position - i).toFloat()
+                val a = if (position < 0) previous else input[i]
+                val b = if (position < 0) input[0] else input[i + 1]
+                val t = if (position < 0) (position + 1).toFloat() else frac
+                output[n++] = a + (b - a) * t
+                position += step
+            }
+            position -= count
+            previous = input[count - 1]
+            return n
+        }
+    }
+
+    companion object {
+        private const val TIMEOUT_US = 10_000L
+    }
+}
@@ -0,0 +1,25 @@
+package com.hx.nekomimi.audio
+
+import androidx.media3.common.audio.AudioProcessor
+import androidx.media3.common.util.UnstableApi
+import com.hx.nekomimi.audio.processor.CompressorAudioProcessor
+import com.hx.nekomimi.audio.processor.GainAudioProcessor
+
+/**
+ * 播放器的音频处理链
+ *
+ * 由 MediaPlaybackService 在构建 AudioSink 时注入，处理顺序即 [processors] 的顺序。
+ * 增益为 1 时输出增益处理器自动旁路；夜间模式关闭时压缩器仍保留 5 ms 前瞻延迟（开关时输出不中断），
+ * 每秒音频的额外耗时见 CompressorAudioProcessor.takeCpuCost。
+ */
+@UnstableApi
+class PlaybackAudioChain {
+
+    /** 夜间模式（动态范围压缩 / 限幅） */
+    val compressor = CompressorAudioProcessor()
+
+    /** 输出增益 */
+    val gain = GainAudioProcessor()
+
+    fun processors(): Array<AudioProcessor> = arrayOf(compressor, gain)
+}
@@ -0,0 +1,191 @@
+package com.hx.nekomimi.audio.cache
+
+import android.content.ContentResolver
+import android.content.Context
+import android.net.Uri
+import android.util.Log
+import androidx.media3.common.util.UnstableApi
+import androidx.media3.database.StandaloneDatabaseProvider
+import androidx.media3.datasource.DataSource
+import androidx.media3.datasource.DataSpec
+import androidx.media3.datasource.DefaultDataSource
+import androidx.media3.datasource.cache.CacheDataSource
+import androidx.media3.datasource.cache.CacheWriter
+import androidx.media3.datasource.cache.LeastRecentlyUsedCacheEvictor
+import androidx.media3.datasource.cache.SimpleCache
+import androidx.media3.datasource.okhttp.OkHttpDataSource
+import com.hx.nekomimi.remote.RemoteHttp
+import com.hx.nekomimi.service.PlaybackProcess
+import kotlinx.coroutines.CoroutineScope
+import kotlinx.coroutines.Dispatchers
+import kotlinx.coroutines.Job
+import kotlinx.coroutines.SupervisorJob
+import kotlinx.coroutines.isActive
+import kotlinx.coroutines.launch
+import java.io.File
+import java.io.InterruptedIOException
+
+/**
+ * 播放读穿缓存（全局单例）
+ *
+ * 云盘 / 网络类 DocumentProvider 和 WebDAV 书库每次打开都很慢，随机 seek 更是灾难。
+ * 播放器经由 [CacheDataSource] 读取这些来源：读过的数据落到本地闪存，之后的 seek 和重播直接命中缓存；
+ * 本地存储（外部存储、媒体库）不经过缓存，避免无意义的双份写入。
+ *
+ * - 容量上限 [MAX_CACHE_BYTES]，超出后按最近最少使用淘汰
+ * - [prefetch] 在后台把当前章节和下一章节写入缓存
+ * - 每个进程使用自己的缓存目录：SimpleCache 只防止同一进程内重复打开，两个进程同时打开同一目录和索引数据库会损坏缓存
+ *   （切换独立播放进程时旧进程不会被杀死）；播放服务销毁时调用 [release]
+ */
+@UnstableApi
+object PlaybackCache {
+
+    private const val TAG = "PlaybackCache"
+    private const val DIR = "media"
+
+    /** 独立播放进程的缓存目录 */
+    private const val PLAYBACK_PROCESS_DIR = "media-playback"
+
+    /** 缓存容量上限 */
+    const val MAX_CACHE_BYTES = 1L shl 30 // 1 GB
+
+    /** 单个文件预取上限（超长单文件有声书只预取开头部分，其余边播边缓存） */
+    private const val PREFETCH_LIMIT_BYTES = 256L shl 20 // 256 MB
+
+    /** 本地存储的 Provider，读取本来就很快，不需要缓存 */
+    private val LOCAL_AUTHORITIES = setOf(
+        "com.android.externalstorage.documents",
+        "com.android.providers.media.documents",
+        "com.android.providers.downloads.documents",
+        "media"
+    )
+
+    @Volatile
+    private var cache: SimpleCache? = null
+
+    private val scope = CoroutineScope(SupervisorJob() + Dispatchers.IO)
+    private var prefetchJob: Job? = null
+
+    @Volatile
+    private var activeWriter: CacheWriter? = null
+
+    /** SimpleCache 要求同一目录在进程内只有一个实例 */
+    @Synchronized
+    fun getCache(context: Context): SimpleCache {
+        cache?.let { return it }
+        val appContext = context.applicationContext
+        val dir = if (PlaybackProcess.isPlaybackProcess()) PLAYBACK_PROCESS_DIR else DIR
+        return SimpleCache(
+            File(appContext.cacheDir, dir),
+            LeastRecentlyUsedCacheEvictor(MAX_CACHE_BYTES),
+            StandaloneDatabaseProvider(appContext)
+        ).also { cache = it }
+    }
+
+    /**
+     * 停止预取并关闭缓存（播放器释放之后调用）；之后再次使用时重新打开
+     */
+    @Synchronized
+    fun release() {
+        prefetchJob?.cancel()
+        prefetchJob = null
+        activeWriter?.cancel()
+        cache?.release()
+        cache = null
+    }
+
+    /**
+     * 是否为需要缓存的慢速来源
+     */
+    fun isSlowSource(uri: Uri): Boolean {
+        if (uri.scheme == ContentResolver.SCHEME_FILE) return false
+        if (uri.scheme == ContentResolver.SCHEME_CONTENT) return uri.authority !in LOCAL_AUTHORITIES
+        return true
+    }
+
+    /**
+     * 播放器使用的 DataSource 工厂：慢速来源经过缓存，本地来源直接读取
+     */
+    fun dataSourceFactory(context: Context): DataSource.Factory {
+        val appContext = context.applicationContext
+        val upstream = upstreamFactory(appContext)
+        val cached = cacheDataSourceFactory(appContext, upstream)
+        return DataSource.Factory { SelectiveCacheDataSource(upstream.createDataSource(), cached) }
+    }
+
+    /** 本地 URI 交给 ContentResolver，http(s)（WebDAV 书库）经 OkHttp 发送 Range 请求 */
+    private fun upstreamFactory(context: Context): DataSource.Factory =
+        DefaultDataSource.Factory(context, OkHttpDataSource.Factory(RemoteHttp.client(context)))
+
+    private fun cacheDataSourceFactory(context: Context, upstream: DataSource.Factory) =
+        CacheDataSource.Factory()
+            .setCache(getCache(context))
+            .setUpstreamDataSourceFactory(upstream)
+            .setFlags(CacheDataSource.FLAG_IGNORE_CACHE_ON_ERROR)
+
+    /**
+     * 依次把给定文件写入缓存（本地来源自动跳过）；再次调用会取消上一次尚未完成的预取
+     */
+    @Synchronized
+    fun prefetch(context: Context, uris: List<Uri>) {
+        prefetchJob?.cancel()
+        activeWriter?.cancel()
+        val targets = uris.distinct().filter { isSlowSource(it) }
+        if (targets.isEmpty()) return
+
+        val appContext = context.applicationContext
+        prefetchJob = scope.launch {
+            val dataSource = cacheDataSourceFactory(appContext, upstreamFactory(appContext))
+                .createDataSource()
+            for (uri in targets) {
+                if (!isActive) break
+                val startedAt = System.currentTimeMillis()
+                try {
+                    val bytes = cacheHead(dataSource, uri, PREFETCH_LIMIT_BYTES) { activeWriter = it }
+                    Log.d(TAG, "预取完成: $uri ($bytes bytes, ${System.currentTimeMillis() - startedAt}ms)")
+                } catch (e: Exception) {
+                    // 取消预取会以 InterruptedIOException 结束，不影响播放
+                    if (isActive) Log.w(TAG, "预取失败: $uri", e)
+                } finally {
+                    activeWriter = null
+                }
+            }
+        }
+    }
+
+    /**
+     * 把 [uri] 开头最多约 [limit] 字节写入缓存（到达上限时在当前块写完后停止）
+     *
+     * 文件长度取自打开数据源时解析出的长度（http 的 Content-Length、content:// 的文件描述符长度），
+     * 不再预先查询：ContentResolver 查不到 http(s) 地址的大小，对慢速 Provider 还要多一次往返。
+     * @param onWriter 写入开始前回调，用于从其它线程取消
+     * @return 本次写入或已在缓存中的字节数
+     */
+    internal fun cacheHead(
+        dataSource: CacheDataSource,
+        uri: Uri,
+        limit: Long,
+        onWriter: (CacheWriter) -> Unit = {}
+    ): Long {
+        var cached = 0L
+        var limitReached = false
+        lateinit var writer: CacheWriter
+        writer = CacheWriter(dataSource, DataSpec.Builder().setUri(uri).build(), null) { _, bytesCached, _ ->
+            cached = bytesCached
+            if (bytesCached >= limit && !limitReached) {
+                limitReached = true
+                writer.cancel()
+            }
+        }
+        onWriter(writer)
+        try {
+            writer.cache()
+        } catch (e: InterruptedIOException) {
+            if (!limitReached) throw e
+        }
+        return cached
+    }
+
+    /** 缓存当前占用的字节数 */
+    fun cacheSpace(context: Context): Long = getCache(context).cacheSpace
+}
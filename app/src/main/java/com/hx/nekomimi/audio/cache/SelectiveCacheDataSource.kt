@@ -0,0 +1,59 @@
+package com.hx.nekomimi.audio.cache
+
+import android.net.Uri
+import androidx.media3.common.util.UnstableApi
+import androidx.media3.datasource.DataSource
+import androidx.media3.datasource.DataSpec
+import androidx.media3.datasource.TransferListener
+
+/**
+ * 按 URI 选择是否经过缓存的 DataSource
+ *
+ * 播放器在 open 之前就创建 DataSource，无法提前知道要读哪个文件，
+ * 因此在 [open] 时才根据 [PlaybackCache.isSlowSource] 选择直接读取或经过缓存读取。
+ */
+@UnstableApi
+class SelectiveCacheDataSource(
+    private val direct: DataSource,
+    private val cachedFactory: DataSource.Factory
+) : DataSource {
+
+    private val transferListeners = mutableListOf<TransferListener>()
+    private var cached: DataSource? = null
+    private var current: DataSource? = null
+
+    override fun addTransferListener(transferListener: TransferListener) {
+        transferListeners.add(transferListener)
+        direct.addTransferListener(transferListener)
+        cached?.addTransferListener(transferListener)
+    }
+
+    override fun open(dataSpec: DataSpec): Long {
+        val source = if (PlaybackCache.isSlowSource(dataSpec.uri)) {
+            cached ?: cachedFactory.createDataSource().also { created ->
+                transferListeners.forEach { created.addTransferListener(it) }
+                cached = created
+            }
+        } else {
+            direct
+        }
+        current = source
+        return source.open(dataSpec)
+    }
+
+    override fun read(buffer: ByteArray, offset: Int, length: Int): Int =
+        checkNotNull(current).read(buffer, offset, length)
+
+    override fun getUri(): Uri? = current?.uri
+
+    override fun getResponseHeaders(): Map<String, List<String>> =
+        current?.responseHeaders ?: emptyMap()
+
+    override fun close() {
+        try {
+            current?.close()
+        } finally {
+            current = null
+        }
+    }
+}
@@ -0,0 +1,75 @@
+package com.hx.nekomimi.audio.dsp
+
+import java.io.Closeable
+import java.nio.ByteBuffer
+import kotlin.math.PI
+import kotlin.math.cos
+import kotlin.math.pow
+import kotlin.math.sin
+
+/**
+ * 双二阶滤波器（原生实现，每声道独立状态；前 8 个声道参与滤波，其余声道原样通过）
+ * 系数公式参考 RBJ Audio EQ Cookbook
+ */
+class Biquad : Closeable {
+
+    companion object {
+        /** Butterworth 品质因数 1/√2 */
+        const val BUTTERWORTH_Q = 0.70710677f
+    }
+
+    private var handle: Long = NativeDsp.biquadCreate()
+
+    /** 低通 */
+    fun setLowPass(sampleRate: Int, cutoffHz: Float, q: Float = BUTTERWORTH_Q) {
+        val (cosW, alpha) = omega(sampleRate, cutoffHz, q)
+        val b1 = 1f - cosW
+        set(b1 / 2f, b1, b1 / 2f, 1f + alpha, -2f * cosW, 1f - alpha)
+    }
+
+    /** 高通 */
+    fun setHighPass(sampleRate: Int, cutoffHz: Float, q: Float = BUTTERWORTH_Q) {
+        val (cosW, alpha) = omega(sampleRate, cutoffHz, q)
+        val b1 = 1f + cosW
+        set(b1 / 2f, -b1, b1 / 2f, 1f + alpha, -2f * cosW, 1f - alpha)
+    }
+
+    /** 峰值均衡 */
+    fun setPeaking(sampleRate: Int, centerHz: Float, q: Float, gainDb: Float) {
+        val (cosW, alpha) = omega(sampleRate, centerHz, q)
+        val a = 10f.pow(gainDb / 40f)
+        set(
+            1f + alpha * a, -2f * cosW, 1f - alpha * a,
+            1f + alpha / a, -2f * cosW, 1f - alpha / a
+        )
+    }
+
+    fun reset() {
+        if (handle != 0L) NativeDsp.biquadReset(handle)
+    }
+
+    /**
+     * 原地处理交错 float 块
+     */
+    fun process(buf: ByteBuffer, offset: Int, frames: Int, channels: Int) {
+        if (handle != 0L) NativeDsp.biquadProcess(handle, buf, offset, frames, channels)
+    }
+
+    override fun close() {
+        if (handle != 0L) {
+            NativeDsp.biquadRelease(handle)
+            handle = 0L
+        }
+    }
+
+    private fun set(b0: Float, b1: Float, b2: Float, a0: Float, a1: Float, a2: Float) {
+        if (handle != 0L) {
+            NativeDsp.biquadSetCoefficients(handle, b0 / a0, b1 / a0, b2 / a0, a1 / a0, a2 / a0)
+        }
+    }
+
+    private fun omega(sampleRate: Int, freqHz: Float, q: Float): Pair<Float, Float> {
+        val w = 2.0 * PI * freqHz / sampleRate
+        return cos(w).toFloat() to (sin(w) / (2.0 * q)).toFloat()
+    }
+}
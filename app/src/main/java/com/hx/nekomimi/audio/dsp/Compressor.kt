@@ -0,0 +1,87 @@
+package com.hx.nekomimi.audio.dsp
+
+import java.io.Closeable
+import java.nio.ByteBuffer
+
+/**
+ * 前瞻式动态范围压缩 / 限幅器（原生实现，声道数不限，所有声道共用同一增益）
+ *
+ * 输出相对输入延迟 [latencyFrames] 帧（[configure] 时的前瞻时长按块取整）；[process] 不分配内存。
+ * [setEnabled] 关闭时音频仍经过延迟线，增益平滑回到 1，开关不会打断输出。
+ */
+class Compressor : Closeable {
+
+    /**
+     * @param thresholdDb 压缩起始电平（dBFS）
+     * @param ratio 超过阈值部分的压缩比
+     * @param kneeDb 软拐点宽度
+     * @param makeupDb 补偿增益（提升压缩后的整体响度，小声台词因此变大）
+     * @param ceilingDb 限幅上限（dBFS）
+     */
+    data class Params(
+        val thresholdDb: Float,
+        val ratio: Float,
+        val kneeDb: Float,
+        val attackMs: Float,
+        val releaseMs: Float,
+        val makeupDb: Float,
+        val ceilingDb: Float
+    )
+
+    companion object {
+        /** 夜间听书：人声响度差压到约一半，小声部分提升约 9 dB */
+        val SPEECH_NIGHT = Params(
+            thresholdDb = -30f,
+            ratio = 4f,
+            kneeDb = 6f,
+            attackMs = 5f,
+            releaseMs = 150f,
+            makeupDb = 9f,
+            ceilingDb = -1f
+        )
+    }
+
+    private var handle: Long = NativeDsp.compressorCreate()
+
+    /**
+     * 格式变化时调用（重新分配延迟线并清空状态）
+     */
+    fun configure(sampleRate: Int, channels: Int, lookaheadMs: Float) {
+        if (handle != 0L) NativeDsp.compressorConfigure(handle, sampleRate, channels, lookaheadMs)
+    }
+
+    fun setParams(params: Params) {
+        if (handle == 0L) return
+        with(params) {
+            NativeDsp.compressorSetParams(handle, thresholdDb, ratio, kneeDb, attackMs, releaseMs, makeupDb, ceilingDb)
+        }
+    }
+
+    fun setEnabled(enabled: Boolean) {
+        if (handle != 0L) NativeDsp.compressorSetEnabled(handle, enabled)
+    }
+
+    fun reset() {
+        if (handle != 0L) NativeDsp.compressorReset(handle)
+    }
+
+    /**
+     * 原地处理交错 float 块（声道数为 [configure] 时的值）
+     */
+    fun process(buf: ByteBuffer, offset: Int, frames: Int) {
+        if (handle != 0L) NativeDsp.compressorProcess(handle, buf, offset, frames)
+    }
+
+    /** 当前增益衰减量（dB，≤ 0，不含补偿增益） */
+    fun gainReductionDb(): Float = if (handle != 0L) NativeDsp.compressorGainReductionDb(handle) else 0f
+
+    /** 输出相对输入的延迟帧数；流结束时送入这么多帧静音即可排空延迟线 */
+    fun latencyFrames(): Int = if (handle != 0L) NativeDsp.compressorLatencyFrames(handle) else 0
+
+    override fun close() {
+        if (handle != 0L) {
+            NativeDsp.compressorRelease(handle)
+            handle = 0L
+        }
+    }
+}
@@ -0,0 +1,80 @@
+package com.hx.nekomimi.audio.dsp
+
+import kotlin.math.PI
+import kotlin.math.cos
+import kotlin.math.sin
+
+/**
+ * 基 2 复数 FFT（原地、迭代），用于离线分析（互相关、频谱）
+ *
+ * 旋转因子和位反转表在构造时预计算，同一尺寸可重复使用同一实例。
+ * @param size 变换长度，必须是 2 的幂
+ */
+class Fft(val size: Int) {
+
+    init {
+        require(size >= 2 && size and (size - 1) == 0) { "FFT 长度必须是 2 的幂: $size" }
+    }
+
+    private val cosTable = FloatArray(size / 2) { cos(2.0 * PI * it / size).toFloat() }
+    private val sinTable = FloatArray(size / 2) { sin(2.0 * PI * it / size).toFloat() }
+    private val bitReverse = IntArray(size).also { table ->
+        val bits = Integer.numberOfTrailingZeros(size)
+        for (i in 0 until size) table[i] = Integer.reverse(i) ushr (32 - bits)
+    }
+
+    /**
+     * 正变换（inverse = true 时为逆变换，结果已除以 size）
+     * @param re 实部，长度为 size
+     * @param im 虚部，长度为 size
+     */
+    fun transform(re: FloatArray, im: FloatArray, inverse: Boolean = false) {
+        for (i in 0 until size) {
+            val j = bitReverse[i]
+            if (j > i) {
+                var t = re[i]; re[i] = re[j]; re[j] = t
+                t = im[i]; im[i] = im[j]; im[j] = t
+            }
+        }
+
+        val sign = if (inverse) 1f else -1f
+        var half = 1
+        while (half < size) {
+            val step = size / (half * 2)
+            var start = 0
+            while (start < size) {
+                for (k in 0 until half) {
+                    val wr = cosTable[k * step]
+                    val wi = sign * sinTable[k * step]
+                    val a = start + k
+                    val b = a + half
+                    val xr = re[b] * wr - im[b] * wi
+                    val xi = re[b] * wi + im[b] * wr
+                    re[b] = re[a] - xr
+                    im[b] = im[a] - xi
+                    re[a] += xr
+                    im[a] += xi
+                }
+                start += half * 2
+            }
+            half *= 2
+        }
+
+        if (inverse) {
+            val norm = 1f / size
+            for (i in 0 until size) {
+                re[i] *= norm
+                im[i] *= norm
+            }
+        }
+    }
+
+    companion object {
+        /** 不小于 n 的最小 2 的幂 */
+        fun sizeFor(n: Int): Int {
+            var size = 2
+            while (size < n) size = size shl 1
+            return size
+        }
+    }
+}
@@ -0,0 +1,82 @@
+package com.hx.nekomimi.audio.dsp
+
+import android.util.Log
+import java.nio.ByteBuffer
+
+/**
+ * 原生 DSP 核心（libnekodsp）的 JNI 入口
+ *
+ * - 所有 ByteBuffer 参数必须是 direct buffer（native 字节序），偏移量单位为字节
+ * - 浮点缓冲区为交错排列的 float 采样，范围 [-1, 1)
+ * - 按 CPU 在运行时选择 NEON / AVX2 / SSE2 / 标量实现，见 [kernelName]
+ */
+object NativeDsp {
+
+    private const val TAG = "NativeDsp"
+
+    /** 原生库是否加载成功（未加载时所有 DSP 处理器自动旁路） */
+    val isAvailable: Boolean = try {
+        System.loadLibrary("nekodsp")
+        true
+    } catch (e: UnsatisfiedLinkError) {
+        Log.w(TAG, "libnekodsp 加载失败，DSP 处理将被旁路", e)
+        false
+    }
+
+    /** 当前使用的内核实现名 */
+    external fun kernelName(): String
+
+    /** 交错 PCM16 -> float */
+    external fun pcm16ToFloat(src: ByteBuffer, srcOffset: Int, dst: ByteBuffer, dstOffset: Int, samples: Int)
+
+    /** float -> 交错 PCM16（饱和截断） */
+    external fun floatToPcm16(src: ByteBuffer, srcOffset: Int, dst: ByteBuffer, dstOffset: Int, samples: Int)
+
+    /** 线性增益渐变（原地），同一帧所有声道使用相同增益 */
+    external fun gainRamp(buf: ByteBuffer, offset: Int, frames: Int, channels: Int, startGain: Float, endGain: Float)
+
+    /**
+     * 按 hop 计算 RMS / 峰值包络（所有声道合并）
+     * @param rmsOut 可为 null，容量需 ≥ ceil(frames / hopFrames)
+     * @param peakOut 可为 null，容量同上
+     * @return 写出的包络点数；输出容量不足时返回 0
+     */
+    external fun envelope(
+        buf: ByteBuffer, offset: Int, frames: Int, channels: Int, hopFrames: Int,
+        rmsOut: FloatArray?, peakOut: FloatArray?
+    ): Int
+
+    /** dst += src * window（window 为 null 时直接相加），n 为采样数 */
+    external fun overlapAdd(
+        dst: ByteBuffer, dstOffset: Int,
+        src: ByteBuffer, srcOffset: Int,
+        window: ByteBuffer?, windowOffset: Int,
+        n: Int
+    )
+
+    // 以下句柄接口通过 [Biquad] / [Compressor] 类使用。必须是 public：
+    // internal 成员的 JVM 名会被 Kotlin 改写（如 biquadCreate$app_release），与 JNI 符号对不上
+
+    // ========== Biquad ==========
+
+    external fun biquadCreate(): Long
+    external fun biquadSetCoefficients(handle: Long, b0: Float, b1: Float, b2: Float, a1: Float, a2: Float)
+    external fun biquadReset(handle: Long)
+    external fun biquadProcess(handle: Long, buf: ByteBuffer, offset: Int, frames: Int, channels: Int)
+    external fun biquadRelease(handle: Long)
+
+    // ========== Compressor ==========
+
+    external fun compressorCreate(): Long
+    external fun compressorConfigure(handle: Long, sampleRate: Int, channels: Int, lookaheadMs: Float)
+    external fun compressorSetParams(
+        handle: Long, thresholdDb: Float, ratio: Float, kneeDb: Float,
+        attackMs: Float, releaseMs: Float, makeupDb: Float, ceilingDb: Float
+    )
+    external fun compressorSetEnabled(handle: Long, enabled: Boolean)
+    external fun compressorReset(handle: Long)
+    external fun compressorProcess(handle: Long, buf: ByteBuffer, offset: Int, frames: Int)
+    external fun compressorGainReductionDb(handle: Long): Float
+    external fun compressorLatencyFrames(handle: Long): Int
+    external fun compressorRelease(handle: Long)
+}
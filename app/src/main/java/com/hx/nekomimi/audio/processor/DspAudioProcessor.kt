@@ -0,0 +1,122 @@
+package com.hx.nekomimi.audio.processor
+
+import androidx.media3.common.C
+import androidx.media3.common.audio.AudioProcessor
+import androidx.media3.common.audio.AudioProcessor.AudioFormat
+import androidx.media3.common.audio.BaseAudioProcessor
+import androidx.media3.common.util.UnstableApi
+import com.hx.nekomimi.audio.dsp.NativeDsp
+import java.nio.ByteBuffer
+import java.nio.ByteOrder
+
+/**
+ * 基于原生 DSP 核心的 AudioProcessor 基类
+ *
+ * 负责 PCM16 <-> float 的转换与缓冲区复用，子类只需在 [processBlock] 中原地处理交错 float 块。
+ * - 所有中间缓冲区按需扩容后复用，稳态播放时不产生分配
+ * - [isBypassed] 为 true 时直接拷贝 PCM，跳过格式转换
+ * - 原生库不可用或输入不是 PCM16 时，处理器自动变为非激活状态（由 AudioSink 跳过）
+ */
+@UnstableApi
+abstract class DspAudioProcessor : BaseAudioProcessor() {
+
+    /** 交错 float 工作块（direct，native 字节序） */
+    private var floatBlock: ByteBuffer = AudioProcessor.EMPTY_BUFFER
+
+    /** 非 direct 输入的中转缓冲 */
+    private var staging: ByteBuffer = AudioProcessor.EMPTY_BUFFER
+
+    protected val sampleRate: Int get() = inputAudioFormat.sampleRate
+    protected val channelCount: Int get() = inputAudioFormat.channelCount
+
+    override fun onConfigure(inputAudioFormat: AudioFormat): AudioFormat {
+        // 非 PCM16（如高精度 float 输出）时不处理，直接旁路，避免整个 AudioSink 配置失败
+        if (inputAudioFormat.encoding != C.ENCODING_PCM_16BIT || !NativeDsp.isAvailable) {
+            return AudioFormat.NOT_SET
+        }
+        onConfigureDsp(inputAudioFormat.sampleRate, inputAudioFormat.channelCount)
+        return inputAudioFormat
+    }
+
+    override fun queueInput(inputBuffer: ByteBuffer) {
+        val size = inputBuffer.remaining()
+        if (size == 0) return
+        val output = replaceOutputBuffer(size)
+
+        if (isBypassed()) {
+            output.put(inputBuffer)
+            output.flip()
+            return
+        }
+
+        val channels = channelCount
+        val frames = size / inputAudioFormat.bytesPerFrame
+        val samples = frames * channels
+
+        val source = if (inputBuffer.isDirect) inputBuffer else stage(inputBuffer)
+        ensureFloatCapacity(samples)
+
+        NativeDsp.pcm16ToFloat(source, source.position(), floatBlock, 0, samples)
+        processBlock(floatBlock, frames, channels)
+        NativeDsp.floatToPcm16(floatBlock, 0, output, 0, samples)
+
+        inputBuffer.position(inputBuffer.limit())
+        output.position(samples * 2)
+        output.flip()
+    }
+
+    override fun onReset() {
+        floatBlock = AudioProcessor.EMPTY_BUFFER
+        staging = AudioProcessor.EMPTY_BUFFER
+    }
+
+    /**
+     * 格式确定后调用，子类在此根据采样率/声道数重算参数
+     */
+    protected open fun onConfigureDsp(sampleRate: Int, channelCount: Int) {}
+
+    /**
+     * 当前是否可以直接透传（例如增益为 1、效果关闭）
+     */
+    protected open fun isBypassed(): Boolean = false
+
+    /**
+     * 原地处理一个交错 float 块（从字节偏移 0 开始，共 frames * channels 个采样）
+     */
+    protected abstract fun processBlock(block: ByteBuffer, frames: Int, channels: Int)
+
+    /**
+     * 把 [frames] 帧静音送过 [processBlock] 作为输出（有内部延迟的子类在流结束时用来排空延迟线）
+     */
+    protected fun drainWithSilence(frames: Int) {
+        if (frames <= 0) return
+        val channels = channelCount
+        val samples = frames * channels
+        ensureFloatCapacity(samples)
+        for (i in 0 until samples) floatBlock.putFloat(i * 4, 0f)
+        processBlock(floatBlock, frames, channels)
+
+        val output = replaceOutputBuffer(samples * 2)
+        NativeDsp.floatToPcm16(floatBlock, 0, output, 0, samples)
+        output.position(samples * 2)
+        output.flip()
+    }
+
+    private fun ensureFloatCapacity(samples: Int) {
+        val bytes = samples * 4
+        if (floatBlock.capacity() < bytes) {
+            floatBlock = ByteBuffer.allocateDirect(bytes).order(ByteOrder.nativeOrder())
+        }
+    }
+
+    private fun stage(input: ByteBuffer): ByteBuffer {
+        val size = input.remaining()
+        if (staging.capacity() < size) {
+            staging = ByteBuffer.allocateDirect(size).order(ByteOrder.nativeOrder())
+        }
+        staging.clear()
+        staging.put(input.duplicate())
+        staging.flip()
+        return staging
+    }
+}
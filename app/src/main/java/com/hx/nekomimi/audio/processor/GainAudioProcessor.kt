@@ -0,0 +1,42 @@
+package com.hx.nekomimi.audio.processor
+
+import androidx.media3.common.util.UnstableApi
+import com.hx.nekomimi.audio.dsp.NativeDsp
+import java.nio.ByteBuffer
+
+/**
+ * 平滑增益处理器
+ *
+ * 增益变化时在一个块内做线性渐变，避免突变产生爆音；增益为 1 时直接透传。
+ * 可在播放线程之外调用 [setGain]，下一个块生效。
+ */
+@UnstableApi
+class GainAudioProcessor : DspAudioProcessor() {
+
+    @Volatile
+    private var targetGain = 1.0f
+    private var currentGain = 1.0f
+
+    fun setGain(gain: Float) {
+        targetGain = gain.coerceIn(0f, MAX_GAIN)
+    }
+
+    fun getGain(): Float = targetGain
+
+    override fun isBypassed(): Boolean = targetGain == 1.0f && currentGain == 1.0f
+
+    override fun processBlock(block: ByteBuffer, frames: Int, channels: Int) {
+        val target = targetGain
+        NativeDsp.gainRamp(block, 0, frames, channels, currentGain, target)
+        currentGain = target
+    }
+
+    override fun onFlush() {
+        currentGain = targetGain
+    }
+
+    companion object {
+        /** 最大增益（约 +12 dB） */
+        const val MAX_GAIN = 4.0f
+    }
+}
@@ -0,0 +1,121 @@
+package com.hx.nekomimi.audio.waveform
+
+import java.io.DataInputStream
+import java.io.DataOutputStream
+import java.io.File
+import java.io.IOException
+import kotlin.math.max
+
+/**
+ * 章节波形概览：固定时长的桶，每桶保存最小值 / 最大值 / RMS
+ *
+ * 二进制格式（大端）：
+ * ```
+ * magic "NKWF" | version u8 | bucketMs i32 | durationMs i64 | count i32
+ * min[count] i8 | max[count] i8 | rms[count] u8
+ * ```
+ * 采样量化为 8 位，每桶 3 字节，2048 桶约 6 KB。
+ *
+ * @param bucketMs 每桶时长
+ * @param durationMs 音频总时长
+ */
+class WaveformData(
+    val bucketMs: Int,
+    val durationMs: Long,
+    private val mins: ByteArray,
+    private val maxes: ByteArray,
+    private val rmsValues: ByteArray
+) {
+
+    val size: Int get() = mins.size
+
+    /** 整条波形的最大峰值（0..1），渲染时用于归一化，使小音量录音也能看清 */
+    val peak: Float = (0 until size).fold(0f) { acc, i -> max(acc, max(-minAt(i), maxAt(i))) }
+
+    fun minAt(index: Int): Float = mins[index] / 127f
+
+    fun maxAt(index: Int): Float = maxes[index] / 127f
+
+    fun rmsAt(index: Int): Float = (rmsValues[index].toInt() and 0xFF) / 255f
+
+    /** 时间对应的桶下标 */
+    fun indexAt(positionMs: Long): Int = (positionMs / bucketMs).toInt().coerceIn(0, max(size - 1, 0))
+
+    /**
+     * 截取 [startMs, endMs) 区间（用于单文件有声书的虚拟章节）
+     */
+    fun slice(startMs: Long, endMs: Long): WaveformData {
+        val from = indexAt(startMs)
+        val to = (indexAt(endMs - 1) + 1).coerceAtLeast(from)
+        return WaveformData(
+            bucketMs,
+            endMs - startMs,
+            mins.copyOfRange(from, to),
+            maxes.copyOfRange(from, to),
+            rmsValues.copyOfRange(from, to)
+        )
+    }
+
+    fun writeTo(file: File) {
+        file.parentFile?.mkdirs()
+        val temp = File(file.path + ".tmp")
+        DataOutputStream(temp.outputStream().buffered()).use { out ->
+            out.write(MAGIC)
+            out.writeByte(VERSION)
+            out.writeInt(bucketMs)
+            out.writeLong(durationMs)
+            out.writeInt(size)
+            out.write(mins)
+            out.write(maxes)
+            out.write(rmsValues)
+        }
+        if (!temp.renameTo(file)) {
+            temp.delete()
+            throw IOException("无法写入波形文件: $file")
+        }
+    }
+
+    companion object {
+        private val MAGIC = byteArrayOf('N'.code.toByte(), 'K'.code.toByte(), 'W'.code.toByte(), 'F'.code.toByte())
+        private const val VERSION = 1
+
+        /** 防止损坏文件导致超大分配 */
+        private const val MAX_BUCKETS = 1 shl 20
+
+        /**
+         * 从量化前的浮点数据构造
+         */
+        fun quantize(bucketMs: Int, durationMs: Long, mins: FloatArray, maxes: FloatArray, rms: FloatArray, count: Int) =
+            WaveformData(
+                bucketMs,
+                durationMs,
+                ByteArray(count) { (mins[it].coerceIn(-1f, 1f) * 127f).toInt().toByte() },
+                ByteArray(count) { (maxes[it].coerceIn(-1f, 1f) * 127f).toInt().toByte() },
+                ByteArray(count) { (rms[it].coerceIn(0f, 1f) * 255f).toInt().toByte() }
+            )
+
+        /**
+         * 读取波形文件；文件不存在、损坏或版本不符时返回 null
+         */
+        fun readFrom(file: File): WaveformData? {
+            if (!file.isFile) return null
+            return try {
+                DataInputStream(file.inputStream().buffered()).use { input ->
+                    val magic = ByteArray(MAGIC.size)
+                    input.readFully(magic)
+                    if (!magic.contentEquals(MAGIC) || input.readUnsignedByte() != VERSION) return null
+                    val bucketMs = input.readInt()
+                    val durationMs = input.readLong()
+                    val count = input.readInt()
+                    if (bucketMs <= 0 || count !in 0..MAX_BUCKETS) return null
+                    val mins = ByteArray(count).also { input.readFully(it) }
+                    val maxes = ByteArray(count).also { input.readFully(it) }
+                    val rms = ByteArray(count).also { input.readFully(it) }
+                    WaveformData(bucketMs, durationMs, mins, maxes, rms)
+                }
+            } catch (e: IOException) {
+                null
+            }
+        }
+    }
+}
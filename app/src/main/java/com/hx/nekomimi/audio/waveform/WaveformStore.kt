@@ -0,0 +1,136 @@
+package com.hx.nekomimi.audio.waveform
+
+import android.content.Context
+import android.net.Uri
+import android.os.Process
+import android.util.Log
+import com.hx.nekomimi.audio.PcmDecoder
+import com.hx.nekomimi.util.HashUtils
+import kotlinx.coroutines.Dispatchers
+import kotlinx.coroutines.Job
+import kotlinx.coroutines.asCoroutineDispatcher
+import kotlinx.coroutines.currentCoroutineContext
+import kotlinx.coroutines.withContext
+import java.io.File
+import java.util.concurrent.Executors
+import kotlin.math.max
+import kotlin.math.min
+import kotlin.math.sqrt
+
+/**
+ * 章节波形概览的生成与缓存
+ *
+ * - 波形文件按音频 URI 的哈希存放在应用私有目录，重新扫描书籍后仍可复用
+ * - 生成在单线程、最低优先级的专用线程上执行，多个请求自动排队，不与播放和 UI 抢占 CPU
+ * - 一次流式解码完成，内存占用与音频时长无关
+ */
+object WaveformStore {
+
+    private const val TAG = "WaveformStore"
+    private const val DIR = "waveforms"
+
+    /** 每个章节的桶数（与时长无关，足够覆盖高分辨率屏幕的宽度） */
+    const val BUCKETS = 2048
+
+    /** 时长未知时使用的桶时长 */
+    private const val FALLBACK_BUCKET_MS = 1000
+
+    private const val MIN_BUCKET_MS = 10
+
+    private val generatorDispatcher = Executors.newSingleThreadExecutor { runnable ->
+        Thread({
+            Process.setThreadPriority(Process.THREAD_PRIORITY_LOWEST)
+            runnable.run()
+        }, "waveform-generator").apply { isDaemon = true }
+    }.asCoroutineDispatcher()
+
+    fun fileFor(context: Context, audioUri: String): File =
+        File(File(context.filesDir, DIR), "${HashUtils.sha1Hex(audioUri)}.nkwf")
+
+    /**
+     * 读取已有的波形，不存在时在后台生成
+     * @param durationHintMs 章节时长（容器未给出时长时用于确定桶大小），未知时传 0
+     * @return 波形数据；解码失败或协程被取消时返回 null
+     */
+    suspend fun getOrGenerate(context: Context, audioUri: String, durationHintMs: Long = 0L): WaveformData? {
+        val file = fileFor(context, audioUri)
+        withContext(Dispatchers.IO) { WaveformData.readFrom(file) }?.let { return it }
+
+        return withContext(generatorDispatcher) {
+            // 排队期间可能已由其他请求生成
+            WaveformData.readFrom(file)?.let { return@withContext it }
+            try {
+                val data = generate(context, Uri.parse(audioUri), durationHintMs) ?: return@withContext null
+                data.writeTo(file)
+                data
+            } catch (e: Exception) {
+                Log.w(TAG, "波形生成失败: $audioUri", e)
+                null
+            }
+        }
+    }
+
+    private suspend fun generate(context: Context, uri: Uri, durationHintMs: Long): WaveformData? {
+        val coroutineJob = currentCoroutineContext()[Job]
+        val startedAt = System.currentTimeMillis()
+
+        var bucketMs = FALLBACK_BUCKET_MS
+        var durationMs = durationHintMs
+        var sampleRate = 0
+        var capacity = BUCKETS
+        var mins = FloatArray(capacity)
+        var maxes = FloatArray(capacity)
+        var sumSquares = FloatArray(capacity)
+        var counts = IntArray(capacity)
+        var buckets = 0
+        var position = 0L // 已处理的采样数
+
+        PcmDecoder(context, uri).decode(
+            onInfo = { info ->
+                sampleRate = info.sampleRate
+                if (info.durationMs > 0) durationMs = info.durationMs
+                if (durationMs > 0) {
+                    bucketMs = max(MIN_BUCKET_MS.toLong(), (durationMs + BUCKETS - 1) / BUCKETS).toInt()
+                }
+            }
+        ) { samples, count, _ ->
+            val samplesPerBucket = sampleRate.toLong() * bucketMs / 1000
+            var i = 0
+            while (i < count) {
+                val bucket = (position / samplesPerBucket).toInt()
+                if (bucket >= capacity) {
+                    // 实际时长超出容器声明（或时长未知），扩容
+                    capacity *= 2
+                    mins = mins.copyOf(capacity)
+                    maxes = maxes.copyOf(capacity)
+                    sumSquares = sumSquares.copyOf(capacity)
+                    counts = counts.copyOf(capacity)
+                }
+                val end = min(count.toLong(), i + (bucket + 1) * samplesPerBucket - position).toInt()
+                var lo = mins[bucket]
+                var hi = maxes[bucket]
+                var sq = 0f
+                for (j in i until end) {
+                    val s = samples[j]
+                    if (s < lo) lo = s
+                    if (s > hi) hi = s
+                    sq += s * s
+                }
+                mins[bucket] = lo
+                maxes[bucket] = hi
+                sumSquares[bucket] += sq
+                counts[bucket] += end - i
+                position += end - i
+                buckets = max(buckets, bucket + 1)
+                i = end
+            }
+            coroutineJob?.isActive != false
+        }
+        if (coroutineJob?.isActive == false || buckets == 0) return null
+
+        val rms = FloatArray(buckets) { if (counts[it] > 0) sqrt(sumSquares[it] / counts[it]) else 0f }
+        val actualDurationMs = if (sampleRate > 0) position * 1000 / sampleRate else durationMs
+        Log.d(TAG, "波形生成完成: $buckets 桶 × ${bucketMs}ms, 耗时 ${System.currentTimeMillis() - startedAt}ms")
+        return WaveformData.quantize(bucketMs, actualDurationMs, mins, maxes, rms, buckets)
+    }
+}
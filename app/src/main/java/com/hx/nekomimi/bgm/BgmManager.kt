@@ -5,43 +5,33 @@ import android.media.AudioAttributes
 import android.media.AudioManager
 import android.media.MediaPlayer
 import android.net.Uri
+import android.provider.OpenableColumns
 import android.util.Log
+import com.hx.nekomimi.settings.AppSettings
+import kotlinx.coroutines.CoroutineScope
+import kotlinx.coroutines.Dispatchers
+import kotlinx.coroutines.SupervisorJob
+import kotlinx.coroutines.launch
+import kotlinx.coroutines.withContext
 
 /**
  * 背景音乐管理器（全局单例）
  * - 使用独立的 MediaPlayer 实例播放背景音乐，与听书音频互不干扰
  * - 支持循环播放、音量微调
- * - 设置通过 SharedPreferences 全局持久化
+ * - 设置保存在 [AppSettings]，主线程只读内存快照
  */
 object BgmManager {
 
     private const val TAG = "BgmManager"
-    private const val PREFS_NAME = "bgm_settings"
-    private const val KEY_BGM_URI = "bgm_uri"
-    private const val KEY_BGM_VOLUME = "bgm_volume"
-    private const val KEY_BGM_ENABLED = "bgm_enabled"
-    private const val DEFAULT_VOLUME = 0.3f // 默认背景音乐音量 30%
 
     private var mediaPlayer: MediaPlayer? = null
-    private var currentUri: Uri? = null
-    private var volume: Float = DEFAULT_VOLUME
-    private var isEnabled: Boolean = false
     private var isPrepared: Boolean = false
     private var shouldPlayWhenReady: Boolean = false
 
-    /**
-     * 从持久化设置恢复 BGM 状态
-     */
-    fun init(context: Context) {
-        val prefs = context.getSharedPreferences(PREFS_NAME, Context.MODE_PRIVATE)
-        val uriStr = prefs.getString(KEY_BGM_URI, null)
-        volume = prefs.getFloat(KEY_BGM_VOLUME, DEFAULT_VOLUME)
-        isEnabled = prefs.getBoolean(KEY_BGM_ENABLED, false)
-
-        if (uriStr != null) {
-            currentUri = Uri.parse(uriStr)
-        }
-    }
+    private val scope = CoroutineScope(SupervisorJob() + Dispatchers.Main)
+
+    private val currentUri: Uri? get() = AppSettings.current.bgmUri?.let { Uri.parse(it) }
+    private val volume: Float get() = AppSettings.current.bgmVolume
 
     /**
      * 获取当前BGM的URI
@@ -56,7 +46,7 @@ object BgmManager {
     /**
      * BGM 是否已启用
      */
-    fun isEnabled(): Boolean = isEnabled
+    fun isEnabled(): Boolean = AppSettings.current.bgmEnabled
 
     /**
      * 是否正在播放
@@ -70,16 +60,20 @@ object BgmManager {
     }
 
     /**
-     * 设置BGM文件并持久化
+     * 设置BGM文件并持久化；文件名在后台查询后补写
      */
     fun setBgmUri(context: Context, uri: Uri?) {
-        currentUri = uri
-        val prefs = context.getSharedPreferences(PREFS_NAME, Context.MODE_PRIVATE)
-        prefs.edit().putString(KEY_BGM_URI, uri?.toString()).apply()
+        AppSettings.setBgm(uri?.toString(), null)
 
         if (uri == null) {
             stop()
             setEnabled(context, false)
+            return
+        }
+        val appContext = context.applicationContext
+        scope.launch {
+            val name = queryDisplayName(appContext, uri)
+            if (currentUri == uri) AppSettings.setBgm(uri.toString(), name)
         }
     }
 
@@ -87,9 +81,8 @@ object BgmManager {
      * 设置音量并持久化（0.0 ~ 1.0）
      */
     fun setVolume(context: Context, vol: Float) {
-        volume = vol.coerceIn(0f, 1f)
-        val prefs = context.getSharedPreferences(PREFS_NAME, Context.MODE_PRIVATE)
-        prefs.edit().putFloat(KEY_BGM_VOLUME, volume).apply()
+        val volume = vol.coerceIn(0f, 1f)
+        AppSettings.setBgmVolume(volume)
 
         // 实时更新播放音量
         try {
@@ -103,9 +96,7 @@ object BgmManager {
      * 启用/禁用BGM并持久化
      */
     fun setEnabled(context: Context, enabled: Boolean) {
-        isEnabled = enabled
-        val prefs = context.getSharedPreferences(PREFS_NAME, Context.MODE_PRIVATE)
-        prefs.edit().putBoolean(KEY_BGM_ENABLED, enabled).apply()
+        AppSettings.setBgmEnabled(enabled)
 
         if (enabled) {
             start(context)
@@ -119,7 +110,7 @@ object BgmManager {
      */
     fun start(context: Context) {
         val uri = currentUri
-        if (uri == null || !isEnabled) {
+        if (uri == null || !isEnabled()) {
             Log.d(TAG, "BGM 未设置或未启用，跳过播放")
             return
         }
@@ -134,14 +125,13 @@ object BgmManager {
         releasePlayer()
 
         try {
-            mediaPlayer = MediaPlayer().apply {
+            val player = MediaPlayer().apply {
                 setAudioAttributes(
                     AudioAttributes.Builder()
                         .setContentType(AudioAttributes.CONTENT_TYPE_MUSIC)
                         .setUsage(AudioAttributes.USAGE_MEDIA)
                         .build()
                 )
-                setDataSource(context.applicationContext, uri)
                 isLooping = true // 循环播放
                 setVolume(volume, volume)
 
@@ -161,8 +151,25 @@ object BgmManager {
                     true
                 }
 
-                shouldPlayWhenReady = true
-                prepareAsync()
+            }
+            mediaPlayer = player
+            shouldPlayWhenReady = true
+
+            // 打开 content:// 文件要经过 ContentResolver，放到 IO 线程
+            val appContext = context.applicationContext
+            scope.launch {
+                val opened = withContext(Dispatchers.IO) {
+                    try {
+                        player.setDataSource(appContext, uri)
+                        true
+                    } catch (e: Exception) {
+                        Log.e(TAG, "BGM 文件打开失败", e)
+                        false
+                    }
+                }
+                // 打开期间已被停止或替换
+                if (mediaPlayer !== player) return@launch
+                if (opened) player.prepareAsync() else releasePlayer()
             }
         } catch (e: Exception) {
             Log.e(TAG, "BGM 初始化失败", e)
@@ -188,7 +195,7 @@ object BgmManager {
      * 恢复播放
      */
     fun resume() {
-        if (!isEnabled || currentUri == null) return
+        if (!isEnabled() || currentUri == null) return
         try {
             if (isPrepared && mediaPlayer?.isPlaying == false) {
                 mediaPlayer?.start()
@@ -226,24 +233,37 @@ object BgmManager {
     }
 
     /**
-     * 获取BGM文件名（用于UI显示）
+     * 获取BGM文件名（用于UI显示，读取已保存的名称，不查询 ContentResolver）
      */
-    fun getBgmDisplayName(context: Context): String? {
+    fun getBgmDisplayName(): String? {
         val uri = currentUri ?: return null
-        return try {
-            val cursor = context.contentResolver.query(uri, null, null, null, null)
-            cursor?.use {
+        return AppSettings.current.bgmDisplayName ?: uri.lastPathSegment?.substringAfterLast('/')
+    }
+
+    /**
+     * 补全旧版本没有保存的文件名（在后台查询）
+     * @return 查询到的文件名
+     */
+    suspend fun resolveDisplayName(context: Context): String? {
+        val uri = currentUri ?: return null
+        AppSettings.current.bgmDisplayName?.let { return it }
+        val name = queryDisplayName(context.applicationContext, uri) ?: return null
+        if (currentUri == uri) AppSettings.setBgm(uri.toString(), name)
+        return name
+    }
+
+    private suspend fun queryDisplayName(context: Context, uri: Uri): String? = withContext(Dispatchers.IO) {
+        try {
+            context.contentResolver.query(uri, arrayOf(OpenableColumns.DISPLAY_NAME), null, null, null)?.use {
                 if (it.moveToFirst()) {
-                    val nameIndex = it.getColumnIndex(android.provider.OpenableColumns.DISPLAY_NAME)
-                    if (nameIndex >= 0) {
-                        return it.getString(nameIndex)
-                    }
+                    val nameIndex = it.getColumnIndex(OpenableColumns.DISPLAY_NAME)
+                    if (nameIndex >= 0) return@withContext it.getString(nameIndex)
                 }
             }
-            // fallback: 从URI路径中提取文件名
-            uri.lastPathSegment?.substringAfterLast('/')
+            null
         } catch (e: Exception) {
-            uri.lastPathSegment?.substringAfterLast('/')
+            Log.w(TAG, "查询 BGM 文件名失败", e)
+            null
         }
     }
 }
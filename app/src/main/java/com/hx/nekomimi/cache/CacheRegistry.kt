@@ -0,0 +1,76 @@
+package com.hx.nekomimi.cache
+
+import android.content.ComponentCallbacks2
+import android.util.Log
+import java.util.concurrent.CopyOnWriteArrayList
+
+/**
+ * 进程内存缓存的统一登记处
+ *
+ * 各缓存在 [com.hx.nekomimi.NekoMimiApp] 中注册，声明大小和优先级；
+ * 收到 onTrimMemory 时按优先级从低到高依次裁剪：界面不可见时先丢封面，
+ * 进入后台 LRU 后再裁字幕，只有即将被杀时才动当前播放依赖的数据，
+ * 让小内存设备上息屏听书的进程尽量不被回收。
+ */
+object CacheRegistry {
+
+    private const val TAG = "CacheRegistry"
+
+    private val caches = CopyOnWriteArrayList<TrimmableCache>()
+
+    class Stat(val name: String, val priority: CachePriority, val sizeBytes: Long, val maxSizeBytes: Long)
+
+    /** 最近一次收到的裁剪级别（调试页显示），未收到时为 -1 */
+    @Volatile
+    var lastTrimLevel: Int = -1
+        private set
+
+    @Volatile
+    var lastTrimAt: Long = 0L
+        private set
+
+    fun register(cache: TrimmableCache) {
+        caches.addIfAbsent(cache)
+    }
+
+    fun unregister(cache: TrimmableCache) {
+        caches.remove(cache)
+    }
+
+    /** 各缓存当前占用，按裁剪顺序排列 */
+    fun stats(): List<Stat> = caches.sortedBy { it.priority }
+        .map { Stat(it.name, it.priority, it.sizeBytes(), it.maxSizeBytes()) }
+
+    fun onTrimMemory(level: Int) {
+        lastTrimLevel = level
+        lastTrimAt = System.currentTimeMillis()
+
+        val retained = retainedFractions(level)
+        for (cache in caches.sortedBy { it.priority }) {
+            val fraction = retained[cache.priority.ordinal]
+            if (fraction >= 1f) continue
+            val before = cache.sizeBytes()
+            try {
+                cache.trimTo(fraction)
+            } catch (e: Exception) {
+                Log.w(TAG, "裁剪缓存失败: ${cache.name}", e)
+            }
+            Log.d(TAG, "level=$level ${cache.name}: $before -> ${cache.sizeBytes()} 字节")
+        }
+    }
+
+    /**
+     * 各优先级（LOW / NORMAL / HIGH）保留的比例，1 表示不裁剪
+     */
+    @Suppress("DEPRECATION")
+    private fun retainedFractions(level: Int): FloatArray = when {
+        level >= ComponentCallbacks2.TRIM_MEMORY_COMPLETE -> floatArrayOf(0f, 0f, 0f)
+        level >= ComponentCallbacks2.TRIM_MEMORY_MODERATE -> floatArrayOf(0f, 0f, 0.5f)
+        level >= ComponentCallbacks2.TRIM_MEMORY_BACKGROUND -> floatArrayOf(0f, 0.5f, 1f)
+        level >= ComponentCallbacks2.TRIM_MEMORY_UI_HIDDEN -> floatArrayOf(0f, 1f, 1f)
+        level >= ComponentCallbacks2.TRIM_MEMORY_RUNNING_CRITICAL -> floatArrayOf(0f, 0f, 0.5f)
+        level >= ComponentCallbacks2.TRIM_MEMORY_RUNNING_LOW -> floatArrayOf(0f, 0.5f, 1f)
+        level >= ComponentCallbacks2.TRIM_MEMORY_RUNNING_MODERATE -> floatArrayOf(0.5f, 1f, 1f)
+        else -> floatArrayOf(1f, 1f, 1f)
+    }
+}
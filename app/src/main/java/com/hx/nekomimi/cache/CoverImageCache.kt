@@ -0,0 +1,56 @@
+package com.hx.nekomimi.cache
+
+import android.content.ComponentCallbacks2
+import android.content.Context
+import com.bumptech.glide.Glide
+import com.bumptech.glide.GlideBuilder
+import com.bumptech.glide.load.engine.bitmap_recycle.LruBitmapPool
+import com.bumptech.glide.load.engine.cache.LruResourceCache
+import com.bumptech.glide.load.engine.cache.MemorySizeCalculator
+
+/**
+ * 封面缩略图（Glide 的内存缓存 + Bitmap 复用池）
+ *
+ * 用 Glide 默认算出的容量自行创建两级缓存并交给 Glide，这样才能读到实时占用；
+ * 需要在第一次使用 Glide 之前调用 [install]。
+ */
+class CoverImageCache private constructor(
+    private val memoryCache: LruResourceCache,
+    private val bitmapPool: LruBitmapPool
+) : TrimmableCache {
+
+    override val name = "封面缩略图"
+    override val priority = CachePriority.LOW
+
+    override fun sizeBytes(): Long = memoryCache.currentSize + bitmapPool.currentSize
+
+    override fun maxSizeBytes(): Long = memoryCache.maxSize + bitmapPool.maxSize
+
+    override fun trimTo(fraction: Float) {
+        if (fraction <= 0f) {
+            memoryCache.clearMemory()
+            bitmapPool.clearMemory()
+        } else if (fraction < 1f) {
+            // Glide 的缓存只支持按级别裁剪，UI_HIDDEN 对应裁到容量的一半
+            memoryCache.trimMemory(ComponentCallbacks2.TRIM_MEMORY_UI_HIDDEN)
+            bitmapPool.trimMemory(ComponentCallbacks2.TRIM_MEMORY_UI_HIDDEN)
+        }
+    }
+
+    companion object {
+        fun install(context: Context): CoverImageCache {
+            val sizes = MemorySizeCalculator.Builder(context).build()
+            val cache = CoverImageCache(
+                LruResourceCache(sizes.memoryCacheSize.toLong()),
+                LruBitmapPool(sizes.bitmapPoolSize.toLong())
+            )
+            Glide.init(
+                context,
+                GlideBuilder()
+                    .setMemoryCache(cache.memoryCache)
+                    .setBitmapPool(cache.bitmapPool)
+            )
+            return cache
+        }
+    }
+}
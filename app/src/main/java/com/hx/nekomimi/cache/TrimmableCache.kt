@@ -0,0 +1,37 @@
+package com.hx.nekomimi.cache
+
+/**
+ * 可按内存压力裁剪的内存缓存，注册到 [CacheRegistry] 后由系统的 onTrimMemory 统一调度
+ */
+interface TrimmableCache {
+
+    /** 调试页显示的名称 */
+    val name: String
+
+    val priority: CachePriority
+
+    /** 当前占用（字节，可以是估算值） */
+    fun sizeBytes(): Long
+
+    /** 容量上限（字节） */
+    fun maxSizeBytes(): Long
+
+    /**
+     * 裁剪到当前占用的 [fraction]（0 表示清空）
+     */
+    fun trimTo(fraction: Float)
+}
+
+/**
+ * 裁剪顺序：越靠前越先被清理
+ */
+enum class CachePriority(val label: String) {
+    /** 可以从磁盘缓存快速恢复（封面缩略图） */
+    LOW("低"),
+
+    /** 需要重新读取、解析（字幕时间轴） */
+    NORMAL("中"),
+
+    /** 当前播放依赖的数据，只在内存极度紧张时裁剪 */
+    HIGH("高")
+}
@@ -0,0 +1,20 @@
+package com.hx.nekomimi.chapter
+
+/**
+ * 单文件有声书内部的章节标记
+ * @param title 章节标题（可能为空）
+ * @param startMs 章节在文件中的起始时间
+ */
+data class ChapterMarker(
+    val title: String,
+    val startMs: Long
+)
+
+/**
+ * 一个音频文件的全部章节标记
+ * @param durationMs 文件总时长（未知时为 0）
+ */
+data class ChapterMarkers(
+    val markers: List<ChapterMarker>,
+    val durationMs: Long = 0L
+)
@@ -0,0 +1,109 @@
+package com.hx.nekomimi.chapter
+
+import java.nio.ByteBuffer
+import java.nio.charset.CharacterCodingException
+import java.nio.charset.Charset
+import java.nio.charset.CodingErrorAction
+
+/**
+ * CUE 索引表解析器
+ *
+ * CUE 格式示例:
+ * ```
+ * FILE "book.mp3" MP3
+ *   TRACK 01 AUDIO
+ *     TITLE "第一章"
+ *     INDEX 01 00:00:00
+ *   TRACK 02 AUDIO
+ *     TITLE "第二章"
+ *     INDEX 01 23:41:37
+ * ```
+ * INDEX 时间格式为 分:秒:帧（每秒 75 帧）
+ */
+object CueSheetParser {
+
+    /**
+     * @param fileName FILE 行引用的音频文件名
+     */
+    data class CueTrack(
+        val fileName: String,
+        val title: String,
+        val startMs: Long
+    )
+
+    private val indexPattern = Regex("""INDEX\s+01\s+(\d+):(\d{1,2}):(\d{1,2})""", RegexOption.IGNORE_CASE)
+
+    fun parse(content: String): List<CueTrack> {
+        val tracks = mutableListOf<CueTrack>()
+        var fileName: String? = null
+        var inTrack = false
+        var title = ""
+
+        for (raw in content.lines()) {
+            val line = raw.trim()
+            val keyword = line.substringBefore(' ').uppercase()
+            when (keyword) {
+                "FILE" -> {
+                    fileName = unquote(line.substringAfter(' ').substringBeforeLast(' '))
+                    inTrack = false
+                }
+                "TRACK" -> {
+                    inTrack = true
+                    title = ""
+                }
+                "TITLE" -> if (inTrack) title = unquote(line.substringAfter(' '))
+                "INDEX" -> {
+                    val match = indexPattern.find(line) ?: continue
+                    val file = fileName ?: continue
+                    if (!inTrack) continue
+                    val (m, s, f) = match.destructured
+                    val startMs = m.toLong() * 60_000 + s.toLong() * 1000 + f.toLong() * 1000 / 75
+                    tracks.add(CueTrack(file, title, startMs))
+                    inTrack = false // 每个 TRACK 只取 INDEX 01
+                }
+            }
+        }
+        return tracks
+    }
+
+    /**
+     * 按音频文件分组，返回与 [audioFileName] 匹配的章节标记
+     *
+     * CUE 中的文件名经常与实际文件的扩展名不一致（例如抓轨时为 .wav，之后转成了 .mp3），
+     * 因此按去掉扩展名后的文件名（忽略大小写）匹配；CUE 只引用一个文件时，
+     * 只要 CUE 与音频同名也视为匹配。
+     */
+    fun markersFor(tracks: List<CueTrack>, audioFileName: String, cueFileName: String): List<ChapterMarker> {
+        val audioBase = baseName(audioFileName)
+        val files = tracks.map { it.fileName }.distinct()
+        val matched = tracks.filter { baseName(it.fileName).equals(audioBase, ignoreCase = true) }
+            .ifEmpty {
+                if (files.size == 1 && baseName(cueFileName).equals(audioBase, ignoreCase = true)) tracks
+                else emptyList()
+            }
+        return matched.map { ChapterMarker(it.title, it.startMs) }.sortedBy { it.startMs }
+    }
+
+    /**
+     * CUE 文件常见 GBK / Shift-JIS 等本地编码：先按 UTF-8 严格解码，失败时回落到 GB18030
+     */
+    fun decode(bytes: ByteArray): String {
+        if (bytes.size >= 3 && bytes[0] == 0xEF.toByte() && bytes[1] == 0xBB.toByte() && bytes[2] == 0xBF.toByte()) {
+            return String(bytes, 3, bytes.size - 3, Charsets.UTF_8)
+        }
+        return try {
+            Charsets.UTF_8.newDecoder()
+                .onMalformedInput(CodingErrorAction.REPORT)
+                .onUnmappableCharacter(CodingErrorAction.REPORT)
+                .decode(ByteBuffer.wrap(bytes))
+                .toString()
+        } catch (e: CharacterCodingException) {
+            String(bytes, Charset.forName("GB18030"))
+        }
+    }
+
+    private fun baseName(path: String): String =
+        path.substringAfterLast('/').substringAfterLast('\\').substringBeforeLast('.')
+
+    private fun unquote(value: String): String = value.trim().removeSurrounding("\"")
+}
@@ -0,0 +1,307 @@
+package com.hx.nekomimi.chapter
+
+import android.content.Context
+import android.net.Uri
+import android.util.Log
+import java.io.FileInputStream
+import java.io.IOException
+import java.nio.ByteBuffer
+import java.nio.channels.FileChannel
+import kotlin.math.min
+
+/**
+ * M4B / M4A 章节读取
+ *
+ * 支持两种章节格式：
+ * - QuickTime 章节轨道（tref/chap 指向的文本轨道），iTunes / Apple Books 使用
+ * - Nero 章节（moov/udta/chpl），多数转换工具使用
+ *
+ * 只按 box 头部跳转并读取需要的叶子 box（mvhd、tkhd、mdhd、hdlr、样本表和章节文本样本），
+ * 不会读取音频数据；文件描述符不支持随机访问时（部分网络 Provider）直接放弃。
+ */
+class Mp4ChapterReader private constructor(private val channel: FileChannel) {
+
+    private class Box(val type: String, val start: Long, val headerSize: Int, val size: Long) {
+        val contentStart: Long get() = start + headerSize
+        val end: Long get() = start + size
+    }
+
+    private class Track(val box: Box) {
+        var trackId = 0
+        var timescale = 0L
+        var handler = ""
+        var chapterTrackIds = IntArray(0)
+        var stbl: Box? = null
+    }
+
+    private fun read(): ChapterMarkers? {
+        val moov = children(0, channel.size()).firstOrNull { it.type == "moov" } ?: return null
+
+        var durationMs = 0L
+        var neroChapters: List<ChapterMarker> = emptyList()
+        val tracks = mutableListOf<Track>()
+
+        for (box in children(moov.contentStart, moov.end)) {
+            when (box.type) {
+                "mvhd" -> durationMs = readMovieDurationMs(box)
+                "udta" -> children(box.contentStart, box.end).firstOrNull { it.type == "chpl" }
+                    ?.let { neroChapters = readNeroChapters(it) }
+                "trak" -> tracks.add(readTrack(box))
+            }
+        }
+
+        // 优先使用 QuickTime 章节轨道（时间精度更高），其次 Nero 章节
+        val referenced = tracks.flatMap { it.chapterTrackIds.asList() }.toSet()
+        val chapterTrack = tracks.firstOrNull { it.trackId in referenced && it.handler in TEXT_HANDLERS }
+        val quickTimeChapters = chapterTrack?.let { readTextTrack(it) }.orEmpty()
+
+        val markers = quickTimeChapters.ifEmpty { neroChapters }
+        if (markers.isEmpty()) return null
+        return ChapterMarkers(markers.sortedBy { it.startMs }, durationMs)
+    }
+
+    // ========== box 遍历 ==========
+
+    private fun readBytes(position: Long, size: Int): ByteBuffer {
+        val buffer = ByteBuffer.allocate(size)
+        var offset = position
+        while (buffer.hasRemaining()) {
+            val n = channel.read(buffer, offset)
+            if (n < 0) throw IOException("意外的文件结尾")
+            offset += n
+        }
+        buffer.flip()
+        return buffer
+    }
+
+    private fun readBox(box: Box, limit: Int = MAX_LEAF_BOX_SIZE): ByteBuffer {
+        val size = box.size - box.headerSize
+        if (size > limit) throw IOException("${box.type} 过大: $size")
+        return readBytes(box.contentStart, size.toInt())
+    }
+
+    private fun children(start: Long, end: Long): Sequence<Box> = sequence {
+        var position = start
+        while (position + 8 <= end) {
+            val header = readBytes(position, 8)
+            var size = header.int.toLong() and 0xFFFFFFFFL
+            val type = String(ByteArray(4).also { header.get(it) }, Charsets.ISO_8859_1)
+            var headerSize = 8
+            when (size) {
+                1L -> {
+                    size = readBytes(position + 8, 8).long
+                    headerSize = 16
+                }
+                0L -> size = end - position
+            }
+            if (size < headerSize || position + size > end) break
+            yield(Box(type, position, headerSize, size))
+            position += size
+        }
+    }
+
+    private fun findPath(box: Box, vararg path: String): Box? {
+        var current = box
+        for (type in path) {
+            current = children(current.contentStart, current.end).firstOrNull { it.type == type } ?: return null
+        }
+        return current
+    }
+
+    // ========== 叶子 box 解析 ==========
+
+    private fun readMovieDurationMs(mvhd: Box): Long {
+        val b = readBox(mvhd)
+        val version = b.get().toInt()
+        b.position(4)
+        val timescale: Long
+        val duration: Long
+        if (version == 1) {
+            b.position(b.position() + 16)
+            timescale = b.int.toLong() and 0xFFFFFFFFL
+            duration = b.long
+        } else {
+            b.position(b.position() + 8)
+            timescale = b.int.toLong() and 0xFFFFFFFFL
+            duration = b.int.toLong() and 0xFFFFFFFFL
+        }
+        return if (timescale > 0) duration * 1000 / timescale else 0L
+    }
+
+    /**
+     * Nero chpl：version(1) flags(3) [reserved(4), v1] count(1)
+     * 每条：start(8, 100ns 单位) titleLength(1) title(UTF-8)
+     */
+    private fun readNeroChapters(chpl: Box): List<ChapterMarker> {
+        val b = readBox(chpl)
+        val version = b.get().toInt()
+        b.position(4)
+        if (version == 1) b.position(b.position() + 4)
+        val count = b.get().toInt() and 0xFF
+        val result = mutableListOf<ChapterMarker>()
+        repeat(count) {
+            if (b.remaining() < 9) return result
+            val start = b.long
+            val length = b.get().toInt() and 0xFF
+            if (b.remaining() < length) return result
+            val title = ByteArray(length).also { b.get(it) }.toString(Charsets.UTF_8)
+            result.add(ChapterMarker(title.trim(), start / 10_000))
+        }
+        return result
+    }
+
+    private fun readTrack(trak: Box): Track {
+        val track = Track(trak)
+        for (box in children(trak.contentStart, trak.end)) {
+            when (box.type) {
+                "tkhd" -> {
+                    val b = readBox(box)
+                    val version = b.get().toInt()
+                    b.position(if (version == 1) 4 + 16 else 4 + 8)
+                    track.trackId = b.int
+                }
+                "tref" -> children(box.contentStart, box.end).firstOrNull { it.type == "chap" }?.let { chap ->
+                    val b = readBox(chap)
+                    track.chapterTrackIds = IntArray(b.remaining() / 4) { b.int }
+                }
+                "mdia" -> for (child in children(box.contentStart, box.end)) {
+                    when (child.type) {
+                        "mdhd" -> {
+                            val b = readBox(child)
+                            val version = b.get().toInt()
+                            b.position(if (version == 1) 4 + 16 else 4 + 8)
+                            track.timescale = b.int.toLong() and 0xFFFFFFFFL
+                        }
+                        "hdlr" -> {
+                            val b = readBox(child)
+                            b.position(8)
+                            track.handler = String(ByteArray(4).also { b.get(it) }, Charsets.ISO_8859_1)
+                        }
+                        "minf" -> track.stbl = findPath(child, "stbl")
+                    }
+                }
+            }
+        }
+        return track
+    }
+
+    /**
+     * 读取文本章节轨道：样本时间来自 stts，样本位置来自 stsc + stco/co64 + stsz，
+     * 每个样本为 u16 长度 + 文本
+     */
+    private fun readTextTrack(track: Track): List<ChapterMarker> {
+        val stbl = track.stbl ?: return emptyList()
+        if (track.timescale <= 0) return emptyList()
+
+        var stts: ByteBuffer? = null
+        var stsc: ByteBuffer? = null
+        var stsz: ByteBuffer? = null
+        var chunkOffsets = LongArray(0)
+        for (box in children(stbl.contentStart, stbl.end)) {
+            when (box.type) {
+                "stts" -> stts = readBox(box)
+                "stsc" -> stsc = readBox(box)
+                "stsz" -> stsz = readBox(box)
+                "stco" -> readBox(box).let { b ->
+                    b.position(4)
+                    chunkOffsets = LongArray(b.int) { b.int.toLong() and 0xFFFFFFFFL }
+                }
+                "co64" -> readBox(box).let { b ->
+                    b.position(4)
+                    chunkOffsets = LongArray(b.int) { b.long }
+                }
+            }
+        }
+        if (stts == null || stsc == null || stsz == null || chunkOffsets.isEmpty()) return emptyList()
+
+        // 样本开始时间
+        stts.position(4)
+        val times = mutableListOf<Long>()
+        var time = 0L
+        repeat(stts.int) {
+            val count = stts.int
+            val delta = stts.int.toLong() and 0xFFFFFFFFL
+            repeat(min(count, MAX_CHAPTERS - times.size)) {
+                times.add(time)
+                time += delta
+            }
+        }
+
+        // 样本大小
+        stsz.position(4)
+        val uniformSize = stsz.int
+        val sampleCount = min(stsz.int, times.size)
+        val sizes = IntArray(sampleCount) { if (uniformSize != 0) uniformSize else stsz.int }
+
+        // 样本偏移：按 chunk 展开 stsc
+        stsc.position(4)
+        val entries = stsc.int
+        val firstChunks = IntArray(entries)
+        val samplesPerChunk = IntArray(entries)
+        for (i in 0 until entries) {
+            firstChunks[i] = stsc.int
+            samplesPerChunk[i] = stsc.int
+            stsc.int // sample description index
+        }
+        val offsets = LongArray(sampleCount)
+        var sample = 0
+        var entry = 0
+        for (chunk in chunkOffsets.indices) {
+            if (sample >= sampleCount) break
+            while (entry + 1 < entries && firstChunks[entry + 1] <= chunk + 1) entry++
+            var offset = chunkOffsets[chunk]
+            repeat(if (entries > 0) samplesPerChunk[entry] else 0) {
+                if (sample < sampleCount) {
+                    offsets[sample] = offset
+                    offset += sizes[sample]
+                    sample++
+                }
+            }
+        }
+
+        val result = mutableListOf<ChapterMarker>()
+        for (i in 0 until sample) {
+            val size = sizes[i]
+            if (size < 2 || size > MAX_TITLE_SAMPLE_SIZE) continue
+            val b = readBytes(offsets[i], size)
+            val length = min(b.short.toInt() and 0xFFFF, b.remaining())
+            val bytes = ByteArray(length).also { b.get(it) }
+            result.add(ChapterMarker(decodeTitle(bytes), times[i] * 1000 / track.timescale))
+        }
+        return result
+    }
+
+    private fun decodeTitle(bytes: ByteArray): String {
+        val utf16 = bytes.size >= 2 &&
+            ((bytes[0] == 0xFE.toByte() && bytes[1] == 0xFF.toByte()) ||
+                (bytes[0] == 0xFF.toByte() && bytes[1] == 0xFE.toByte()))
+        return (if (utf16) String(bytes, Charsets.UTF_16) else String(bytes, Charsets.UTF_8)).trim()
+    }
+
+    companion object {
+        private const val TAG = "Mp4ChapterReader"
+
+        private val TEXT_HANDLERS = setOf("text", "sbtl")
+
+        /** 叶子 box 读取上限，防止损坏文件导致超大分配 */
+        private const val MAX_LEAF_BOX_SIZE = 4 shl 20
+        private const val MAX_CHAPTERS = 10_000
+        private const val MAX_TITLE_SAMPLE_SIZE = 4096
+
+        /**
+         * 读取章节；没有章节或无法读取时返回 null
+         */
+        fun read(context: Context, uri: Uri): ChapterMarkers? {
+            return try {
+                context.contentResolver.openFileDescriptor(uri, "r")?.use { pfd ->
+                    FileInputStream(pfd.fileDescriptor).channel.use { channel ->
+                        Mp4ChapterReader(channel).read()
+                    }
+                }
+            } catch (e: Exception) {
+                Log.w(TAG, "读取章节失败: $uri", e)
+                null
+            }
+        }
+    }
+}
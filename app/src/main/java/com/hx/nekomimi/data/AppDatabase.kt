@@ -7,13 +7,25 @@ import androidx.room.RoomDatabase
 import com.hx.nekomimi.data.dao.BookDao
 import com.hx.nekomimi.data.dao.ChapterDao
 import com.hx.nekomimi.data.dao.PlaybackProgressDao
+import com.hx.nekomimi.data.dao.SearchDao
+import com.hx.nekomimi.data.dao.SubtitleTrackDao
+import com.hx.nekomimi.data.dao.TranscriptionJobDao
+import com.hx.nekomimi.data.entity.ArchivedProgress
 import com.hx.nekomimi.data.entity.Book
 import com.hx.nekomimi.data.entity.Chapter
 import com.hx.nekomimi.data.entity.PlaybackProgress
+import com.hx.nekomimi.data.entity.SearchEntry
+import com.hx.nekomimi.data.entity.SubtitleTrack
+import com.hx.nekomimi.data.entity.TranscriptionJob
+import com.hx.nekomimi.data.model.BookWithStats
 
 @Database(
-    entities = [Book::class, Chapter::class, PlaybackProgress::class],
-    version = 1,
+    entities = [
+        Book::class, Chapter::class, PlaybackProgress::class, TranscriptionJob::class, SubtitleTrack::class,
+        ArchivedProgress::class, SearchEntry::class
+    ],
+    views = [BookWithStats::class],
+    version = 8,
     exportSchema = false
 )
 abstract class AppDatabase : RoomDatabase() {
@@ -21,6 +33,9 @@ abstract class AppDatabase : RoomDatabase() {
     abstract fun bookDao(): BookDao
     abstract fun chapterDao(): ChapterDao
     abstract fun playbackProgressDao(): PlaybackProgressDao
+    abstract fun transcriptionJobDao(): TranscriptionJobDao
+    abstract fun subtitleTrackDao(): SubtitleTrackDao
+    abstract fun searchDao(): SearchDao
 
     companion object {
         @Volatile
@@ -33,6 +48,9 @@ abstract class AppDatabase : RoomDatabase() {
                     AppDatabase::class.java,
                     "nekomimi.db"
                 )
+                    .addMigrations(*Migrations.ALL)
+                    // 播放服务可运行在独立进程，两边的 Flow / LiveData 查询需要互相感知写入
+                    .enableMultiInstanceInvalidation()
                     .fallbackToDestructiveMigration()
                     .build()
                 INSTANCE = instance
@@ -0,0 +1,135 @@
+package com.hx.nekomimi.data
+
+import android.content.ContentValues
+import android.database.sqlite.SQLiteDatabase
+import androidx.room.migration.Migration
+import androidx.sqlite.db.SupportSQLiteDatabase
+import com.hx.nekomimi.data.entity.Book
+import com.hx.nekomimi.data.entity.Chapter
+import com.hx.nekomimi.data.entity.SearchEntry
+import com.hx.nekomimi.data.model.BookWithStats
+import com.hx.nekomimi.search.SearchIndex
+
+/**
+ * 数据库迁移
+ * 书架、章节和播放进度都是用户数据，升级时必须保留，不能依赖破坏性迁移
+ */
+object Migrations {
+
+    /** v2: 离线字幕转写任务表 */
+    val MIGRATION_1_2 = object : Migration(1, 2) {
+        override fun migrate(db: SupportSQLiteDatabase) {
+            db.execSQL("""
+                CREATE TABLE IF NOT EXISTS `transcription_jobs` (
+                    `chapterId` INTEGER NOT NULL,
+                    `bookId` INTEGER NOT NULL,
+                    `state` INTEGER NOT NULL,
+                    `processedMs` INTEGER NOT NULL,
+                    `durationMs` INTEGER NOT NULL,
+                    `threads` INTEGER NOT NULL,
+                    `realTimeFactor` REAL NOT NULL,
+                    `error` TEXT,
+                    `updatedAt` INTEGER NOT NULL,
+                    PRIMARY KEY(`chapterId`),
+                    FOREIGN KEY(`chapterId`) REFERENCES `chapters`(`id`) ON UPDATE NO ACTION ON DELETE CASCADE
+                )
+            """.trimIndent())
+            db.execSQL("CREATE INDEX IF NOT EXISTS `index_transcription_jobs_bookId` ON `transcription_jobs` (`bookId`)")
+            db.execSQL("CREATE INDEX IF NOT EXISTS `index_transcription_jobs_state` ON `transcription_jobs` (`state`)")
+        }
+    }
+
+    /** v3: 章节字幕同步偏移 / 漂移 */
+    val MIGRATION_2_3 = object : Migration(2, 3) {
+        override fun migrate(db: SupportSQLiteDatabase) {
+            db.execSQL("ALTER TABLE `chapters` ADD COLUMN `subtitleOffsetMs` INTEGER NOT NULL DEFAULT 0")
+            db.execSQL("ALTER TABLE `chapters` ADD COLUMN `subtitleDriftPpm` REAL NOT NULL DEFAULT 0")
+        }
+    }
+
+    /** v4: 虚拟章节（单文件有声书）的起止时间 */
+    val MIGRATION_3_4 = object : Migration(3, 4) {
+        override fun migrate(db: SupportSQLiteDatabase) {
+            db.execSQL("ALTER TABLE `chapters` ADD COLUMN `startMs` INTEGER NOT NULL DEFAULT 0")
+            db.execSQL("ALTER TABLE `chapters` ADD COLUMN `endMs` INTEGER NOT NULL DEFAULT 0")
+        }
+    }
+
+    /** v5: 多字幕轨道索引，以及章节的第二字幕（双语显示） */
+    val MIGRATION_4_5 = object : Migration(4, 5) {
+        override fun migrate(db: SupportSQLiteDatabase) {
+            db.execSQL("""
+                CREATE TABLE IF NOT EXISTS `subtitle_tracks` (
+                    `id` INTEGER PRIMARY KEY AUTOINCREMENT NOT NULL,
+                    `bookId` INTEGER NOT NULL,
+                    `audioUri` TEXT NOT NULL,
+                    `uri` TEXT NOT NULL,
+                    `language` TEXT NOT NULL,
+                    `format` TEXT NOT NULL,
+                    `label` TEXT NOT NULL,
+                    FOREIGN KEY(`bookId`) REFERENCES `books`(`id`) ON UPDATE NO ACTION ON DELETE CASCADE
+                )
+            """.trimIndent())
+            db.execSQL("CREATE INDEX IF NOT EXISTS `index_subtitle_tracks_bookId_audioUri` ON `subtitle_tracks` (`bookId`, `audioUri`)")
+            db.execSQL("ALTER TABLE `chapters` ADD COLUMN `secondarySubtitleUri` TEXT")
+        }
+    }
+
+    /** v6: 书架读模型视图，以及最近播放查询用的 updatedAt 索引 */
+    val MIGRATION_5_6 = object : Migration(5, 6) {
+        override fun migrate(db: SupportSQLiteDatabase) {
+            db.execSQL("CREATE INDEX IF NOT EXISTS `index_playback_progress_updatedAt` ON `playback_progress` (`updatedAt`)")
+            db.execSQL("CREATE VIEW `${BookWithStats.VIEW_NAME}` AS ${BookWithStats.QUERY}")
+        }
+    }
+
+    /** v7: 章节内容指纹，以及删除书籍时的播放进度存档 */
+    val MIGRATION_6_7 = object : Migration(6, 7) {
+        override fun migrate(db: SupportSQLiteDatabase) {
+            db.execSQL("ALTER TABLE `chapters` ADD COLUMN `contentHash` TEXT")
+            db.execSQL("CREATE INDEX IF NOT EXISTS `index_chapters_contentHash` ON `chapters` (`contentHash`)")
+            db.execSQL("""
+                CREATE TABLE IF NOT EXISTS `archived_progress` (
+                    `contentHash` TEXT NOT NULL,
+                    `startMs` INTEGER NOT NULL,
+                    `positionMs` INTEGER NOT NULL,
+                    `updatedAt` INTEGER NOT NULL,
+                    PRIMARY KEY(`contentHash`, `startMs`)
+                )
+            """.trimIndent())
+        }
+    }
+
+    /** v8: 全书库搜索索引（FTS4），按现有书籍和章节建立 */
+    val MIGRATION_7_8 = object : Migration(7, 8) {
+        override fun migrate(db: SupportSQLiteDatabase) {
+            db.execSQL(SearchEntry.CREATE_SQL)
+            val books = db.query("SELECT `id`, `name`, `rootUri` FROM `books`").use { cursor ->
+                generateSequence { if (cursor.moveToNext()) cursor else null }
+                    .map { Book(id = it.getLong(0), name = it.getString(1), rootUri = it.getString(2)) }
+                    .toList()
+            }
+            for (book in books) {
+                val chapters = db.query(
+                    "SELECT `id`, `title`, `parentFolder` FROM `chapters` WHERE `bookId` = ?", arrayOf(book.id)
+                ).use { cursor ->
+                    generateSequence { if (cursor.moveToNext()) cursor else null }
+                        .map { Chapter(id = it.getLong(0), bookId = book.id, title = it.getString(1), parentFolder = it.getString(2)) }
+                        .toList()
+                }
+                (listOf(SearchIndex.bookEntry(book)) + SearchIndex.chapterEntries(book, chapters)).forEach { entry ->
+                    db.insert(SearchEntry.TABLE_NAME, SQLiteDatabase.CONFLICT_NONE, ContentValues().apply {
+                        put("bookId", entry.bookId)
+                        put("chapterId", entry.chapterId)
+                        put("terms", entry.terms)
+                        put("tags", entry.tags)
+                    })
+                }
+            }
+        }
+    }
+
+    val ALL: Array<Migration> = arrayOf(
+        MIGRATION_1_2, MIGRATION_2_3, MIGRATION_3_4, MIGRATION_4_5, MIGRATION_5_6, MIGRATION_6_7, MIGRATION_7_8
+    )
+}
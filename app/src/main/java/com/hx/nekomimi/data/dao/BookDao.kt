@@ -3,6 +3,7 @@ package com.hx.nekomimi.data.dao
 import androidx.lifecycle.LiveData
 import androidx.room.*
 import com.hx.nekomimi.data.entity.Book
+import com.hx.nekomimi.data.model.BookWithStats
 
 @Dao
 interface BookDao {
@@ -13,6 +14,12 @@ interface BookDao {
     @Query("SELECT * FROM books ORDER BY createdAt DESC")
     suspend fun getAllBooksList(): List<Book>
 
+    /**
+     * 书架（带章节数和最近播放时间）
+     */
+    @Query("SELECT * FROM book_stats ORDER BY createdAt DESC")
+    fun getAllBooksWithStats(): LiveData<List<BookWithStats>>
+
     @Query("SELECT * FROM books WHERE id = :bookId")
     suspend fun getBookById(bookId: Long): Book?
 
@@ -3,6 +3,8 @@ package com.hx.nekomimi.data.dao
 import androidx.lifecycle.LiveData
 import androidx.room.*
 import com.hx.nekomimi.data.entity.Chapter
+import com.hx.nekomimi.data.model.ChapterWithProgress
+import kotlinx.coroutines.flow.Flow
 
 @Dao
 interface ChapterDao {
@@ -16,6 +18,10 @@ interface ChapterDao {
     @Query("SELECT * FROM chapters WHERE id = :chapterId")
     suspend fun getChapterById(chapterId: Long): Chapter?
 
+    /** 章节变化时（切换字幕轨道、调整同步）重新发出 */
+    @Query("SELECT * FROM chapters WHERE id = :chapterId")
+    fun observeChapter(chapterId: Long): Flow<Chapter?>
+
     @Insert(onConflict = OnConflictStrategy.REPLACE)
     suspend fun insertAll(chapters: List<Chapter>)
 
@@ -25,18 +31,43 @@ interface ChapterDao {
     @Update
     suspend fun update(chapter: Chapter)
 
+    /** 原地更新（不同于 REPLACE 插入，不会级联删除进度和转写任务） */
+    @Update
+    suspend fun updateAll(chapters: List<Chapter>)
+
+    @Query("UPDATE chapters SET subtitleOffsetMs = :offsetMs, subtitleDriftPpm = :driftPpm WHERE id = :chapterId")
+    suspend fun updateSubtitleSync(chapterId: Long, offsetMs: Long, driftPpm: Float)
+
+    /** 同一音频文件拆出的虚拟章节共享字幕 */
+    @Query("UPDATE chapters SET subtitleUri = :subtitleUri WHERE fileUri = :fileUri")
+    suspend fun updateSubtitleUriByFileUri(fileUri: String, subtitleUri: String)
+
+    @Query("UPDATE chapters SET subtitleUri = :subtitleUri, secondarySubtitleUri = :secondarySubtitleUri WHERE fileUri = :fileUri")
+    suspend fun updateSubtitleSelection(fileUri: String, subtitleUri: String?, secondarySubtitleUri: String?)
+
     @Delete
     suspend fun delete(chapter: Chapter)
 
+    /**
+     * 本书中与其他书籍内容相同（指纹一致）的章节 ID
+     */
+    @Query("""
+        SELECT c.id FROM chapters c
+        WHERE c.bookId = :bookId AND c.contentHash IS NOT NULL
+            AND EXISTS (SELECT 1 FROM chapters o WHERE o.contentHash = c.contentHash AND o.bookId != c.bookId)
+    """)
+    fun getDuplicateChapterIdsLive(bookId: Long): LiveData<List<Long>>
+
     @Query("DELETE FROM chapters WHERE bookId = :bookId")
     suspend fun deleteByBookId(bookId: Long)
 
-    @Query("SELECT COUNT(*) FROM chapters WHERE bookId = :bookId")
-    suspend fun getChapterCount(bookId: Long): Int
+    @Query("DELETE FROM chapters WHERE id IN (:chapterIds)")
+    suspend fun deleteByIds(chapterIds: List<Long>)
 
     /**
-     * 监听章节表的整体变化（用于触发主页刷新）
+     * 章节及其播放进度、字幕轨道（一次事务内读取）
      */
-    @Query("SELECT COUNT(*) FROM chapters")
-    fun observeTotalChapterCount(): LiveData<Int>
+    @Transaction
+    @Query("SELECT * FROM chapters WHERE id = :chapterId")
+    suspend fun getChapterWithProgress(chapterId: Long): ChapterWithProgress?
 }
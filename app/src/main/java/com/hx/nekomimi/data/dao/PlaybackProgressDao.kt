@@ -2,7 +2,10 @@ package com.hx.nekomimi.data.dao
 
 import androidx.lifecycle.LiveData
 import androidx.room.*
+import com.hx.nekomimi.data.entity.ArchivedProgress
 import com.hx.nekomimi.data.entity.PlaybackProgress
+import com.hx.nekomimi.data.model.ProgressWithChapter
+import com.hx.nekomimi.data.model.RecentlyPlayed
 
 @Dao
 interface PlaybackProgressDao {
@@ -13,6 +16,17 @@ interface PlaybackProgressDao {
     @Query("SELECT * FROM playback_progress WHERE bookId = :bookId")
     fun getProgressByBookIdLive(bookId: Long): LiveData<PlaybackProgress?>
 
+    /**
+     * 本书播放进度及所在章节
+     */
+    @Transaction
+    @Query("SELECT * FROM playback_progress WHERE bookId = :bookId")
+    fun getProgressWithChapterLive(bookId: Long): LiveData<ProgressWithChapter?>
+
+    @Transaction
+    @Query("SELECT * FROM playback_progress WHERE bookId = :bookId")
+    suspend fun getProgressWithChapter(bookId: Long): ProgressWithChapter?
+
     /**
      * 获取最近播放的记录（按更新时间降序）
      */
@@ -22,6 +36,24 @@ interface PlaybackProgressDao {
     @Query("SELECT * FROM playback_progress ORDER BY updatedAt DESC LIMIT 1")
     fun getLastPlayedProgressLive(): LiveData<PlaybackProgress?>
 
+    /**
+     * 最近播放的书籍（主页书架）
+     * 按 updatedAt 索引取前 N 条，章节标题、序号和章节数在同一查询中关联，不需要逐项再查
+     */
+    @Query("""
+        SELECT p.bookId, b.name AS bookName, b.coverPath, p.chapterId, c.title AS chapterTitle,
+            (SELECT COUNT(*) FROM chapters o WHERE o.bookId = c.bookId
+                AND (o.parentFolder, o.sortOrder, o.title) < (c.parentFolder, c.sortOrder, c.title)) AS chapterIndex,
+            (SELECT COUNT(*) FROM chapters n WHERE n.bookId = p.bookId) AS chapterCount,
+            c.durationMs AS chapterDurationMs, p.positionMs, p.updatedAt
+        FROM playback_progress p
+        INNER JOIN books b ON b.id = p.bookId
+        INNER JOIN chapters c ON c.id = p.chapterId
+        ORDER BY p.updatedAt DESC
+        LIMIT :limit
+    """)
+    fun getRecentlyPlayedLive(limit: Int): LiveData<List<RecentlyPlayed>>
+
     @Insert(onConflict = OnConflictStrategy.REPLACE)
     suspend fun insert(progress: PlaybackProgress)
 
@@ -39,4 +71,24 @@ interface PlaybackProgressDao {
 
     @Query("DELETE FROM playback_progress WHERE bookId = :bookId")
     suspend fun deleteByBookId(bookId: Long)
+
+    // ========== 已删除书籍的进度存档 ==========
+
+    @Insert(onConflict = OnConflictStrategy.REPLACE)
+    suspend fun archive(progress: ArchivedProgress)
+
+    /**
+     * 本书章节对应的存档进度中最近的一条
+     */
+    @Query("""
+        SELECT a.* FROM archived_progress a
+        INNER JOIN chapters c ON c.contentHash = a.contentHash AND c.startMs = a.startMs
+        WHERE c.bookId = :bookId
+        ORDER BY a.updatedAt DESC
+        LIMIT 1
+    """)
+    suspend fun findArchivedForBook(bookId: Long): ArchivedProgress?
+
+    @Delete
+    suspend fun deleteArchived(progress: ArchivedProgress)
 }
@@ -0,0 +1,36 @@
+package com.hx.nekomimi.data.dao
+
+import androidx.room.Dao
+import androidx.room.Insert
+import androidx.room.Query
+import com.hx.nekomimi.data.entity.SearchEntry
+import com.hx.nekomimi.data.model.SearchResult
+
+@Dao
+interface SearchDao {
+
+    /**
+     * 全文搜索：书籍排在章节前，同类按名称 / 章节顺序
+     * @param match SearchTokenizer.matchQuery 生成的 MATCH 表达式
+     */
+    @Query("""
+        SELECT search_index.bookId, search_index.chapterId, b.name AS bookName,
+            c.title AS chapterTitle, c.parentFolder
+        FROM search_index
+        INNER JOIN books b ON b.id = search_index.bookId
+        LEFT JOIN chapters c ON c.id = search_index.chapterId
+        WHERE search_index MATCH :match
+        ORDER BY search_index.chapterId != 0, b.name, c.parentFolder, c.sortOrder, c.title
+        LIMIT :limit
+    """)
+    suspend fun search(match: String, limit: Int): List<SearchResult>
+
+    @Insert
+    suspend fun insertAll(entries: List<SearchEntry>)
+
+    @Query("DELETE FROM search_index WHERE bookId = :bookId")
+    suspend fun deleteByBookId(bookId: Long)
+
+    @Query("DELETE FROM search_index WHERE bookId = :bookId AND chapterId = 0")
+    suspend fun deleteBookEntry(bookId: Long)
+}
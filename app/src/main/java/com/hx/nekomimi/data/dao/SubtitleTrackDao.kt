@@ -0,0 +1,17 @@
+package com.hx.nekomimi.data.dao
+
+import androidx.room.*
+import com.hx.nekomimi.data.entity.SubtitleTrack
+
+@Dao
+interface SubtitleTrackDao {
+
+    @Query("SELECT * FROM subtitle_tracks WHERE bookId = :bookId AND audioUri = :audioUri ORDER BY id")
+    suspend fun getTracksForAudio(bookId: Long, audioUri: String): List<SubtitleTrack>
+
+    @Insert
+    suspend fun insertAll(tracks: List<SubtitleTrack>)
+
+    @Query("DELETE FROM subtitle_tracks WHERE bookId = :bookId")
+    suspend fun deleteByBookId(bookId: Long)
+}
@@ -0,0 +1,55 @@
+package com.hx.nekomimi.data.dao
+
+import androidx.lifecycle.LiveData
+import androidx.room.*
+import com.hx.nekomimi.data.entity.TranscriptionJob
+
+@Dao
+interface TranscriptionJobDao {
+
+    /**
+     * 待处理的任务（包括上次进程退出时仍在运行的任务）
+     */
+    @Query("""
+        SELECT * FROM transcription_jobs
+        WHERE state IN (${TranscriptionJob.STATE_PENDING}, ${TranscriptionJob.STATE_RUNNING})
+        ORDER BY bookId, chapterId
+        LIMIT 1
+    """)
+    suspend fun getNextPending(): TranscriptionJob?
+
+    @Query("SELECT * FROM transcription_jobs WHERE chapterId = :chapterId")
+    suspend fun getByChapterId(chapterId: Long): TranscriptionJob?
+
+    @Query("""
+        SELECT COUNT(*) FROM transcription_jobs
+        WHERE bookId = :bookId AND state IN (${TranscriptionJob.STATE_PENDING}, ${TranscriptionJob.STATE_RUNNING})
+    """)
+    fun observePendingCount(bookId: Long): LiveData<Int>
+
+    /** 已有任务的章节不插入（保留进行中任务的断点），见 [requeueFinished] */
+    @Insert(onConflict = OnConflictStrategy.IGNORE)
+    suspend fun insertAll(jobs: List<TranscriptionJob>)
+
+    /**
+     * 已完成或失败的任务重新排队（清空进度和错误，从头转写）
+     */
+    @Query("""
+        UPDATE transcription_jobs
+        SET state = ${TranscriptionJob.STATE_PENDING}, processedMs = 0, realTimeFactor = 0, error = NULL, updatedAt = :updatedAt
+        WHERE chapterId IN (:chapterIds) AND state IN (${TranscriptionJob.STATE_DONE}, ${TranscriptionJob.STATE_FAILED})
+    """)
+    suspend fun requeueFinished(chapterIds: List<Long>, updatedAt: Long = System.currentTimeMillis())
+
+    @Update
+    suspend fun update(job: TranscriptionJob)
+
+    /**
+     * 同步更新进度（在转写工作线程的解码回调中调用，不可在主线程使用）
+     */
+    @Query("UPDATE transcription_jobs SET processedMs = :processedMs, updatedAt = :updatedAt WHERE chapterId = :chapterId")
+    fun updateProgress(chapterId: Long, processedMs: Long, updatedAt: Long = System.currentTimeMillis())
+
+    @Query("DELETE FROM transcription_jobs WHERE bookId = :bookId")
+    suspend fun deleteByBookId(bookId: Long)
+}
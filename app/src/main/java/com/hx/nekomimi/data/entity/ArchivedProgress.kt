@@ -0,0 +1,19 @@
+package com.hx.nekomimi.data.entity
+
+import androidx.room.Entity
+
+/**
+ * 已删除书籍的播放进度存档
+ *
+ * 删除书籍时按所在章节的内容指纹保存进度，之后重新导入同样的文件（无论路径是否变化）时恢复。
+ * 不关联书籍和章节，删除书籍后仍然保留。
+ * @param contentHash 所在章节音频的内容指纹
+ * @param startMs 虚拟章节的起始时间（区分同一文件拆出的章节）
+ */
+@Entity(tableName = "archived_progress", primaryKeys = ["contentHash", "startMs"])
+data class ArchivedProgress(
+    val contentHash: String,
+    val startMs: Long,
+    val positionMs: Long,
+    val updatedAt: Long
+)
@@ -9,7 +9,7 @@ import androidx.room.PrimaryKey
  * @param name 书籍名称
  * @param coverPath 封面图片路径（可选）
  * @param rootPath 书籍根目录路径（用于扫描 mp3 文件）
- * @param rootUri 书籍根目录 URI（SAF 方式）
+ * @param rootUri 书籍根目录 URI（SAF 目录树，或 WebDAV 目录的 http(s) 地址）
  * @param createdAt 创建时间
  */
 @Entity(tableName = "books")
@@ -1,5 +1,6 @@
 package com.hx.nekomimi.data.entity
 
+import androidx.room.ColumnInfo
 import androidx.room.Entity
 import androidx.room.ForeignKey
 import androidx.room.Index
@@ -13,10 +14,16 @@ import androidx.room.PrimaryKey
  * @param filePath 音频文件绝对路径
  * @param fileUri 音频文件 URI（SAF 方式）
  * @param subtitlePath 字幕文件路径（SRT/ASS，可选）
- * @param subtitleUri 字幕文件 URI（SAF 方式，可选）
+ * @param subtitleUri 当前选择的字幕文件 URI（SAF 方式，可选；候选轨道见 SubtitleTrack）
+ * @param secondarySubtitleUri 双语显示时的第二字幕 URI（可选）
  * @param parentFolder 父文件夹路径（用于树形结构展示）
  * @param sortOrder 排序序号
  * @param durationMs 音频时长（毫秒）
+ * @param subtitleOffsetMs 字幕同步偏移（毫秒，正数表示字幕延后）
+ * @param subtitleDriftPpm 字幕线性漂移（百万分之一），见 SubtitleTimeline
+ * @param startMs 虚拟章节在音频文件中的起始时间（单文件有声书按 M4B 章节 / CUE 拆分时使用）
+ * @param endMs 虚拟章节的结束时间，0 表示播放到文件末尾
+ * @param contentHash 音频内容指纹（见 ContentFingerprint），远程文件或未重新扫描的旧数据为 null
  */
 @Entity(
     tableName = "chapters",
@@ -28,7 +35,7 @@ import androidx.room.PrimaryKey
             onDelete = ForeignKey.CASCADE
         )
     ],
-    indices = [Index("bookId")]
+    indices = [Index("bookId"), Index("contentHash")]
 )
 data class Chapter(
     @PrimaryKey(autoGenerate = true)
@@ -41,5 +48,19 @@ data class Chapter(
     val subtitleUri: String? = null,
     val parentFolder: String = "",
     val sortOrder: Int = 0,
-    val durationMs: Long = 0
-)
+    val durationMs: Long = 0,
+    @ColumnInfo(defaultValue = "0")
+    val subtitleOffsetMs: Long = 0,
+    @ColumnInfo(defaultValue = "0")
+    val subtitleDriftPpm: Float = 0f,
+    @ColumnInfo(defaultValue = "0")
+    val startMs: Long = 0,
+    @ColumnInfo(defaultValue = "0")
+    val endMs: Long = 0,
+    val secondarySubtitleUri: String? = null,
+    val contentHash: String? = null
+) {
+    /** 是否为单文件内按时间区间划分的虚拟章节 */
+    val isVirtual: Boolean
+        get() = startMs > 0 || endMs > 0
+}
@@ -29,7 +29,7 @@ import androidx.room.PrimaryKey
             onDelete = ForeignKey.CASCADE
         )
     ],
-    indices = [Index("bookId", unique = true), Index("chapterId")]
+    indices = [Index("bookId", unique = true), Index("chapterId"), Index("updatedAt")]
 )
 data class PlaybackProgress(
     @PrimaryKey(autoGenerate = true)
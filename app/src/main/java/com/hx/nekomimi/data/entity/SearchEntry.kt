@@ -0,0 +1,30 @@
+package com.hx.nekomimi.data.entity
+
+import androidx.room.Entity
+import androidx.room.Fts4
+
+/**
+ * 全书库搜索索引（FTS4 虚拟表 search_index，见 search/SearchIndex）
+ *
+ * 每本书一行（chapterId = 0）加每个章节一行；文本列存放 SearchTokenizer 分词后的词序列，
+ * 显示用的名称从 books / chapters 关联读取。扫描时按书籍整体替换。
+ * @param terms 书名（章节行为章节标题和文件夹路径）的分词结果
+ * @param tags 名称中括号标签的分词结果
+ */
+@Fts4(notIndexed = ["bookId", "chapterId"])
+@Entity(tableName = SearchEntry.TABLE_NAME)
+data class SearchEntry(
+    val bookId: Long,
+    val chapterId: Long,
+    val terms: String,
+    val tags: String
+) {
+    companion object {
+        const val TABLE_NAME = "search_index"
+
+        /** 迁移中创建虚拟表的语句，需与 Room 生成的一致 */
+        const val CREATE_SQL = "CREATE VIRTUAL TABLE IF NOT EXISTS `$TABLE_NAME` USING FTS4(" +
+            "`bookId` INTEGER NOT NULL, `chapterId` INTEGER NOT NULL, `terms` TEXT NOT NULL, `tags` TEXT NOT NULL, " +
+            "notindexed=`bookId`, notindexed=`chapterId`)"
+    }
+}
@@ -0,0 +1,40 @@
+package com.hx.nekomimi.data.entity
+
+import androidx.room.Entity
+import androidx.room.ForeignKey
+import androidx.room.Index
+import androidx.room.PrimaryKey
+
+/**
+ * 字幕轨道（同一音频文件可匹配到多份字幕，例如 01.srt / 01.zh.srt / 01.ja.ass）
+ *
+ * 按音频文件 URI 关联而不是章节 ID：重新扫描时章节 ID 会变化，
+ * 并且同一文件拆出的虚拟章节共享全部字幕轨道。
+ * @param audioUri 所属音频文件 URI（对应 Chapter.fileUri）
+ * @param uri 字幕文件 URI
+ * @param language 规范化的语言代码（见 SubtitleLanguage），未标注时为空
+ * @param format 字幕格式（srt / ass / ssa）
+ * @param label 显示名称（字幕文件名）
+ */
+@Entity(
+    tableName = "subtitle_tracks",
+    foreignKeys = [
+        ForeignKey(
+            entity = Book::class,
+            parentColumns = ["id"],
+            childColumns = ["bookId"],
+            onDelete = ForeignKey.CASCADE
+        )
+    ],
+    indices = [Index("bookId", "audioUri")]
+)
+data class SubtitleTrack(
+    @PrimaryKey(autoGenerate = true)
+    val id: Long = 0,
+    val bookId: Long,
+    val audioUri: String,
+    val uri: String,
+    val language: String,
+    val format: String,
+    val label: String
+)
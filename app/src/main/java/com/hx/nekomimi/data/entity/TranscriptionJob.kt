@@ -0,0 +1,50 @@
+package com.hx.nekomimi.data.entity
+
+import androidx.room.Entity
+import androidx.room.ForeignKey
+import androidx.room.Index
+import androidx.room.PrimaryKey
+
+/**
+ * 离线字幕转写任务（每个章节一条，用于断点续传）
+ * @param chapterId 章节 ID（主键）
+ * @param bookId 所属书籍 ID
+ * @param state 任务状态，见 [STATE_PENDING] 等常量
+ * @param processedMs 已完成转写的音频位置（毫秒），续传时从这里继续解码
+ * @param durationMs 音频总时长（毫秒）
+ * @param threads 推理线程数
+ * @param realTimeFactor 实时率 = 处理耗时 / 音频时长（越小越快）
+ * @param error 失败原因
+ * @param updatedAt 最后更新时间
+ */
+@Entity(
+    tableName = "transcription_jobs",
+    foreignKeys = [
+        ForeignKey(
+            entity = Chapter::class,
+            parentColumns = ["id"],
+            childColumns = ["chapterId"],
+            onDelete = ForeignKey.CASCADE
+        )
+    ],
+    indices = [Index("bookId"), Index("state")]
+)
+data class TranscriptionJob(
+    @PrimaryKey
+    val chapterId: Long,
+    val bookId: Long,
+    val state: Int = STATE_PENDING,
+    val processedMs: Long = 0,
+    val durationMs: Long = 0,
+    val threads: Int = 0,
+    val realTimeFactor: Float = 0f,
+    val error: String? = null,
+    val updatedAt: Long = System.currentTimeMillis()
+) {
+    companion object {
+        const val STATE_PENDING = 0
+        const val STATE_RUNNING = 1
+        const val STATE_DONE = 2
+        const val STATE_FAILED = 3
+    }
+}
@@ -0,0 +1,30 @@
+package com.hx.nekomimi.data.model
+
+import androidx.room.DatabaseView
+import androidx.room.Embedded
+import com.hx.nekomimi.data.entity.Book
+
+/**
+ * 书架读模型（视图 book_stats）：书籍 + 章节数 + 最近播放时间
+ * 主页一次查询即可得到全部书籍卡片所需的数据，章节或进度变化时 LiveData 自动刷新
+ * @param chapterCount 章节数
+ * @param lastPlayedAt 最近一次保存播放进度的时间，从未播放时为 null
+ */
+@DatabaseView(viewName = BookWithStats.VIEW_NAME, value = BookWithStats.QUERY)
+data class BookWithStats(
+    @Embedded
+    val book: Book,
+    val chapterCount: Int,
+    val lastPlayedAt: Long?
+) {
+    companion object {
+        const val VIEW_NAME = "book_stats"
+
+        /** 迁移中创建视图的语句必须与这里完全一致（Room 按 SQL 文本校验视图） */
+        const val QUERY = "SELECT books.*, " +
+            "(SELECT COUNT(*) FROM chapters WHERE chapters.bookId = books.id) AS chapterCount, " +
+            "(SELECT playback_progress.updatedAt FROM playback_progress " +
+            "WHERE playback_progress.bookId = books.id) AS lastPlayedAt " +
+            "FROM books"
+    }
+}
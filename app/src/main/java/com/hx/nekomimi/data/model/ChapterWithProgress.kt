@@ -0,0 +1,28 @@
+package com.hx.nekomimi.data.model
+
+import androidx.room.Embedded
+import androidx.room.Relation
+import com.hx.nekomimi.data.entity.Chapter
+import com.hx.nekomimi.data.entity.PlaybackProgress
+import com.hx.nekomimi.data.entity.SubtitleTrack
+
+/**
+ * 章节 + 本书播放进度 + 音频文件的字幕轨道（播放页一次加载）
+ * @param progress 本书的播放进度（可能在其它章节）
+ */
+data class ChapterWithProgress(
+    @Embedded
+    val chapter: Chapter,
+    @Relation(parentColumn = "bookId", entityColumn = "bookId")
+    val progress: PlaybackProgress?,
+    @Relation(parentColumn = "fileUri", entityColumn = "audioUri")
+    val tracks: List<SubtitleTrack>
+) {
+    /** 同一音频文件可能被多本书引用，只取本书的轨道 */
+    fun subtitleTracks(): List<SubtitleTrack> =
+        tracks.filter { it.bookId == chapter.bookId }.sortedBy { it.id }
+
+    /** 进度是否就在这一章节 */
+    fun progressInChapter(): PlaybackProgress? =
+        progress?.takeIf { it.chapterId == chapter.id && it.positionMs > 0 }
+}
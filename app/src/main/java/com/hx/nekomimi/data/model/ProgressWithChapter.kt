@@ -0,0 +1,16 @@
+package com.hx.nekomimi.data.model
+
+import androidx.room.Embedded
+import androidx.room.Relation
+import com.hx.nekomimi.data.entity.Chapter
+import com.hx.nekomimi.data.entity.PlaybackProgress
+
+/**
+ * 播放进度 + 所在章节（详情页「继续播放」卡片）
+ */
+data class ProgressWithChapter(
+    @Embedded
+    val progress: PlaybackProgress,
+    @Relation(parentColumn = "chapterId", entityColumn = "id")
+    val chapter: Chapter?
+)
@@ -0,0 +1,29 @@
+package com.hx.nekomimi.data.model
+
+/**
+ * 主页「继续收听」书架的一项（PlaybackProgressDao.getRecentlyPlayedLive 一次查询得到）
+ * @param chapterIndex 当前章节在书中的序号（从 0 开始，与章节列表排序一致）
+ * @param chapterCount 本书章节数
+ * @param chapterDurationMs 当前章节时长，未知时为 0
+ */
+data class RecentlyPlayed(
+    val bookId: Long,
+    val bookName: String,
+    val coverPath: String?,
+    val chapterId: Long,
+    val chapterTitle: String,
+    val chapterIndex: Int,
+    val chapterCount: Int,
+    val chapterDurationMs: Long,
+    val positionMs: Long,
+    val updatedAt: Long
+) {
+    /** 全书完成百分比：已听完的章节 + 当前章节已播放的比例 */
+    fun percentComplete(): Int {
+        if (chapterCount <= 0) return 0
+        val inChapter = if (chapterDurationMs > 0) {
+            (positionMs.toDouble() / chapterDurationMs).coerceIn(0.0, 1.0)
+        } else 0.0
+        return ((chapterIndex + inChapter) * 100 / chapterCount).toInt().coerceIn(0, 100)
+    }
+}
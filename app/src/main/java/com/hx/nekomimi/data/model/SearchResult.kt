@@ -0,0 +1,16 @@
+package com.hx.nekomimi.data.model
+
+/**
+ * 搜索结果的一项（书籍或章节）
+ * @param chapterId 章节 ID，书籍结果为 0
+ * @param chapterTitle 章节标题，书籍结果为 null
+ */
+data class SearchResult(
+    val bookId: Long,
+    val chapterId: Long,
+    val bookName: String,
+    val chapterTitle: String?,
+    val parentFolder: String?
+) {
+    val isBook: Boolean get() = chapterId == 0L
+}
@@ -1,30 +1,79 @@
 package com.hx.nekomimi.data.repository
 
 import androidx.lifecycle.LiveData
+import androidx.room.withTransaction
 import com.hx.nekomimi.data.AppDatabase
+import com.hx.nekomimi.data.entity.ArchivedProgress
 import com.hx.nekomimi.data.entity.Book
 import com.hx.nekomimi.data.entity.Chapter
 import com.hx.nekomimi.data.entity.PlaybackProgress
+import com.hx.nekomimi.data.entity.SubtitleTrack
+import com.hx.nekomimi.data.model.BookWithStats
+import com.hx.nekomimi.data.model.ChapterWithProgress
+import com.hx.nekomimi.data.model.ProgressWithChapter
+import com.hx.nekomimi.data.model.RecentlyPlayed
+import com.hx.nekomimi.data.model.SearchResult
+import com.hx.nekomimi.search.SearchIndex
+import com.hx.nekomimi.search.SearchTokenizer
+import com.hx.nekomimi.util.Tracing
 
 class BookRepository(private val db: AppDatabase) {
 
     private val bookDao = db.bookDao()
     private val chapterDao = db.chapterDao()
     private val progressDao = db.playbackProgressDao()
+    private val transcriptionJobDao = db.transcriptionJobDao()
+    private val subtitleTrackDao = db.subtitleTrackDao()
+    private val searchDao = db.searchDao()
 
     // ========== 书籍操作 ==========
 
     fun getAllBooks(): LiveData<List<Book>> = bookDao.getAllBooks()
 
-    suspend fun getBookById(bookId: Long): Book? = bookDao.getBookById(bookId)
+    fun getAllBooksWithStats(): LiveData<List<BookWithStats>> = bookDao.getAllBooksWithStats()
 
-    fun getBookByIdLive(bookId: Long): LiveData<Book?> = bookDao.getBookByIdLive(bookId)
+    suspend fun getBookById(bookId: Long): Book? =
+        Tracing.async("db.getBookById") { bookDao.getBookById(bookId) }
 
-    suspend fun insertBook(book: Book): Long = bookDao.insert(book)
+    fun getBookByIdLive(bookId: Long): LiveData<Book?> = bookDao.getBookByIdLive(bookId)
 
-    suspend fun updateBook(book: Book) = bookDao.update(book)
+    suspend fun insertBook(book: Book): Long =
+        Tracing.async("db.insertBook") {
+            db.withTransaction {
+                val bookId = bookDao.insert(book)
+                searchDao.insertAll(listOf(SearchIndex.bookEntry(book.copy(id = bookId))))
+                bookId
+            }
+        }
+
+    suspend fun updateBook(book: Book) =
+        Tracing.async("db.updateBook") {
+            db.withTransaction {
+                bookDao.update(book)
+                searchDao.deleteBookEntry(book.id)
+                searchDao.insertAll(listOf(SearchIndex.bookEntry(book)))
+            }
+        }
 
-    suspend fun deleteBook(bookId: Long) = bookDao.deleteById(bookId)
+    /**
+     * 删除书籍；播放进度按所在章节的内容指纹存档，重新导入同样的文件时恢复
+     */
+    suspend fun deleteBook(bookId: Long) {
+        Tracing.async("db.deleteBook") {
+            db.withTransaction {
+                progressDao.getProgressWithChapter(bookId)?.let { item ->
+                    val chapter = item.chapter ?: return@let
+                    val hash = chapter.contentHash ?: return@let
+                    progressDao.archive(
+                        ArchivedProgress(hash, chapter.startMs, item.progress.positionMs, item.progress.updatedAt)
+                    )
+                }
+                bookDao.deleteById(bookId)
+                // 搜索索引是虚拟表，没有外键级联
+                searchDao.deleteByBookId(bookId)
+            }
+        }
+    }
 
     // ========== 章节操作 ==========
 
@@ -32,41 +81,155 @@ class BookRepository(private val db: AppDatabase) {
         chapterDao.getChaptersByBookId(bookId)
 
     suspend fun getChaptersByBookIdList(bookId: Long): List<Chapter> =
-        chapterDao.getChaptersByBookIdList(bookId)
+        Tracing.async("db.getChaptersByBookIdList") { chapterDao.getChaptersByBookIdList(bookId) }
 
     suspend fun getChapterById(chapterId: Long): Chapter? =
-        chapterDao.getChapterById(chapterId)
+        Tracing.async("db.getChapterById") { chapterDao.getChapterById(chapterId) }
+
+    suspend fun getChapterWithProgress(chapterId: Long): ChapterWithProgress? =
+        Tracing.async("db.getChapterWithProgress") { chapterDao.getChapterWithProgress(chapterId) }
 
     suspend fun insertChapters(chapters: List<Chapter>) =
-        chapterDao.insertAll(chapters)
+        Tracing.async("db.insertChapters") { chapterDao.insertAll(chapters) }
 
     suspend fun deleteChaptersByBookId(bookId: Long) =
-        chapterDao.deleteByBookId(bookId)
+        Tracing.async("db.deleteChaptersByBookId") { chapterDao.deleteByBookId(bookId) }
 
-    suspend fun getChapterCount(bookId: Long): Int =
-        chapterDao.getChapterCount(bookId)
+    /**
+     * 用重新扫描的结果替换书籍的章节列表和字幕轨道
+     * 按音频 URI（虚拟章节再加起始时间）匹配原有章节，URI 变化（文件移动 / 改名）时再按内容指纹匹配；
+     * 匹配到的章节沿用原 ID、字幕同步设置和仍然存在的字幕轨道选择并原地更新，
+     * 挂在章节上的播放进度和转写任务随之保留；只插入新增的章节、删除消失的章节。
+     * 本书没有进度时（删除后重新导入），按内容指纹恢复存档的进度
+     */
+    suspend fun replaceChapters(bookId: Long, chapters: List<Chapter>, subtitleTracks: List<SubtitleTrack>) {
+        Tracing.async("db.replaceChapters") {
+            db.withTransaction {
+                val previous = chapterDao.getChaptersByBookIdList(bookId)
+                val byUri = previous.filter { it.fileUri != null }.associateBy { it.fileUri to it.startMs }
+                val byHash = previous.filter { it.contentHash != null }.associateBy { it.contentHash to it.startMs }
+                val progress = progressDao.getProgressByBookId(bookId)
+                val trackUris = subtitleTracks.groupBy({ it.audioUri }, { it.uri })
+
+                // 先按 URI 匹配，剩下的再按指纹匹配；每个原章节只能被匹配一次（同一书中可能有重复文件）
+                val claimed = HashSet<Long>()
+                val uriMatches = chapters.map { byUri[it.fileUri to it.startMs]?.takeIf { old -> claimed.add(old.id) } }
+                val merged = chapters.mapIndexed { i, chapter ->
+                    val old = uriMatches[i]
+                        ?: chapter.contentHash?.let { byHash[it to chapter.startMs] }?.takeIf { claimed.add(it.id) }
+                        ?: return@mapIndexed chapter
+                    val available = trackUris[chapter.fileUri].orEmpty()
+                    chapter.copy(
+                        id = old.id,
+                        subtitleOffsetMs = old.subtitleOffsetMs,
+                        subtitleDriftPpm = old.subtitleDriftPpm,
+                        subtitleUri = old.subtitleUri?.takeIf { it in available } ?: chapter.subtitleUri,
+                        secondarySubtitleUri = old.secondarySubtitleUri?.takeIf { it in available }
+                    )
+                }
+
+                // 删除章节会级联删除进度和转写任务，所以只删消失的章节，其余原地更新
+                val removed = previous.map { it.id }.filter { it !in claimed }
+                removed.chunked(500).forEach { chapterDao.deleteByIds(it) }
+                val (kept, added) = merged.partition { it.id in claimed }
+                chapterDao.updateAll(kept)
+                chapterDao.insertAll(added)
+                if (progress == null) restoreArchivedProgress(bookId)
+                subtitleTrackDao.deleteByBookId(bookId)
+                subtitleTrackDao.insertAll(subtitleTracks)
+                reindexBook(bookId)
+            }
+        }
+    }
 
     /**
-     * 监听章节表整体变化
+     * 按书籍整体替换搜索索引行（章节 ID 在写入后才确定）
      */
-    fun observeTotalChapterCount(): LiveData<Int> =
-        chapterDao.observeTotalChapterCount()
+    private suspend fun reindexBook(bookId: Long) {
+        val book = bookDao.getBookById(bookId) ?: return
+        searchDao.deleteByBookId(bookId)
+        searchDao.insertAll(
+            listOf(SearchIndex.bookEntry(book)) +
+                SearchIndex.chapterEntries(book, chapterDao.getChaptersByBookIdList(bookId))
+        )
+    }
+
+    private suspend fun restoreArchivedProgress(bookId: Long) {
+        val archived = progressDao.findArchivedForBook(bookId) ?: return
+        val chapter = chapterDao.getChaptersByBookIdList(bookId)
+            .firstOrNull { it.contentHash == archived.contentHash && it.startMs == archived.startMs } ?: return
+        progressDao.upsert(bookId, chapter.id, archived.positionMs, archived.updatedAt)
+        progressDao.deleteArchived(archived)
+    }
+
+    /**
+     * 本书中与其他书籍内容重复的章节
+     */
+    fun getDuplicateChapterIdsLive(bookId: Long): LiveData<List<Long>> =
+        chapterDao.getDuplicateChapterIdsLive(bookId)
+
+    /**
+     * 音频文件的全部字幕轨道（同一文件拆出的虚拟章节共享）
+     */
+    suspend fun getSubtitleTracks(chapter: Chapter): List<SubtitleTrack> {
+        val audioUri = chapter.fileUri ?: return emptyList()
+        return Tracing.async("db.getSubtitleTracks") { subtitleTrackDao.getTracksForAudio(chapter.bookId, audioUri) }
+    }
+
+    /**
+     * 选择字幕轨道（同一音频文件的虚拟章节一起切换）
+     */
+    suspend fun selectSubtitleTracks(chapter: Chapter, subtitleUri: String?, secondarySubtitleUri: String?) {
+        val audioUri = chapter.fileUri ?: return
+        Tracing.async("db.selectSubtitleTracks") {
+            chapterDao.updateSubtitleSelection(audioUri, subtitleUri, secondarySubtitleUri)
+        }
+    }
+
+    suspend fun updateSubtitleSync(chapterId: Long, offsetMs: Long, driftPpm: Float) =
+        Tracing.async("db.updateSubtitleSync") { chapterDao.updateSubtitleSync(chapterId, offsetMs, driftPpm) }
+
+    // ========== 搜索 ==========
+
+    /**
+     * 搜索书名、章节标题、文件夹路径和标签；以 # 开头时只搜索标签
+     */
+    suspend fun search(query: String, limit: Int): List<SearchResult> {
+        val trimmed = query.trim()
+        val match = if (trimmed.startsWith("#")) {
+            SearchTokenizer.matchQuery(trimmed.drop(1), column = "tags")
+        } else {
+            SearchTokenizer.matchQuery(trimmed)
+        } ?: return emptyList()
+        return Tracing.async("db.search") { searchDao.search(match, limit) }
+    }
 
     // ========== 播放进度操作 ==========
 
     suspend fun getProgressByBookId(bookId: Long): PlaybackProgress? =
-        progressDao.getProgressByBookId(bookId)
+        Tracing.async("db.getProgressByBookId") { progressDao.getProgressByBookId(bookId) }
 
     fun getProgressByBookIdLive(bookId: Long): LiveData<PlaybackProgress?> =
         progressDao.getProgressByBookIdLive(bookId)
 
+    fun getProgressWithChapterLive(bookId: Long): LiveData<ProgressWithChapter?> =
+        progressDao.getProgressWithChapterLive(bookId)
+
     suspend fun getLastPlayedProgress(): PlaybackProgress? =
-        progressDao.getLastPlayedProgress()
+        Tracing.async("db.getLastPlayedProgress") { progressDao.getLastPlayedProgress() }
 
     fun getLastPlayedProgressLive(): LiveData<PlaybackProgress?> =
         progressDao.getLastPlayedProgressLive()
 
+    fun getRecentlyPlayedLive(limit: Int): LiveData<List<RecentlyPlayed>> =
+        progressDao.getRecentlyPlayedLive(limit)
+
     suspend fun saveProgress(bookId: Long, chapterId: Long, positionMs: Long) {
-        progressDao.upsert(bookId, chapterId, positionMs)
+        Tracing.async("db.saveProgress") { progressDao.upsert(bookId, chapterId, positionMs) }
     }
+
+    // ========== 字幕转写任务 ==========
+
+    fun observePendingTranscriptions(bookId: Long): LiveData<Int> =
+        transcriptionJobDao.observePendingCount(bookId)
 }
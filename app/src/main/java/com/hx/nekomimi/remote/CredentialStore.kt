@@ -0,0 +1,48 @@
+package com.hx.nekomimi.remote
+
+import java.io.File
+import java.io.IOException
+import java.util.Properties
+
+/**
+ * 以 properties 文件保存的键值表，供一个写入进程和多个读取进程共享
+ *
+ * 写入时先写临时文件再重命名替换，读取方看到的总是完整的旧文件或新文件；
+ * 每次读取前比较文件的修改时间和长度，其它进程写入后自动重新加载。
+ * 读写都会访问磁盘，不要在主线程调用。
+ */
+internal class CredentialStore(private val file: File) {
+
+    private class Snapshot(val lastModified: Long, val length: Long, val values: Properties)
+
+    @Volatile
+    private var snapshot: Snapshot? = null
+
+    fun get(key: String): String? = current().getProperty(key)
+
+    @Synchronized
+    fun edit(block: (Properties) -> Unit) {
+        val values = Properties().apply { putAll(current()) }
+        block(values)
+        file.parentFile?.mkdirs()
+        val temp = File.createTempFile(file.name, ".tmp", file.parentFile)
+        temp.outputStream().use { values.store(it, null) }
+        // 修改时间严格递增（文件系统的时间精度可能只有秒），长度相同的连续两次写入也能被其它进程发现
+        temp.setLastModified(maxOf(System.currentTimeMillis(), file.lastModified() + 1000))
+        if (!temp.renameTo(file)) {
+            temp.delete()
+            throw IOException("写入失败: $file")
+        }
+        snapshot = Snapshot(file.lastModified(), file.length(), values)
+    }
+
+    private fun current(): Properties {
+        val lastModified = file.lastModified()
+        val length = file.length()
+        snapshot?.let { if (it.lastModified == lastModified && it.length == length) return it.values }
+        val values = Properties()
+        if (file.isFile) file.inputStream().use { values.load(it) }
+        snapshot = Snapshot(lastModified, length, values)
+        return values
+    }
+}
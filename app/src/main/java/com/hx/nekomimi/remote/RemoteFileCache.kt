@@ -0,0 +1,101 @@
+package com.hx.nekomimi.remote
+
+import android.content.Context
+import android.net.Uri
+import android.util.Log
+import com.hx.nekomimi.util.HashUtils
+import okhttp3.Request
+import java.io.File
+import java.io.FileInputStream
+import java.io.IOException
+import java.io.InputStream
+
+/**
+ * 远程小文件（字幕、CUE）的磁盘缓存
+ *
+ * 音频走播放器的 Range 请求缓存（PlaybackCache），字幕等文本文件整份下载到
+ * cacheDir/remote，按 URL 哈希命名；重新扫描时按服务器返回的修改时间失效。
+ */
+object RemoteFileCache {
+
+    private const val TAG = "RemoteFileCache"
+    private const val DIR = "remote"
+    private const val TEMP_SUFFIX = ".tmp"
+
+    /** 单个文件上限，防止误把大文件当作字幕下载 */
+    private const val MAX_FILE_BYTES = 16L shl 20 // 16 MB
+
+    fun fileFor(context: Context, url: String): File =
+        File(File(context.cacheDir, DIR), HashUtils.sha1Hex(url))
+
+    /**
+     * 返回本地缓存文件，未缓存时先下载（不要在主线程调用）
+     */
+    @Throws(IOException::class)
+    fun fetch(context: Context, url: String): File {
+        val file = fileFor(context, url)
+        if (file.isFile) return file
+
+        val request = Request.Builder().url(url).build()
+        RemoteHttp.client(context).newCall(request).execute().use { response ->
+            if (!response.isSuccessful) throw IOException("下载失败: HTTP ${response.code}")
+            val body = response.body ?: throw IOException("响应为空")
+            if (body.contentLength() > MAX_FILE_BYTES) throw IOException("文件过大: ${body.contentLength()}")
+
+            file.parentFile?.mkdirs()
+            val temp = File(file.parentFile, file.name + TEMP_SUFFIX)
+            try {
+                temp.outputStream().use { output ->
+                    val buffer = ByteArray(8192)
+                    var total = 0L
+                    body.byteStream().use { input ->
+                        while (true) {
+                            val n = input.read(buffer)
+                            if (n < 0) break
+                            total += n
+                            if (total > MAX_FILE_BYTES) throw IOException("文件过大: $url")
+                            output.write(buffer, 0, n)
+                        }
+                    }
+                }
+                if (!temp.renameTo(file)) throw IOException("无法写入缓存: $file")
+            } finally {
+                temp.delete()
+            }
+        }
+        return file
+    }
+
+    /**
+     * 打开远程或本地 URI：远程经过缓存，其余交给 ContentResolver
+     */
+    @Throws(IOException::class)
+    fun openInputStream(context: Context, uri: Uri): InputStream? {
+        if (!RemoteHttp.isRemote(uri)) return context.contentResolver.openInputStream(uri)
+        return FileInputStream(fetch(context, uri.toString()))
+    }
+
+    /**
+     * 服务器上的文件比缓存新时删除缓存
+     */
+    fun invalidateIfStale(context: Context, url: String, lastModified: Long) {
+        val file = fileFor(context, url)
+        if (lastModified > 0 && file.isFile && file.lastModified() < lastModified) {
+            file.delete()
+        }
+    }
+
+    /**
+     * 预取一组文件（忽略本地 URI 和下载失败）
+     */
+    fun prefetch(context: Context, urls: List<String>) {
+        for (url in urls.distinct()) {
+            if (!RemoteHttp.isRemote(url)) continue
+            try {
+                fetch(context, url)
+            } catch (e: IOException) {
+                Log.w(TAG, "预取失败: $url", e)
+            }
+        }
+    }
+}
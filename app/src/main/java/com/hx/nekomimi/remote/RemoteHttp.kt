@@ -0,0 +1,62 @@
+package com.hx.nekomimi.remote
+
+import android.content.Context
+import android.net.Uri
+import okhttp3.Credentials
+import okhttp3.HttpUrl.Companion.toHttpUrlOrNull
+import okhttp3.OkHttpClient
+import java.util.concurrent.TimeUnit
+
+/**
+ * 远程书库（WebDAV / HTTP）共用的 OkHttpClient
+ *
+ * 列目录、字幕下载和播放器的 Range 请求共用同一个连接池；
+ * 拦截器按请求来源附加 [WebDavCredentials] 中保存的 Basic 认证。
+ */
+object RemoteHttp {
+
+    private const val HEADER_AUTHORIZATION = "Authorization"
+
+    @Volatile
+    private var client: OkHttpClient? = null
+
+    fun isRemote(uri: String?): Boolean =
+        uri != null && (uri.startsWith("http://", ignoreCase = true) || uri.startsWith("https://", ignoreCase = true))
+
+    fun isRemote(uri: Uri): Boolean =
+        uri.scheme.equals("http", ignoreCase = true) || uri.scheme.equals("https", ignoreCase = true)
+
+    @Synchronized
+    fun client(context: Context): OkHttpClient {
+        client?.let { return it }
+        val appContext = context.applicationContext
+        return OkHttpClient.Builder()
+            .connectTimeout(15, TimeUnit.SECONDS)
+            .readTimeout(30, TimeUnit.SECONDS)
+            .addInterceptor { chain ->
+                val request = chain.request()
+                val credential = WebDavCredentials.get(appContext, request.url)
+                if (credential == null || request.header(HEADER_AUTHORIZATION) != null) {
+                    chain.proceed(request)
+                } else {
+                    chain.proceed(
+                        request.newBuilder()
+                            .header(HEADER_AUTHORIZATION, Credentials.basic(credential.username, credential.password))
+                            .build()
+                    )
+                }
+            }
+            .build()
+            .also { client = it }
+    }
+
+    /**
+     * 不经过 OkHttp 的读取方（MediaExtractor）使用的请求头
+     */
+    fun headersFor(context: Context, uri: Uri): Map<String, String>? {
+        if (!isRemote(uri)) return null
+        val url = uri.toString().toHttpUrlOrNull() ?: return null
+        val credential = WebDavCredentials.get(context, url) ?: return null
+        return mapOf(HEADER_AUTHORIZATION to Credentials.basic(credential.username, credential.password))
+    }
+}
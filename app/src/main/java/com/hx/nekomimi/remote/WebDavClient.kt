@@ -0,0 +1,129 @@
+package com.hx.nekomimi.remote
+
+import android.content.Context
+import android.util.Xml
+import okhttp3.HttpUrl
+import okhttp3.HttpUrl.Companion.toHttpUrlOrNull
+import okhttp3.MediaType.Companion.toMediaType
+import okhttp3.Request
+import okhttp3.RequestBody.Companion.toRequestBody
+import org.xmlpull.v1.XmlPullParser
+import java.io.IOException
+import java.io.InputStream
+import java.net.URLDecoder
+import java.text.SimpleDateFormat
+import java.util.Locale
+
+/**
+ * 最小 WebDAV 客户端：只实现列目录（PROPFIND Depth: 1）
+ *
+ * 文件内容通过普通 GET / Range 请求读取（播放器见 PlaybackCache，字幕见 [RemoteFileCache]）。
+ */
+class WebDavClient(context: Context) {
+
+    /**
+     * 目录项
+     * @param url 绝对地址（目录以 / 结尾）
+     * @param lastModified 最后修改时间（未知时为 0）
+     */
+    data class Entry(
+        val name: String,
+        val url: String,
+        val isDirectory: Boolean,
+        val size: Long,
+        val lastModified: Long
+    )
+
+    private val client = RemoteHttp.client(context)
+
+    /**
+     * 列出目录的直接子项（不含目录自身）
+     * @throws IOException 网络错误、认证失败或服务器不支持 WebDAV
+     */
+    fun list(directoryUrl: String): List<Entry> {
+        val base = directoryUrl.toHttpUrlOrNull() ?: throw IOException("无效的地址: $directoryUrl")
+        val request = Request.Builder()
+            .url(base)
+            .header("Depth", "1")
+            .method("PROPFIND", PROPFIND_BODY.toRequestBody(XML_MEDIA_TYPE))
+            .build()
+
+        client.newCall(request).execute().use { response ->
+            if (response.code != HTTP_MULTI_STATUS) {
+                throw IOException("WebDAV 列目录失败: HTTP ${response.code}")
+            }
+            val body = response.body ?: throw IOException("WebDAV 响应为空")
+            return parseMultiStatus(base, body.byteStream())
+                .filter { normalizePath(it.url) != normalizePath(base.toString()) }
+        }
+    }
+
+    private fun parseMultiStatus(base: HttpUrl, input: InputStream): List<Entry> {
+        val parser = Xml.newPullParser()
+        parser.setFeature(XmlPullParser.FEATURE_PROCESS_NAMESPACES, true)
+        parser.setInput(input, null)
+
+        val entries = mutableListOf<Entry>()
+        var href: String? = null
+        var isDirectory = false
+        var size = 0L
+        var lastModified = 0L
+
+        var event = parser.eventType
+        while (event != XmlPullParser.END_DOCUMENT) {
+            if (event == XmlPullParser.START_TAG && parser.namespace == DAV_NAMESPACE) {
+                when (parser.name) {
+                    "response" -> {
+                        href = null
+                        isDirectory = false
+                        size = 0L
+                        lastModified = 0L
+                    }
+                    "href" -> href = parser.nextText().trim()
+                    "collection" -> isDirectory = true
+                    "getcontentlength" -> size = parser.nextText().trim().toLongOrNull() ?: 0L
+                    "getlastmodified" -> lastModified = parseHttpDate(parser.nextText().trim())
+                }
+            } else if (event == XmlPullParser.END_TAG && parser.namespace == DAV_NAMESPACE && parser.name == "response") {
+                val url = href?.let { base.resolve(it) }
+                if (url != null) {
+                    val directoryUrl = if (isDirectory && !url.encodedPath.endsWith("/")) {
+                        url.newBuilder().addPathSegment("").build()
+                    } else url
+                    val name = url.pathSegments.lastOrNull { it.isNotEmpty() }.orEmpty()
+                    if (name.isNotEmpty()) {
+                        entries.add(Entry(name, directoryUrl.toString(), isDirectory, size, lastModified))
+                    }
+                }
+            }
+            event = parser.next()
+        }
+        return entries
+    }
+
+    private fun normalizePath(url: String): String =
+        URLDecoder.decode(url.toHttpUrlOrNull()?.encodedPath.orEmpty(), "UTF-8").trimEnd('/')
+
+    private fun parseHttpDate(value: String): Long {
+        return try {
+            SimpleDateFormat("EEE, dd MMM yyyy HH:mm:ss zzz", Locale.US).parse(value)?.time ?: 0L
+        } catch (e: Exception) {
+            0L
+        }
+    }
+
+    companion object {
+        private const val DAV_NAMESPACE = "DAV:"
+        private const val HTTP_MULTI_STATUS = 207
+        private val XML_MEDIA_TYPE = "application/xml; charset=utf-8".toMediaType()
+
+        private const val PROPFIND_BODY = """<?xml version="1.0" encoding="utf-8"?>
+<d:propfind xmlns:d="DAV:">
+  <d:prop>
+    <d:resourcetype/>
+    <d:getcontentlength/>
+    <d:getlastmodified/>
+  </d:prop>
+</d:propfind>"""
+    }
+}
@@ -0,0 +1,59 @@
+package com.hx.nekomimi.remote
+
+import android.content.Context
+import kotlinx.coroutines.Dispatchers
+import kotlinx.coroutines.withContext
+import okhttp3.HttpUrl
+import okhttp3.HttpUrl.Companion.toHttpUrlOrNull
+import java.io.File
+
+/**
+ * WebDAV 账号（按服务器来源 scheme://host:port 保存在应用私有的 no_backup 目录）
+ *
+ * 章节 URI 中不携带账号信息，所有请求由 [RemoteHttp] 按来源统一附加认证头。
+ * 只有界面进程写入；独立播放进程读取时通过 [CredentialStore] 看到最新内容，
+ * 不依赖已弃用且不可靠的 SharedPreferences MODE_MULTI_PROCESS。
+ */
+object WebDavCredentials {
+
+    private const val FILE_NAME = "webdav_credentials.properties"
+    private const val KEY_USER_SUFFIX = "|user"
+    private const val KEY_PASSWORD_SUFFIX = "|password"
+
+    data class Credential(val username: String, val password: String)
+
+    @Volatile
+    private var store: CredentialStore? = null
+
+    private fun origin(url: HttpUrl): String = "${url.scheme}://${url.host}:${url.port}"
+
+    private fun store(context: Context): CredentialStore = store ?: synchronized(this) {
+        store ?: CredentialStore(File(context.noBackupFilesDir, FILE_NAME)).also { store = it }
+    }
+
+    suspend fun save(context: Context, url: String, username: String, password: String) {
+        val httpUrl = url.toHttpUrlOrNull() ?: return
+        val key = origin(httpUrl)
+        withContext(Dispatchers.IO) {
+            store(context).edit { values ->
+                if (username.isEmpty()) {
+                    values.remove(key + KEY_USER_SUFFIX)
+                    values.remove(key + KEY_PASSWORD_SUFFIX)
+                } else {
+                    values.setProperty(key + KEY_USER_SUFFIX, username)
+                    values.setProperty(key + KEY_PASSWORD_SUFFIX, password)
+                }
+            }
+        }
+    }
+
+    /**
+     * 读取来源对应的账号（在 OkHttp 拦截器等后台线程调用）
+     */
+    fun get(context: Context, url: HttpUrl): Credential? {
+        val key = origin(url)
+        val store = store(context)
+        val username = store.get(key + KEY_USER_SUFFIX) ?: return null
+        return Credential(username, store.get(key + KEY_PASSWORD_SUFFIX).orEmpty())
+    }
+}
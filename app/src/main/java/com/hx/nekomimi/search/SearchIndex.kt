@@ -0,0 +1,54 @@
+package com.hx.nekomimi.search
+
+import android.net.Uri
+import com.hx.nekomimi.data.entity.Book
+import com.hx.nekomimi.data.entity.Chapter
+import com.hx.nekomimi.data.entity.SearchEntry
+
+/**
+ * 搜索索引行的构建（扫描写库和数据库迁移共用）
+ *
+ * 书籍行索引书名和根目录名；章节行索引章节标题和所在文件夹路径，
+ * 标签取自书名、根目录名和章节所在的各级文件夹名（有声书常把 CV、字幕组等写在文件夹名里）。
+ */
+object SearchIndex {
+
+    fun bookEntry(book: Book): SearchEntry {
+        val names = listOfNotNull(book.name, rootFolderName(book.rootUri))
+        return SearchEntry(
+            bookId = book.id,
+            chapterId = 0L,
+            terms = SearchTokenizer.indexTerms(names.joinToString(" ")),
+            tags = tagTerms(names)
+        )
+    }
+
+    fun chapterEntries(book: Book, chapters: List<Chapter>): List<SearchEntry> {
+        val bookTags = listOfNotNull(book.name, rootFolderName(book.rootUri))
+        val folderTags = mutableMapOf<String, String>()
+        return chapters.map { chapter ->
+            SearchEntry(
+                bookId = book.id,
+                chapterId = chapter.id,
+                terms = SearchTokenizer.indexTerms("${chapter.title} ${chapter.parentFolder}"),
+                tags = folderTags.getOrPut(chapter.parentFolder) {
+                    tagTerms(bookTags + chapter.parentFolder.split('/'))
+                }
+            )
+        }
+    }
+
+    private fun tagTerms(names: List<String>): String =
+        names.flatMap { SearchTokenizer.extractTags(it) }
+            .distinct()
+            .joinToString(" ") { SearchTokenizer.indexTerms(it) }
+
+    /**
+     * 根目录的文件夹名（SAF 目录树 URI 的最后一级，或 WebDAV 地址的最后一段）
+     */
+    private fun rootFolderName(rootUri: String?): String? {
+        val uri = Uri.parse(rootUri ?: return null)
+        val segment = uri.lastPathSegment ?: return null
+        return segment.substringAfterLast(':').substringAfterLast('/').takeIf { it.isNotBlank() }
+    }
+}
@@ -0,0 +1,124 @@
+package com.hx.nekomimi.search
+
+import java.text.Normalizer
+
+/**
+ * 搜索索引的分词（建索引和查询共用同一规则）
+ *
+ * FTS4 自带的 simple 分词器按空格和 ASCII 标点切分，中日韩文本会整段成为一个词，无法部分匹配，
+ * 所以入库前自行分词，以空格连接：
+ * - 字母 / 数字连续段作为一个词（小写，全角转半角），查询时按前缀匹配
+ * - 中日韩连续段拆成相邻两字的 bigram，末字再单独作为一个词；
+ *   查询时多字按 bigram 短语匹配，单字按前缀匹配（末字单独入库，所以任意位置的单字都能命中）
+ * - 中日韩连续段在 FTS 中是相邻的词，所以短语匹配等价于原文中的连续子串
+ */
+object SearchTokenizer {
+
+    private enum class CharClass { CJK, WORD, SEPARATOR }
+
+    /** 片假名长音符「ー」不属于任何文字，按假名处理 */
+    private const val PROLONGED_SOUND_MARK = 0x30FC
+
+    /** 书名、文件夹名中的标签：【CV:xxx】[字幕组] (完结) 「系列名」 等括号内的内容 */
+    private val TAG_PATTERN = Regex("""[【\[(（「『]([^】\])）」』]+)[】\])）」』]""")
+
+    /** 一个括号内的多个标签 */
+    private val TAG_SEPARATORS = Regex("""[、,，/&＆;；+]+""")
+
+    /**
+     * 入库用的词序列
+     */
+    fun indexTerms(text: String): String {
+        val terms = mutableListOf<String>()
+        for ((run, cls) in runs(text)) {
+            when (cls) {
+                CharClass.WORD -> terms.add(run)
+                CharClass.CJK -> {
+                    val chars = codePoints(run)
+                    for (i in 0 until chars.size - 1) terms.add(chars[i] + chars[i + 1])
+                    terms.add(chars.last())
+                }
+                CharClass.SEPARATOR -> Unit
+            }
+        }
+        return terms.joinToString(" ")
+    }
+
+    /**
+     * 用户输入 -> FTS MATCH 表达式（各部分之间为 AND）
+     * @param column 只在指定列中匹配，null 表示全部列
+     * @return 输入中没有可搜索的字符时返回 null
+     */
+    fun matchQuery(input: String, column: String? = null): String? {
+        val prefix = column?.let { "$it:" }.orEmpty()
+        val parts = runs(input).mapNotNull { (run, cls) ->
+            when (cls) {
+                CharClass.WORD -> "$prefix$run*"
+                CharClass.CJK -> {
+                    val chars = codePoints(run)
+                    val bigrams = (0 until chars.size - 1).map { chars[it] + chars[it + 1] }
+                    when {
+                        chars.size == 1 -> "$prefix${chars[0]}*"
+                        // 列限定不支持短语，退化为各 bigram 同时出现
+                        column != null -> bigrams.joinToString(" ") { "$prefix$it" }
+                        else -> "\"${bigrams.joinToString(" ")}\""
+                    }
+                }
+                CharClass.SEPARATOR -> null
+            }
+        }
+        return parts.takeIf { it.isNotEmpty() }?.joinToString(" ")
+    }
+
+    /**
+     * 从名称中提取括号内的标签
+     */
+    fun extractTags(name: String): List<String> =
+        TAG_PATTERN.findAll(name)
+            .flatMap { it.groupValues[1].split(TAG_SEPARATORS) }
+            // "CV:xxx" 这类标签同时能按 xxx 搜到
+            .flatMap { tag -> listOf(tag, tag.substringAfter(':', tag.substringAfter('：', ""))) }
+            .map { it.trim() }
+            .filter { it.isNotEmpty() }
+            .distinct()
+            .toList()
+
+    /**
+     * 归一化后按字符类别切分为连续段（分隔符段不返回内容）
+     */
+    private fun runs(text: String): List<Pair<String, CharClass>> {
+        val normalized = Normalizer.normalize(text, Normalizer.Form.NFKC).lowercase()
+        val result = mutableListOf<Pair<String, CharClass>>()
+        val current = StringBuilder()
+        var currentClass = CharClass.SEPARATOR
+        var i = 0
+        while (i < normalized.length) {
+            val cp = normalized.codePointAt(i)
+            val cls = classify(cp)
+            if (cls != currentClass && current.isNotEmpty()) {
+                result.add(current.toString() to currentClass)
+                current.clear()
+            }
+            currentClass = cls
+            if (cls != CharClass.SEPARATOR) current.appendCodePoint(cp)
+            i += Character.charCount(cp)
+        }
+        if (current.isNotEmpty()) result.add(current.toString() to currentClass)
+        return result
+    }
+
+    private fun classify(cp: Int): CharClass {
+        if (cp == PROLONGED_SOUND_MARK) return CharClass.CJK
+        when (Character.UnicodeScript.of(cp)) {
+            Character.UnicodeScript.HAN,
+            Character.UnicodeScript.HIRAGANA,
+            Character.UnicodeScript.KATAKANA,
+            Character.UnicodeScript.HANGUL -> return CharClass.CJK
+            else -> Unit
+        }
+        return if (Character.isLetterOrDigit(cp)) CharClass.WORD else CharClass.SEPARATOR
+    }
+
+    private fun codePoints(run: String): List<String> =
+        run.codePoints().toArray().map { String(Character.toChars(it)) }
+}
@@ -0,0 +1,43 @@
+package com.hx.nekomimi.service
+
+import androidx.media3.common.C
+import androidx.media3.common.MediaItem
+import androidx.media3.common.MediaMetadata
+import com.hx.nekomimi.data.entity.Chapter
+import com.hx.nekomimi.util.FileScanner
+
+/**
+ * 章节与 MediaItem 的对应（播放页和播放服务预热必须构建完全相同的 MediaItem）
+ */
+object ChapterMediaItems {
+
+    /**
+     * 虚拟章节通过裁剪播放文件中的一段，不拆分文件；mediaId 为章节 ID
+     */
+    fun build(chapter: Chapter): MediaItem? {
+        val audioUri = FileScanner.getAudioUri(chapter) ?: return null
+        return MediaItem.Builder()
+            .setMediaId(chapter.id.toString())
+            .setUri(audioUri)
+            .setClippingConfiguration(
+                MediaItem.ClippingConfiguration.Builder()
+                    .setStartPositionMs(chapter.startMs)
+                    .setEndPositionMs(if (chapter.endMs > 0) chapter.endMs else C.TIME_END_OF_SOURCE)
+                    .build()
+            )
+            // 进程重启后从快照恢复时没有数据库信息，通知栏标题直接取这里
+            .setMediaMetadata(MediaMetadata.Builder().setTitle(chapter.title).build())
+            .build()
+    }
+
+    /**
+     * 整本书的播放列表（没有音频的章节跳过）
+     * @return MediaItem 列表，以及 [chapterId] 在列表中的位置（找不到时为 -1）
+     */
+    fun buildPlaylist(chapters: List<Chapter>, chapterId: Long): Pair<List<MediaItem>, Int> {
+        val playable = chapters.mapNotNull { chapter -> build(chapter)?.let { chapter.id to it } }
+        return playable.map { it.second } to playable.indexOfFirst { it.first == chapterId }
+    }
+
+    fun chapterId(mediaItem: MediaItem?): Long? = mediaItem?.mediaId?.toLongOrNull()
+}
@@ -0,0 +1,78 @@
+package com.hx.nekomimi.service
+
+import android.net.Uri
+import android.util.Log
+import androidx.media3.common.C
+import androidx.media3.common.MediaItem
+import androidx.media3.common.PlaybackException
+import androidx.media3.common.Player
+import androidx.media3.common.util.UnstableApi
+import androidx.media3.exoplayer.ExoPlaybackException
+import androidx.media3.exoplayer.ExoPlayer
+import androidx.media3.exoplayer.Renderer
+import androidx.media3.exoplayer.audio.MediaCodecAudioRenderer
+import androidx.media3.exoplayer.trackselection.DefaultTrackSelector
+
+/**
+ * 平台解码器出错时改用 FFmpeg 扩展重试当前文件
+ *
+ * 渲染器工厂使用 EXTENSION_RENDERER_MODE_ON：平台 MediaCodec 排在前面，声明支持的格式总是优先使用。
+ * 部分设备的平台解码器对某些文件声称支持，却在初始化或解码中途失败（常见于 ALAC、高采样率 FLAC）。
+ * 这时禁用平台音频渲染器并重新 prepare，由扩展渲染器从出错位置继续；播放列表切到另一个文件时恢复平台解码器。
+ * 没有打包 FFmpeg 扩展、或扩展也失败时不再重试，错误照常交给界面提示。
+ * 所有方法都在主线程调用。
+ */
+@UnstableApi
+class DecoderFallback(
+    private val player: ExoPlayer,
+    private val trackSelector: DefaultTrackSelector
+) : Player.Listener {
+
+    companion object {
+        private const val TAG = "DecoderFallback"
+
+        private val DECODER_ERRORS = setOf(
+            PlaybackException.ERROR_CODE_DECODER_INIT_FAILED,
+            PlaybackException.ERROR_CODE_DECODER_QUERY_FAILED,
+            PlaybackException.ERROR_CODE_DECODING_FAILED,
+            PlaybackException.ERROR_CODE_DECODING_FORMAT_UNSUPPORTED,
+            PlaybackException.ERROR_CODE_DECODING_FORMAT_EXCEEDS_CAPABILITIES
+        )
+    }
+
+    /** 被禁用的平台音频渲染器序号，未禁用时为 [C.INDEX_UNSET] */
+    private var disabledRenderer = C.INDEX_UNSET
+
+    /** 改用扩展解码的文件（同一文件拆出的虚拟章节之间切换时保持扩展解码） */
+    private var fallbackUri: Uri? = null
+
+    override fun onPlayerError(error: PlaybackException) {
+        if (disabledRenderer != C.INDEX_UNSET || error.errorCode !in DECODER_ERRORS) return
+        val platform = audioRenderer { it is MediaCodecAudioRenderer }
+        val extension = audioRenderer { it !is MediaCodecAudioRenderer }
+        if (platform == C.INDEX_UNSET || extension == C.INDEX_UNSET) return
+        // 只处理平台音频渲染器自己的错误
+        if ((error as? ExoPlaybackException)?.rendererIndex != platform) return
+
+        Log.w(TAG, "平台解码器失败（${error.errorCodeName}），改用 ${player.getRenderer(extension).name} 重试", error)
+        disabledRenderer = platform
+        fallbackUri = player.currentMediaItem?.localConfiguration?.uri
+        trackSelector.setParameters(trackSelector.buildUponParameters().setRendererDisabled(platform, true))
+        player.prepare()
+    }
+
+    override fun onMediaItemTransition(mediaItem: MediaItem?, reason: Int) {
+        if (disabledRenderer == C.INDEX_UNSET) return
+        if (mediaItem?.localConfiguration?.uri == fallbackUri) return
+        trackSelector.setParameters(trackSelector.buildUponParameters().setRendererDisabled(disabledRenderer, false))
+        disabledRenderer = C.INDEX_UNSET
+        fallbackUri = null
+    }
+
+    private inline fun audioRenderer(predicate: (Renderer) -> Boolean): Int {
+        for (i in 0 until player.rendererCount) {
+            if (player.getRendererType(i) == C.TRACK_TYPE_AUDIO && predicate(player.getRenderer(i))) return i
+        }
+        return C.INDEX_UNSET
+    }
+}
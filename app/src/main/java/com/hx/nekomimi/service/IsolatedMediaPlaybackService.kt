@@ -0,0 +1,11 @@
+package com.hx.nekomimi.service
+
+import androidx.media3.common.util.UnstableApi
+
+/**
+ * 运行在独立 `:playback` 进程中的播放服务（清单中默认禁用，见 [PlaybackProcess]）
+ *
+ * 行为与 [MediaPlaybackService] 完全相同，只是单独声明一个组件以指定 android:process。
+ */
+@UnstableApi
+class IsolatedMediaPlaybackService : MediaPlaybackService()
@@ -1,33 +1,86 @@
 package com.hx.nekomimi.service
 
 import android.app.PendingIntent
+import android.content.Context
 import android.content.Intent
 import android.graphics.Color
+import android.net.Uri
 import android.os.Bundle
+import android.util.Log
 import androidx.core.app.NotificationCompat
 import androidx.media3.common.AudioAttributes
 import androidx.media3.common.C
+import androidx.media3.common.MediaItem
+import androidx.media3.common.PlaybackParameters
+import androidx.media3.common.Player
+import androidx.media3.common.Timeline
 import androidx.media3.common.util.UnstableApi
+import androidx.media3.exoplayer.DefaultRenderersFactory
 import androidx.media3.exoplayer.ExoPlayer
+import androidx.media3.exoplayer.analytics.AnalyticsListener
+import androidx.media3.exoplayer.audio.AudioSink
+import androidx.media3.exoplayer.audio.DefaultAudioSink
+import androidx.media3.exoplayer.source.DefaultMediaSourceFactory
+import androidx.media3.exoplayer.trackselection.DefaultTrackSelector
 import androidx.media3.session.CommandButton
 import androidx.media3.session.DefaultMediaNotificationProvider
 import androidx.media3.session.MediaNotification
 import androidx.media3.session.MediaSession
 import androidx.media3.session.MediaSessionService
+import androidx.media3.session.SessionCommand
+import androidx.media3.session.SessionResult
+import com.google.common.util.concurrent.Futures
+import com.google.common.util.concurrent.ListenableFuture
+import com.google.common.util.concurrent.SettableFuture
 import com.hx.nekomimi.NekoMimiApp
 import com.hx.nekomimi.R
+import com.hx.nekomimi.audio.PlaybackAudioChain
+import com.hx.nekomimi.audio.cache.PlaybackCache
+import com.hx.nekomimi.remote.RemoteFileCache
+import com.hx.nekomimi.remote.RemoteHttp
 import com.hx.nekomimi.ui.PlayerActivity
+import kotlinx.coroutines.CoroutineScope
+import kotlinx.coroutines.Dispatchers
+import kotlinx.coroutines.Job
+import kotlinx.coroutines.SupervisorJob
+import kotlinx.coroutines.cancel
+import kotlinx.coroutines.delay
+import kotlinx.coroutines.launch
+import kotlinx.coroutines.withContext
 
 @UnstableApi
-class MediaPlaybackService : MediaSessionService() {
+open class MediaPlaybackService : MediaSessionService() {
+
+    companion object {
+        private const val TAG = "MediaPlaybackService"
+        private const val SNAPSHOT_INTERVAL_MS = 10_000L
+    }
 
     private var mediaSession: MediaSession? = null
     private var player: ExoPlayer? = null
 
+    /** 音频处理链（原生 DSP 处理器） */
+    private val audioChain = PlaybackAudioChain()
+
+    private val serviceScope = CoroutineScope(SupervisorJob() + Dispatchers.Main)
+
+    private var snapshotJob: Job? = null
+
+    /** 当前字幕行写入会话元数据 */
+    private var subtitlePublisher: SessionSubtitlePublisher? = null
+
+    /** 本次服务生命周期内的 AudioTrack 欠载次数（用于对比同进程 / 独立进程的播放稳定性） */
+    private var underrunCount = 0
+
     override fun onCreate() {
         super.onCreate()
+        PlaybackSnapshot.preload(this)
 
-        val exoPlayer = ExoPlayer.Builder(this)
+        val trackSelector = DefaultTrackSelector(this)
+        val exoPlayer = ExoPlayer.Builder(this, createRenderersFactory())
+            .setTrackSelector(trackSelector)
+            // 云盘等慢速来源经过本地读穿缓存
+            .setMediaSourceFactory(DefaultMediaSourceFactory(PlaybackCache.dataSourceFactory(this)))
             .setAudioAttributes(
                 AudioAttributes.Builder()
                     .setContentType(C.AUDIO_CONTENT_TYPE_MUSIC)
@@ -39,6 +92,52 @@ class MediaPlaybackService : MediaSessionService() {
             .build()
 
         player = exoPlayer
+        exoPlayer.addListener(DecoderFallback(exoPlayer, trackSelector))
+
+        // 切换章节时预取当前章节和下一章节
+        exoPlayer.addListener(object : Player.Listener {
+            override fun onMediaItemTransition(mediaItem: MediaItem?, reason: Int) {
+                prefetchAround(mediaItem)
+                PlaybackSnapshot.savePosition(this@MediaPlaybackService, exoPlayer)
+            }
+
+            override fun onTimelineChanged(timeline: Timeline, reason: Int) {
+                if (reason == Player.TIMELINE_CHANGE_REASON_PLAYLIST_CHANGED && !timeline.isEmpty) {
+                    PlaybackSnapshot.savePlaylist(this@MediaPlaybackService, exoPlayer)
+                }
+            }
+
+            override fun onIsPlayingChanged(isPlaying: Boolean) {
+                snapshotJob?.cancel()
+                if (isPlaying) {
+                    // 播放中定期记录位置，进程被杀后恢复时误差不超过一个间隔
+                    snapshotJob = serviceScope.launch {
+                        while (true) {
+                            delay(SNAPSHOT_INTERVAL_MS)
+                            PlaybackSnapshot.savePosition(this@MediaPlaybackService, exoPlayer)
+                        }
+                    }
+                } else {
+                    PlaybackSnapshot.savePosition(this@MediaPlaybackService, exoPlayer)
+                    logPlaybackHealth()
+                }
+            }
+
+            override fun onPlaybackParametersChanged(playbackParameters: PlaybackParameters) {
+                PlaybackSnapshot.savePosition(this@MediaPlaybackService, exoPlayer)
+            }
+        })
+        exoPlayer.addAnalyticsListener(object : AnalyticsListener {
+            override fun onAudioUnderrun(
+                eventTime: AnalyticsListener.EventTime,
+                bufferSize: Int,
+                bufferSizeMs: Long,
+                elapsedSinceLastFeedMs: Long
+            ) {
+                underrunCount++
+                Log.w(TAG, "音频欠载 #$underrunCount，距上次写入 ${elapsedSinceLastFeedMs}ms")
+            }
+        })
 
         // 创建点击通知时打开播放页面的 Intent
         val intent = Intent(this, PlayerActivity::class.java)
@@ -47,14 +146,111 @@ class MediaPlaybackService : MediaSessionService() {
             PendingIntent.FLAG_UPDATE_CURRENT or PendingIntent.FLAG_IMMUTABLE
         )
 
-        mediaSession = MediaSession.Builder(this, exoPlayer)
+        // 会话使用叠加了当前字幕行的播放器包装，锁屏和车机上显示正在播放的台词
+        val sessionPlayer = SubtitleMetadataPlayer(exoPlayer)
+        mediaSession = MediaSession.Builder(this, sessionPlayer)
             .setSessionActivity(pendingIntent)
+            .setCallback(SessionCallback())
             .build()
+        subtitlePublisher = SessionSubtitlePublisher(this, sessionPlayer, serviceScope).also { it.start() }
 
         // 使用自定义通知 Provider，强制暗色主题 + 粉色强调色
         setMediaNotificationProvider(CustomMediaNotificationProvider())
     }
 
+    /**
+     * 渲染器工厂
+     * - EXTENSION_RENDERER_MODE_ON：扩展渲染器排在平台解码器之后，
+     *   只有平台 MediaCodec 不支持该格式时才会回落到 FFmpeg（需先构建 lib-decoder-ffmpeg，未打包时自动忽略）；
+     *   平台解码器声称支持却解码失败时由 [DecoderFallback] 改用 FFmpeg 重试
+     * - enableDecoderFallback：首选平台解码器初始化失败时，尝试其它可用解码器
+     * - AudioSink 中注入 [audioChain] 的处理器
+     */
+    private fun createRenderersFactory(): DefaultRenderersFactory {
+        return object : DefaultRenderersFactory(this) {
+            override fun buildAudioSink(
+                context: Context,
+                enableFloatOutput: Boolean,
+                enableAudioTrackPlaybackParams: Boolean
+            ): AudioSink {
+                return DefaultAudioSink.Builder(context)
+                    .setEnableFloatOutput(enableFloatOutput)
+                    .setEnableAudioTrackPlaybackParams(enableAudioTrackPlaybackParams)
+                    .setAudioProcessors(audioChain.processors())
+                    .build()
+            }
+        }
+            .setExtensionRendererMode(DefaultRenderersFactory.EXTENSION_RENDERER_MODE_ON)
+            .setEnableDecoderFallback(true)
+    }
+
+    /**
+     * 预取章节音频和字幕到缓存（MediaItem.mediaId 为章节 ID）
+     * 同一文件拆出的虚拟章节跳过，取下一个不同的文件
+     */
+    private fun prefetchAround(mediaItem: MediaItem?) {
+        val chapterId = ChapterMediaItems.chapterId(mediaItem) ?: return
+        serviceScope.launch {
+            val chapterDao = (application as NekoMimiApp).database.chapterDao()
+            val chapter = chapterDao.getChapterById(chapterId) ?: return@launch
+            val chapters = chapterDao.getChaptersByBookIdList(chapter.bookId)
+            val index = chapters.indexOfFirst { it.id == chapterId }
+            val next = chapters.drop(index + 1).firstOrNull { it.fileUri != chapter.fileUri }
+            val uris = listOfNotNull(chapter.fileUri, next?.fileUri).map { Uri.parse(it) }
+            PlaybackCache.prefetch(this@MediaPlaybackService, uris)
+            // 远程书库的字幕整份下载到本地，切到下一章时不必等待网络
+            withContext(Dispatchers.IO) {
+                RemoteFileCache.prefetch(
+                    this@MediaPlaybackService,
+                    listOfNotNull(chapter.subtitleUri, next?.subtitleUri)
+                )
+            }
+        }
+    }
+
+    /**
+     * 按上次进度载入播放列表但不播放（见 [PlaybackPrewarm]）
+     * 播放器已加载内容（正在播放或暂停中）时不做任何事；远程（WebDAV）章节不预热，打开应用时不访问网络
+     */
+    private fun prewarm(chapterId: Long, positionMs: Long) {
+        if (player?.mediaItemCount != 0) return
+        serviceScope.launch {
+            val chapterDao = (application as NekoMimiApp).database.chapterDao()
+            val chapter = chapterDao.getChapterById(chapterId) ?: return@launch
+            if (RemoteHttp.isRemote(chapter.fileUri)) return@launch
+            // 与播放页相同：整本书作为播放列表
+            val (items, index) = ChapterMediaItems.buildPlaylist(
+                chapterDao.getChaptersByBookIdList(chapter.bookId), chapterId
+            )
+            if (index < 0) return@launch
+            val exoPlayer = player ?: return@launch
+            if (exoPlayer.mediaItemCount != 0) return@launch
+            exoPlayer.playWhenReady = false
+            // 不 prepare：非 IDLE 的播放器会让 MediaSessionService 发布媒体通知和锁屏控件，
+            // 仅仅打开应用不应出现暂停中的播放通知；点击继续播放后由播放页 prepare
+            exoPlayer.setMediaItems(items, index, positionMs)
+        }
+    }
+
+    /**
+     * 暂停 / 停止时记录所在进程、Java 堆占用、欠载次数和夜间模式的处理耗时
+     */
+    private fun logPlaybackHealth() {
+        val usedMb = usedHeapKb() / 1024
+        val process = if (PlaybackProcess.isPlaybackProcess()) "playback" else "main"
+        val compressorCost = audioChain.compressor.takeCpuCost()
+        Log.i(
+            TAG,
+            "进程=$process 堆=${usedMb}MB 欠载=$underrunCount " +
+                "夜间模式=${audioChain.compressor.isEnabled()} 压缩耗时=${"%.2f".format(compressorCost)}ms/每秒音频"
+        )
+    }
+
+    private fun usedHeapKb(): Long {
+        val runtime = Runtime.getRuntime()
+        return (runtime.totalMemory() - runtime.freeMemory()) / 1024
+    }
+
     override fun onGetSession(controllerInfo: MediaSession.ControllerInfo): MediaSession? {
         return mediaSession
     }
@@ -67,15 +263,86 @@ class MediaPlaybackService : MediaSessionService() {
     }
 
     override fun onDestroy() {
+        player?.let { PlaybackSnapshot.savePosition(this, it) }
+        subtitlePublisher?.release()
+        subtitlePublisher = null
         mediaSession?.run {
             player.release()
             release()
             mediaSession = null
         }
         player = null
+        // 播放器已释放，关闭本进程的读穿缓存（下次创建服务时重新打开）
+        PlaybackCache.release()
+        logPlaybackHealth()
+        serviceScope.cancel()
         super.onDestroy()
     }
 
+    /**
+     * 会话回调：在默认命令之外开放预热命令，并支持进程重启后的恢复播放
+     */
+    private inner class SessionCallback : MediaSession.Callback {
+
+        override fun onConnect(
+            session: MediaSession,
+            controller: MediaSession.ControllerInfo
+        ): MediaSession.ConnectionResult {
+            val commands = MediaSession.ConnectionResult.DEFAULT_SESSION_COMMANDS.buildUpon()
+                .add(PlaybackPrewarm.COMMAND)
+                .add(NightMode.COMMAND)
+                .add(PlaybackHealth.COMMAND)
+                .build()
+            return MediaSession.ConnectionResult.AcceptedResultBuilder(session)
+                .setAvailableSessionCommands(commands)
+                .build()
+        }
+
+        /**
+         * 进程被杀后耳机按键 / 系统媒体控件恢复播放：只在后台线程读取快照，不查询数据库
+         */
+        override fun onPlaybackResumption(
+            mediaSession: MediaSession,
+            controller: MediaSession.ControllerInfo
+        ): ListenableFuture<MediaSession.MediaItemsWithStartPosition> {
+            val future = SettableFuture.create<MediaSession.MediaItemsWithStartPosition>()
+            serviceScope.launch {
+                val snapshot = PlaybackSnapshot.load(this@MediaPlaybackService)
+                if (snapshot == null) {
+                    future.setException(UnsupportedOperationException())
+                    return@launch
+                }
+                mediaSession.player.setPlaybackSpeed(snapshot.speed)
+                future.set(MediaSession.MediaItemsWithStartPosition(snapshot.items, snapshot.index, snapshot.positionMs))
+            }
+            return future
+        }
+
+        override fun onCustomCommand(
+            session: MediaSession,
+            controller: MediaSession.ControllerInfo,
+            customCommand: SessionCommand,
+            args: Bundle
+        ): ListenableFuture<SessionResult> {
+            if (customCommand.customAction == PlaybackPrewarm.ACTION) {
+                prewarm(
+                    args.getLong(PlaybackPrewarm.ARG_CHAPTER_ID),
+                    args.getLong(PlaybackPrewarm.ARG_POSITION_MS)
+                )
+                return Futures.immediateFuture(SessionResult(SessionResult.RESULT_SUCCESS))
+            }
+            if (customCommand.customAction == NightMode.ACTION) {
+                audioChain.compressor.setEnabled(args.getBoolean(NightMode.ARG_ENABLED))
+                return Futures.immediateFuture(SessionResult(SessionResult.RESULT_SUCCESS))
+            }
+            if (customCommand.customAction == PlaybackHealth.ACTION) {
+                val result = PlaybackHealth.result(usedHeapKb(), underrunCount)
+                return Futures.immediateFuture(SessionResult(SessionResult.RESULT_SUCCESS, result))
+            }
+            return super.onCustomCommand(session, controller, customCommand, args)
+        }
+    }
+
     /**
      * 自定义媒体通知 Provider
      * 在 DefaultMediaNotificationProvider 基础上，强制设置通知颜色为暗色背景 + 粉色强调色
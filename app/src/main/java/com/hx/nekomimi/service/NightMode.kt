@@ -0,0 +1,21 @@
+package com.hx.nekomimi.service
+
+import android.os.Bundle
+import androidx.media3.session.SessionCommand
+
+/**
+ * 夜间模式开关命令
+ *
+ * 开关保存在界面进程的设置中，播放页连接播放服务后发送一次，切换时再发送。
+ */
+object NightMode {
+
+    const val ACTION = "com.hx.nekomimi.action.NIGHT_MODE"
+    const val ARG_ENABLED = "enabled"
+
+    val COMMAND = SessionCommand(ACTION, Bundle.EMPTY)
+
+    fun args(enabled: Boolean): Bundle = Bundle().apply {
+        putBoolean(ARG_ENABLED, enabled)
+    }
+}
@@ -0,0 +1,24 @@
+package com.hx.nekomimi.service
+
+import android.os.Bundle
+import androidx.media3.session.SessionCommand
+
+/**
+ * 播放健康状况查询命令
+ *
+ * 服务在结果的 extras 中返回所在进程的 Java 堆占用和启动以来的音频欠载次数，
+ * 供 PlaybackProcessBenchmark 对比同进程和独立进程两种模式；界面不使用。
+ */
+object PlaybackHealth {
+
+    const val ACTION = "com.hx.nekomimi.action.PLAYBACK_HEALTH"
+    const val KEY_HEAP_KB = "heap_kb"
+    const val KEY_UNDERRUNS = "underruns"
+
+    val COMMAND = SessionCommand(ACTION, Bundle.EMPTY)
+
+    fun result(heapKb: Long, underruns: Int): Bundle = Bundle().apply {
+        putLong(KEY_HEAP_KB, heapKb)
+        putInt(KEY_UNDERRUNS, underruns)
+    }
+}
@@ -0,0 +1,25 @@
+package com.hx.nekomimi.service
+
+import android.os.Bundle
+import androidx.media3.session.SessionCommand
+
+/**
+ * 「继续播放」预热命令
+ *
+ * 书籍详情页 / 主页可见时发送给播放服务，服务按上次进度载入整本书的播放列表，但不 prepare、不播放
+ * （不会出现媒体通知，也不打开文件）；点击继续播放后，播放页发现播放器已载入同一章节，
+ * 省去连接服务、查询章节和构建播放列表，直接 prepare + play。远程章节不预热。
+ */
+object PlaybackPrewarm {
+
+    const val ACTION = "com.hx.nekomimi.action.PREWARM"
+    const val ARG_CHAPTER_ID = "chapter_id"
+    const val ARG_POSITION_MS = "position_ms"
+
+    val COMMAND = SessionCommand(ACTION, Bundle.EMPTY)
+
+    fun args(chapterId: Long, positionMs: Long): Bundle = Bundle().apply {
+        putLong(ARG_CHAPTER_ID, chapterId)
+        putLong(ARG_POSITION_MS, positionMs)
+    }
+}
@@ -0,0 +1,78 @@
+package com.hx.nekomimi.service
+
+import android.app.Application
+import android.content.ComponentName
+import android.content.Context
+import android.content.Intent
+import android.content.pm.PackageManager
+import android.os.Build
+import java.io.File
+
+/**
+ * 播放服务所在进程
+ *
+ * 播放服务有两个组件，同一时间只启用一个：
+ * - [MediaPlaybackService]：与界面同进程（默认）
+ * - [IsolatedMediaPlaybackService]：独立的 `:playback` 进程，不加载界面、Glide 和字幕列表，
+ *   界面卡顿和 GC 不会影响播放线程，息屏听书时进程堆也更小更稳定
+ *
+ * 控制端统一通过 [sessionComponent] 连接，MediaController 的用法不变。
+ * 两个进程通过 Room 的多实例失效通知共享数据库。
+ */
+object PlaybackProcess {
+
+    const val PROCESS_SUFFIX = ":playback"
+
+    fun isSeparateProcessEnabled(context: Context): Boolean {
+        val state = context.packageManager.getComponentEnabledSetting(
+            ComponentName(context, IsolatedMediaPlaybackService::class.java)
+        )
+        return state == PackageManager.COMPONENT_ENABLED_STATE_ENABLED
+    }
+
+    /**
+     * 切换播放服务所在进程；正在运行的旧服务会被停止，下次打开播放页时生效
+     */
+    fun setSeparateProcessEnabled(context: Context, enabled: Boolean) {
+        if (enabled == isSeparateProcessEnabled(context)) return
+        val (on, off) = if (enabled) {
+            IsolatedMediaPlaybackService::class.java to MediaPlaybackService::class.java
+        } else {
+            MediaPlaybackService::class.java to IsolatedMediaPlaybackService::class.java
+        }
+        context.stopService(Intent(context, off))
+        val pm = context.packageManager
+        pm.setComponentEnabledSetting(
+            ComponentName(context, on),
+            PackageManager.COMPONENT_ENABLED_STATE_ENABLED,
+            PackageManager.DONT_KILL_APP
+        )
+        pm.setComponentEnabledSetting(
+            ComponentName(context, off),
+            PackageManager.COMPONENT_ENABLED_STATE_DISABLED,
+            PackageManager.DONT_KILL_APP
+        )
+    }
+
+    /** MediaController 连接的会话服务组件 */
+    fun sessionComponent(context: Context): ComponentName {
+        val service = if (isSeparateProcessEnabled(context)) {
+            IsolatedMediaPlaybackService::class.java
+        } else {
+            MediaPlaybackService::class.java
+        }
+        return ComponentName(context, service)
+    }
+
+    /** 当前是否运行在独立播放进程中 */
+    fun isPlaybackProcess(): Boolean = processName().endsWith(PROCESS_SUFFIX)
+
+    private fun processName(): String {
+        if (Build.VERSION.SDK_INT >= Build.VERSION_CODES.P) return Application.getProcessName()
+        return try {
+            File("/proc/self/cmdline").readText().substringBefore('\u0000').trim()
+        } catch (e: Exception) {
+            ""
+        }
+    }
+}
@@ -0,0 +1,159 @@
+package com.hx.nekomimi.service
+
+import android.content.Context
+import android.net.Uri
+import androidx.media3.common.C
+import androidx.media3.common.MediaItem
+import androidx.media3.common.MediaMetadata
+import androidx.media3.common.Player
+import com.hx.nekomimi.NekoMimiApp
+import kotlinx.coroutines.CoroutineScope
+import kotlinx.coroutines.SupervisorJob
+import kotlinx.coroutines.asCoroutineDispatcher
+import kotlinx.coroutines.launch
+import kotlinx.coroutines.withContext
+import org.json.JSONArray
+import org.json.JSONObject
+import java.util.concurrent.Executors
+
+/**
+ * 播放状态快照（播放列表 / 当前章节 / 位置 / 倍速）
+ *
+ * 由播放服务写入，进程被杀后耳机按键或系统媒体控件恢复播放时，
+ * 只读取这一份 SharedPreferences 即可重建播放列表，不查询数据库、不启动界面。
+ * 播放列表只在变化时写入，位置和倍速单独写入；位置同时写入数据库的本书进度，
+ * 没有界面时（耳机 / 系统媒体控件恢复播放）继续播放卡片、预热和最近播放也不会落后。
+ *
+ * 播放器状态在调用线程（主线程）上取值，读写 SharedPreferences 和数据库都在单独的后台线程上按顺序执行：
+ * 同进程模式下服务的主线程就是界面主线程，首次访问 SharedPreferences 要等待从磁盘加载。
+ */
+object PlaybackSnapshot {
+
+    private const val PREFS_NAME = "playback_snapshot"
+    private const val KEY_PLAYLIST = "playlist"
+    private const val KEY_INDEX = "index"
+    private const val KEY_POSITION_MS = "position_ms"
+    private const val KEY_SPEED = "speed"
+
+    private const val FIELD_ID = "id"
+    private const val FIELD_URI = "uri"
+    private const val FIELD_START_MS = "start"
+    private const val FIELD_END_MS = "end"
+    private const val FIELD_TITLE = "title"
+
+    class State(val items: List<MediaItem>, val index: Int, val positionMs: Long, val speed: Float)
+
+    /** 单线程：写入按调用顺序落盘，后写的位置不会被先写的覆盖 */
+    private val dispatcher = Executors.newSingleThreadExecutor().asCoroutineDispatcher()
+    private val scope = CoroutineScope(SupervisorJob() + dispatcher)
+
+    /** 上次写入进度的章节及其书籍（只在 [dispatcher] 上访问） */
+    private var lastChapterId = 0L
+    private var lastBookId = 0L
+
+    private fun prefs(context: Context) = context.getSharedPreferences(PREFS_NAME, Context.MODE_PRIVATE)
+
+    /** 服务创建时调用：在后台线程把 SharedPreferences 从磁盘加载进内存 */
+    fun preload(context: Context) {
+        val appContext = context.applicationContext
+        scope.launch { prefs(appContext).contains(KEY_PLAYLIST) }
+    }
+
+    /** 播放列表变化时调用 */
+    fun savePlaylist(context: Context, player: Player) {
+        val items = JSONArray()
+        for (i in 0 until player.mediaItemCount) {
+            val item = player.getMediaItemAt(i)
+            val uri = item.localConfiguration?.uri ?: continue
+            items.put(
+                JSONObject()
+                    .put(FIELD_ID, item.mediaId)
+                    .put(FIELD_URI, uri.toString())
+                    .put(FIELD_START_MS, item.clippingConfiguration.startPositionMs)
+                    .put(FIELD_END_MS, item.clippingConfiguration.endPositionMs)
+                    .put(FIELD_TITLE, item.mediaMetadata.title?.toString().orEmpty())
+            )
+        }
+        val json = items.toString()
+        val index = player.currentMediaItemIndex
+        val positionMs = player.currentPosition
+        val appContext = context.applicationContext
+        scope.launch {
+            prefs(appContext).edit()
+                .putString(KEY_PLAYLIST, json)
+                .putInt(KEY_INDEX, index)
+                .putLong(KEY_POSITION_MS, positionMs)
+                .apply()
+        }
+    }
+
+    /** 切换章节、暂停和播放中定期调用 */
+    fun savePosition(context: Context, player: Player) {
+        if (player.mediaItemCount == 0) return
+        val index = player.currentMediaItemIndex
+        val positionMs = player.currentPosition
+        val speed = player.playbackParameters.speed
+        val chapterId = ChapterMediaItems.chapterId(player.currentMediaItem)
+        val appContext = context.applicationContext
+        scope.launch {
+            prefs(appContext).edit()
+                .putInt(KEY_INDEX, index)
+                .putLong(KEY_POSITION_MS, positionMs)
+                .putFloat(KEY_SPEED, speed)
+                .apply()
+            if (chapterId != null) saveProgress(appContext, chapterId, positionMs)
+        }
+    }
+
+    private suspend fun saveProgress(context: Context, chapterId: Long, positionMs: Long) {
+        try {
+            val database = (context as NekoMimiApp).database
+            if (chapterId != lastChapterId) {
+                lastBookId = database.chapterDao().getChapterById(chapterId)?.bookId ?: return
+                lastChapterId = chapterId
+            }
+            database.playbackProgressDao().upsert(lastBookId, chapterId, positionMs)
+        } catch (e: Exception) {
+            e.printStackTrace()
+        }
+    }
+
+    /**
+     * 在后台线程读取快照；没有快照或内容损坏时返回 null
+     */
+    suspend fun load(context: Context): State? = withContext(dispatcher) { read(context.applicationContext) }
+
+    private fun read(context: Context): State? {
+        val prefs = prefs(context)
+        val json = prefs.getString(KEY_PLAYLIST, null) ?: return null
+        val items = try {
+            val array = JSONArray(json)
+            List(array.length()) { i ->
+                val item = array.getJSONObject(i)
+                MediaItem.Builder()
+                    .setMediaId(item.getString(FIELD_ID))
+                    .setUri(Uri.parse(item.getString(FIELD_URI)))
+                    .setClippingConfiguration(
+                        MediaItem.ClippingConfiguration.Builder()
+                            .setStartPositionMs(item.optLong(FIELD_START_MS, 0L))
+                            .setEndPositionMs(item.optLong(FIELD_END_MS, C.TIME_END_OF_SOURCE))
+                            .build()
+                    )
+                    .setMediaMetadata(
+                        MediaMetadata.Builder().setTitle(item.optString(FIELD_TITLE).ifEmpty { null }).build()
+                    )
+                    .build()
+            }
+        } catch (e: Exception) {
+            e.printStackTrace()
+            return null
+        }
+        if (items.isEmpty()) return null
+        return State(
+            items = items,
+            index = prefs.getInt(KEY_INDEX, 0).coerceIn(0, items.size - 1),
+            positionMs = prefs.getLong(KEY_POSITION_MS, 0L).coerceAtLeast(0L),
+            speed = prefs.getFloat(KEY_SPEED, 1.0f)
+        )
+    }
+}
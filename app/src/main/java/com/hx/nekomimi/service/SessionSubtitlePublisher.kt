@@ -0,0 +1,174 @@
+package com.hx.nekomimi.service
+
+import android.content.Context
+import android.os.SystemClock
+import android.util.Log
+import androidx.media3.common.MediaItem
+import androidx.media3.common.PlaybackParameters
+import androidx.media3.common.Player
+import androidx.media3.common.util.UnstableApi
+import com.hx.nekomimi.NekoMimiApp
+import com.hx.nekomimi.data.entity.Chapter
+import com.hx.nekomimi.subtitle.SubtitleLoader
+import com.hx.nekomimi.subtitle.SubtitleTimeline
+import kotlinx.coroutines.CoroutineScope
+import kotlinx.coroutines.Dispatchers
+import kotlinx.coroutines.Job
+import kotlinx.coroutines.delay
+import kotlinx.coroutines.flow.collectLatest
+import kotlinx.coroutines.flow.distinctUntilChangedBy
+import kotlinx.coroutines.launch
+import kotlinx.coroutines.withContext
+
+/**
+ * 把当前字幕行发布到媒体会话元数据（锁屏、通知栏、蓝牙车机显示）
+ *
+ * 播放服务自己读取当前章节的字幕并在时间轴上查找，不依赖播放页是否打开。
+ * 下一次检查安排在下一个字幕边界；两次发布之间至少间隔 [MIN_UPDATE_INTERVAL_MS]，
+ * 期间的变化合并为一次（只发布到时的那一行），密集的 ASS 特效字幕也不会频繁重建通知。
+ * 所有方法都在主线程调用。
+ */
+@UnstableApi
+class SessionSubtitlePublisher(
+    private val context: Context,
+    private val sessionPlayer: SubtitleMetadataPlayer,
+    private val scope: CoroutineScope
+) : Player.Listener {
+
+    companion object {
+        private const val TAG = "SessionSubtitles"
+
+        /** 两次元数据更新的最小间隔 */
+        private const val MIN_UPDATE_INTERVAL_MS = 1000L
+
+        /** 没有后续字幕边界时的检查间隔 */
+        private const val MAX_CHECK_INTERVAL_MS = 10_000L
+
+        private const val MIN_CHECK_INTERVAL_MS = 50L
+
+        /** 下一行在这个时长内开始时，字幕间隙中保留上一行（避免元数据在行与行之间来回闪烁） */
+        private const val GAP_HOLD_MS = 2000L
+
+        /** 锁屏 / 车机单行显示的字数上限 */
+        private const val MAX_LINE_LENGTH = 80
+    }
+
+    private val player: Player = sessionPlayer.wrappedPlayer
+
+    private var timeline = SubtitleTimeline.EMPTY
+    private var chapterJob: Job? = null
+    private var tickJob: Job? = null
+    private var lastPublishAt = 0L
+
+    fun start() {
+        player.addListener(this)
+        onChapterChanged(player.currentMediaItem)
+    }
+
+    fun release() {
+        player.removeListener(this)
+        chapterJob?.cancel()
+        tickJob?.cancel()
+    }
+
+    override fun onMediaItemTransition(mediaItem: MediaItem?, reason: Int) {
+        onChapterChanged(mediaItem)
+    }
+
+    override fun onIsPlayingChanged(isPlaying: Boolean) = reschedule()
+
+    override fun onPositionDiscontinuity(
+        oldPosition: Player.PositionInfo,
+        newPosition: Player.PositionInfo,
+        reason: Int
+    ) = reschedule()
+
+    override fun onPlaybackParametersChanged(playbackParameters: PlaybackParameters) = reschedule()
+
+    /**
+     * 切换章节：清空字幕行，读取新章节的字幕；章节的字幕选择或同步设置变化时重新读取
+     */
+    private fun onChapterChanged(mediaItem: MediaItem?) {
+        chapterJob?.cancel()
+        tickJob?.cancel()
+        timeline = SubtitleTimeline.EMPTY
+        publish(null)
+        val chapterId = ChapterMediaItems.chapterId(mediaItem) ?: return
+        val chapterDao = (context.applicationContext as NekoMimiApp).database.chapterDao()
+        chapterJob = scope.launch {
+            chapterDao.observeChapter(chapterId)
+                .distinctUntilChangedBy { it?.let { c -> listOf(c.subtitleUri, c.subtitleOffsetMs, c.subtitleDriftPpm) } }
+                .collectLatest { chapter ->
+                    timeline = chapter?.let { loadTimeline(it) } ?: SubtitleTimeline.EMPTY
+                    reschedule()
+                }
+        }
+    }
+
+    private suspend fun loadTimeline(chapter: Chapter): SubtitleTimeline {
+        val subtitleUri = chapter.subtitleUri ?: return SubtitleTimeline.EMPTY
+        val entries = withContext(Dispatchers.IO) {
+            try {
+                SubtitleLoader.load(context, subtitleUri, chapter.fileUri)
+            } catch (e: Exception) {
+                Log.w(TAG, "读取字幕失败: $subtitleUri", e)
+                emptyList()
+            }
+        }
+        return SubtitleTimeline.forChapter(entries, chapter)
+    }
+
+    private fun reschedule() {
+        tickJob?.cancel()
+        if (timeline.isEmpty) {
+            publish(null)
+            return
+        }
+        tickJob = scope.launch {
+            while (true) {
+                val wait = MIN_UPDATE_INTERVAL_MS - (SystemClock.elapsedRealtime() - lastPublishAt)
+                if (wait > 0) delay(wait)
+                val positionMs = player.currentPosition
+                publish(lineAt(positionMs))
+                // 暂停时停在当前行，恢复播放或跳转时重新安排
+                if (!player.isPlaying) break
+                delay(delayUntilNextBoundary(positionMs))
+            }
+        }
+    }
+
+    private fun lineAt(positionMs: Long): CharSequence? {
+        val entries = timeline.entries
+        val index = timeline.indexAt(positionMs)
+        if (index >= 0) {
+            return entries[index].text.replace('\n', ' ').trim().take(MAX_LINE_LENGTH).ifEmpty { null }
+        }
+        val next = timeline.nextIndexAfter(positionMs)
+        if (next >= 0 && timeline.toAudioTime(entries[next].startMs) - positionMs <= GAP_HOLD_MS) {
+            return sessionPlayer.line
+        }
+        return null
+    }
+
+    /**
+     * 到下一个字幕边界（当前行结束或下一行开始）的实际等待时间（已按倍速换算）
+     */
+    private fun delayUntilNextBoundary(positionMs: Long): Long {
+        val entries = timeline.entries
+        val index = timeline.indexAt(positionMs)
+        val next = timeline.nextIndexAfter(positionMs)
+        val boundaries = listOfNotNull(
+            index.takeIf { it >= 0 }?.let { timeline.toAudioTime(entries[it].endMs) },
+            next.takeIf { it >= 0 }?.let { timeline.toAudioTime(entries[it].startMs) }
+        ).filter { it > positionMs }
+        val boundary = boundaries.minOrNull() ?: return MAX_CHECK_INTERVAL_MS
+        val speed = player.playbackParameters.speed.coerceAtLeast(0.1f)
+        return ((boundary - positionMs) / speed).toLong().coerceIn(MIN_CHECK_INTERVAL_MS, MAX_CHECK_INTERVAL_MS)
+    }
+
+    private fun publish(text: CharSequence?) {
+        if (text?.toString() == sessionPlayer.line?.toString()) return
+        sessionPlayer.setLine(text)
+        lastPublishAt = SystemClock.elapsedRealtime()
+    }
+}
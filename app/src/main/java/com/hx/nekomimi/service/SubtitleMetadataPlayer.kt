@@ -0,0 +1,57 @@
+package com.hx.nekomimi.service
+
+import androidx.media3.common.FlagSet
+import androidx.media3.common.ForwardingPlayer
+import androidx.media3.common.MediaMetadata
+import androidx.media3.common.Player
+import androidx.media3.common.util.UnstableApi
+import java.util.concurrent.CopyOnWriteArraySet
+
+/**
+ * 媒体会话使用的播放器包装：在当前章节的元数据上叠加正在播放的字幕行
+ *
+ * 字幕行同时写入 subtitle 和 artist（锁屏、通知栏和蓝牙车机 AVRCP 大多只显示标题 + 艺术家），
+ * 其余调用原样转发给被包装的播放器。[setLine] 只能在播放器所在线程调用。
+ */
+@UnstableApi
+class SubtitleMetadataPlayer(player: Player) : ForwardingPlayer(player) {
+
+    private val listeners = CopyOnWriteArraySet<Player.Listener>()
+
+    /** 当前显示的字幕行，null 表示只显示章节信息 */
+    var line: CharSequence? = null
+        private set
+
+    override fun addListener(listener: Player.Listener) {
+        super.addListener(listener)
+        listeners.add(listener)
+    }
+
+    override fun removeListener(listener: Player.Listener) {
+        super.removeListener(listener)
+        listeners.remove(listener)
+    }
+
+    override fun getMediaMetadata(): MediaMetadata {
+        val metadata = super.getMediaMetadata()
+        val text = line ?: return metadata
+        return metadata.buildUpon()
+            .setSubtitle(text)
+            .setArtist(text)
+            .build()
+    }
+
+    /**
+     * 更新字幕行并通知会话（会话据此刷新锁屏 / 通知栏，每次调用都可能重建通知，调用方负责限频）
+     */
+    fun setLine(text: CharSequence?) {
+        if (text?.toString() == line?.toString()) return
+        line = text
+        val metadata = mediaMetadata
+        val events = Player.Events(FlagSet.Builder().add(Player.EVENT_MEDIA_METADATA_CHANGED).build())
+        for (listener in listeners) {
+            listener.onMediaMetadataChanged(metadata)
+            listener.onEvents(this, events)
+        }
+    }
+}
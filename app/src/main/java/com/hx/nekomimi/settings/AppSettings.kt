@@ -0,0 +1,163 @@
+package com.hx.nekomimi.settings
+
+import android.content.Context
+import android.util.Log
+import androidx.datastore.core.DataStore
+import androidx.datastore.preferences.SharedPreferencesMigration
+import androidx.datastore.preferences.core.MutablePreferences
+import androidx.datastore.preferences.core.Preferences
+import androidx.datastore.preferences.core.booleanPreferencesKey
+import androidx.datastore.preferences.core.edit
+import androidx.datastore.preferences.core.emptyPreferences
+import androidx.datastore.preferences.core.floatPreferencesKey
+import androidx.datastore.preferences.core.intPreferencesKey
+import androidx.datastore.preferences.core.stringPreferencesKey
+import androidx.datastore.preferences.preferencesDataStore
+import com.hx.nekomimi.subtitle.SubtitleDisplayMode
+import kotlinx.coroutines.CoroutineScope
+import kotlinx.coroutines.Dispatchers
+import kotlinx.coroutines.SupervisorJob
+import kotlinx.coroutines.flow.MutableStateFlow
+import kotlinx.coroutines.flow.StateFlow
+import kotlinx.coroutines.flow.catch
+import kotlinx.coroutines.flow.filterNotNull
+import kotlinx.coroutines.flow.first
+import kotlinx.coroutines.launch
+
+/**
+ * 应用设置（DataStore 持久化 + 内存快照）
+ *
+ * - 启动时在 IO 线程加载一次，之后所有读取都走内存中的 [settings]，主线程不会碰磁盘
+ * - 修改先更新内存快照（界面立即生效），再异步写入 DataStore
+ * - 首次运行时从旧的 SharedPreferences（subtitle_prefs / bgm_settings）迁移
+ *
+ * DataStore 只能在单个进程中使用；独立播放进程不读写这里的设置。
+ */
+object AppSettings {
+
+    private const val TAG = "AppSettings"
+    private const val STORE_NAME = "settings"
+
+    private val KEY_SUBTITLE_MODE = intPreferencesKey("subtitle_display_mode")
+    private val KEY_PLAYBACK_SPEED = floatPreferencesKey("playback_speed")
+    private val KEY_BGM_URI = stringPreferencesKey("bgm_uri")
+    private val KEY_BGM_NAME = stringPreferencesKey("bgm_display_name")
+    private val KEY_BGM_VOLUME = floatPreferencesKey("bgm_volume")
+    private val KEY_BGM_ENABLED = booleanPreferencesKey("bgm_enabled")
+    private val KEY_NIGHT_MODE = booleanPreferencesKey("night_mode")
+    private val KEY_LOOKAHEAD_FRACTION = floatPreferencesKey("lookahead_fraction")
+
+    /**
+     * @param bgmDisplayName 背景音乐文件名（选择文件时在后台查询后保存）
+     * @param nightMode 夜间模式（播放时压缩动态范围）
+     * @param lookaheadFraction 当前章节播放到这个比例时预取下一章节（慢速存储可以调低，提前开始读取）
+     */
+    data class Settings(
+        val subtitleDisplayMode: SubtitleDisplayMode = SubtitleDisplayMode.DEFAULT,
+        val playbackSpeed: Float = 1.0f,
+        val bgmUri: String? = null,
+        val bgmDisplayName: String? = null,
+        val bgmVolume: Float = DEFAULT_BGM_VOLUME,
+        val bgmEnabled: Boolean = false,
+        val nightMode: Boolean = false,
+        val lookaheadFraction: Float = DEFAULT_LOOKAHEAD_FRACTION
+    )
+
+    const val DEFAULT_BGM_VOLUME = 0.3f // 默认背景音乐音量 30%
+    const val DEFAULT_LOOKAHEAD_FRACTION = 0.8f
+
+    /** 预取比例的取值范围：太早会白读用户不会听到的章节，太晚来不及读完 */
+    private const val MIN_LOOKAHEAD_FRACTION = 0.1f
+    private const val MAX_LOOKAHEAD_FRACTION = 0.95f
+
+    private val Context.dataStore: DataStore<Preferences> by preferencesDataStore(
+        name = STORE_NAME,
+        produceMigrations = { context ->
+            listOf(
+                SharedPreferencesMigration(context, "subtitle_prefs"),
+                SharedPreferencesMigration(context, "bgm_settings")
+            )
+        }
+    )
+
+    private val scope = CoroutineScope(SupervisorJob() + Dispatchers.IO)
+
+    private lateinit var store: DataStore<Preferences>
+
+    private val _settings = MutableStateFlow<Settings?>(null)
+
+    /** 内存快照；首次加载完成前为 null */
+    val settings: StateFlow<Settings?> = _settings
+
+    /** 当前设置（未加载完成时为默认值） */
+    val current: Settings get() = _settings.value ?: Settings()
+
+    /**
+     * 在 Application.onCreate 中调用，后台加载并持续同步快照
+     */
+    fun init(context: Context) {
+        if (::store.isInitialized) return
+        store = context.applicationContext.dataStore
+        scope.launch {
+            store.data
+                .catch { e ->
+                    Log.e(TAG, "读取设置失败，使用默认值", e)
+                    emit(emptyPreferences())
+                }
+                .collect { _settings.value = toSettings(it) }
+        }
+    }
+
+    /** 等待首次加载完成 */
+    suspend fun await(): Settings = settings.filterNotNull().first()
+
+    fun setSubtitleDisplayMode(mode: SubtitleDisplayMode) =
+        update({ it.copy(subtitleDisplayMode = mode) }) { it[KEY_SUBTITLE_MODE] = mode.ordinal }
+
+    fun setPlaybackSpeed(speed: Float) =
+        update({ it.copy(playbackSpeed = speed) }) { it[KEY_PLAYBACK_SPEED] = speed }
+
+    fun setBgm(uri: String?, displayName: String?) = update({ it.copy(bgmUri = uri, bgmDisplayName = displayName) }) {
+        if (uri == null) it.remove(KEY_BGM_URI) else it[KEY_BGM_URI] = uri
+        if (displayName == null) it.remove(KEY_BGM_NAME) else it[KEY_BGM_NAME] = displayName
+    }
+
+    fun setBgmVolume(volume: Float) =
+        update({ it.copy(bgmVolume = volume) }) { it[KEY_BGM_VOLUME] = volume }
+
+    fun setBgmEnabled(enabled: Boolean) =
+        update({ it.copy(bgmEnabled = enabled) }) { it[KEY_BGM_ENABLED] = enabled }
+
+    fun setNightMode(enabled: Boolean) =
+        update({ it.copy(nightMode = enabled) }) { it[KEY_NIGHT_MODE] = enabled }
+
+    fun setLookaheadFraction(fraction: Float) {
+        val value = fraction.coerceIn(MIN_LOOKAHEAD_FRACTION, MAX_LOOKAHEAD_FRACTION)
+        update({ it.copy(lookaheadFraction = value) }) { it[KEY_LOOKAHEAD_FRACTION] = value }
+    }
+
+    private fun update(snapshot: (Settings) -> Settings, write: (MutablePreferences) -> Unit) {
+        _settings.value = snapshot(current)
+        scope.launch {
+            try {
+                store.edit(write)
+            } catch (e: Exception) {
+                Log.e(TAG, "保存设置失败", e)
+            }
+        }
+    }
+
+    private fun toSettings(prefs: Preferences) = Settings(
+        subtitleDisplayMode = SubtitleDisplayMode.fromOrdinal(
+            prefs[KEY_SUBTITLE_MODE] ?: SubtitleDisplayMode.DEFAULT.ordinal
+        ),
+        playbackSpeed = prefs[KEY_PLAYBACK_SPEED] ?: 1.0f,
+        bgmUri = prefs[KEY_BGM_URI],
+        bgmDisplayName = prefs[KEY_BGM_NAME],
+        bgmVolume = prefs[KEY_BGM_VOLUME] ?: DEFAULT_BGM_VOLUME,
+        bgmEnabled = prefs[KEY_BGM_ENABLED] ?: false,
+        nightMode = prefs[KEY_NIGHT_MODE] ?: false,
+        lookaheadFraction = (prefs[KEY_LOOKAHEAD_FRACTION] ?: DEFAULT_LOOKAHEAD_FRACTION)
+            .coerceIn(MIN_LOOKAHEAD_FRACTION, MAX_LOOKAHEAD_FRACTION)
+    )
+}
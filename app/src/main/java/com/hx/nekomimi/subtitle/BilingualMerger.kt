@@ -0,0 +1,40 @@
+package com.hx.nekomimi.subtitle
+
+/**
+ * 双语字幕合并
+ *
+ * 以主字幕的时间为准，把第二字幕中与之重叠最多的条目文本拼接到下一行。
+ * 两份字幕各自先经过 [SubtitleTimeline] 映射到音频时间再比较，
+ * 因此两个轨道的时间轴不必完全一致；结果仍使用主字幕的原始时间。
+ */
+object BilingualMerger {
+
+    fun merge(primary: SubtitleTimeline, secondary: SubtitleTimeline): List<SubtitleEntry> {
+        val secondaryEntries = secondary.entries
+        if (secondaryEntries.isEmpty()) return primary.entries
+
+        // 第二字幕按音频时间的起点排序后双指针扫描
+        val starts = LongArray(secondaryEntries.size) { secondary.toAudioTime(secondaryEntries[it].startMs) }
+        val ends = LongArray(secondaryEntries.size) { secondary.toAudioTime(secondaryEntries[it].endMs) }
+
+        var cursor = 0
+        return primary.entries.map { entry ->
+            val start = primary.toAudioTime(entry.startMs)
+            val end = primary.toAudioTime(entry.endMs)
+            while (cursor < starts.size && ends[cursor] <= start) cursor++
+
+            var best = -1
+            var bestOverlap = 0L
+            var i = cursor
+            while (i < starts.size && starts[i] < end) {
+                val overlap = minOf(end, ends[i]) - maxOf(start, starts[i])
+                if (overlap > bestOverlap) {
+                    bestOverlap = overlap
+                    best = i
+                }
+                i++
+            }
+            if (best < 0) entry else entry.copy(text = entry.text + "\n" + secondaryEntries[best].text)
+        }
+    }
+}
@@ -0,0 +1,283 @@
+package com.hx.nekomimi.subtitle
+
+import android.content.Context
+import android.net.Uri
+import android.util.Log
+import com.hx.nekomimi.remote.RemoteHttp
+import okhttp3.Request
+import java.io.ByteArrayInputStream
+import java.io.DataInputStream
+import java.io.EOFException
+import java.io.IOException
+import java.io.InputStream
+import java.nio.charset.Charset
+
+/**
+ * ID3v2 内嵌歌词读取（SYLT 同步歌词 / USLT 非同步歌词）
+ *
+ * 只读取文件开头的 ID3 标签区域：逐个读取帧头，非歌词帧（封面等）直接跳过，不会读取音频数据。
+ * 支持 ID3v2.2（SLT / ULT）、v2.3、v2.4。优先使用 SYLT；USLT 本身是 LRC 文本时按 LRC 解析，
+ * 否则整段作为一条字幕。
+ */
+object Id3LyricsReader {
+
+    private const val TAG = "Id3LyricsReader"
+
+    /** 内嵌歌词在 SubtitleTrack.format 中的标记（轨道 URI 即音频文件本身） */
+    const val FORMAT = "id3"
+
+    /** 歌词帧大小上限，防止损坏的标签导致超大分配 */
+    private const val MAX_FRAME_SIZE = 1 shl 20
+
+    /** 非同步歌词整段显示的时长（无法知道音频时长，取一个足够长的值） */
+    private const val UNSYNCED_DURATION_MS = 24 * 3600_000L
+
+    /** SYLT 时间戳格式：毫秒（另一种 MPEG 帧格式需要帧时长，无法直接换算） */
+    private const val TIMESTAMP_MS = 2
+
+    /**
+     * @param language 帧中的 ISO-639-2 语言代码（规范化后，未识别时为空）
+     * @param synchronized 是否带时间（SYLT 或 LRC 格式的 USLT）
+     */
+    class Lyrics(val language: String, val entries: List<SubtitleEntry>, val synchronized: Boolean)
+
+    private class Frame(val id: String, val data: ByteArray)
+
+    /**
+     * 读取音频文件的内嵌歌词；没有歌词或读取失败时返回 null（不要在主线程调用）
+     */
+    fun read(context: Context, audioUri: Uri): Lyrics? {
+        return try {
+            if (RemoteHttp.isRemote(audioUri)) {
+                // 流式 GET，读完标签后立即断开
+                val request = Request.Builder().url(audioUri.toString()).build()
+                RemoteHttp.client(context).newCall(request).execute().use { response ->
+                    if (!response.isSuccessful) return null
+                    response.body?.byteStream()?.let { read(it) }
+                }
+            } else {
+                context.contentResolver.openInputStream(audioUri)?.use { read(it) }
+            }
+        } catch (e: Exception) {
+            Log.w(TAG, "读取内嵌歌词失败: $audioUri", e)
+            null
+        }
+    }
+
+    fun read(input: InputStream): Lyrics? {
+        val frames = readLyricFrames(DataInputStream(input))
+        val sylt = frames.filter { it.id == "SYLT" || it.id == "SLT" }
+            .firstNotNullOfOrNull { parseSylt(it.data) }
+        if (sylt != null) return sylt
+        return frames.filter { it.id == "USLT" || it.id == "ULT" }
+            .firstNotNullOfOrNull { parseUslt(it.data) }
+    }
+
+    // ========== 标签结构 ==========
+
+    private fun readLyricFrames(input: DataInputStream): List<Frame> {
+        val header = ByteArray(10)
+        try {
+            input.readFully(header)
+        } catch (e: EOFException) {
+            return emptyList()
+        }
+        if (header[0] != 'I'.code.toByte() || header[1] != 'D'.code.toByte() || header[2] != '3'.code.toByte()) {
+            return emptyList()
+        }
+        val version = header[3].toInt()
+        if (version !in 2..4) return emptyList()
+        val flags = header[5].toInt() and 0xFF
+        val tagSize = syncSafe(header, 6)
+
+        // 整个标签做了反同步（v2.2 / v2.3）：读入内存还原后再解析
+        var body: DataInputStream = input
+        var remaining = tagSize
+        if (flags and 0x80 != 0 && version < 4) {
+            val raw = ByteArray(tagSize)
+            input.readFully(raw)
+            val restored = removeUnsynchronisation(raw)
+            body = DataInputStream(ByteArrayInputStream(restored))
+            remaining = restored.size
+        }
+
+        // 扩展头
+        if (flags and 0x40 != 0 && version >= 3) {
+            val sizeBytes = ByteArray(4).also { body.readFully(it) }
+            val extSize = if (version == 4) syncSafe(sizeBytes, 0) - 4 else readInt(sizeBytes, 0)
+            skipFully(body, extSize.toLong())
+            remaining -= 4 + extSize
+        }
+
+        val frames = mutableListOf<Frame>()
+        val idLength = if (version == 2) 3 else 4
+        val headerLength = if (version == 2) 6 else 10
+        val frameHeader = ByteArray(headerLength)
+        while (remaining >= headerLength) {
+            body.readFully(frameHeader)
+            remaining -= headerLength
+            if (frameHeader[0].toInt() == 0) break // 填充区
+
+            val id = String(frameHeader, 0, idLength, Charsets.ISO_8859_1)
+            val size = when (version) {
+                2 -> ((frameHeader[3].toInt() and 0xFF) shl 16) or
+                    ((frameHeader[4].toInt() and 0xFF) shl 8) or (frameHeader[5].toInt() and 0xFF)
+                3 -> readInt(frameHeader, 4)
+                else -> syncSafe(frameHeader, 4)
+            }
+            if (size < 0 || size > remaining) break
+            remaining -= size
+
+            val isLyrics = id == "SYLT" || id == "USLT" || id == "SLT" || id == "ULT"
+            if (!isLyrics || size > MAX_FRAME_SIZE) {
+                skipFully(body, size.toLong())
+                continue
+            }
+            val data = ByteArray(size).also { body.readFully(it) }
+            decodeFrameFlags(version, frameHeader, data)?.let { frames.add(Frame(id, it)) }
+        }
+        return frames
+    }
+
+    /**
+     * 处理帧格式标志；压缩或加密的帧返回 null
+     */
+    private fun decodeFrameFlags(version: Int, header: ByteArray, data: ByteArray): ByteArray? {
+        if (version == 2) return data
+        val format = header[9].toInt() and 0xFF
+        if (version == 3) {
+            if (format and 0xC0 != 0) return null // 压缩 / 加密
+            return if (format and 0x20 != 0) data.copyOfRange(1, data.size) else data // 分组标识
+        }
+        if (format and 0x0C != 0) return null // 压缩 / 加密
+        var result = data
+        if (format and 0x40 != 0) result = result.copyOfRange(1, result.size) // 分组标识
+        if (format and 0x01 != 0) result = result.copyOfRange(4, result.size) // 数据长度指示
+        if (format and 0x02 != 0) result = removeUnsynchronisation(result)
+        return result
+    }
+
+    // ========== 歌词帧 ==========
+
+    /**
+     * SYLT：encoding(1) language(3) timestampFormat(1) contentType(1) descriptor(字符串)
+     * 之后重复：text(字符串) timestamp(4)
+     */
+    private fun parseSylt(data: ByteArray): Lyrics? {
+        if (data.size < 6) return null
+        val encoding = data[0].toInt()
+        val language = SubtitleLanguage.fromIso639(String(data, 1, 3, Charsets.ISO_8859_1))
+        if (data[4].toInt() != TIMESTAMP_MS) return null
+        var position = readString(data, 6, encoding).second
+
+        val syllables = mutableListOf<Pair<Long, String>>()
+        while (position < data.size) {
+            val (text, next) = readString(data, position, encoding)
+            if (next + 4 > data.size) break
+            syllables.add(readInt(data, next).toLong() to text)
+            position = next + 4
+        }
+        if (syllables.isEmpty()) return null
+
+        // 逐字歌词：以换行开头的音节开始新的一句，每个音节的时间成为卡拉 OK 填充时间；否则每个条目就是一句
+        val karaoke = syllables.any { it.second.startsWith("\n") || it.second.startsWith("\r") }
+        val lines = if (!karaoke) {
+            syllables.map { LyricLine(it.first, it.second.trim()) }
+        } else {
+            class Merged(val startMs: Long, val text: StringBuilder, val words: MutableList<WordMark>)
+            val merged = mutableListOf<Merged>()
+            for ((time, text) in syllables) {
+                val isNewLine = text.startsWith("\n") || text.startsWith("\r")
+                if (merged.isEmpty() || isNewLine) merged.add(Merged(time, StringBuilder(), mutableListOf()))
+                val line = merged.last()
+                line.words.add(WordMark(time, line.text.length))
+                line.text.append(if (isNewLine) text.trimStart('\r', '\n') else text)
+            }
+            merged.map { LyricTiming.line(it.startMs, it.text.toString(), it.words) }
+        }
+        val entries = LyricTiming.toEntries(lines)
+        return if (entries.isEmpty()) null else Lyrics(language, entries, synchronized = true)
+    }
+
+    /**
+     * USLT：encoding(1) language(3) descriptor(字符串) lyrics(字符串)
+     */
+    private fun parseUslt(data: ByteArray): Lyrics? {
+        if (data.size < 4) return null
+        val encoding = data[0].toInt()
+        val language = SubtitleLanguage.fromIso639(String(data, 1, 3, Charsets.ISO_8859_1))
+        val descriptorEnd = readString(data, 4, encoding).second
+        val text = readString(data, descriptorEnd, encoding).first.trim()
+        if (text.isEmpty()) return null
+
+        // 不少工具把 LRC 原文写进 USLT
+        val lrc = LrcParser().parse(text)
+        if (lrc.isNotEmpty()) return Lyrics(language, lrc, synchronized = true)
+        return Lyrics(language, listOf(SubtitleEntry(0L, UNSYNCED_DURATION_MS, text)), synchronized = false)
+    }
+
+    // ========== 字节工具 ==========
+
+    /**
+     * 读取以 0 结尾的字符串
+     * @return 字符串与结束符之后的位置
+     */
+    private fun readString(data: ByteArray, start: Int, encoding: Int): Pair<String, Int> {
+        if (start >= data.size) return "" to data.size
+        val wide = encoding == 1 || encoding == 2
+        var end = start
+        if (wide) {
+            while (end + 1 < data.size && !(data[end].toInt() == 0 && data[end + 1].toInt() == 0)) end += 2
+        } else {
+            while (end < data.size && data[end].toInt() != 0) end++
+        }
+        val text = String(data, start, minOf(end, data.size) - start, charsetOf(encoding))
+        val next = if (wide) minOf(end + 2, data.size) else minOf(end + 1, data.size)
+        return text.removePrefix("\uFEFF") to next
+    }
+
+    private fun charsetOf(encoding: Int): Charset = when (encoding) {
+        1 -> Charsets.UTF_16
+        2 -> Charsets.UTF_16BE
+        3 -> Charsets.UTF_8
+        else -> Charsets.ISO_8859_1
+    }
+
+    private fun syncSafe(bytes: ByteArray, offset: Int): Int =
+        ((bytes[offset].toInt() and 0x7F) shl 21) or
+            ((bytes[offset + 1].toInt() and 0x7F) shl 14) or
+            ((bytes[offset + 2].toInt() and 0x7F) shl 7) or
+            (bytes[offset + 3].toInt() and 0x7F)
+
+    private fun readInt(bytes: ByteArray, offset: Int): Int =
+        ((bytes[offset].toInt() and 0xFF) shl 24) or
+            ((bytes[offset + 1].toInt() and 0xFF) shl 16) or
+            ((bytes[offset + 2].toInt() and 0xFF) shl 8) or
+            (bytes[offset + 3].toInt() and 0xFF)
+
+    /** 反同步还原：FF 00 → FF */
+    private fun removeUnsynchronisation(data: ByteArray): ByteArray {
+        val out = ByteArray(data.size)
+        var n = 0
+        var i = 0
+        while (i < data.size) {
+            out[n++] = data[i]
+            if (data[i] == 0xFF.toByte() && i + 1 < data.size && data[i + 1].toInt() == 0) i++
+            i++
+        }
+        return out.copyOf(n)
+    }
+
+    private fun skipFully(input: InputStream, count: Long) {
+        var remaining = count
+        while (remaining > 0) {
+            val skipped = input.skip(remaining)
+            if (skipped <= 0) {
+                if (input.read() < 0) throw IOException("意外的标签结尾")
+                remaining--
+            } else {
+                remaining -= skipped
+            }
+        }
+    }
+}
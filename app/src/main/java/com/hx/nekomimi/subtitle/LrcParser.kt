@@ -0,0 +1,146 @@
+package com.hx.nekomimi.subtitle
+
+/**
+ * LRC 歌词解析器
+ *
+ * LRC 格式示例:
+ * ```
+ * [ti:标题]
+ * [offset:+500]
+ * [00:12.00][01:30.50]同一句在两个时间出现
+ * [00:15.20]<00:15.20>逐<00:15.60>字<00:16.00>时间
+ * [00:18.00]
+ * ```
+ * - 一行可以有多个时间标签，每个时间各生成一条字幕
+ * - 增强格式的逐字时间标签 `<mm:ss.xx>` 转为卡拉 OK 音节：每个字（词）从自己的标签填充到下一个标签，
+ *   行尾单独的标签只作为最后一个字的结束时间
+ * - 空白行只作为上一句的结束时间
+ * - `[offset:]` 为正数时歌词整体提前
+ */
+class LrcParser : SubtitleParser {
+
+    private val timeTagPattern = Regex("""\[(\d+):(\d{1,2})(?:[.:](\d{1,3}))?]""")
+    private val offsetPattern = Regex("""^\[offset:\s*([+-]?\d+)\s*]$""", RegexOption.IGNORE_CASE)
+    private val wordTagPattern = Regex("""<(\d+):(\d{1,2})(?:[.:](\d{1,3}))?>""")
+
+    override fun parse(content: String): List<SubtitleEntry> {
+        val lines = mutableListOf<LyricLine>()
+        var offsetMs = 0L
+
+        for (raw in content.lines()) {
+            val line = raw.trim()
+            if (!line.startsWith("[")) continue
+
+            offsetPattern.find(line)?.let { match ->
+                offsetMs = match.groupValues[1].toLong()
+                continue
+            }
+
+            // 行首连续的时间标签
+            val times = mutableListOf<Long>()
+            var position = 0
+            while (true) {
+                val match = timeTagPattern.matchAt(line, position) ?: break
+                times.add(toMs(match))
+                position = match.range.last + 1
+            }
+            if (times.isEmpty()) continue // [ti:] [ar:] 等标签行
+
+            // 逐字标签：记录每个标签在去掉标签后的文本中的位置
+            val text = StringBuilder()
+            val marks = mutableListOf<WordMark>()
+            var textStart = position
+            for (match in wordTagPattern.findAll(line, position)) {
+                text.append(line, textStart, match.range.first)
+                marks.add(WordMark(toMs(match), text.length))
+                textStart = match.range.last + 1
+            }
+            text.append(line, textStart, line.length)
+
+            // 同一句出现在多个时间时，逐字时间随行时间平移
+            for (time in times) {
+                val shift = time - times.first() - offsetMs
+                val shifted = marks.map { WordMark((it.startMs + shift).coerceAtLeast(0L), it.position) }
+                lines.add(LyricTiming.line((time - offsetMs).coerceAtLeast(0L), text.toString(), shifted))
+            }
+        }
+
+        return LyricTiming.toEntries(lines)
+    }
+
+    private fun toMs(match: MatchResult): Long {
+        val (m, s, fraction) = match.destructured
+        return m.toLong() * 60_000 + s.toLong() * 1000 + fractionToMs(fraction)
+    }
+
+    /** 小数部分：1 位为十分之一秒，2 位为百分之一秒，3 位为毫秒 */
+    private fun fractionToMs(fraction: String): Long = when (fraction.length) {
+        0 -> 0L
+        1 -> fraction.toLong() * 100
+        2 -> fraction.toLong() * 10
+        else -> fraction.toLong()
+    }
+}
+
+/**
+ * 逐字时间：从 [startMs] 起填充 [LyricLine.text] 中 [position] 开始的字，直到下一个标记
+ */
+internal data class WordMark(val startMs: Long, val position: Int)
+
+/**
+ * 只有开始时间的一句歌词
+ * @param text 歌词文本（空文本只作为上一句的结束标记）
+ * @param words 逐字时间标记，按位置递增；为空表示没有逐字时间
+ */
+internal class LyricLine(val startMs: Long, val text: String, val words: List<WordMark> = emptyList())
+
+/**
+ * 只有开始时间的歌词（LRC、ID3 SYLT）转换为字幕条目：每句持续到下一句开始
+ */
+internal object LyricTiming {
+
+    /** 最后一句没有下一句时的显示时长 */
+    private const val LAST_LINE_MS = 5_000L
+
+    /**
+     * 去掉 [raw] 首尾空白，同时换算逐字标记的位置
+     */
+    fun line(startMs: Long, raw: String, words: List<WordMark>): LyricLine {
+        val text = raw.trim()
+        val lead = raw.length - raw.trimStart().length
+        return LyricLine(startMs, text, words.map { it.copy(position = (it.position - lead).coerceIn(0, text.length)) })
+    }
+
+    fun toEntries(lines: List<LyricLine>): List<SubtitleEntry> {
+        val sorted = lines.sortedBy { it.startMs }
+        val entries = ArrayList<SubtitleEntry>(sorted.size)
+        for (i in sorted.indices) {
+            val line = sorted[i]
+            if (line.text.isEmpty()) continue
+            val startMs = line.startMs
+            val endMs = sorted.getOrNull(i + 1)?.startMs?.takeIf { it > startMs } ?: (startMs + LAST_LINE_MS)
+            entries.add(SubtitleEntry(startMs, endMs, line.text, syllables(line, endMs)))
+        }
+        return entries
+    }
+
+    /**
+     * 每个标记到下一个标记之间的文字为一个音节（逐渐填充）；第一个标记之前的文字从句首开始，
+     * 最后一个音节持续到句末。标记之间没有文字时只作为上一个音节的结束时间
+     */
+    private fun syllables(line: LyricLine, endMs: Long): List<KaraokeSyllable> {
+        if (line.words.isEmpty()) return emptyList()
+        val marks = if (line.words.first().position > 0) listOf(WordMark(line.startMs, 0)) + line.words else line.words
+        val result = ArrayList<KaraokeSyllable>(marks.size)
+        for (j in marks.indices) {
+            val mark = marks[j]
+            val next = marks.getOrNull(j + 1)
+            val end = next?.position ?: line.text.length
+            if (end <= mark.position) continue
+            val syllableStart = mark.startMs.coerceIn(line.startMs, endMs)
+            val syllableEnd = (next?.startMs ?: endMs).coerceIn(syllableStart, endMs)
+            result.add(KaraokeSyllable(syllableStart, syllableEnd, mark.position, end, sweep = true))
+        }
+        return result
+    }
+}
@@ -0,0 +1,71 @@
+package com.hx.nekomimi.subtitle
+
+/**
+ * 字幕文件名中的语言标记
+ *
+ * 常见命名：`01.zh.srt`、`01.chs.ass`、`01.ja-JP.srt`、`01 [简体].srt`。
+ * 只识别已知标记，避免把 `part2`、`v2` 之类的文件名后缀误当作语言。
+ */
+object SubtitleLanguage {
+
+    const val ZH_HANS = "zh-Hans"
+    const val ZH_HANT = "zh-Hant"
+    const val JA = "ja"
+    const val EN = "en"
+    const val KO = "ko"
+
+    private val ALIASES: Map<String, String> = buildMap {
+        listOf("zh", "chs", "sc", "gb", "chi", "zho", "zh-cn", "zh-hans", "zh-sg", "简体", "简中", "简", "中文")
+            .forEach { put(it, ZH_HANS) }
+        listOf("cht", "tc", "big5", "zh-tw", "zh-hk", "zh-hant", "繁體", "繁体", "繁中", "繁")
+            .forEach { put(it, ZH_HANT) }
+        listOf("ja", "jp", "jpn", "ja-jp", "日本語", "日文", "日语", "日")
+            .forEach { put(it, JA) }
+        listOf("en", "eng", "en-us", "en-gb", "英文", "英语", "英")
+            .forEach { put(it, EN) }
+        listOf("ko", "kor", "ko-kr", "韩文", "韩语", "한국어")
+            .forEach { put(it, KO) }
+    }
+
+    /** 选择默认轨道时的优先级（未标注语言的轨道排在最前） */
+    private val PRIORITY = listOf("", ZH_HANS, ZH_HANT, JA, EN, KO)
+
+    private val BRACKETED_TAG = Regex("""[\s_-]*[\[(（【]([^\])）】]+)[\])）】]\s*$""")
+
+    /**
+     * 解析字幕文件名（不含扩展名）
+     * @return 去掉语言标记后的文件名，以及规范化的语言代码（未识别时为空）
+     */
+    fun split(baseName: String): Pair<String, String> {
+        // 01 [简体] / 01（日文）
+        BRACKETED_TAG.find(baseName)?.let { match ->
+            val language = ALIASES[match.groupValues[1].trim().lowercase()]
+            if (language != null) return baseName.substring(0, match.range.first) to language
+        }
+        // 01.zh / 01.ja-JP
+        val dot = baseName.lastIndexOf('.')
+        if (dot > 0) {
+            val language = ALIASES[baseName.substring(dot + 1).trim().lowercase().replace('_', '-')]
+            if (language != null) return baseName.substring(0, dot) to language
+        }
+        return baseName to ""
+    }
+
+    /**
+     * ID3 帧中的 ISO-639-2 语言代码（chi / jpn / eng …），未识别（含 XXX、und）时为空
+     */
+    fun fromIso639(code: String): String = ALIASES[code.trim().lowercase()].orEmpty()
+
+    /** 按默认优先级排序用的权重 */
+    fun rank(language: String): Int = PRIORITY.indexOf(language).let { if (it < 0) PRIORITY.size else it }
+
+    /** 语言的显示名称（未识别的语言直接显示代码） */
+    fun displayName(language: String): String = when (language) {
+        ZH_HANS -> "简体中文"
+        ZH_HANT -> "繁體中文"
+        JA -> "日本語"
+        EN -> "English"
+        KO -> "한국어"
+        else -> language
+    }
+}
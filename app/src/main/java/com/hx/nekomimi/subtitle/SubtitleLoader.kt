@@ -0,0 +1,81 @@
+package com.hx.nekomimi.subtitle
+
+import android.content.Context
+import android.net.Uri
+import android.util.LruCache
+import com.hx.nekomimi.cache.CachePriority
+import com.hx.nekomimi.cache.TrimmableCache
+import com.hx.nekomimi.data.entity.Chapter
+import com.hx.nekomimi.util.FileScanner
+import com.hx.nekomimi.util.Tracing
+
+/**
+ * 字幕读取与解析（进程内共享缓存）
+ *
+ * 播放页、书籍详情页 / 主页的预热都从这里读取，预热时解析好的字幕打开播放页时直接命中。
+ */
+object SubtitleLoader {
+
+    /** 缓存容量（字节，估算值） */
+    private const val CACHE_MAX_BYTES = 2 shl 20
+
+    /** 每条字幕除文本外的对象开销（SubtitleEntry + String 头，估算值） */
+    private const val ENTRY_OVERHEAD_BYTES = 64
+
+    /** 每个卡拉 OK 音节的对象开销（估算值） */
+    private const val SYLLABLE_BYTES = 40
+
+    /** 已解析的字幕（按 URI），切换轨道时不必重新读取和解析 */
+    private val parsedTracks = object : LruCache<String, List<SubtitleEntry>>(CACHE_MAX_BYTES) {
+        override fun sizeOf(key: String, value: List<SubtitleEntry>): Int =
+            value.sumOf { ENTRY_OVERHEAD_BYTES + it.text.length * 2 + it.syllables.size * SYLLABLE_BYTES }.coerceAtLeast(1)
+    }
+
+    /** 注册到 [com.hx.nekomimi.cache.CacheRegistry] 的内存缓存 */
+    val memoryCache: TrimmableCache = object : TrimmableCache {
+        override val name = "字幕时间轴"
+        override val priority = CachePriority.NORMAL
+        override fun sizeBytes(): Long = parsedTracks.size().toLong()
+        override fun maxSizeBytes(): Long = parsedTracks.maxSize().toLong()
+        override fun trimTo(fraction: Float) {
+            if (fraction <= 0f) parsedTracks.evictAll() else parsedTracks.trimToSize((parsedTracks.size() * fraction).toInt())
+        }
+    }
+
+    /**
+     * 读取并解析一条字幕轨道（不要在主线程调用）
+     * @param audioUri 所属音频；与 [subtitleUri] 相同时为内嵌 ID3 歌词
+     */
+    fun load(context: Context, subtitleUri: String, audioUri: String?): List<SubtitleEntry> {
+        parsedTracks.get(subtitleUri)?.let { return it }
+
+        if (subtitleUri == audioUri) {
+            val lyrics = Tracing.section("subtitle.id3") { Id3LyricsReader.read(context, Uri.parse(subtitleUri)) }
+                ?: return emptyList()
+            return lyrics.entries.also { parsedTracks.put(subtitleUri, it) }
+        }
+
+        val content = Tracing.section("subtitle.read") { FileScanner.readSubtitleContent(context, subtitleUri) }
+            ?: return emptyList()
+
+        // 根据 URI 判断字幕类型
+        val fileName = Uri.parse(subtitleUri).lastPathSegment ?: "subtitle.srt"
+        return SubtitleHelper.parseSubtitle(content, fileName).also { parsedTracks.put(subtitleUri, it) }
+    }
+
+    /** 已缓存的解析结果，未缓存时为 null（可在主线程调用） */
+    fun peek(subtitleUri: String): List<SubtitleEntry>? = parsedTracks.get(subtitleUri)
+
+    /**
+     * 预解析章节当前选择的字幕（含双语的第二字幕），失败时忽略
+     */
+    fun preload(context: Context, chapter: Chapter) {
+        listOfNotNull(chapter.subtitleUri, chapter.secondarySubtitleUri).forEach { uri ->
+            try {
+                load(context, uri, chapter.fileUri)
+            } catch (e: Exception) {
+                e.printStackTrace()
+            }
+        }
+    }
+}
@@ -1,15 +1,35 @@
 package com.hx.nekomimi.subtitle
 
+import com.hx.nekomimi.util.Tracing
+
 /**
  * 字幕条目
  * @param startMs 开始时间（毫秒）
  * @param endMs 结束时间（毫秒）
  * @param text 字幕文本
+ * @param syllables 逐字 / 逐音节的卡拉 OK 时间（ASS \k 标签、增强 LRC 的 <mm:ss.xx> 逐字标签、ID3 SYLT 逐字歌词），按时间顺序；没有时为空
  */
 data class SubtitleEntry(
     val startMs: Long,
     val endMs: Long,
-    val text: String
+    val text: String,
+    val syllables: List<KaraokeSyllable> = emptyList()
+)
+
+/**
+ * 卡拉 OK 音节
+ * @param startMs 开始时间（毫秒，与字幕条目同一时间轴）
+ * @param endMs 结束时间（毫秒）
+ * @param start 在 [SubtitleEntry.text] 中的起始字符位置
+ * @param end 在 [SubtitleEntry.text] 中的结束字符位置（不含）
+ * @param sweep true 表示在音节时长内从左到右逐渐填充（\kf、\K），false 表示开始时整个音节立即高亮（\k、\ko）
+ */
+data class KaraokeSyllable(
+    val startMs: Long,
+    val endMs: Long,
+    val start: Int,
+    val end: Int,
+    val sweep: Boolean
 )
 
 /**
@@ -88,6 +108,9 @@ class AssParser : SubtitleParser {
 
     private val timePattern = Regex("""(\d+):(\d{2}):(\d{2})\.(\d{2})""")
 
+    /** 卡拉 OK 标签：\k \kf \K \ko 后跟时长（厘秒） */
+    private val karaokeTag = Regex("""\\(kf|ko|k|K)(\d+)""")
+
     override fun parse(content: String): List<SubtitleEntry> {
         val entries = mutableListOf<SubtitleEntry>()
         val lines = content.split(Regex("""\r?\n"""))
@@ -138,10 +161,14 @@ class AssParser : SubtitleParser {
                     parts.last().trim()
                 }
 
-                // 清理 ASS 样式标签
-                val cleanText = cleanAssText(text)
-                if (cleanText.isNotEmpty()) {
-                    entries.add(SubtitleEntry(startTime, endTime, cleanText))
+                // 带卡拉 OK 标签的行保留音节时间，其余只清理 ASS 样式标签
+                val entry = if (karaokeTag.containsMatchIn(text)) {
+                    parseKaraoke(text, startTime, endTime)
+                } else {
+                    SubtitleEntry(startTime, endTime, cleanAssText(text))
+                }
+                if (entry.text.isNotEmpty()) {
+                    entries.add(entry)
                 }
             }
         }
@@ -169,6 +196,69 @@ class AssParser : SubtitleParser {
             .replace("\\h", " ")                  // ASS 硬空格
             .trim()
     }
+
+    /**
+     * 解析带卡拉 OK 标签的文本，得到与 [cleanAssText] 相同的文本和各音节的时间
+     * 例如: {\k20}こ{\k30}ん{\kf40}にちは -> こんにちは，音节 こ / ん / にちは
+     *
+     * 每个 \k 标签结束上一个音节并开始新音节，时长从行开始时间依次累加；
+     * 没有文本的音节（连续标签、句中停顿）只占用时间，不产生音节。
+     */
+    private fun parseKaraoke(raw: String, startMs: Long, endMs: Long): SubtitleEntry {
+        val text = StringBuilder()
+        val syllables = mutableListOf<KaraokeSyllable>()
+        var cursorMs = startMs
+        var pending: KaraokeSyllable? = null
+
+        fun closePending() {
+            val syllable = pending ?: return
+            if (text.length > syllable.start) syllables.add(syllable.copy(end = text.length))
+            pending = null
+        }
+
+        var i = 0
+        while (i < raw.length) {
+            val c = raw[i]
+            when {
+                c == '{' && raw.indexOf('}', i) > i -> {
+                    val close = raw.indexOf('}', i)
+                    for (match in karaokeTag.findAll(raw.substring(i + 1, close))) {
+                        closePending()
+                        val (tag, centis) = match.destructured
+                        val durationMs = centis.toLong() * 10L
+                        pending = KaraokeSyllable(
+                            startMs = cursorMs,
+                            endMs = (cursorMs + durationMs).coerceAtMost(endMs),
+                            start = text.length,
+                            end = text.length,
+                            sweep = tag == "kf" || tag == "K"
+                        )
+                        cursorMs += durationMs
+                    }
+                    i = close + 1
+                }
+                c == '\\' && i + 1 < raw.length && raw[i + 1] in "Nnh" -> {
+                    text.append(if (raw[i + 1] == 'h') ' ' else '\n')
+                    i += 2
+                }
+                else -> {
+                    text.append(c)
+                    i++
+                }
+            }
+        }
+        closePending()
+
+        // 与 cleanAssText 一样去掉首尾空白，音节位置随之平移
+        val leading = text.length - text.trimStart().length
+        val trimmed = text.trim().toString()
+        val shifted = syllables.mapNotNull { s ->
+            val start = (s.start - leading).coerceIn(0, trimmed.length)
+            val end = (s.end - leading).coerceIn(0, trimmed.length)
+            if (end > start) s.copy(start = start, end = end) else null
+        }
+        return SubtitleEntry(startMs, endMs, trimmed, shifted)
+    }
 }
 
 /**
@@ -184,9 +274,10 @@ object SubtitleHelper {
             fileName.endsWith(".srt", ignoreCase = true) -> SrtParser()
             fileName.endsWith(".ass", ignoreCase = true) -> AssParser()
             fileName.endsWith(".ssa", ignoreCase = true) -> AssParser()
+            fileName.endsWith(".lrc", ignoreCase = true) -> LrcParser()
             else -> SrtParser() // 默认使用 SRT 解析
         }
-        return parser.parse(content)
+        return Tracing.section("subtitle.parse.${parser.javaClass.simpleName}") { parser.parse(content) }
     }
 
     /**
@@ -0,0 +1,247 @@
+package com.hx.nekomimi.subtitle
+
+import android.content.Context
+import android.net.Uri
+import android.util.Log
+import com.hx.nekomimi.audio.PcmDecoder
+import com.hx.nekomimi.audio.dsp.Fft
+import kotlin.math.abs
+import kotlin.math.ln
+import kotlin.math.max
+import kotlin.math.min
+import kotlin.math.roundToLong
+import kotlin.math.sqrt
+
+/**
+ * 字幕自动对齐分析器
+ *
+ * 把音频的语音活动包络与字幕的出现/消失模式做 FFT 互相关，估计字幕相对音频的偏移：
+ * 1. 在章节中均匀取若干分析窗（短章节直接整章一个窗），只解码这些区间
+ * 2. 每个窗以 10 ms 为一帧计算对数能量，按分位数归一化为语音活动度
+ * 3. 与同一区间（两侧各扩展最大搜索范围）的字幕占空序列做互相关，取峰值作为该窗的偏移
+ * 4. 多个可信窗的偏移做线性拟合得到全局偏移和漂移；窗数不足或漂移不显著时只取中位数偏移
+ *
+ * 只解码部分音频，1 小时章节通常几秒内完成；必须在后台线程调用。
+ */
+class SubtitleSyncAnalyzer(
+    private val context: Context,
+    private val maxOffsetMs: Long = DEFAULT_MAX_OFFSET_MS
+) {
+
+    /**
+     * @param offsetMs 全局偏移（音频时间 = 字幕时间 × (1 + drift) + offset）
+     * @param driftPpm 线性漂移，未检测到时为 0
+     * @param confidence 峰值显著性（峰值高出相关序列均值的标准差倍数，取各窗中位数）
+     * @param windows 参与估计的可信窗数
+     */
+    data class Result(
+        val offsetMs: Long,
+        val driftPpm: Float,
+        val confidence: Float,
+        val windows: Int
+    )
+
+    private class WindowEstimate(val centerMs: Long, val offsetMs: Double, val confidence: Float)
+
+    /**
+     * 分析一个章节
+     * @param durationMs 章节时长，未知时传 0（以最后一条字幕的结束时间估计）
+     * @return 估计结果；没有可信的相关峰时返回 null
+     */
+    fun analyze(audioUri: Uri, entries: List<SubtitleEntry>, durationMs: Long): Result? {
+        if (entries.isEmpty()) return null
+        val totalMs = if (durationMs > 0) durationMs else entries.last().endMs + maxOffsetMs
+
+        val estimates = planWindows(totalMs).mapNotNull { (startMs, endMs) ->
+            analyzeWindow(audioUri, entries, startMs, endMs)
+        }
+        if (estimates.isEmpty()) return null
+
+        val confidence = estimates.map { it.confidence }.sorted()[estimates.size / 2]
+        val medianOffset = estimates.map { it.offsetMs }.sorted()[estimates.size / 2]
+
+        // 线性拟合 offset(t) = a + b·t；残差过大（存在误匹配窗）或漂移不显著时退回中位数
+        if (estimates.size >= MIN_WINDOWS_FOR_DRIFT) {
+            val fit = fitLine(estimates)
+            if (fit != null) {
+                val (a, b) = fit
+                val driftPpm = b * 1_000_000
+                val maxResidual = estimates.maxOf { abs(it.offsetMs - (a + b * it.centerMs)) }
+                if (abs(driftPpm) >= MIN_DRIFT_PPM && maxResidual <= MAX_FIT_RESIDUAL_MS) {
+                    return Result(a.roundToLong(), driftPpm.toFloat(), confidence, estimates.size)
+                }
+            }
+        }
+        return Result(medianOffset.roundToLong(), 0f, confidence, estimates.size)
+    }
+
+    /**
+     * 分析窗布局：[startMs, endMs) 列表
+     */
+    private fun planWindows(totalMs: Long): List<Pair<Long, Long>> {
+        if (totalMs <= WINDOW_MS * 2) return listOf(0L to totalMs)
+        val count = (totalMs / WINDOW_SPACING_MS).toInt().coerceIn(MIN_WINDOWS_FOR_DRIFT, MAX_WINDOWS)
+        return (0 until count).map { i ->
+            val center = totalMs * (2 * i + 1) / (2 * count)
+            val start = (center - WINDOW_MS / 2).coerceAtLeast(0)
+            start to min(start + WINDOW_MS, totalMs)
+        }
+    }
+
+    private fun analyzeWindow(
+        audioUri: Uri,
+        entries: List<SubtitleEntry>,
+        startMs: Long,
+        endMs: Long
+    ): WindowEstimate? {
+        val activity = speechActivity(audioUri, startMs, endMs) ?: return null
+        val n = activity.size
+        val lag = (maxOffsetMs / FRAME_MS).toInt()
+        val m = n + 2 * lag
+
+        // 字幕占空序列覆盖 [startMs - maxOffset, endMs + maxOffset)
+        val cues = cuePattern(entries, startMs - lag * FRAME_MS, m)
+        if (cues.none { it != 0f }) return null
+        removeMean(activity)
+        removeMean(cues)
+
+        // r[k] = Σ a[i]·c[i+k]，k ∈ [0, 2·lag]，对应偏移 d = lag - k
+        // 长度 ≥ m 时 i + k < m，不会发生循环卷绕
+        val fft = Fft(Fft.sizeFor(m))
+        val size = fft.size
+        val aRe = FloatArray(size).also { activity.copyInto(it) }
+        val aIm = FloatArray(size)
+        val cRe = FloatArray(size).also { cues.copyInto(it) }
+        val cIm = FloatArray(size)
+        fft.transform(aRe, aIm)
+        fft.transform(cRe, cIm)
+        for (i in 0 until size) {
+            // conj(A)·C
+            val re = aRe[i] * cRe[i] + aIm[i] * cIm[i]
+            val im = aRe[i] * cIm[i] - aIm[i] * cRe[i]
+            cRe[i] = re
+            cIm[i] = im
+        }
+        fft.transform(cRe, cIm, inverse = true)
+
+        val scores = cRe.copyOf(2 * lag + 1)
+        var best = 0
+        for (k in scores.indices) if (scores[k] > scores[best]) best = k
+
+        val mean = scores.average()
+        val std = sqrt(scores.sumOf { (it - mean) * (it - mean) } / scores.size)
+        if (std <= 0.0) return null
+        val confidence = ((scores[best] - mean) / std).toFloat()
+        if (confidence < MIN_CONFIDENCE) return null
+
+        // 抛物线插值得到亚帧精度
+        var refined = best.toDouble()
+        if (best > 0 && best < scores.size - 1) {
+            val l = scores[best - 1]
+            val c = scores[best]
+            val r = scores[best + 1]
+            val denominator = l - 2 * c + r
+            if (denominator != 0f) refined += 0.5 * (l - r) / denominator
+        }
+        val offsetMs = (lag - refined) * FRAME_MS
+        Log.d(TAG, "窗口 ${startMs / 1000}s-${endMs / 1000}s: 偏移 ${offsetMs.toLong()}ms, 显著性 %.1f".format(confidence))
+        return WindowEstimate((startMs + endMs) / 2, offsetMs, confidence)
+    }
+
+    /**
+     * 解码区间并计算每帧的语音活动度（0..1）
+     */
+    private fun speechActivity(audioUri: Uri, startMs: Long, endMs: Long): FloatArray? {
+        val frameSamples = (ANALYSIS_SAMPLE_RATE * FRAME_MS / 1000).toInt()
+        val frames = ((endMs - startMs) / FRAME_MS).toInt()
+        if (frames <= 0) return null
+        val energy = FloatArray(frames)
+
+        var frame = 0
+        var filled = 0
+        var sum = 0f
+        PcmDecoder(context, audioUri).decode(
+            startMs = startMs,
+            endMs = endMs,
+            targetSampleRate = ANALYSIS_SAMPLE_RATE
+        ) { samples, count, _ ->
+            for (i in 0 until count) {
+                sum += samples[i] * samples[i]
+                if (++filled == frameSamples) {
+                    if (frame < frames) energy[frame] = ln(sum / frameSamples + ENERGY_EPSILON)
+                    frame++
+                    filled = 0
+                    sum = 0f
+                }
+            }
+            frame < frames
+        }
+        if (frame < frames / 2) return null
+
+        // 按分位数归一化：低分位近似噪声底，高分位近似语音电平，对录音音量不敏感
+        val valid = energy.copyOf(min(frame, frames))
+        val sorted = valid.sortedArray()
+        val floor = sorted[(sorted.size * 0.1).toInt()]
+        val ceiling = sorted[(sorted.size * 0.9).toInt()]
+        val range = max(ceiling - floor, 1e-3f)
+        for (i in valid.indices) valid[i] = ((valid[i] - floor) / range).coerceIn(0f, 1f)
+        return valid
+    }
+
+    /**
+     * 字幕占空序列：帧时间落在任一字幕区间内为 1，否则为 0
+     */
+    private fun cuePattern(entries: List<SubtitleEntry>, fromMs: Long, frames: Int): FloatArray {
+        val pattern = FloatArray(frames)
+        val toMs = fromMs + frames * FRAME_MS
+        for (entry in entries) {
+            if (entry.endMs <= fromMs || entry.startMs >= toMs) continue
+            val first = ((entry.startMs - fromMs) / FRAME_MS).toInt().coerceAtLeast(0)
+            val last = ((entry.endMs - fromMs) / FRAME_MS).toInt().coerceAtMost(frames)
+            for (i in first until last) pattern[i] = 1f
+        }
+        return pattern
+    }
+
+    private fun removeMean(values: FloatArray) {
+        val mean = values.average().toFloat()
+        for (i in values.indices) values[i] -= mean
+    }
+
+    /** 最小二乘拟合 offset = a + b·centerMs */
+    private fun fitLine(estimates: List<WindowEstimate>): Pair<Double, Double>? {
+        val n = estimates.size
+        val meanX = estimates.sumOf { it.centerMs.toDouble() } / n
+        val meanY = estimates.sumOf { it.offsetMs } / n
+        var sxx = 0.0
+        var sxy = 0.0
+        for (e in estimates) {
+            val dx = e.centerMs - meanX
+            sxx += dx * dx
+            sxy += dx * (e.offsetMs - meanY)
+        }
+        if (sxx <= 0.0) return null
+        val b = sxy / sxx
+        return (meanY - b * meanX) to b
+    }
+
+    companion object {
+        private const val TAG = "SubtitleSync"
+
+        /** 默认最大搜索偏移 */
+        const val DEFAULT_MAX_OFFSET_MS = 30_000L
+
+        private const val ANALYSIS_SAMPLE_RATE = 8000
+        private const val FRAME_MS = 10L
+
+        private const val WINDOW_MS = 180_000L
+        private const val WINDOW_SPACING_MS = 600_000L
+        private const val MAX_WINDOWS = 6
+        private const val MIN_WINDOWS_FOR_DRIFT = 3
+
+        private const val MIN_CONFIDENCE = 4f
+        private const val MIN_DRIFT_PPM = 100.0
+        private const val MAX_FIT_RESIDUAL_MS = 250.0
+        private const val ENERGY_EPSILON = 1e-10f
+    }
+}
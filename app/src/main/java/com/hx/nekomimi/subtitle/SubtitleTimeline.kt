@@ -0,0 +1,77 @@
+package com.hx.nekomimi.subtitle
+
+import com.hx.nekomimi.data.entity.Chapter
+import kotlin.math.roundToLong
+
+/**
+ * 字幕时间轴
+ *
+ * 在不改写字幕条目的前提下应用同步校正，并用二分查找定位当前字幕：
+ * 音频时间 = 字幕时间 × (1 + drift) + offset
+ *
+ * @param entries 按 startMs 升序排列的字幕条目（解析器输出即为有序）
+ * @param offsetMs 全局偏移，正数表示字幕整体延后
+ * @param driftPpm 线性漂移（百万分之一），字幕时间轴相对音频的速率误差
+ */
+class SubtitleTimeline(
+    val entries: List<SubtitleEntry>,
+    val offsetMs: Long = 0L,
+    val driftPpm: Float = 0f
+) {
+
+    private val scale = 1.0 + driftPpm / 1_000_000.0
+
+    val isEmpty: Boolean get() = entries.isEmpty()
+
+    /** 音频时间 -> 字幕时间 */
+    fun toSubtitleTime(audioMs: Long): Long = ((audioMs - offsetMs) / scale).roundToLong()
+
+    /** 字幕时间 -> 音频时间（例如点击字幕跳转时使用） */
+    fun toAudioTime(subtitleMs: Long): Long = (subtitleMs * scale).roundToLong() + offsetMs
+
+    /**
+     * 当前播放位置对应的字幕索引，没有时返回 -1
+     * 多条字幕重叠时返回最后开始的那一条
+     */
+    fun indexAt(audioMs: Long): Int {
+        val t = toSubtitleTime(audioMs)
+        val i = lastStartingAtOrBefore(t)
+        return if (i >= 0 && t <= entries[i].endMs) i else -1
+    }
+
+    /** 当前播放位置之后第一条字幕的索引，没有时返回 -1 */
+    fun nextIndexAfter(audioMs: Long): Int {
+        val i = lastStartingAtOrBefore(toSubtitleTime(audioMs)) + 1
+        return if (i < entries.size) i else -1
+    }
+
+    fun withSync(offsetMs: Long, driftPpm: Float): SubtitleTimeline =
+        SubtitleTimeline(entries, offsetMs, driftPpm)
+
+    private fun lastStartingAtOrBefore(t: Long): Int {
+        var lo = 0
+        var hi = entries.size - 1
+        var result = -1
+        while (lo <= hi) {
+            val mid = (lo + hi) ushr 1
+            if (entries[mid].startMs <= t) {
+                result = mid
+                lo = mid + 1
+            } else {
+                hi = mid - 1
+            }
+        }
+        return result
+    }
+
+    companion object {
+        val EMPTY = SubtitleTimeline(emptyList())
+
+        /**
+         * 章节的字幕时间轴：应用章节保存的同步校正；
+         * 虚拟章节的播放位置从章节起点算起，而字幕时间以整个文件为准
+         */
+        fun forChapter(entries: List<SubtitleEntry>, chapter: Chapter): SubtitleTimeline =
+            SubtitleTimeline(entries, chapter.subtitleOffsetMs - chapter.startMs, chapter.subtitleDriftPpm)
+    }
+}
@@ -0,0 +1,35 @@
+package com.hx.nekomimi.transcribe
+
+import android.content.Context
+import android.net.Uri
+import com.hx.nekomimi.util.HashUtils
+import java.io.File
+
+/**
+ * 自动生成字幕的存放位置
+ *
+ * SAF 目录只有读权限，生成的 SRT 放在应用私有目录，按音频 URI 的哈希命名，
+ * 这样重新扫描书籍（章节 ID 变化）后仍能找回已生成的字幕。
+ */
+object GeneratedSubtitles {
+
+    private const val DIR = "subtitles/generated"
+    private const val PARTIAL_SUFFIX = ".part"
+
+    fun fileFor(context: Context, audioUri: String): File =
+        File(File(context.filesDir, DIR), "${HashUtils.sha1Hex(audioUri)}.srt")
+
+    /** 转写进行中的临时文件（按分块追加写入，完成后重命名） */
+    fun partialFileFor(context: Context, audioUri: String): File {
+        val file = fileFor(context, audioUri)
+        return File(file.parentFile, file.name + PARTIAL_SUFFIX)
+    }
+
+    /**
+     * 查找已生成的字幕，返回可直接写入 Chapter.subtitleUri 的 URI
+     */
+    fun find(context: Context, audioUri: String): String? {
+        val file = fileFor(context, audioUri)
+        return if (file.isFile) Uri.fromFile(file).toString() else null
+    }
+}
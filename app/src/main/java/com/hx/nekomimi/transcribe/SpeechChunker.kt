@@ -0,0 +1,129 @@
+package com.hx.nekomimi.transcribe
+
+import kotlin.math.max
+import kotlin.math.min
+import kotlin.math.sqrt
+
+/**
+ * 基于能量 VAD 的语音分块器
+ *
+ * 把连续的 16 kHz 单声道 PCM 切成不超过 [WhisperEngine.MAX_WINDOW_MS] 的分块：
+ * - 尽量在静音段中间切开，避免把一句话截断
+ * - 完全没有语音的分块直接跳过，不送去推理
+ * - 自适应噪声底：跟随最小帧能量缓慢上浮，适应不同录音电平
+ */
+class SpeechChunker(
+    startMs: Long,
+    private val onChunk: (samples: FloatArray, count: Int, startMs: Long, hasSpeech: Boolean) -> Unit
+) {
+
+    private val sampleRate = WhisperEngine.SAMPLE_RATE
+    private val frameSize = sampleRate * FRAME_MS / 1000
+    private val capacity = (sampleRate * WhisperEngine.MAX_WINDOW_MS / 1000).toInt()
+    private val minChunk = sampleRate * MIN_CHUNK_MS / 1000
+    private val minSilenceFrames = MIN_SILENCE_MS / FRAME_MS
+
+    private val buffer = FloatArray(capacity)
+    private var count = 0
+
+    /** 每个完整帧是否判定为语音 */
+    private val speechFlags = BooleanArray(capacity / frameSize + 1)
+    private var analyzedFrames = 0
+
+    private var noiseFloor = INITIAL_NOISE_FLOOR
+    private var silenceRun = 0
+    private var cutCandidate = -1 // 最近一段足够长静音的中点（采样下标）
+
+    private var chunkStartMs = startMs
+
+    /**
+     * 输入一块 PCM（时间需连续）
+     */
+    fun feed(samples: FloatArray, length: Int) {
+        var offset = 0
+        while (offset < length) {
+            val n = min(capacity - count, length - offset)
+            System.arraycopy(samples, offset, buffer, count, n)
+            count += n
+            offset += n
+            analyze()
+            if (count == capacity) {
+                val cut = if (cutCandidate >= minChunk) cutCandidate else capacity
+                emit(cut)
+            }
+        }
+    }
+
+    /**
+     * 输出剩余数据
+     */
+    fun flush() {
+        if (count > 0) emit(count)
+    }
+
+    private fun analyze() {
+        while ((analyzedFrames + 1) * frameSize <= count) {
+            val from = analyzedFrames * frameSize
+            var sum = 0f
+            for (i in from until from + frameSize) sum += buffer[i] * buffer[i]
+            val rms = sqrt(sum / frameSize)
+
+            noiseFloor = min(noiseFloor * NOISE_FLOOR_RISE, max(rms, MIN_NOISE_FLOOR))
+            val speech = rms > max(noiseFloor * SPEECH_RATIO, SPEECH_ABSOLUTE_MIN)
+            speechFlags[analyzedFrames] = speech
+
+            if (speech) {
+                silenceRun = 0
+            } else {
+                silenceRun++
+                if (silenceRun >= minSilenceFrames) {
+                    cutCandidate = (analyzedFrames - silenceRun / 2) * frameSize
+                }
+            }
+            analyzedFrames++
+        }
+    }
+
+    private fun emit(cut: Int) {
+        val cutFrames = (cut + frameSize - 1) / frameSize
+        var hasSpeech = false
+        for (i in 0 until min(cutFrames, analyzedFrames)) {
+            if (speechFlags[i]) {
+                hasSpeech = true
+                break
+            }
+        }
+        // 尾部不足一帧的数据也视为可能有语音，交给模型判断
+        if (!hasSpeech && cutFrames > analyzedFrames) hasSpeech = true
+
+        onChunk(buffer, cut, chunkStartMs, hasSpeech)
+        chunkStartMs += cut * 1000L / sampleRate
+
+        // 把切点之后的数据移到开头
+        val remaining = count - cut
+        System.arraycopy(buffer, cut, buffer, 0, remaining)
+        count = remaining
+
+        val shiftFrames = cut / frameSize
+        val keptFrames = max(0, analyzedFrames - shiftFrames)
+        System.arraycopy(speechFlags, shiftFrames, speechFlags, 0, keptFrames)
+        analyzedFrames = keptFrames
+        // 切点不在帧边界时重新分析残余数据
+        if (cut % frameSize != 0) analyzedFrames = 0
+
+        cutCandidate = -1
+        silenceRun = 0
+    }
+
+    companion object {
+        private const val FRAME_MS = 30
+        private const val MIN_CHUNK_MS = 10_000
+        private const val MIN_SILENCE_MS = 300
+
+        private const val INITIAL_NOISE_FLOOR = 0.01f
+        private const val MIN_NOISE_FLOOR = 1e-4f
+        private const val NOISE_FLOOR_RISE = 1.002f
+        private const val SPEECH_RATIO = 3f
+        private const val SPEECH_ABSOLUTE_MIN = 0.005f
+    }
+}
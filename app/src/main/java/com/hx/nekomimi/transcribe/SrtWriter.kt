@@ -0,0 +1,84 @@
+package com.hx.nekomimi.transcribe
+
+import java.io.File
+import java.io.IOException
+
+/**
+ * SRT 字幕写入（追加模式，配合分块转写的断点续传）
+ *
+ * 字幕先追加、进度后记录，进程在两者之间被杀时文件中会多出进度之后的字幕。
+ * 续传时用 [resumeMs] 打开：只保留开始时间早于断点的完整字幕，其余截掉，
+ * 之后从断点重新转写的分块不会与它们重复。
+ *
+ * @param resumeMs 续传位置（毫秒）；0 表示从头开始，已有文件被清空
+ */
+class SrtWriter(private val file: File, resumeMs: Long = 0L) {
+
+    /** 下一条字幕的序号 */
+    private var nextIndex: Int = 1
+
+    init {
+        if (resumeMs <= 0L) {
+            file.delete()
+        } else if (file.isFile) {
+            val kept = readCues(file).filter { it.startMs < resumeMs }
+            rewrite(kept)
+            nextIndex = kept.size + 1
+        }
+    }
+
+    fun append(cues: List<WhisperEngine.Segment>) {
+        if (cues.isEmpty()) return
+        file.parentFile?.mkdirs()
+        file.appendText(format(cues, nextIndex))
+        nextIndex += cues.size
+    }
+
+    /** 先写临时文件再替换，截断过程中被杀也不会丢掉已有字幕 */
+    private fun rewrite(cues: List<WhisperEngine.Segment>) {
+        val temp = File(file.parentFile, file.name + ".tmp")
+        temp.writeText(format(cues, 1))
+        if (!temp.renameTo(file)) {
+            temp.delete()
+            throw IOException("截断字幕失败: $file")
+        }
+    }
+
+    companion object {
+
+        private val timeLinePattern = Regex("""^(\d+):(\d{2}):(\d{2}),(\d{3}) --> (\d+):(\d{2}):(\d{2}),(\d{3})$""")
+
+        /**
+         * 读取本类写出的字幕；末尾写到一半的条目（缺时间行或文本）被丢弃
+         */
+        internal fun readCues(file: File): List<WhisperEngine.Segment> {
+            val cues = mutableListOf<WhisperEngine.Segment>()
+            for (block in file.readText().split("\n\n")) {
+                val lines = block.trim('\n').lines()
+                if (lines.size < 3) continue
+                val match = timeLinePattern.matchEntire(lines[1]) ?: continue
+                val t = match.groupValues.drop(1).map { it.toLong() }
+                val startMs = t[0] * 3_600_000 + t[1] * 60_000 + t[2] * 1000 + t[3]
+                val endMs = t[4] * 3_600_000 + t[5] * 60_000 + t[6] * 1000 + t[7]
+                cues.add(WhisperEngine.Segment(startMs, endMs, lines.drop(2).joinToString("\n")))
+            }
+            return cues
+        }
+
+        private fun format(cues: List<WhisperEngine.Segment>, firstIndex: Int): String = buildString {
+            var index = firstIndex
+            for (cue in cues) {
+                append(index++).append('\n')
+                append(formatTime(cue.startMs)).append(" --> ").append(formatTime(cue.endMs)).append('\n')
+                append(cue.text).append("\n\n")
+            }
+        }
+
+        private fun formatTime(ms: Long): String {
+            val h = ms / 3_600_000
+            val m = (ms % 3_600_000) / 60_000
+            val s = (ms % 60_000) / 1000
+            return String.format("%02d:%02d:%02d,%03d", h, m, s, ms % 1000)
+        }
+    }
+}
@@ -0,0 +1,174 @@
+package com.hx.nekomimi.transcribe
+
+import android.content.Context
+import android.net.Uri
+import android.os.SystemClock
+import android.util.Log
+import androidx.room.withTransaction
+import com.hx.nekomimi.audio.PcmDecoder
+import com.hx.nekomimi.data.AppDatabase
+import com.hx.nekomimi.data.entity.TranscriptionJob
+import kotlinx.coroutines.CoroutineScope
+import kotlinx.coroutines.Dispatchers
+import kotlinx.coroutines.Job
+import kotlinx.coroutines.SupervisorJob
+import kotlinx.coroutines.currentCoroutineContext
+import kotlinx.coroutines.isActive
+import kotlinx.coroutines.launch
+import kotlin.math.min
+
+/**
+ * 离线字幕转写队列（全局单例）
+ *
+ * - 任务持久化在 transcription_jobs 表中，按章节逐个处理，进程被杀后下次启动从断点继续
+ * - 每个分块完成后立即追加写入 SRT 临时文件并记录进度；续传时截掉进度之后多写的字幕，避免重复
+ * - 整章完成后把字幕链接到 Chapter.subtitleUri
+ */
+object TranscriptionQueue {
+
+    private const val TAG = "TranscriptionQueue"
+
+    /** 推理线程上限（whisper 在小核上收益很低，超过大核数反而变慢） */
+    private const val MAX_THREADS = 4
+
+    private val scope = CoroutineScope(SupervisorJob() + Dispatchers.Default)
+    private var worker: Job? = null
+
+    /**
+     * 把一本书中所有没有字幕的章节加入队列
+     * 同一文件拆出的虚拟章节只转写一次，整个文件的字幕由这些章节共享。
+     * 之前失败或已完成（字幕后来被移除）的任务重置为待处理并从头转写，进行中的任务保留断点
+     * @return 加入队列的章节数
+     */
+    suspend fun enqueueBook(context: Context, bookId: Long): Int {
+        val db = AppDatabase.getInstance(context)
+        val dao = db.transcriptionJobDao()
+        val chapters = db.chapterDao().getChaptersByBookIdList(bookId)
+            .filter { it.subtitleUri == null && it.fileUri != null }
+            .distinctBy { it.fileUri }
+        db.withTransaction {
+            dao.insertAll(chapters.map { TranscriptionJob(chapterId = it.id, bookId = bookId) })
+            // SQLite 单条语句的参数个数有上限
+            chapters.map { it.id }.chunked(500).forEach { dao.requeueFinished(it) }
+        }
+        start(context)
+        return chapters.size
+    }
+
+    /**
+     * 启动工作协程（已在运行时忽略）；应用启动时调用以恢复未完成的任务
+     */
+    @Synchronized
+    fun start(context: Context) {
+        if (worker?.isActive == true) return
+        val appContext = context.applicationContext
+        worker = scope.launch { runQueue(appContext) }
+    }
+
+    private suspend fun runQueue(context: Context) {
+        val dao = AppDatabase.getInstance(context).transcriptionJobDao()
+        if (dao.getNextPending() == null) return
+
+        val engine = WhisperEngine.load(context)
+        if (engine == null) {
+            Log.w(TAG, "转写引擎不可用（缺少原生库或模型），任务保留到下次")
+            return
+        }
+        engine.use {
+            while (currentCoroutineContext().isActive) {
+                val job = dao.getNextPending() ?: break
+                try {
+                    process(context, engine, job)
+                } catch (e: Exception) {
+                    Log.e(TAG, "章节 ${job.chapterId} 转写失败", e)
+                    dao.update(job.copy(state = TranscriptionJob.STATE_FAILED, error = e.message))
+                }
+            }
+        }
+    }
+
+    private suspend fun process(context: Context, engine: WhisperEngine, job: TranscriptionJob) {
+        val db = AppDatabase.getInstance(context)
+        val dao = db.transcriptionJobDao()
+        val chapter = db.chapterDao().getChapterById(job.chapterId)
+        val audioUri = chapter?.fileUri
+        if (chapter == null || audioUri == null || chapter.subtitleUri != null) {
+            // 章节已删除或已有字幕（例如用户手动放入了 SRT）
+            dao.update(job.copy(state = TranscriptionJob.STATE_DONE))
+            return
+        }
+
+        val threads = min(Runtime.getRuntime().availableProcessors(), MAX_THREADS)
+        dao.update(job.copy(state = TranscriptionJob.STATE_RUNNING, threads = threads, error = null))
+
+        // 续传时截掉断点之后的字幕（上次追加后未来得及记录进度的分块会重新转写）
+        val partial = GeneratedSubtitles.partialFileFor(context, audioUri)
+        val writer = SrtWriter(partial, resumeMs = job.processedMs)
+
+        val coroutineJob = currentCoroutineContext()[Job]
+        var durationMs = job.durationMs
+        var processedMs = job.processedMs
+        var inferenceMs = 0L
+        val sessionStartMs = job.processedMs
+
+        val chunker = SpeechChunker(job.processedMs) { samples, count, chunkStartMs, hasSpeech ->
+            val chunkEndMs = chunkStartMs + count * 1000L / WhisperEngine.SAMPLE_RATE
+            if (hasSpeech) {
+                val begin = SystemClock.elapsedRealtime()
+                val segments = engine.transcribe(samples, count, threads)
+                inferenceMs += SystemClock.elapsedRealtime() - begin
+                writer.append(segments.filter { it.text.isNotBlank() }.map {
+                    it.copy(
+                        startMs = chunkStartMs + it.startMs,
+                        endMs = min(chunkStartMs + it.endMs, chunkEndMs)
+                    )
+                })
+            }
+            processedMs = chunkEndMs
+            dao.updateProgress(job.chapterId, chunkEndMs)
+        }
+
+        val wallStart = SystemClock.elapsedRealtime()
+        PcmDecoder(context, Uri.parse(audioUri)).decode(
+            startMs = job.processedMs,
+            targetSampleRate = WhisperEngine.SAMPLE_RATE,
+            onInfo = { info -> if (info.durationMs > 0) durationMs = info.durationMs }
+        ) { samples, count, _ ->
+            chunker.feed(samples, count)
+            coroutineJob?.isActive != false
+        }
+        if (coroutineJob?.isActive == false) return
+        chunker.flush()
+
+        // 完成：临时文件转正，并链接到章节
+        val output = GeneratedSubtitles.fileFor(context, audioUri)
+        if (!partial.exists()) {
+            partial.parentFile?.mkdirs()
+            partial.createNewFile()
+        }
+        if (!partial.renameTo(output)) {
+            partial.copyTo(output, overwrite = true)
+            partial.delete()
+        }
+        db.chapterDao().updateSubtitleUriByFileUri(audioUri, Uri.fromFile(output).toString())
+
+        val audioMs = (processedMs - sessionStartMs).coerceAtLeast(1)
+        val wallMs = SystemClock.elapsedRealtime() - wallStart
+        val rtf = wallMs.toFloat() / audioMs
+        Log.i(
+            TAG,
+            "章节 ${job.chapterId} 转写完成: 音频 ${audioMs / 1000}s, 耗时 ${wallMs / 1000}s, " +
+                "推理 ${inferenceMs / 1000}s, RTF=%.3f @ %d 线程".format(rtf, threads)
+        )
+        dao.update(
+            job.copy(
+                state = TranscriptionJob.STATE_DONE,
+                processedMs = processedMs,
+                durationMs = durationMs,
+                threads = threads,
+                realTimeFactor = rtf,
+                updatedAt = System.currentTimeMillis()
+            )
+        )
+    }
+}
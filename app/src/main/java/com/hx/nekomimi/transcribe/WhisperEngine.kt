@@ -0,0 +1,96 @@
+package com.hx.nekomimi.transcribe
+
+import android.content.Context
+import android.util.Log
+import java.io.Closeable
+import java.io.File
+
+/**
+ * whisper.cpp 推理引擎（libnekowhisper，纯 CPU）
+ *
+ * 一个实例对应一个已加载的模型，非线程安全，由 [TranscriptionQueue] 在单一工作协程中使用。
+ */
+class WhisperEngine private constructor(private var handle: Long) : Closeable {
+
+    /**
+     * 识别结果片段（时间相对于输入分块起点）
+     */
+    data class Segment(val startMs: Long, val endMs: Long, val text: String)
+
+    /**
+     * 识别一段 16 kHz 单声道 float PCM
+     * @param language 语言代码，"auto" 为自动检测
+     */
+    fun transcribe(samples: FloatArray, count: Int, threads: Int, language: String = "auto"): List<Segment> {
+        check(handle != 0L) { "WhisperEngine 已释放" }
+        val n = nativeTranscribe(handle, samples, count, threads, language)
+        if (n <= 0) return emptyList()
+        return (0 until n).map { i ->
+            Segment(
+                startMs = nativeSegmentStartMs(handle, i),
+                endMs = nativeSegmentEndMs(handle, i),
+                text = nativeSegmentText(handle, i).trim()
+            )
+        }
+    }
+
+    override fun close() {
+        if (handle != 0L) {
+            nativeRelease(handle)
+            handle = 0L
+        }
+    }
+
+    private external fun nativeTranscribe(handle: Long, samples: FloatArray, count: Int, threads: Int, language: String?): Int
+    private external fun nativeSegmentStartMs(handle: Long, index: Int): Long
+    private external fun nativeSegmentEndMs(handle: Long, index: Int): Long
+    private external fun nativeSegmentText(handle: Long, index: Int): String
+    private external fun nativeRelease(handle: Long)
+
+    companion object {
+        private const val TAG = "WhisperEngine"
+
+        /** whisper 要求的输入采样率 */
+        const val SAMPLE_RATE = 16_000
+
+        /** 单次推理的最大窗口（whisper 的固定上下文长度） */
+        const val MAX_WINDOW_MS = 30_000L
+
+        private const val MODEL_DIR = "models"
+        private const val MODEL_FILE = "ggml-whisper.bin"
+
+        /** 原生库是否可用（未启用 NEKO_WITH_WHISPER 构建时为 false） */
+        val isAvailable: Boolean = try {
+            System.loadLibrary("nekowhisper")
+            true
+        } catch (e: UnsatisfiedLinkError) {
+            Log.w(TAG, "libnekowhisper 不可用", e)
+            false
+        }
+
+        /**
+         * 模型文件位置（用户导入的 ggml 模型会被复制到这里）
+         */
+        fun modelFile(context: Context): File =
+            File(File(context.filesDir, MODEL_DIR), MODEL_FILE)
+
+        fun hasModel(context: Context): Boolean = modelFile(context).length() > 0
+
+        /**
+         * 加载模型；库或模型不可用时返回 null
+         */
+        fun load(context: Context): WhisperEngine? {
+            if (!isAvailable || !hasModel(context)) return null
+            val handle = nativeInit(modelFile(context).absolutePath)
+            if (handle == 0L) return null
+            Log.i(TAG, nativeSystemInfo())
+            return WhisperEngine(handle)
+        }
+
+        @JvmStatic
+        private external fun nativeInit(modelPath: String): Long
+
+        @JvmStatic
+        private external fun nativeSystemInfo(): String
+    }
+}
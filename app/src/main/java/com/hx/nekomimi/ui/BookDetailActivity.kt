@@ -1,12 +1,14 @@
 package com.hx.nekomimi.ui
 
 import android.content.Intent
+import android.net.Uri
 import android.os.Bundle
 import android.view.View
 import android.widget.Toast
+import androidx.activity.result.contract.ActivityResultContracts
 import androidx.activity.viewModels
 import androidx.appcompat.app.AppCompatActivity
-import androidx.lifecycle.lifecycleScope
+import com.google.android.material.dialog.MaterialAlertDialogBuilder
 import androidx.recyclerview.widget.LinearLayoutManager
 import com.hx.nekomimi.R
 import com.hx.nekomimi.data.entity.Chapter
@@ -14,7 +16,6 @@ import com.hx.nekomimi.databinding.ActivityBookDetailBinding
 import com.hx.nekomimi.ui.adapter.ChapterAdapter
 import com.hx.nekomimi.ui.viewmodel.BookDetailViewModel
 import com.hx.nekomimi.util.TimeUtils
-import kotlinx.coroutines.launch
 
 class BookDetailActivity : AppCompatActivity() {
 
@@ -28,6 +29,13 @@ class BookDetailActivity : AppCompatActivity() {
 
     private var bookId: Long = 0L
 
+    // 语音识别模型文件选择器
+    private val modelFilePicker = registerForActivityResult(
+        ActivityResultContracts.OpenDocument()
+    ) { uri: Uri? ->
+        if (uri != null) viewModel.importModel(uri)
+    }
+
     override fun onCreate(savedInstanceState: Bundle?) {
         super.onCreate(savedInstanceState)
         binding = ActivityBookDetailBinding.inflate(layoutInflater)
@@ -40,6 +48,7 @@ class BookDetailActivity : AppCompatActivity() {
         }
 
         viewModel.setBookId(bookId)
+        PlaybackPrewarmer(this) { it.getProgressByBookId(bookId) }
 
         setupToolbar()
         setupRecyclerView()
@@ -54,6 +63,10 @@ class BookDetailActivity : AppCompatActivity() {
                     viewModel.refreshChapters()
                     true
                 }
+                R.id.action_generate_subtitles -> {
+                    viewModel.generateSubtitles()
+                    true
+                }
                 else -> false
             }
         }
@@ -85,21 +98,34 @@ class BookDetailActivity : AppCompatActivity() {
             val isEmpty = chapters.isEmpty()
             binding.emptyView.visibility = if (isEmpty) View.VISIBLE else View.GONE
             binding.recyclerChapters.visibility = if (isEmpty) View.GONE else View.VISIBLE
-            binding.tvChapterCount.text = if (isEmpty) "" else getString(R.string.chapter_count, chapters.size)
+            updateChapterCount()
+        }
+
+        viewModel.duplicateChapterIds.observe(this) { ids ->
+            chapterAdapter.setDuplicates(ids)
+        }
+
+        // 字幕转写进度
+        viewModel.pendingTranscriptions.observe(this) { updateChapterCount() }
+
+        viewModel.needModel.observe(this) { need ->
+            if (need) {
+                viewModel.clearNeedModel()
+                showImportModelDialog()
+            }
         }
 
         // 上次播放进度
-        viewModel.progress.observe(this) { progress ->
+        viewModel.progress.observe(this) { item ->
+            val progress = item?.progress
             if (progress != null && progress.positionMs > 0) {
                 binding.cardLastPlayed.visibility = View.VISIBLE
 
-                lifecycleScope.launch {
-                    val chapterTitle = viewModel.getChapterTitle(progress.chapterId) ?: "未知章节"
-                    val timeStr = TimeUtils.formatTime(progress.positionMs)
-                    binding.tvLastPlayedInfo.text = getString(
-                        R.string.last_played_info, chapterTitle, timeStr
-                    )
-                }
+                val chapterTitle = item.chapter?.title ?: "未知章节"
+                val timeStr = TimeUtils.formatTime(progress.positionMs)
+                binding.tvLastPlayedInfo.text = getString(
+                    R.string.last_played_info, chapterTitle, timeStr
+                )
 
                 binding.btnContinuePlay.setOnClickListener {
                     openPlayer(progress.chapterId)
@@ -125,6 +151,27 @@ class BookDetailActivity : AppCompatActivity() {
         }
     }
 
+    private fun updateChapterCount() {
+        val count = viewModel.chapters.value?.size ?: 0
+        val pending = viewModel.pendingTranscriptions.value ?: 0
+        binding.tvChapterCount.text = when {
+            count == 0 -> ""
+            pending > 0 -> getString(R.string.chapter_count_transcribing, count, pending)
+            else -> getString(R.string.chapter_count, count)
+        }
+    }
+
+    private fun showImportModelDialog() {
+        MaterialAlertDialogBuilder(this)
+            .setTitle(R.string.transcribe_model_title)
+            .setMessage(R.string.transcribe_model_message)
+            .setPositiveButton(R.string.transcribe_select_model) { _, _ ->
+                modelFilePicker.launch(arrayOf("*/*"))
+            }
+            .setNegativeButton(R.string.cancel, null)
+            .show()
+    }
+
     private fun openPlayer(chapter: Chapter) {
         val intent = Intent(this, PlayerActivity::class.java).apply {
             putExtra(PlayerActivity.EXTRA_BOOK_ID, bookId)
@@ -0,0 +1,108 @@
+package com.hx.nekomimi.ui
+
+import android.app.ActivityManager
+import android.content.ComponentCallbacks2
+import android.os.Bundle
+import android.os.Debug
+import android.os.Handler
+import android.os.Looper
+import android.text.format.DateUtils
+import android.text.format.Formatter
+import androidx.appcompat.app.AppCompatActivity
+import com.hx.nekomimi.R
+import com.hx.nekomimi.cache.CacheRegistry
+import com.hx.nekomimi.databinding.ActivityCacheDebugBinding
+
+/**
+ * 缓存与内存调试页（仅调试包的主页菜单中可见）
+ *
+ * 每秒刷新进程内存和各缓存的实时占用，并可手动模拟系统的 onTrimMemory 级别。
+ */
+class CacheDebugActivity : AppCompatActivity() {
+
+    companion object {
+        private const val REFRESH_INTERVAL = 1000L
+    }
+
+    private lateinit var binding: ActivityCacheDebugBinding
+
+    private val handler = Handler(Looper.getMainLooper())
+    private val refresher = object : Runnable {
+        override fun run() {
+            refresh()
+            handler.postDelayed(this, REFRESH_INTERVAL)
+        }
+    }
+
+    override fun onCreate(savedInstanceState: Bundle?) {
+        super.onCreate(savedInstanceState)
+        binding = ActivityCacheDebugBinding.inflate(layoutInflater)
+        setContentView(binding.root)
+
+        binding.toolbar.setNavigationOnClickListener { finish() }
+
+        @Suppress("DEPRECATION")
+        val buttons = mapOf(
+            binding.btnTrimUiHidden to ComponentCallbacks2.TRIM_MEMORY_UI_HIDDEN,
+            binding.btnTrimBackground to ComponentCallbacks2.TRIM_MEMORY_BACKGROUND,
+            binding.btnTrimComplete to ComponentCallbacks2.TRIM_MEMORY_COMPLETE
+        )
+        buttons.forEach { (button, level) ->
+            button.setOnClickListener {
+                CacheRegistry.onTrimMemory(level)
+                refresh()
+            }
+        }
+    }
+
+    override fun onResume() {
+        super.onResume()
+        handler.post(refresher)
+    }
+
+    override fun onPause() {
+        super.onPause()
+        handler.removeCallbacks(refresher)
+    }
+
+    private fun refresh() {
+        val runtime = Runtime.getRuntime()
+        val activityManager = getSystemService(ActivityManager::class.java)
+        val systemMemory = ActivityManager.MemoryInfo().also { activityManager.getMemoryInfo(it) }
+
+        binding.tvProcessMemory.text = getString(
+            R.string.cache_debug_process_format,
+            size(runtime.totalMemory() - runtime.freeMemory()),
+            size(runtime.maxMemory()),
+            size(Debug.getNativeHeapAllocatedSize()),
+            activityManager.memoryClass,
+            size(systemMemory.availMem),
+            size(systemMemory.totalMem),
+            if (activityManager.isLowRamDevice) getString(R.string.cache_debug_low_ram) else ""
+        )
+
+        val stats = CacheRegistry.stats()
+        val lines = stats.map {
+            getString(
+                R.string.cache_debug_cache_format,
+                it.name,
+                it.priority.label,
+                size(it.sizeBytes),
+                size(it.maxSizeBytes)
+            )
+        }
+        val total = getString(R.string.cache_debug_total_format, size(stats.sumOf { it.sizeBytes }))
+        val lastTrim = if (CacheRegistry.lastTrimLevel < 0) {
+            getString(R.string.cache_debug_no_trim)
+        } else {
+            getString(
+                R.string.cache_debug_last_trim_format,
+                CacheRegistry.lastTrimLevel,
+                DateUtils.getRelativeTimeSpanString(CacheRegistry.lastTrimAt)
+            )
+        }
+        binding.tvCaches.text = (lines + total + lastTrim).joinToString("\n")
+    }
+
+    private fun size(bytes: Long): String = Formatter.formatShortFileSize(this, bytes)
+}
@@ -3,24 +3,34 @@ package com.hx.nekomimi.ui
 import android.content.Intent
 import android.net.Uri
 import android.os.Bundle
+import android.view.MenuItem
 import android.view.View
 import android.widget.Toast
 import androidx.activity.result.contract.ActivityResultContracts
 import androidx.activity.viewModels
 import androidx.appcompat.app.AlertDialog
 import androidx.appcompat.app.AppCompatActivity
+import androidx.appcompat.widget.SearchView
 import androidx.lifecycle.lifecycleScope
 import androidx.recyclerview.widget.GridLayoutManager
+import androidx.recyclerview.widget.LinearLayoutManager
 import com.google.android.material.dialog.MaterialAlertDialogBuilder
 import com.hx.nekomimi.R
 import com.hx.nekomimi.NekoMimiApp
 import com.hx.nekomimi.bgm.BgmManager
 import com.hx.nekomimi.data.entity.Book
+import com.hx.nekomimi.data.model.RecentlyPlayed
+import com.hx.nekomimi.data.model.SearchResult
 import com.hx.nekomimi.data.repository.BookRepository
 import com.hx.nekomimi.databinding.ActivityMainBinding
 import com.hx.nekomimi.databinding.DialogAddBookBinding
 import com.hx.nekomimi.databinding.DialogBgmSettingsBinding
+import com.hx.nekomimi.remote.RemoteHttp
+import com.hx.nekomimi.remote.WebDavCredentials
+import com.hx.nekomimi.service.PlaybackProcess
 import com.hx.nekomimi.ui.adapter.BookAdapter
+import com.hx.nekomimi.ui.adapter.RecentlyPlayedAdapter
+import com.hx.nekomimi.ui.adapter.SearchResultAdapter
 import com.hx.nekomimi.ui.viewmodel.MainViewModel
 import com.hx.nekomimi.util.FileScanner
 import kotlinx.coroutines.Dispatchers
@@ -32,6 +42,8 @@ class MainActivity : AppCompatActivity() {
     private lateinit var binding: ActivityMainBinding
     private val viewModel: MainViewModel by viewModels()
     private lateinit var bookAdapter: BookAdapter
+    private lateinit var recentAdapter: RecentlyPlayedAdapter
+    private lateinit var searchAdapter: SearchResultAdapter
 
     // 选择文件夹后的回调
     private var pendingBookName: String? = null
@@ -76,16 +88,21 @@ class MainActivity : AppCompatActivity() {
         binding = ActivityMainBinding.inflate(layoutInflater)
         setContentView(binding.root)
 
-        // 初始化 BGM 管理器
-        BgmManager.init(this)
-
         setupToolbar()
+        setupSearch()
         setupRecyclerView()
         setupFab()
         observeData()
+
+        // 预热最近播放的章节
+        PlaybackPrewarmer(this) { it.getLastPlayedProgress() }
     }
 
     private fun setupToolbar() {
+        binding.toolbar.menu.findItem(R.id.action_playback_process)?.isChecked =
+            PlaybackProcess.isSeparateProcessEnabled(this)
+        val debuggable = (application as NekoMimiApp).isDebuggable
+        binding.toolbar.menu.findItem(R.id.action_cache_debug)?.isVisible = debuggable
         binding.toolbar.setOnMenuItemClickListener { menuItem ->
             when (menuItem.itemId) {
                 R.id.action_bgm_settings -> {
@@ -96,11 +113,56 @@ class MainActivity : AppCompatActivity() {
                     refreshAllBooks()
                     true
                 }
+                R.id.action_playback_process -> {
+                    val enabled = !menuItem.isChecked
+                    PlaybackProcess.setSeparateProcessEnabled(this, enabled)
+                    menuItem.isChecked = enabled
+                    Toast.makeText(this, R.string.playback_process_changed, Toast.LENGTH_SHORT).show()
+                    true
+                }
+                R.id.action_cache_debug -> {
+                    startActivity(Intent(this, CacheDebugActivity::class.java))
+                    true
+                }
                 else -> false
             }
         }
     }
 
+    /**
+     * 工具栏搜索框：边输入边搜索，收起时回到书架
+     */
+    private fun setupSearch() {
+        val item = binding.toolbar.menu.findItem(R.id.action_search) ?: return
+        val searchView = item.actionView as SearchView
+        searchView.queryHint = getString(R.string.search_hint)
+        searchView.setOnQueryTextListener(object : SearchView.OnQueryTextListener {
+            override fun onQueryTextSubmit(query: String): Boolean {
+                searchView.clearFocus()
+                return true
+            }
+
+            override fun onQueryTextChange(newText: String): Boolean {
+                viewModel.search(newText)
+                return true
+            }
+        })
+        item.setOnActionExpandListener(object : MenuItem.OnActionExpandListener {
+            override fun onMenuItemActionExpand(item: MenuItem): Boolean = true
+
+            override fun onMenuItemActionCollapse(item: MenuItem): Boolean {
+                viewModel.search("")
+                return true
+            }
+        })
+
+        searchAdapter = SearchResultAdapter { result -> openSearchResult(result) }
+        binding.recyclerSearch.apply {
+            layoutManager = LinearLayoutManager(this@MainActivity)
+            adapter = searchAdapter
+        }
+    }
+
     private fun setupRecyclerView() {
         bookAdapter = BookAdapter(
             onClick = { book -> openBookDetail(book) },
@@ -111,6 +173,12 @@ class MainActivity : AppCompatActivity() {
             layoutManager = GridLayoutManager(this@MainActivity, 2)
             adapter = bookAdapter
         }
+
+        recentAdapter = RecentlyPlayedAdapter { item -> openPlayer(item) }
+        binding.recyclerRecent.apply {
+            layoutManager = LinearLayoutManager(this@MainActivity, LinearLayoutManager.HORIZONTAL, false)
+            adapter = recentAdapter
+        }
     }
 
     private fun setupFab() {
@@ -122,9 +190,28 @@ class MainActivity : AppCompatActivity() {
     private fun observeData() {
         viewModel.bookItems.observe(this) { items ->
             bookAdapter.submitList(items)
-            binding.emptyView.visibility = if (items.isEmpty()) View.VISIBLE else View.GONE
+            binding.emptyView.visibility =
+                if (items.isEmpty() && viewModel.searchResults.value == null) View.VISIBLE else View.GONE
             binding.recyclerBooks.visibility = if (items.isEmpty()) View.GONE else View.VISIBLE
         }
+
+        viewModel.searchResults.observe(this) { results ->
+            val searching = results != null
+            searchAdapter.submitList(results.orEmpty())
+            binding.searchContainer.visibility = if (searching) View.VISIBLE else View.GONE
+            binding.tvSearchEmpty.visibility = if (results?.isEmpty() == true) View.VISIBLE else View.GONE
+            binding.shelfContainer.visibility = if (searching) View.GONE else View.VISIBLE
+            binding.emptyView.visibility =
+                if (!searching && viewModel.bookItems.value.isNullOrEmpty()) View.VISIBLE else View.GONE
+            if (searching) binding.fabAddBook.hide() else binding.fabAddBook.show()
+        }
+
+        viewModel.recentlyPlayed.observe(this) { items ->
+            recentAdapter.submitList(items)
+            val visibility = if (items.isEmpty()) View.GONE else View.VISIBLE
+            binding.tvRecentTitle.visibility = visibility
+            binding.recyclerRecent.visibility = visibility
+        }
     }
 
     private fun openBookDetail(book: Book) {
@@ -134,6 +221,31 @@ class MainActivity : AppCompatActivity() {
         startActivity(intent)
     }
 
+    /** 书籍结果进入详情页，章节结果直接播放 */
+    private fun openSearchResult(result: SearchResult) {
+        if (result.isBook) {
+            val intent = Intent(this, BookDetailActivity::class.java).apply {
+                putExtra(BookDetailActivity.EXTRA_BOOK_ID, result.bookId)
+            }
+            startActivity(intent)
+        } else {
+            val intent = Intent(this, PlayerActivity::class.java).apply {
+                putExtra(PlayerActivity.EXTRA_BOOK_ID, result.bookId)
+                putExtra(PlayerActivity.EXTRA_CHAPTER_ID, result.chapterId)
+            }
+            startActivity(intent)
+        }
+    }
+
+    /** 从「继续收听」直接进入播放页 */
+    private fun openPlayer(item: RecentlyPlayed) {
+        val intent = Intent(this, PlayerActivity::class.java).apply {
+            putExtra(PlayerActivity.EXTRA_BOOK_ID, item.bookId)
+            putExtra(PlayerActivity.EXTRA_CHAPTER_ID, item.chapterId)
+        }
+        startActivity(intent)
+    }
+
     private fun showDeleteDialog(book: Book) {
         AlertDialog.Builder(this)
             .setTitle(R.string.delete_book_title)
@@ -147,6 +259,10 @@ class MainActivity : AppCompatActivity() {
 
     private fun showAddBookDialog() {
         val dialogBinding = DialogAddBookBinding.inflate(layoutInflater)
+        dialogBinding.radioSource.setOnCheckedChangeListener { _, checkedId ->
+            dialogBinding.layoutWebDav.visibility =
+                if (checkedId == R.id.radioSourceWebDav) View.VISIBLE else View.GONE
+        }
 
         AlertDialog.Builder(this)
             .setTitle(R.string.select_book_folder)
@@ -157,6 +273,20 @@ class MainActivity : AppCompatActivity() {
                     Toast.makeText(this, R.string.input_book_name, Toast.LENGTH_SHORT).show()
                     return@setPositiveButton
                 }
+                if (dialogBinding.radioSource.checkedRadioButtonId == R.id.radioSourceWebDav) {
+                    val url = dialogBinding.editWebDavUrl.text?.toString()?.trim().orEmpty()
+                    if (!RemoteHttp.isRemote(url)) {
+                        Toast.makeText(this, R.string.webdav_invalid_url, Toast.LENGTH_SHORT).show()
+                        return@setPositiveButton
+                    }
+                    val username = dialogBinding.editWebDavUsername.text?.toString()?.trim().orEmpty()
+                    val password = dialogBinding.editWebDavPassword.text?.toString().orEmpty()
+                    lifecycleScope.launch {
+                        WebDavCredentials.save(this@MainActivity, url, username, password)
+                        addBook(name, if (url.endsWith("/")) url else "$url/")
+                    }
+                    return@setPositiveButton
+                }
                 pendingBookName = name
                 folderPicker.launch(null)
             }
@@ -167,7 +297,14 @@ class MainActivity : AppCompatActivity() {
     private fun addBookFromUri(treeUri: Uri) {
         val bookName = pendingBookName ?: return
         pendingBookName = null
+        addBook(bookName, treeUri.toString())
+    }
 
+    /**
+     * 添加书籍并扫描章节
+     * @param rootUri SAF 目录树 URI 或 WebDAV 目录地址
+     */
+    private fun addBook(bookName: String, rootUri: String) {
         lifecycleScope.launch {
             try {
                 val repository = BookRepository((application as NekoMimiApp).database)
@@ -175,19 +312,19 @@ class MainActivity : AppCompatActivity() {
                 // 插入书籍记录
                 val book = Book(
                     name = bookName,
-                    rootUri = treeUri.toString()
+                    rootUri = rootUri
                 )
                 val bookId = repository.insertBook(book)
 
                 // 扫描章节
-                val chapters = withContext(Dispatchers.IO) {
-                    FileScanner.scanFromUri(this@MainActivity, treeUri, bookId)
+                val result = withContext(Dispatchers.IO) {
+                    FileScanner.scanBook(this@MainActivity, book.copy(id = bookId))
                 }
-                repository.insertChapters(chapters)
+                repository.replaceChapters(bookId, result.chapters, result.subtitleTracks)
 
                 Toast.makeText(
                     this@MainActivity,
-                    "添加成功，共 ${chapters.size} 个章节",
+                    "添加成功，共 ${result.chapters.size} 个章节",
                     Toast.LENGTH_SHORT
                 ).show()
             } catch (e: Exception) {
@@ -209,13 +346,12 @@ class MainActivity : AppCompatActivity() {
             }
 
             for (book in books) {
-                val treeUri = book.rootUri?.let { Uri.parse(it) } ?: continue
+                if (book.rootUri == null) continue
                 try {
-                    val chapters = withContext(Dispatchers.IO) {
-                        FileScanner.scanFromUri(this@MainActivity, treeUri, book.id)
+                    val result = withContext(Dispatchers.IO) {
+                        FileScanner.scanBook(this@MainActivity, book)
                     }
-                    repository.deleteChaptersByBookId(book.id)
-                    repository.insertChapters(chapters)
+                    repository.replaceChapters(book.id, result.chapters, result.subtitleTracks)
                 } catch (e: Exception) {
                     e.printStackTrace()
                 }
@@ -237,10 +373,14 @@ class MainActivity : AppCompatActivity() {
         dialogBinding.switchBgmEnable.isChecked = BgmManager.isEnabled()
 
         // 初始化文件名显示
-        val displayName = BgmManager.getBgmDisplayName(this)
+        val displayName = BgmManager.getBgmDisplayName()
         if (displayName != null) {
             dialogBinding.tvBgmFileName.text = displayName
             dialogBinding.btnClearBgm.visibility = View.VISIBLE
+            // 旧版本没有保存文件名，后台查询后补上
+            lifecycleScope.launch {
+                BgmManager.resolveDisplayName(this@MainActivity)?.let { dialogBinding.tvBgmFileName.text = it }
+            }
         } else {
             dialogBinding.tvBgmFileName.text = getString(R.string.bgm_no_file)
             dialogBinding.btnClearBgm.visibility = View.GONE
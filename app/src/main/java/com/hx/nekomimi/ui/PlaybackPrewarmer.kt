@@ -0,0 +1,79 @@
+package com.hx.nekomimi.ui
+
+import androidx.appcompat.app.AppCompatActivity
+import androidx.core.content.ContextCompat
+import androidx.lifecycle.DefaultLifecycleObserver
+import androidx.lifecycle.LifecycleOwner
+import androidx.lifecycle.lifecycleScope
+import androidx.media3.session.MediaController
+import androidx.media3.session.SessionToken
+import com.google.common.util.concurrent.ListenableFuture
+import com.hx.nekomimi.NekoMimiApp
+import com.hx.nekomimi.data.entity.PlaybackProgress
+import com.hx.nekomimi.data.repository.BookRepository
+import com.hx.nekomimi.remote.RemoteHttp
+import com.hx.nekomimi.service.PlaybackPrewarm
+import com.hx.nekomimi.service.PlaybackProcess
+import com.hx.nekomimi.subtitle.SubtitleLoader
+import kotlinx.coroutines.Dispatchers
+import kotlinx.coroutines.Job
+import kotlinx.coroutines.launch
+import kotlinx.coroutines.withContext
+
+/**
+ * 页面可见时预热「继续播放」
+ *
+ * 连接播放服务并发送 [PlaybackPrewarm] 命令，让服务按上次进度载入播放列表；同时预解析该章节的字幕。
+ * 远程（WebDAV）章节不预热：仅仅打开页面不应访问网络。
+ * 页面可见期间保持连接，否则服务会随最后一个控制端断开而销毁，预热的播放器也随之释放。
+ *
+ * @param progressProvider 要预热的播放进度（没有时返回 null）
+ */
+class PlaybackPrewarmer(
+    private val activity: AppCompatActivity,
+    private val progressProvider: suspend (BookRepository) -> PlaybackProgress?
+) : DefaultLifecycleObserver {
+
+    private val repository = BookRepository((activity.application as NekoMimiApp).database)
+
+    private var controllerFuture: ListenableFuture<MediaController>? = null
+    private var job: Job? = null
+
+    init {
+        activity.lifecycle.addObserver(this)
+    }
+
+    override fun onStart(owner: LifecycleOwner) {
+        job = activity.lifecycleScope.launch {
+            val progress = progressProvider(repository) ?: return@launch
+            val chapter = repository.getChapterById(progress.chapterId) ?: return@launch
+            if (RemoteHttp.isRemote(chapter.fileUri)) return@launch
+
+            val token = SessionToken(activity, PlaybackProcess.sessionComponent(activity))
+            val future = MediaController.Builder(activity, token).buildAsync()
+            controllerFuture = future
+            future.addListener({
+                val controller = try {
+                    future.get()
+                } catch (e: Exception) {
+                    return@addListener
+                }
+                controller.sendCustomCommand(
+                    PlaybackPrewarm.COMMAND,
+                    PlaybackPrewarm.args(chapter.id, progress.positionMs)
+                )
+            }, ContextCompat.getMainExecutor(activity))
+
+            withContext(Dispatchers.IO) {
+                SubtitleLoader.preload(activity.applicationContext, chapter)
+            }
+        }
+    }
+
+    override fun onStop(owner: LifecycleOwner) {
+        job?.cancel()
+        job = null
+        controllerFuture?.let { MediaController.releaseFuture(it) }
+        controllerFuture = null
+    }
+}
@@ -1,16 +1,21 @@
 package com.hx.nekomimi.ui
 
-import android.content.ComponentName
 import android.content.Intent
 import android.net.Uri
 import android.os.Bundle
 import android.os.Handler
 import android.os.Looper
+import android.view.Choreographer
 import android.view.View
+import android.widget.TextView
+import android.widget.Toast
 import androidx.activity.result.contract.ActivityResultContracts
 import androidx.activity.viewModels
 import androidx.appcompat.app.AppCompatActivity
+import androidx.lifecycle.Lifecycle
+import androidx.lifecycle.lifecycleScope
 import androidx.media3.common.MediaItem
+import androidx.media3.common.PlaybackException
 import androidx.media3.common.Player
 import androidx.media3.session.MediaController
 import androidx.media3.session.SessionToken
@@ -24,12 +29,24 @@ import com.hx.nekomimi.R
 import com.hx.nekomimi.bgm.BgmManager
 import com.hx.nekomimi.databinding.ActivityPlayerBinding
 import com.hx.nekomimi.databinding.DialogBgmSettingsBinding
-import com.hx.nekomimi.service.MediaPlaybackService
+import com.hx.nekomimi.service.ChapterMediaItems
+import com.hx.nekomimi.service.NightMode
+import com.hx.nekomimi.service.PlaybackProcess
+import com.hx.nekomimi.settings.AppSettings
+import com.hx.nekomimi.subtitle.Id3LyricsReader
 import com.hx.nekomimi.subtitle.SubtitleDisplayMode
-import com.hx.nekomimi.subtitle.SubtitleHelper
+import com.hx.nekomimi.subtitle.SubtitleEntry
+import com.hx.nekomimi.subtitle.SubtitleLanguage
+import com.hx.nekomimi.subtitle.SubtitleTimeline
 import com.hx.nekomimi.ui.adapter.SubtitleAdapter
 import com.hx.nekomimi.ui.viewmodel.PlayerViewModel
+import com.hx.nekomimi.ui.widget.KaraokeHighlighter
+import com.hx.nekomimi.ui.widget.WaveformSeekBar
 import com.hx.nekomimi.util.TimeUtils
+import com.hx.nekomimi.util.Tracing
+import kotlinx.coroutines.launch
+import kotlin.math.abs
+import kotlin.math.roundToInt
 
 class PlayerActivity : AppCompatActivity() {
 
@@ -39,12 +56,13 @@ class PlayerActivity : AppCompatActivity() {
         private const val PROGRESS_UPDATE_INTERVAL = 300L // 进度更新间隔（毫秒）
         private const val PROGRESS_SAVE_INTERVAL = 5000L  // 进度保存间隔（毫秒）
         private const val SEEK_INCREMENT_MS = 30_000L     // 快进/快退 30 秒
-        private const val PREF_NAME = "subtitle_prefs"
-        private const val KEY_SUBTITLE_MODE = "subtitle_display_mode"
-        private const val KEY_PLAYBACK_SPEED = "playback_speed"
+        private const val SUBTITLE_SYNC_STEP_MS = 500L    // 字幕手动微调步长
 
         /** 可选倍速列表 */
         private val SPEED_OPTIONS = floatArrayOf(0.5f, 0.75f, 1.0f, 1.25f, 1.5f, 1.75f, 2.0f, 2.5f, 3.0f)
+
+        /** 可选的预读比例（慢速存储选得越早，切章时越不容易等待） */
+        private val LOOKAHEAD_OPTIONS = floatArrayOf(0.5f, 0.6f, 0.7f, 0.8f, 0.9f)
     }
 
     private lateinit var binding: ActivityPlayerBinding
@@ -60,6 +78,12 @@ class PlayerActivity : AppCompatActivity() {
     private var isUserSeeking = false
     private var lastSaveTime = 0L
 
+    /** 本页面是否已经开始过播放（之后再连接控制器时跟随播放器当前章节） */
+    private var playbackStarted = false
+
+    /** 进行中的 "player.prepare" 异步区段 cookie（0 表示没有） */
+    private var prepareTraceCookie = 0
+
     /** 当前字幕显示模式 */
     private var currentDisplayMode = SubtitleDisplayMode.DEFAULT
 
@@ -74,6 +98,25 @@ class PlayerActivity : AppCompatActivity() {
     private var dualLineHighlightOnTop = true
     private var lastDualLineIndex = -1
 
+    /** 双行模式高亮句的卡拉 OK 逐字填充 */
+    private val dualLineKaraoke by lazy { KaraokeHighlighter(getColor(R.color.subtitle_highlight)) }
+
+    /**
+     * 卡拉 OK 帧回调：当前行带音节时间且正在播放时，每个显示帧更新一次填充进度，
+     * 只改动当前行的 span（其余字幕行保持静态），否则不注册回调
+     */
+    private var karaokeActive = false
+    private var karaokeFrameScheduled = false
+    private val karaokeFrameCallback = Choreographer.FrameCallback {
+        karaokeFrameScheduled = false
+        val controller = mediaController
+        val timeline = viewModel.timeline.value
+        if (controller != null && timeline != null) {
+            updateKaraoke(timeline.toSubtitleTime(controller.currentPosition))
+        }
+        scheduleKaraokeFrame()
+    }
+
     /**
      * 歌词模式：用户是否正在手动滚动（手动滚动时解除居中锁定）
      * 用户停止滚动 3 秒后自动恢复居中
@@ -129,12 +172,11 @@ class PlayerActivity : AppCompatActivity() {
 
         viewModel.loadChapter(bookId, chapterId)
 
-        // 初始化 BGM 管理器
-        BgmManager.init(this)
-
-        // 恢复保存的字幕模式和倍速
-        loadSubtitleMode()
-        loadPlaybackSpeed()
+        // 恢复保存的字幕模式和倍速（内存快照，不读磁盘）
+        AppSettings.settings.value?.let {
+            currentDisplayMode = it.subtitleDisplayMode
+            currentSpeed = it.playbackSpeed
+        }
 
         setupToolbar()
         setupSubtitleList()
@@ -142,7 +184,23 @@ class PlayerActivity : AppCompatActivity() {
         setupBgmEntry()
         setupSubtitleModeSwitch()
         setupSpeedControl()
+        setupNightMode()
         observeData()
+        restoreSettingsWhenLoaded()
+    }
+
+    /**
+     * 设置在 Application 中后台加载，冷启动直接进入播放页时可能还没加载完，加载后再应用
+     */
+    private fun restoreSettingsWhenLoaded() {
+        if (AppSettings.settings.value != null) return
+        lifecycleScope.launch {
+            val saved = AppSettings.await()
+            switchDisplayMode(saved.subtitleDisplayMode)
+            if (saved.playbackSpeed != currentSpeed) setPlaybackSpeed(saved.playbackSpeed)
+            updateNightModeLabel()
+            mediaController?.let { sendNightMode(it) }
+        }
     }
 
     override fun onStart() {
@@ -158,6 +216,8 @@ class PlayerActivity : AppCompatActivity() {
     override fun onPause() {
         super.onPause()
         handler.removeCallbacks(progressUpdater)
+        Choreographer.getInstance().removeFrameCallback(karaokeFrameCallback)
+        karaokeFrameScheduled = false
         // 暂停时保存进度
         saveCurrentProgress()
     }
@@ -178,6 +238,27 @@ class PlayerActivity : AppCompatActivity() {
 
     private fun setupToolbar() {
         binding.toolbar.setNavigationOnClickListener { finish() }
+        binding.toolbar.setOnMenuItemClickListener { menuItem ->
+            when (menuItem.itemId) {
+                R.id.action_subtitle_sync -> {
+                    showSubtitleSyncDialog()
+                    true
+                }
+                R.id.action_subtitle_tracks -> {
+                    showSubtitleTrackDialog()
+                    true
+                }
+                R.id.action_subtitle_bilingual -> {
+                    showBilingualTrackDialog()
+                    true
+                }
+                R.id.action_lookahead -> {
+                    showLookaheadDialog()
+                    true
+                }
+                else -> false
+            }
+        }
     }
 
     private fun setupSubtitleList() {
@@ -237,7 +318,7 @@ class PlayerActivity : AppCompatActivity() {
     private fun switchDisplayMode(mode: SubtitleDisplayMode) {
         if (currentDisplayMode == mode) return
         currentDisplayMode = mode
-        saveSubtitleMode()
+        AppSettings.setSubtitleDisplayMode(mode)
         updateSubtitleModeLabel()
         subtitleAdapter.setDisplayMode(mode)
         applyDisplayMode()
@@ -283,17 +364,97 @@ class PlayerActivity : AppCompatActivity() {
         binding.tvSubtitleModeLabel.text = label
     }
 
-    private fun saveSubtitleMode() {
-        getSharedPreferences(PREF_NAME, MODE_PRIVATE)
-            .edit()
-            .putInt(KEY_SUBTITLE_MODE, currentDisplayMode.ordinal)
-            .apply()
+    // ========== 字幕同步 ==========
+
+    private fun showSubtitleSyncDialog() {
+        if (viewModel.subtitles.value.isNullOrEmpty()) {
+            Toast.makeText(this, R.string.no_subtitle, Toast.LENGTH_SHORT).show()
+            return
+        }
+        if (viewModel.isSyncing.value == true) {
+            Toast.makeText(this, R.string.subtitle_sync_running, Toast.LENGTH_SHORT).show()
+            return
+        }
+
+        val offsetMs = viewModel.chapter.value?.subtitleOffsetMs ?: 0L
+        val items = arrayOf(
+            getString(R.string.subtitle_sync_auto),
+            getString(R.string.subtitle_sync_earlier),
+            getString(R.string.subtitle_sync_later),
+            getString(R.string.subtitle_sync_reset)
+        )
+        MaterialAlertDialogBuilder(this, R.style.Theme_NekoMimi_Dialog)
+            .setTitle(getString(R.string.subtitle_sync_title, PlayerViewModel.formatOffset(offsetMs)))
+            .setItems(items) { _, which ->
+                when (which) {
+                    0 -> {
+                        Toast.makeText(this, R.string.subtitle_sync_running, Toast.LENGTH_SHORT).show()
+                        viewModel.autoSyncSubtitles()
+                    }
+                    1 -> viewModel.adjustSubtitleOffset(-SUBTITLE_SYNC_STEP_MS)
+                    2 -> viewModel.adjustSubtitleOffset(SUBTITLE_SYNC_STEP_MS)
+                    3 -> viewModel.resetSubtitleSync()
+                }
+            }
+            .show()
+    }
+
+    // ========== 字幕轨道 ==========
+
+    /**
+     * 当前章节可选的字幕轨道；当前字幕不在索引中时（离线生成的字幕、升级前未重新扫描）也列出
+     * @return URI 与显示名称
+     */
+    private fun subtitleTrackChoices(): List<Pair<String, String>> {
+        val choices = viewModel.subtitleTracks.value.orEmpty().map { track ->
+            val name = if (track.format == Id3LyricsReader.FORMAT) getString(R.string.subtitle_track_embedded) else track.label
+            val label = if (track.language.isEmpty()) name
+            else getString(R.string.subtitle_track_label, SubtitleLanguage.displayName(track.language), name)
+            track.uri to label
+        }
+        val current = viewModel.chapter.value?.subtitleUri
+        return if (current == null || choices.any { it.first == current }) choices
+        else listOf(current to getString(R.string.subtitle_track_current)) + choices
     }
 
-    private fun loadSubtitleMode() {
-        val prefs = getSharedPreferences(PREF_NAME, MODE_PRIVATE)
-        val ordinal = prefs.getInt(KEY_SUBTITLE_MODE, SubtitleDisplayMode.DEFAULT.ordinal)
-        currentDisplayMode = SubtitleDisplayMode.fromOrdinal(ordinal)
+    private fun showSubtitleTrackDialog() {
+        val chapter = viewModel.chapter.value ?: return
+        val choices = subtitleTrackChoices()
+        val labels = listOf(getString(R.string.subtitle_track_off)) + choices.map { it.second }
+        val checked = choices.indexOfFirst { it.first == chapter.subtitleUri } + 1
+
+        MaterialAlertDialogBuilder(this, R.style.Theme_NekoMimi_Dialog)
+            .setTitle(R.string.action_subtitle_tracks)
+            .setSingleChoiceItems(labels.toTypedArray(), checked) { dialog, which ->
+                val uri = if (which == 0) null else choices[which - 1].first
+                viewModel.selectSubtitleTracks(uri, chapter.secondarySubtitleUri)
+                dialog.dismiss()
+            }
+            .show()
+    }
+
+    private fun showBilingualTrackDialog() {
+        val chapter = viewModel.chapter.value ?: return
+        if (chapter.subtitleUri == null) {
+            Toast.makeText(this, R.string.subtitle_bilingual_need_primary, Toast.LENGTH_SHORT).show()
+            return
+        }
+        val choices = subtitleTrackChoices().filter { it.first != chapter.subtitleUri }
+        if (choices.isEmpty()) {
+            Toast.makeText(this, R.string.subtitle_bilingual_no_other, Toast.LENGTH_SHORT).show()
+            return
+        }
+        val labels = listOf(getString(R.string.subtitle_track_none)) + choices.map { it.second }
+        val checked = choices.indexOfFirst { it.first == chapter.secondarySubtitleUri } + 1
+
+        MaterialAlertDialogBuilder(this, R.style.Theme_NekoMimi_Dialog)
+            .setTitle(R.string.action_subtitle_bilingual)
+            .setSingleChoiceItems(labels.toTypedArray(), checked) { dialog, which ->
+                val uri = if (which == 0) null else choices[which - 1].first
+                viewModel.selectSubtitleTracks(chapter.subtitleUri, uri)
+                dialog.dismiss()
+            }
+            .show()
     }
 
     // ========== 倍速控制 ==========
@@ -305,6 +466,21 @@ class PlayerActivity : AppCompatActivity() {
         }
     }
 
+    private fun showLookaheadDialog() {
+        val labels = LOOKAHEAD_OPTIONS.map { getString(R.string.lookahead_option, (it * 100).roundToInt()) }.toTypedArray()
+        val current = AppSettings.current.lookaheadFraction
+        val checkedIndex = LOOKAHEAD_OPTIONS.indices.minByOrNull { abs(LOOKAHEAD_OPTIONS[it] - current) } ?: 0
+
+        MaterialAlertDialogBuilder(this, R.style.Theme_NekoMimi_Dialog)
+            .setTitle(R.string.action_lookahead)
+            .setSingleChoiceItems(labels, checkedIndex) { dialog, which ->
+                AppSettings.setLookaheadFraction(LOOKAHEAD_OPTIONS[which])
+                dialog.dismiss()
+            }
+            .setNegativeButton(R.string.cancel, null)
+            .show()
+    }
+
     private fun showSpeedDialog() {
         val speedLabels = SPEED_OPTIONS.map { speed ->
             if (speed == speed.toLong().toFloat()) "${speed.toLong().toInt()}x" else "${speed}x"
@@ -325,7 +501,7 @@ class PlayerActivity : AppCompatActivity() {
 
     private fun setPlaybackSpeed(speed: Float) {
         currentSpeed = speed
-        savePlaybackSpeed()
+        AppSettings.setPlaybackSpeed(speed)
         updateSpeedLabel()
         mediaController?.setPlaybackSpeed(speed)
     }
@@ -345,16 +521,31 @@ class PlayerActivity : AppCompatActivity() {
         }
     }
 
-    private fun savePlaybackSpeed() {
-        getSharedPreferences(PREF_NAME, MODE_PRIVATE)
-            .edit()
-            .putFloat(KEY_PLAYBACK_SPEED, currentSpeed)
-            .apply()
+    // ========== 夜间模式 ==========
+
+    private fun setupNightMode() {
+        updateNightModeLabel()
+        binding.tvNightMode.setOnClickListener {
+            val enabled = !AppSettings.current.nightMode
+            AppSettings.setNightMode(enabled)
+            updateNightModeLabel()
+            mediaController?.let { sendNightMode(it) }
+            Toast.makeText(
+                this,
+                if (enabled) R.string.night_mode_on else R.string.night_mode_off,
+                Toast.LENGTH_SHORT
+            ).show()
+        }
     }
 
-    private fun loadPlaybackSpeed() {
-        val prefs = getSharedPreferences(PREF_NAME, MODE_PRIVATE)
-        currentSpeed = prefs.getFloat(KEY_PLAYBACK_SPEED, 1.0f)
+    private fun updateNightModeLabel() {
+        val color = if (AppSettings.current.nightMode) R.color.primary else R.color.player_text_secondary
+        binding.tvNightMode.setTextColor(getColor(color))
+    }
+
+    /** 夜间模式在播放服务的音频链中处理，开关通过会话命令同步 */
+    private fun sendNightMode(controller: MediaController) {
+        controller.sendCustomCommand(NightMode.COMMAND, NightMode.args(AppSettings.current.nightMode))
     }
 
     private fun setupControls() {
@@ -402,6 +593,26 @@ class PlayerActivity : AppCompatActivity() {
             }
         })
 
+        // 波形进度条拖动
+        binding.waveformSeekBar.onSeekListener = object : WaveformSeekBar.OnSeekListener {
+            override fun onSeekStart() {
+                isUserSeeking = true
+            }
+
+            override fun onSeekPreview(positionMs: Long) {
+                binding.tvCurrentTime.text = TimeUtils.formatTime(positionMs)
+            }
+
+            override fun onSeek(positionMs: Long) {
+                isUserSeeking = false
+                mediaController?.seekTo(positionMs)
+            }
+
+            override fun onSeekCancel() {
+                isUserSeeking = false
+            }
+        }
+
         binding.sliderProgress.addOnChangeListener { _, value, fromUser ->
             if (fromUser) {
                 val duration = mediaController?.duration?.coerceAtLeast(0) ?: 0
@@ -417,6 +628,8 @@ class PlayerActivity : AppCompatActivity() {
             if (chapter != null) {
                 binding.toolbar.title = chapter.title
                 binding.toolbar.subtitle = chapter.parentFolder.ifEmpty { null }
+                // 控制器先于章节就绪时，章节加载完成后再开始播放
+                if (!playbackStarted) mediaController?.let { startPlayback(it) }
             }
         }
 
@@ -432,6 +645,26 @@ class PlayerActivity : AppCompatActivity() {
             }
         }
 
+        // 波形概览
+        viewModel.waveform.observe(this) { waveform ->
+            binding.waveformSeekBar.setWaveform(waveform)
+            binding.waveformSeekBar.visibility = if (waveform != null) View.VISIBLE else View.GONE
+        }
+
+        // 字幕同步结果
+        viewModel.syncMessage.observe(this) { message ->
+            if (message != null) {
+                Toast.makeText(this, message, Toast.LENGTH_SHORT).show()
+                viewModel.clearSyncMessage()
+            }
+        }
+
+        // 字幕时间轴变化时重绘当前字幕（同步调整后立即生效）
+        viewModel.timeline.observe(this) {
+            lastDualLineIndex = -1
+            updateSubtitleDisplay(viewModel.currentPosition.value ?: 0L)
+        }
+
         // 上次播放位置提示
         viewModel.lastProgress.observe(this) { progress ->
             if (progress != null && progress.positionMs > 0) {
@@ -454,11 +687,13 @@ class PlayerActivity : AppCompatActivity() {
     // ========== MediaController 管理 ==========
 
     private fun initMediaController() {
-        val sessionToken = SessionToken(this, ComponentName(this, MediaPlaybackService::class.java))
+        val sessionToken = SessionToken(this, PlaybackProcess.sessionComponent(this))
+        val traceCookie = Tracing.beginAsync("player.connect")
         val future = MediaController.Builder(this, sessionToken).buildAsync()
         controllerFuture = future
 
         future.addListener({
+            Tracing.endAsync("player.connect", traceCookie)
             try {
                 mediaController = future.get()
                 onMediaControllerReady()
@@ -476,32 +711,92 @@ class PlayerActivity : AppCompatActivity() {
             override fun onIsPlayingChanged(isPlaying: Boolean) {
                 viewModel.updatePlayingState(isPlaying)
                 updatePlayPauseButton(isPlaying)
+                scheduleKaraokeFrame()
             }
 
             override fun onPlaybackStateChanged(playbackState: Int) {
                 if (playbackState == Player.STATE_READY) {
+                    endPrepareTrace()
                     val duration = controller.duration
                     viewModel.updateDuration(duration)
                     binding.tvTotalTime.text = TimeUtils.formatTime(duration)
                     binding.sliderProgress.valueTo = 100f
                 }
             }
+
+            override fun onMediaItemTransition(mediaItem: MediaItem?, reason: Int) {
+                // 连播进入下一章节（设置播放列表本身引起的切换不算）
+                if (reason == Player.MEDIA_ITEM_TRANSITION_REASON_PLAYLIST_CHANGED) return
+                ChapterMediaItems.chapterId(mediaItem)?.let { viewModel.switchToChapter(it) }
+            }
+
+            override fun onPlayerError(error: PlaybackException) {
+                endPrepareTrace()
+                // 平台解码器和 FFmpeg 扩展都无法处理时，明确提示而不是静默失败
+                val message = when (error.errorCode) {
+                    PlaybackException.ERROR_CODE_DECODER_INIT_FAILED,
+                    PlaybackException.ERROR_CODE_DECODING_FORMAT_UNSUPPORTED,
+                    PlaybackException.ERROR_CODE_DECODING_FORMAT_EXCEEDS_CAPABILITIES,
+                    PlaybackException.ERROR_CODE_PARSING_CONTAINER_UNSUPPORTED ->
+                        getString(R.string.playback_error_unsupported)
+                    else -> getString(R.string.playback_error, error.errorCodeName)
+                }
+                Toast.makeText(this@PlayerActivity, message, Toast.LENGTH_LONG).show()
+            }
         })
 
-        // 设置保存的倍速
+        // 设置保存的倍速和夜间模式
         controller.setPlaybackSpeed(currentSpeed)
+        sendNightMode(controller)
 
         // 开始播放
         startPlayback(controller)
     }
 
     private fun startPlayback(controller: MediaController) {
-        val audioUri = viewModel.getAudioUri() ?: return
+        val active = controller.playbackState != Player.STATE_IDLE &&
+            controller.playbackState != Player.STATE_ENDED
+        val currentId = ChapterMediaItems.chapterId(controller.currentMediaItem)
+
+        // 从后台回到播放页：播放器可能已连播到后面的章节，跟随播放器
+        if (playbackStarted && active && currentId != null && viewModel.playlist.any { it.id == currentId }) {
+            viewModel.switchToChapter(currentId)
+            controller.play()
+            return
+        }
+
+        // 播放器已加载这一章节：不重新加载，直接播放；
+        // 详情页 / 主页预热只载入了播放列表（停在 IDLE、位置为上次进度），在这里 prepare
+        if (currentId == viewModel.chapterId && (active || controller.playbackState == Player.STATE_IDLE)) {
+            playbackStarted = true
+            if (!active) {
+                endPrepareTrace()
+                prepareTraceCookie = Tracing.beginAsync("player.prepare")
+                controller.prepare()
+            }
+            controller.play()
+            return
+        }
 
-        val mediaItem = MediaItem.fromUri(audioUri)
-        controller.setMediaItem(mediaItem)
+        val chapter = viewModel.chapter.value ?: return
+        // 整本书作为播放列表，章节结束后自动连播下一章节
+        val (items, index) = ChapterMediaItems.buildPlaylist(viewModel.playlist, chapter.id)
+        if (index >= 0) {
+            controller.setMediaItems(items, index, 0L)
+        } else {
+            controller.setMediaItem(ChapterMediaItems.build(chapter) ?: return)
+        }
+        endPrepareTrace()
+        prepareTraceCookie = Tracing.beginAsync("player.prepare")
         controller.prepare()
         controller.play()
+        playbackStarted = true
+    }
+
+    private fun endPrepareTrace() {
+        if (prepareTraceCookie == 0) return
+        Tracing.endAsync("player.prepare", prepareTraceCookie)
+        prepareTraceCookie = 0
     }
 
     private fun releaseMediaController() {
@@ -520,6 +815,8 @@ class PlayerActivity : AppCompatActivity() {
 
         val position = controller.currentPosition
         val duration = controller.duration.coerceAtLeast(1)
+        // 连播切换章节时播放状态保持 READY，时长在这里跟进
+        if (controller.duration > 0) viewModel.updateDuration(controller.duration)
 
         viewModel.updatePosition(position)
 
@@ -530,6 +827,8 @@ class PlayerActivity : AppCompatActivity() {
 
             val progress = (position.toFloat() / duration * 100f).coerceIn(0f, 100f)
             binding.sliderProgress.value = progress
+            binding.waveformSeekBar.setDuration(duration)
+            binding.waveformSeekBar.setPosition(position)
         }
 
         // 根据模式更新字幕
@@ -547,16 +846,37 @@ class PlayerActivity : AppCompatActivity() {
      * 根据当前字幕模式更新字幕显示
      */
     private fun updateSubtitleDisplay(positionMs: Long) {
-        val subtitles = viewModel.subtitles.value ?: return
-        if (subtitles.isEmpty()) return
+        karaokeActive = false
+        val timeline = viewModel.timeline.value ?: return
+        if (timeline.isEmpty) return
 
-        val index = SubtitleHelper.getCurrentSubtitleIndex(subtitles, positionMs)
+        val index = timeline.indexAt(positionMs)
 
         when (currentDisplayMode) {
             SubtitleDisplayMode.LYRIC -> updateLyricMode(index)
-            SubtitleDisplayMode.DUAL_LINE -> updateDualLineMode(index, subtitles)
+            SubtitleDisplayMode.DUAL_LINE -> updateDualLineMode(index, timeline)
             SubtitleDisplayMode.CHAT -> updateChatMode(index)
         }
+
+        // 暂停和拖动时也按当前位置显示填充进度，播放中由帧回调接着更新
+        karaokeActive = index >= 0 && timeline.entries[index].syllables.isNotEmpty()
+        if (karaokeActive) updateKaraoke(timeline.toSubtitleTime(positionMs))
+        scheduleKaraokeFrame()
+    }
+
+    private fun updateKaraoke(subtitleMs: Long) {
+        if (currentDisplayMode == SubtitleDisplayMode.DUAL_LINE) {
+            dualLineKaraoke.update(subtitleMs)
+        } else {
+            subtitleAdapter.updateKaraoke(subtitleMs)
+        }
+    }
+
+    private fun scheduleKaraokeFrame() {
+        if (karaokeFrameScheduled || !karaokeActive || mediaController?.isPlaying != true) return
+        if (!lifecycle.currentState.isAtLeast(Lifecycle.State.RESUMED)) return
+        karaokeFrameScheduled = true
+        Choreographer.getInstance().postFrameCallback(karaokeFrameCallback)
     }
 
     /**
@@ -587,8 +907,9 @@ class PlayerActivity : AppCompatActivity() {
      *   切换：上=句3(高亮) 下=句4(暗)
      *   如此交替...
      */
-    private fun updateDualLineMode(index: Int, subtitles: List<com.hx.nekomimi.subtitle.SubtitleEntry>) {
+    private fun updateDualLineMode(index: Int, timeline: SubtitleTimeline) {
         val dualLineBinding = binding.layoutDualLine
+        val subtitles = timeline.entries
 
         if (index >= 0 && index < subtitles.size) {
             // 字幕索引发生变化时，切换高亮位置
@@ -603,15 +924,19 @@ class PlayerActivity : AppCompatActivity() {
                 lastDualLineIndex = index
             }
 
-            val currentText = subtitles[index].text
+            val current = subtitles[index]
             val nextText = if (index + 1 < subtitles.size) subtitles[index + 1].text else ""
+            // 卡拉 OK 句以普通文字颜色为底，已唱部分逐字变为高亮色
+            val highlightColor = getColor(
+                if (current.syllables.isNotEmpty()) R.color.player_text else R.color.subtitle_highlight
+            )
 
             if (dualLineHighlightOnTop) {
                 // 高亮在上面：上=当前句(高亮)，下=下一句(暗)
-                dualLineBinding.tvCurrentLine.text = currentText
+                setDualLineCue(dualLineBinding.tvCurrentLine, current)
                 dualLineBinding.tvNextLine.text = nextText
                 // 上面高亮样式
-                dualLineBinding.tvCurrentLine.setTextColor(getColor(R.color.subtitle_highlight))
+                dualLineBinding.tvCurrentLine.setTextColor(highlightColor)
                 dualLineBinding.tvCurrentLine.textSize = 20f
                 dualLineBinding.tvCurrentLine.alpha = 1.0f
                 dualLineBinding.tvCurrentLine.paint.isFakeBoldText = true
@@ -623,14 +948,14 @@ class PlayerActivity : AppCompatActivity() {
             } else {
                 // 高亮在下面：上=下一句(暗)，下=当前句(高亮)
                 dualLineBinding.tvCurrentLine.text = nextText
-                dualLineBinding.tvNextLine.text = currentText
+                setDualLineCue(dualLineBinding.tvNextLine, current)
                 // 上面暗色样式
                 dualLineBinding.tvCurrentLine.setTextColor(getColor(R.color.player_text_secondary))
                 dualLineBinding.tvCurrentLine.textSize = 16f
                 dualLineBinding.tvCurrentLine.alpha = 0.6f
                 dualLineBinding.tvCurrentLine.paint.isFakeBoldText = false
                 // 下面高亮样式
-                dualLineBinding.tvNextLine.setTextColor(getColor(R.color.subtitle_highlight))
+                dualLineBinding.tvNextLine.setTextColor(highlightColor)
                 dualLineBinding.tvNextLine.textSize = 20f
                 dualLineBinding.tvNextLine.alpha = 1.0f
                 dualLineBinding.tvNextLine.paint.isFakeBoldText = true
@@ -645,7 +970,7 @@ class PlayerActivity : AppCompatActivity() {
         } else {
             // 当前没有字幕匹配（间隙期间）
             // 找到下一条即将出现的字幕
-            val nextIndex = subtitles.indexOfFirst { it.startMs > (viewModel.currentPosition.value ?: 0L) }
+            val nextIndex = timeline.nextIndexAfter(viewModel.currentPosition.value ?: 0L)
             if (nextIndex >= 0) {
                 if (dualLineHighlightOnTop) {
                     // 上一次高亮在上面，那下一句预览放下面
@@ -674,6 +999,17 @@ class PlayerActivity : AppCompatActivity() {
         }
     }
 
+    /**
+     * 双行模式设置当前句：带音节时间时逐字填充（同一句已显示在这一行上时不重复设置，保留填充进度）
+     */
+    private fun setDualLineCue(view: TextView, entry: SubtitleEntry) {
+        if (entry.syllables.isEmpty()) {
+            view.text = entry.text
+        } else if (!dualLineKaraoke.isShowing(view, entry.syllables)) {
+            dualLineKaraoke.attach(view, entry.text, entry.syllables)
+        }
+    }
+
     /**
      * 对话模式：高亮当前行并滚动到可见
      */
@@ -752,10 +1088,14 @@ class PlayerActivity : AppCompatActivity() {
         dialogBinding.switchBgmEnable.isChecked = BgmManager.isEnabled()
 
         // 初始化文件名显示
-        val displayName = BgmManager.getBgmDisplayName(this)
+        val displayName = BgmManager.getBgmDisplayName()
         if (displayName != null) {
             dialogBinding.tvBgmFileName.text = displayName
             dialogBinding.btnClearBgm.visibility = View.VISIBLE
+            // 旧版本没有保存文件名，后台查询后补上
+            lifecycleScope.launch {
+                BgmManager.resolveDisplayName(this@PlayerActivity)?.let { dialogBinding.tvBgmFileName.text = it }
+            }
         } else {
             dialogBinding.tvBgmFileName.text = getString(R.string.bgm_no_file)
             dialogBinding.btnClearBgm.visibility = View.GONE
@@ -18,6 +18,9 @@ class ChapterAdapter(
 
     private var currentPlayingId: Long = -1
 
+    /** 与其他书籍内容重复的章节 */
+    private var duplicateIds: Set<Long> = emptySet()
+
     fun setCurrentPlaying(chapterId: Long) {
         val oldId = currentPlayingId
         currentPlayingId = chapterId
@@ -29,6 +32,15 @@ class ChapterAdapter(
         }
     }
 
+    fun setDuplicates(ids: Set<Long>) {
+        if (ids == duplicateIds) return
+        val changed = (ids - duplicateIds) + (duplicateIds - ids)
+        duplicateIds = ids
+        currentList.forEachIndexed { index, chapter ->
+            if (chapter.id in changed) notifyItemChanged(index)
+        }
+    }
+
     override fun onCreateViewHolder(parent: ViewGroup, viewType: Int): ViewHolder {
         val binding = ItemChapterBinding.inflate(
             LayoutInflater.from(parent.context), parent, false
@@ -61,10 +73,14 @@ class ChapterAdapter(
 
             binding.tvChapterTitle.text = chapter.title
 
-            // 文件夹路径
-            if (chapter.parentFolder.isNotEmpty()) {
+            // 文件夹路径，以及与其他书籍重复的标记
+            val folderLine = listOfNotNull(
+                chapter.parentFolder.takeIf { it.isNotEmpty() },
+                context.getString(R.string.chapter_duplicate).takeIf { chapter.id in duplicateIds }
+            ).joinToString(" · ")
+            if (folderLine.isNotEmpty()) {
                 binding.tvFolderPath.visibility = View.VISIBLE
-                binding.tvFolderPath.text = chapter.parentFolder
+                binding.tvFolderPath.text = folderLine
             } else {
                 binding.tvFolderPath.visibility = View.GONE
             }
@@ -0,0 +1,73 @@
+package com.hx.nekomimi.ui.adapter
+
+import android.view.LayoutInflater
+import android.view.View
+import android.view.ViewGroup
+import androidx.recyclerview.widget.DiffUtil
+import androidx.recyclerview.widget.ListAdapter
+import androidx.recyclerview.widget.RecyclerView
+import com.hx.nekomimi.R
+import com.hx.nekomimi.data.model.RecentlyPlayed
+import com.hx.nekomimi.databinding.ItemRecentlyPlayedBinding
+import com.hx.nekomimi.util.TimeUtils
+
+/**
+ * 主页「继续收听」书架（横向列表）
+ */
+class RecentlyPlayedAdapter(
+    private val onClick: (RecentlyPlayed) -> Unit
+) : ListAdapter<RecentlyPlayed, RecentlyPlayedAdapter.ViewHolder>(DIFF_CALLBACK) {
+
+    override fun onCreateViewHolder(parent: ViewGroup, viewType: Int): ViewHolder {
+        val binding = ItemRecentlyPlayedBinding.inflate(
+            LayoutInflater.from(parent.context), parent, false
+        )
+        return ViewHolder(binding)
+    }
+
+    override fun onBindViewHolder(holder: ViewHolder, position: Int) {
+        holder.bind(getItem(position))
+    }
+
+    inner class ViewHolder(
+        private val binding: ItemRecentlyPlayedBinding
+    ) : RecyclerView.ViewHolder(binding.root) {
+
+        fun bind(item: RecentlyPlayed) {
+            val context = binding.root.context
+            val percent = item.percentComplete()
+
+            binding.tvBookName.text = item.bookName
+            binding.tvChapterTitle.text = item.chapterTitle
+            binding.tvProgress.text = context.getString(
+                R.string.recent_progress, TimeUtils.formatTime(item.positionMs), percent
+            )
+            binding.progressBook.progress = percent
+
+            // 封面：有封面路径时加载，否则显示默认图标
+            if (item.coverPath != null) {
+                binding.imgCover.visibility = View.VISIBLE
+                com.bumptech.glide.Glide.with(context)
+                    .load(item.coverPath)
+                    .centerCrop()
+                    .into(binding.imgCover)
+            } else {
+                binding.imgCover.visibility = View.GONE
+            }
+
+            binding.root.setOnClickListener { onClick(item) }
+        }
+    }
+
+    companion object {
+        private val DIFF_CALLBACK = object : DiffUtil.ItemCallback<RecentlyPlayed>() {
+            override fun areItemsTheSame(oldItem: RecentlyPlayed, newItem: RecentlyPlayed): Boolean {
+                return oldItem.bookId == newItem.bookId
+            }
+
+            override fun areContentsTheSame(oldItem: RecentlyPlayed, newItem: RecentlyPlayed): Boolean {
+                return oldItem == newItem
+            }
+        }
+    }
+}
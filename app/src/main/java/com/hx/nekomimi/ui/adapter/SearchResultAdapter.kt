@@ -0,0 +1,59 @@
+package com.hx.nekomimi.ui.adapter
+
+import android.view.LayoutInflater
+import android.view.ViewGroup
+import androidx.recyclerview.widget.DiffUtil
+import androidx.recyclerview.widget.ListAdapter
+import androidx.recyclerview.widget.RecyclerView
+import com.hx.nekomimi.R
+import com.hx.nekomimi.data.model.SearchResult
+import com.hx.nekomimi.databinding.ItemSearchResultBinding
+
+/**
+ * 主页搜索结果（书籍在前，章节在后）
+ */
+class SearchResultAdapter(
+    private val onClick: (SearchResult) -> Unit
+) : ListAdapter<SearchResult, SearchResultAdapter.ViewHolder>(DIFF_CALLBACK) {
+
+    override fun onCreateViewHolder(parent: ViewGroup, viewType: Int): ViewHolder {
+        val binding = ItemSearchResultBinding.inflate(
+            LayoutInflater.from(parent.context), parent, false
+        )
+        return ViewHolder(binding)
+    }
+
+    override fun onBindViewHolder(holder: ViewHolder, position: Int) {
+        holder.bind(getItem(position))
+    }
+
+    inner class ViewHolder(
+        private val binding: ItemSearchResultBinding
+    ) : RecyclerView.ViewHolder(binding.root) {
+
+        fun bind(item: SearchResult) {
+            val context = binding.root.context
+            if (item.isBook) {
+                binding.tvTitle.text = item.bookName
+                binding.tvSubtitle.text = context.getString(R.string.search_result_book)
+            } else {
+                binding.tvTitle.text = item.chapterTitle
+                binding.tvSubtitle.text = listOfNotNull(item.bookName, item.parentFolder?.takeIf { it.isNotEmpty() })
+                    .joinToString(" · ")
+            }
+            binding.root.setOnClickListener { onClick(item) }
+        }
+    }
+
+    companion object {
+        private val DIFF_CALLBACK = object : DiffUtil.ItemCallback<SearchResult>() {
+            override fun areItemsTheSame(oldItem: SearchResult, newItem: SearchResult): Boolean {
+                return oldItem.bookId == newItem.bookId && oldItem.chapterId == newItem.chapterId
+            }
+
+            override fun areContentsTheSame(oldItem: SearchResult, newItem: SearchResult): Boolean {
+                return oldItem == newItem
+            }
+        }
+    }
+}
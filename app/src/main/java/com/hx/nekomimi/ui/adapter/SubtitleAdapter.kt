@@ -2,6 +2,7 @@ package com.hx.nekomimi.ui.adapter
 
 import android.view.LayoutInflater
 import android.view.ViewGroup
+import android.widget.TextView
 import androidx.core.content.ContextCompat
 import androidx.recyclerview.widget.DiffUtil
 import androidx.recyclerview.widget.ListAdapter
@@ -12,11 +13,13 @@ import com.hx.nekomimi.databinding.ItemSubtitleChatLeftBinding
 import com.hx.nekomimi.databinding.ItemSubtitleChatRightBinding
 import com.hx.nekomimi.subtitle.SubtitleDisplayMode
 import com.hx.nekomimi.subtitle.SubtitleEntry
+import com.hx.nekomimi.ui.widget.KaraokeHighlighter
 
 /**
  * 字幕适配器 — 支持歌词模式、双行模式、对话模式
  *
  * 歌词模式和对话模式使用此 Adapter，双行模式由 PlayerActivity 直接操作双行布局。
+ * 高亮行带卡拉 OK 音节时由 [KaraokeHighlighter] 逐字填充，进度通过 [updateKaraoke] 直接更新该行，不重新绑定。
  */
 class SubtitleAdapter(
     private var displayMode: SubtitleDisplayMode = SubtitleDisplayMode.LYRIC
@@ -44,6 +47,9 @@ class SubtitleAdapter(
 
     private var highlightIndex: Int = -1
 
+    /** 高亮行的逐字填充（第一次创建 ViewHolder 时按主题颜色创建） */
+    private var karaoke: KaraokeHighlighter? = null
+
     /**
      * 对话模式下，已知说话人列表（按出场顺序），用于交替左右气泡
      * 第一个说话人放左边，第二个放右边，第三个又放左边...
@@ -55,6 +61,7 @@ class SubtitleAdapter(
      * 设置当前高亮的字幕索引
      */
     fun setHighlightIndex(index: Int) {
+        if (index == highlightIndex) return
         val oldIndex = highlightIndex
         highlightIndex = index
         if (oldIndex >= 0 && oldIndex < currentList.size) {
@@ -67,6 +74,16 @@ class SubtitleAdapter(
 
     fun getHighlightIndex(): Int = highlightIndex
 
+    /** 高亮行是否正在显示卡拉 OK 音节 */
+    fun hasActiveKaraoke(): Boolean = karaoke?.isAttached == true
+
+    /**
+     * 按字幕时间更新高亮行的逐字填充（每帧调用，只重绘高亮行）
+     */
+    fun updateKaraoke(subtitleMs: Long) {
+        karaoke?.update(subtitleMs)
+    }
+
     /**
      * 切换显示模式
      */
@@ -114,6 +131,9 @@ class SubtitleAdapter(
 
     override fun onCreateViewHolder(parent: ViewGroup, viewType: Int): RecyclerView.ViewHolder {
         val inflater = LayoutInflater.from(parent.context)
+        if (karaoke == null) {
+            karaoke = KaraokeHighlighter(ContextCompat.getColor(parent.context, R.color.subtitle_highlight))
+        }
         return when (viewType) {
             TYPE_CHAT_LEFT -> {
                 val binding = ItemSubtitleChatLeftBinding.inflate(inflater, parent, false)
@@ -141,6 +161,26 @@ class SubtitleAdapter(
         }
     }
 
+    /**
+     * 设置字幕文本：高亮行有音节时间时交给 [karaoke] 逐字填充
+     * @param offset [shown] 在字幕条目文本中的起始位置
+     */
+    private fun bindCueText(view: TextView, entry: SubtitleEntry, shown: String, offset: Int, isHighlight: Boolean) {
+        val karaoke = karaoke
+        if (isHighlight && entry.syllables.isNotEmpty() && karaoke != null) {
+            karaoke.attach(view, shown, entry.syllables, offset)
+        } else {
+            view.text = shown
+        }
+    }
+
+    /** 对话模式正文在字幕条目文本中的起始位置（正文为空时显示整行，位置为 0） */
+    private fun contentOffset(entry: SubtitleEntry, match: MatchResult, content: String): Int {
+        if (content.isEmpty()) return 0
+        val group = match.groups[2] ?: return 0
+        return entry.text.indexOf(content, group.range.first).coerceAtLeast(0)
+    }
+
     // ========== 歌词模式 ViewHolder ==========
 
     inner class LyricViewHolder(
@@ -149,12 +189,12 @@ class SubtitleAdapter(
 
         fun bind(entry: SubtitleEntry, isHighlight: Boolean) {
             val context = binding.root.context
-            binding.tvSubtitleText.text = entry.text
+            bindCueText(binding.tvSubtitleText, entry, entry.text, 0, isHighlight)
 
             if (isHighlight) {
-                binding.tvSubtitleText.setTextColor(
-                    ContextCompat.getColor(context, R.color.subtitle_highlight)
-                )
+                // 卡拉 OK 行以普通文字颜色为底，已唱部分逐字变为高亮色
+                val color = if (entry.syllables.isNotEmpty()) R.color.player_text else R.color.subtitle_highlight
+                binding.tvSubtitleText.setTextColor(ContextCompat.getColor(context, color))
                 binding.tvSubtitleText.alpha = 1.0f
                 binding.tvSubtitleText.textSize = 18f
             } else {
@@ -181,12 +221,12 @@ class SubtitleAdapter(
                 val speaker = match.groupValues[1].trim()
                 val content = match.groupValues[2].trim()
                 binding.tvSpeaker.text = speaker
-                binding.tvContent.text = content.ifEmpty { entry.text }
+                bindCueText(binding.tvContent, entry, content.ifEmpty { entry.text }, contentOffset(entry, match, content), isHighlight)
                 // 头像显示说话人名字首字
                 binding.tvAvatar.text = speaker.firstOrNull()?.toString() ?: "?"
             } else {
                 binding.tvSpeaker.text = ""
-                binding.tvContent.text = entry.text
+                bindCueText(binding.tvContent, entry, entry.text, 0, isHighlight)
                 binding.tvAvatar.text = "?"
             }
 
@@ -216,11 +256,11 @@ class SubtitleAdapter(
                 val speaker = match.groupValues[1].trim()
                 val content = match.groupValues[2].trim()
                 binding.tvSpeaker.text = speaker
-                binding.tvContent.text = content.ifEmpty { entry.text }
+                bindCueText(binding.tvContent, entry, content.ifEmpty { entry.text }, contentOffset(entry, match, content), isHighlight)
                 binding.tvAvatar.text = speaker.firstOrNull()?.toString() ?: "?"
             } else {
                 binding.tvSpeaker.text = ""
-                binding.tvContent.text = entry.text
+                bindCueText(binding.tvContent, entry, entry.text, 0, isHighlight)
                 binding.tvAvatar.text = "?"
             }
 
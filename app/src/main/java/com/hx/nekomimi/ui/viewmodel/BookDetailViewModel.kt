@@ -4,10 +4,13 @@ import android.app.Application
 import android.net.Uri
 import androidx.lifecycle.*
 import com.hx.nekomimi.NekoMimiApp
+import com.hx.nekomimi.R
 import com.hx.nekomimi.data.entity.Book
 import com.hx.nekomimi.data.entity.Chapter
-import com.hx.nekomimi.data.entity.PlaybackProgress
+import com.hx.nekomimi.data.model.ProgressWithChapter
 import com.hx.nekomimi.data.repository.BookRepository
+import com.hx.nekomimi.transcribe.TranscriptionQueue
+import com.hx.nekomimi.transcribe.WhisperEngine
 import com.hx.nekomimi.util.FileScanner
 import kotlinx.coroutines.Dispatchers
 import kotlinx.coroutines.launch
@@ -27,10 +30,25 @@ class BookDetailViewModel(application: Application) : AndroidViewModel(applicati
         repository.getChaptersByBookId(id)
     }
 
-    val progress: LiveData<PlaybackProgress?> = _bookId.switchMap { id ->
-        repository.getProgressByBookIdLive(id)
+    /** 与其他书籍内容重复的章节 ID */
+    val duplicateChapterIds: LiveData<Set<Long>> = _bookId.switchMap { id ->
+        repository.getDuplicateChapterIdsLive(id).map { it.toSet() }
     }
 
+    /** 上次播放进度及所在章节 */
+    val progress: LiveData<ProgressWithChapter?> = _bookId.switchMap { id ->
+        repository.getProgressWithChapterLive(id)
+    }
+
+    /** 本书尚未完成的字幕转写任务数 */
+    val pendingTranscriptions: LiveData<Int> = _bookId.switchMap { id ->
+        repository.observePendingTranscriptions(id)
+    }
+
+    /** 需要用户导入语音识别模型（一次性事件） */
+    private val _needModel = MutableLiveData(false)
+    val needModel: LiveData<Boolean> = _needModel
+
     private val _isScanning = MutableLiveData(false)
     val isScanning: LiveData<Boolean> = _isScanning
 
@@ -41,13 +59,6 @@ class BookDetailViewModel(application: Application) : AndroidViewModel(applicati
         _bookId.value = bookId
     }
 
-    /**
-     * 获取上次播放章节的标题
-     */
-    suspend fun getChapterTitle(chapterId: Long): String? {
-        return repository.getChapterById(chapterId)?.title
-    }
-
     /**
      * 刷新章节列表（重新扫描）
      */
@@ -57,17 +68,16 @@ class BookDetailViewModel(application: Application) : AndroidViewModel(applicati
             _isScanning.value = true
             try {
                 val book = repository.getBookById(bookId) ?: return@launch
-                val treeUri = book.rootUri?.let { Uri.parse(it) } ?: return@launch
+                if (book.rootUri == null) return@launch
 
-                val chapters = withContext(Dispatchers.IO) {
-                    FileScanner.scanFromUri(getApplication(), treeUri, bookId)
+                val result = withContext(Dispatchers.IO) {
+                    FileScanner.scanBook(getApplication(), book)
                 }
 
                 // 删除旧章节，插入新章节
-                repository.deleteChaptersByBookId(bookId)
-                repository.insertChapters(chapters)
+                repository.replaceChapters(bookId, result.chapters, result.subtitleTracks)
 
-                _scanResult.value = "扫描完成，共 ${chapters.size} 个章节"
+                _scanResult.value = "扫描完成，共 ${result.chapters.size} 个章节"
             } catch (e: Exception) {
                 e.printStackTrace()
                 _scanResult.value = "扫描失败: ${e.message}"
@@ -80,4 +90,62 @@ class BookDetailViewModel(application: Application) : AndroidViewModel(applicati
     fun clearScanResult() {
         _scanResult.value = null
     }
+
+    /**
+     * 为本书所有没有字幕的章节生成字幕
+     * 首次使用时先请求导入模型
+     */
+    fun generateSubtitles() {
+        val bookId = _bookId.value ?: return
+        val app = getApplication<Application>()
+        if (!WhisperEngine.isAvailable) {
+            _scanResult.value = app.getString(R.string.transcribe_unavailable)
+            return
+        }
+        if (!WhisperEngine.hasModel(app)) {
+            _needModel.value = true
+            return
+        }
+        viewModelScope.launch {
+            val count = TranscriptionQueue.enqueueBook(app, bookId)
+            _scanResult.value = if (count > 0) {
+                app.getString(R.string.transcribe_enqueued, count)
+            } else {
+                app.getString(R.string.transcribe_nothing)
+            }
+        }
+    }
+
+    /**
+     * 把用户选择的模型文件复制到应用私有目录，然后开始生成字幕
+     */
+    fun importModel(uri: Uri) {
+        val app = getApplication<Application>()
+        viewModelScope.launch {
+            val ok = withContext(Dispatchers.IO) {
+                val target = WhisperEngine.modelFile(app)
+                val temp = java.io.File(target.path + ".tmp")
+                try {
+                    target.parentFile?.mkdirs()
+                    app.contentResolver.openInputStream(uri)?.use { input ->
+                        temp.outputStream().use { input.copyTo(it) }
+                    } ?: return@withContext false
+                    temp.renameTo(target)
+                } catch (e: Exception) {
+                    e.printStackTrace()
+                    temp.delete()
+                    false
+                }
+            }
+            if (ok) {
+                generateSubtitles()
+            } else {
+                _scanResult.value = app.getString(R.string.transcribe_model_import_failed)
+            }
+        }
+    }
+
+    fun clearNeedModel() {
+        _needModel.value = false
+    }
 }
@@ -3,38 +3,46 @@ package com.hx.nekomimi.ui.viewmodel
 import android.app.Application
 import androidx.lifecycle.*
 import com.hx.nekomimi.NekoMimiApp
-import com.hx.nekomimi.data.entity.Book
+import com.hx.nekomimi.data.model.RecentlyPlayed
+import com.hx.nekomimi.data.model.SearchResult
 import com.hx.nekomimi.data.repository.BookRepository
 import com.hx.nekomimi.ui.adapter.BookAdapter
+import kotlinx.coroutines.Job
+import kotlinx.coroutines.delay
 import kotlinx.coroutines.launch
 
 class MainViewModel(application: Application) : AndroidViewModel(application) {
 
     private val repository = BookRepository((application as NekoMimiApp).database)
 
-    private val _books = repository.getAllBooks()
-    val books: LiveData<List<Book>> = _books
-
-    // 监听章节表整体变化，当章节插入/删除时会触发
-    private val _chapterChange = repository.observeTotalChapterCount()
-
     /**
-     * 将书籍列表转换为带章节数量的 BookItem 列表
-     * 同时监听书籍列表和章节表变化，任一变化都会重新计算
+     * 书架列表（book_stats 视图一次查询带出章节数，书籍或章节变化时自动刷新）
      */
-    private val _refreshTrigger = MediatorLiveData<Unit>().apply {
-        addSource(_books) { value = Unit }
-        addSource(_chapterChange) { value = Unit }
+    val bookItems: LiveData<List<BookAdapter.BookItem>> = repository.getAllBooksWithStats().map { books ->
+        books.map { BookAdapter.BookItem(it.book, it.chapterCount) }
     }
 
-    val bookItems: LiveData<List<BookAdapter.BookItem>> = _refreshTrigger.switchMap {
-        liveData {
-            val bookList = _books.value ?: emptyList()
-            val items = bookList.map { book ->
-                val count = repository.getChapterCount(book.id)
-                BookAdapter.BookItem(book, count)
-            }
-            emit(items)
+    /** 「继续收听」书架：最近播放的几本书，进度变化时自动刷新 */
+    val recentlyPlayed: LiveData<List<RecentlyPlayed>> = repository.getRecentlyPlayedLive(RECENT_SHELF_SIZE)
+
+    /** 搜索结果；null 表示没有在搜索（显示书架） */
+    private val _searchResults = MutableLiveData<List<SearchResult>?>(null)
+    val searchResults: LiveData<List<SearchResult>?> = _searchResults
+
+    private var searchJob: Job? = null
+
+    /**
+     * 输入变化时调用：短暂停顿后再查询，连续输入只执行最后一次
+     */
+    fun search(query: String) {
+        searchJob?.cancel()
+        if (query.isBlank()) {
+            _searchResults.value = null
+            return
+        }
+        searchJob = viewModelScope.launch {
+            delay(SEARCH_DEBOUNCE_MS)
+            _searchResults.value = repository.search(query, SEARCH_LIMIT)
         }
     }
 
@@ -43,4 +51,10 @@ class MainViewModel(application: Application) : AndroidViewModel(application) {
             repository.deleteBook(bookId)
         }
     }
+
+    companion object {
+        private const val RECENT_SHELF_SIZE = 10
+        private const val SEARCH_DEBOUNCE_MS = 150L
+        private const val SEARCH_LIMIT = 200
+    }
 }
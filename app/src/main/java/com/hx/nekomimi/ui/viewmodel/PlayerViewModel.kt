@@ -4,12 +4,21 @@ import android.app.Application
 import android.net.Uri
 import androidx.lifecycle.*
 import com.hx.nekomimi.NekoMimiApp
+import com.hx.nekomimi.R
+import com.hx.nekomimi.audio.waveform.WaveformData
+import com.hx.nekomimi.audio.waveform.WaveformStore
 import com.hx.nekomimi.data.entity.Chapter
 import com.hx.nekomimi.data.entity.PlaybackProgress
+import com.hx.nekomimi.data.entity.SubtitleTrack
 import com.hx.nekomimi.data.repository.BookRepository
+import com.hx.nekomimi.settings.AppSettings
+import com.hx.nekomimi.subtitle.BilingualMerger
 import com.hx.nekomimi.subtitle.SubtitleEntry
-import com.hx.nekomimi.subtitle.SubtitleHelper
+import com.hx.nekomimi.subtitle.SubtitleLoader
+import com.hx.nekomimi.subtitle.SubtitleSyncAnalyzer
+import com.hx.nekomimi.subtitle.SubtitleTimeline
 import com.hx.nekomimi.util.FileScanner
+import com.hx.nekomimi.util.Tracing
 import kotlinx.coroutines.Dispatchers
 import kotlinx.coroutines.launch
 import kotlinx.coroutines.withContext
@@ -24,6 +33,24 @@ class PlayerViewModel(application: Application) : AndroidViewModel(application)
     private val _subtitles = MutableLiveData<List<SubtitleEntry>>(emptyList())
     val subtitles: LiveData<List<SubtitleEntry>> = _subtitles
 
+    /** 当前音频文件的全部候选字幕轨道 */
+    private val _subtitleTracks = MutableLiveData<List<SubtitleTrack>>(emptyList())
+    val subtitleTracks: LiveData<List<SubtitleTrack>> = _subtitleTracks
+
+    /** 应用了同步校正的字幕时间轴，用于按播放位置查找字幕 */
+    private val _timeline = MutableLiveData(SubtitleTimeline.EMPTY)
+    val timeline: LiveData<SubtitleTimeline> = _timeline
+
+    /** 章节波形概览（首次打开时在后台生成） */
+    private val _waveform = MutableLiveData<WaveformData?>()
+    val waveform: LiveData<WaveformData?> = _waveform
+
+    private val _isSyncing = MutableLiveData(false)
+    val isSyncing: LiveData<Boolean> = _isSyncing
+
+    private val _syncMessage = MutableLiveData<String?>()
+    val syncMessage: LiveData<String?> = _syncMessage
+
     private val _currentPosition = MutableLiveData(0L)
     val currentPosition: LiveData<Long> = _currentPosition
 
@@ -41,6 +68,23 @@ class PlayerViewModel(application: Application) : AndroidViewModel(application)
     var chapterId: Long = 0L
         private set
 
+    /** 整本书的章节（播放列表顺序） */
+    var playlist: List<Chapter> = emptyList()
+        private set
+
+    /**
+     * 预取的下一章节及其字幕轨道（字幕已解析进 [SubtitleLoader] 缓存）
+     */
+    private class Lookahead(val chapter: Chapter, val tracks: List<SubtitleTrack>)
+
+    private var lookahead: Lookahead? = null
+
+    /** 已经发起过预取的章节，每个章节只预取一次 */
+    private var lookaheadFor = 0L
+
+    /** 预取作废时递增，作废之前发起、尚未完成的预取结果直接丢弃 */
+    private var lookaheadGeneration = 0
+
     /**
      * 加载章节信息和字幕
      */
@@ -49,48 +93,164 @@ class PlayerViewModel(application: Application) : AndroidViewModel(application)
         this.chapterId = chapterId
 
         viewModelScope.launch {
-            val chapter = repository.getChapterById(chapterId)
-            _chapter.value = chapter
+            Tracing.async("player.loadChapter") {
+                playlist = repository.getChaptersByBookIdList(bookId)
+                // 章节、本书进度和字幕轨道一次读取
+                val item = repository.getChapterWithProgress(chapterId)
+                if (item == null) {
+                    _chapter.value = null
+                    return@async
+                }
+                _lastProgress.value = item.progressInChapter()
+                showChapter(item.chapter, item.subtitleTracks())
+            }
+        }
+    }
+
+    /**
+     * 播放器进入了另一章节（自动连播或从后台回到播放页）
+     * 预取过的章节在主线程直接切换，字幕在切换的第一帧就能显示
+     */
+    fun switchToChapter(chapterId: Long) {
+        if (chapterId == this.chapterId) return
+        this.chapterId = chapterId
+        _lastProgress.value = null
+        _currentPosition.value = 0L
+        _duration.value = 0L
+
+        val prefetched = lookahead?.takeIf { it.chapter.id == chapterId }
+        lookahead = null
+        viewModelScope.launch {
+            if (prefetched != null) {
+                showChapter(prefetched.chapter, prefetched.tracks)
+            } else {
+                val item = repository.getChapterWithProgress(chapterId) ?: return@launch
+                if (this@PlayerViewModel.chapterId != chapterId) return@launch
+                showChapter(item.chapter, item.subtitleTracks())
+            }
+        }
+    }
 
-            // 加载字幕
-            if (chapter?.subtitleUri != null) {
-                loadSubtitles(chapter)
+    private suspend fun showChapter(chapter: Chapter, tracks: List<SubtitleTrack>) {
+        _chapter.value = chapter
+        _subtitleTracks.value = tracks
+
+        // 加载波形（不阻塞字幕加载）；虚拟章节共享整个文件的波形，按区间截取
+        _waveform.value = null
+        chapter.fileUri?.let { audioUri ->
+            viewModelScope.launch {
+                val hintMs = if (chapter.isVirtual) 0L else chapter.durationMs
+                val data = WaveformStore.getOrGenerate(getApplication(), audioUri, hintMs)
+                if (_chapter.value?.id != chapter.id) return@launch
+                _waveform.value = if (data != null && chapter.isVirtual) {
+                    data.slice(chapter.startMs, chapter.endMs.takeIf { it > 0 } ?: data.durationMs)
+                } else data
             }
+        }
 
-            // 加载上次播放进度
-            val progress = repository.getProgressByBookId(bookId)
-            if (progress != null && progress.chapterId == chapterId && progress.positionMs > 0) {
-                _lastProgress.value = progress
+        // 加载字幕（只解析当前选择的轨道，其余轨道在切换时才解析）
+        loadSubtitles(chapter)
+    }
+
+    /**
+     * 当前章节播放超过设置中的预取比例（[AppSettings.Settings.lookaheadFraction]）后，读取下一章节并解析其字幕
+     */
+    private fun prefetchNextChapter() {
+        val current = chapterId
+        if (lookaheadFor == current) return
+        lookaheadFor = current
+        val generation = lookaheadGeneration
+
+        val index = playlist.indexOfFirst { it.id == current }
+        val nextId = playlist.getOrNull(index + 1)?.id?.takeIf { index >= 0 } ?: return
+        viewModelScope.launch {
+            val next = repository.getChapterWithProgress(nextId) ?: return@launch
+            withContext(Dispatchers.IO) {
+                SubtitleLoader.preload(getApplication(), next.chapter)
+            }
+            if (chapterId == current && generation == lookaheadGeneration) {
+                lookahead = Lookahead(next.chapter, next.subtitleTracks())
             }
         }
     }
 
-    private suspend fun loadSubtitles(chapter: Chapter) {
-        withContext(Dispatchers.IO) {
-            try {
-                val subtitleUri = chapter.subtitleUri ?: return@withContext
-                val content = FileScanner.readSubtitleContent(getApplication(), subtitleUri)
-                    ?: return@withContext
+    private fun checkLookahead(positionMs: Long) {
+        val durationMs = _duration.value ?: 0L
+        if (durationMs > 0 && positionMs >= durationMs * AppSettings.current.lookaheadFraction) prefetchNextChapter()
+    }
 
-                // 根据 URI 判断字幕类型
-                val fileName = Uri.parse(subtitleUri).lastPathSegment ?: "subtitle.srt"
-                val entries = SubtitleHelper.parseSubtitle(content, fileName)
+    /** 丢弃已预取（或正在预取）的下一章节，下次到达预取位置时重新读取 */
+    private fun invalidateLookahead() {
+        lookahead = null
+        lookaheadFor = 0L
+        lookaheadGeneration++
+    }
 
-                withContext(Dispatchers.Main) {
-                    _subtitles.value = entries
+    private suspend fun loadSubtitles(chapter: Chapter) {
+        // 已缓存（预取过）的字幕直接在主线程组装
+        val entries = composeSubtitles(chapter) { SubtitleLoader.peek(it) }
+            ?: withContext(Dispatchers.IO) {
+                try {
+                    composeSubtitles(chapter) { readTrack(it, chapter) }.orEmpty()
+                } catch (e: Exception) {
+                    e.printStackTrace()
+                    emptyList()
                 }
-            } catch (e: Exception) {
-                e.printStackTrace()
             }
+        if (_chapter.value?.id != chapter.id) return
+        _subtitles.value = entries
+        _timeline.value = buildTimeline(entries, _chapter.value ?: chapter)
+    }
+
+    /**
+     * 组装主字幕（及双语的第二字幕）
+     * @param read 读取一条轨道；返回 null 表示该轨道暂不可用，此时整体返回 null
+     */
+    private inline fun composeSubtitles(
+        chapter: Chapter,
+        read: (String) -> List<SubtitleEntry>?
+    ): List<SubtitleEntry>? {
+        val primary = chapter.subtitleUri?.let { read(it) ?: return null }.orEmpty()
+        val secondary = chapter.secondarySubtitleUri
+            ?.takeIf { it != chapter.subtitleUri }
+            ?.let { read(it) ?: return null }
+        if (primary.isEmpty() || secondary.isNullOrEmpty()) return primary
+        // 双语：两条时间轴合并为一份，以主字幕的时间为准
+        return BilingualMerger.merge(buildTimeline(primary, chapter), buildTimeline(secondary, chapter))
+    }
+
+    private fun readTrack(subtitleUri: String, chapter: Chapter): List<SubtitleEntry> =
+        SubtitleLoader.load(getApplication(), subtitleUri, chapter.fileUri)
+
+    /**
+     * 切换字幕轨道
+     * @param subtitleUri 主字幕，null 表示关闭字幕
+     * @param secondarySubtitleUri 双语显示的第二字幕，null 表示不显示
+     */
+    fun selectSubtitleTracks(subtitleUri: String?, secondarySubtitleUri: String?) {
+        val current = _chapter.value ?: return
+        val secondary = secondarySubtitleUri?.takeIf { subtitleUri != null && it != subtitleUri }
+        if (current.subtitleUri == subtitleUri && current.secondarySubtitleUri == secondary) return
+        val chapter = current.copy(subtitleUri = subtitleUri, secondarySubtitleUri = secondary)
+        _chapter.value = chapter
+        // 字幕选择按音频文件保存，同一文件的下一章节（虚拟章节）预取到的是旧选择
+        invalidateLookahead()
+        viewModelScope.launch {
+            repository.selectSubtitleTracks(chapter, subtitleUri, secondary)
+            // 写入期间发起的预取可能读到旧选择，写入完成后再作废一次并按新选择重新预取
+            invalidateLookahead()
+            checkLookahead(_currentPosition.value ?: 0L)
+            loadSubtitles(chapter)
         }
     }
 
     fun updatePosition(positionMs: Long) {
         _currentPosition.value = positionMs
+        checkLookahead(positionMs)
     }
 
     fun updateDuration(durationMs: Long) {
-        _duration.value = durationMs
+        if (_duration.value != durationMs) _duration.value = durationMs
     }
 
     fun updatePlayingState(playing: Boolean) {
@@ -117,4 +277,78 @@ class PlayerViewModel(application: Application) : AndroidViewModel(application)
     fun clearLastProgress() {
         _lastProgress.value = null
     }
+
+    // ========== 字幕同步 ==========
+
+    /**
+     * 自动估计字幕偏移（分析音频语音活动与字幕出现时间的相关性）
+     */
+    fun autoSyncSubtitles() {
+        val chapter = _chapter.value ?: return
+        val audioUri = getAudioUri() ?: return
+        val entries = _subtitles.value.orEmpty()
+        if (entries.isEmpty() || _isSyncing.value == true) return
+
+        val app = getApplication<Application>()
+        viewModelScope.launch {
+            _isSyncing.value = true
+            try {
+                // 虚拟章节的字幕时间相对整个文件，按整个文件分析
+                val durationMs = if (chapter.isVirtual) 0L else _duration.value?.takeIf { it > 0 } ?: chapter.durationMs
+                val result = withContext(Dispatchers.Default) {
+                    SubtitleSyncAnalyzer(app).analyze(audioUri, entries, durationMs)
+                }
+                if (result == null) {
+                    _syncMessage.value = app.getString(R.string.subtitle_sync_failed)
+                } else {
+                    applySubtitleSync(result.offsetMs, result.driftPpm)
+                    _syncMessage.value = app.getString(
+                        R.string.subtitle_sync_done, formatOffset(result.offsetMs)
+                    )
+                }
+            } catch (e: Exception) {
+                e.printStackTrace()
+                _syncMessage.value = app.getString(R.string.subtitle_sync_failed)
+            } finally {
+                _isSyncing.value = false
+            }
+        }
+    }
+
+    /**
+     * 手动微调字幕偏移
+     * @param deltaMs 正数表示字幕延后
+     */
+    fun adjustSubtitleOffset(deltaMs: Long) {
+        val chapter = _chapter.value ?: return
+        applySubtitleSync(chapter.subtitleOffsetMs + deltaMs, chapter.subtitleDriftPpm)
+    }
+
+    fun resetSubtitleSync() {
+        applySubtitleSync(0L, 0f)
+    }
+
+    fun clearSyncMessage() {
+        _syncMessage.value = null
+    }
+
+    private fun applySubtitleSync(offsetMs: Long, driftPpm: Float) {
+        val chapter = _chapter.value?.copy(subtitleOffsetMs = offsetMs, subtitleDriftPpm = driftPpm) ?: return
+        _chapter.value = chapter
+        _timeline.value = buildTimeline(_subtitles.value.orEmpty(), chapter)
+        viewModelScope.launch {
+            repository.updateSubtitleSync(chapter.id, offsetMs, driftPpm)
+        }
+    }
+
+    /**
+     * 字幕时间相对整个音频文件；虚拟章节的播放位置从章节起点算起，需要额外减去起点
+     */
+    private fun buildTimeline(entries: List<SubtitleEntry>, chapter: Chapter) =
+        SubtitleTimeline.forChapter(entries, chapter)
+
+    companion object {
+        /** 偏移显示为带符号的秒数，例如 +1.25 */
+        fun formatOffset(offsetMs: Long): String = "%+.2f".format(offsetMs / 1000f)
+    }
 }
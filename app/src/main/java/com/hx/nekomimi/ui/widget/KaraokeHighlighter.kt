@@ -0,0 +1,131 @@
+package com.hx.nekomimi.ui.widget
+
+import android.text.Spannable
+import android.text.TextPaint
+import android.text.style.CharacterStyle
+import android.text.style.UpdateAppearance
+import android.widget.TextView
+import androidx.annotation.ColorInt
+import androidx.core.graphics.ColorUtils
+import com.hx.nekomimi.subtitle.KaraokeSyllable
+
+/**
+ * 当前字幕行的卡拉 OK 逐字填充
+ *
+ * [attach] 时给行内每个属于音节的字挂一个颜色可变的 span（只做一次），之后每帧调用 [update]：
+ * 只修改填充进度变化的那几个字的 span 并重绘这一个 TextView。不重新设置文本、不调用 setSpan，
+ * 所以不会触发重新布局，也不会重新绑定列表项，每帧开销与字幕总条数无关。
+ * 正在填充的字按音节内进度从原文字颜色渐变到 [sungColor]。
+ *
+ * TextView 的文本被替换后（例如列表项被回收绑定到其他字幕）自动失效，[update] 不再有任何操作。
+ */
+class KaraokeHighlighter(@ColorInt private val sungColor: Int) {
+
+    /** 单个字的填充程度：0 = 原颜色，1 = 已唱颜色 */
+    private inner class FillSpan : CharacterStyle(), UpdateAppearance {
+        var fraction = 0f
+
+        override fun updateDrawState(tp: TextPaint) {
+            if (fraction > 0f) tp.color = ColorUtils.blendARGB(tp.color, sungColor, fraction)
+        }
+    }
+
+    private var view: TextView? = null
+    private var text: Spannable? = null
+    private var syllables: List<KaraokeSyllable> = emptyList()
+
+    /** 显示文本在 SubtitleEntry.text 中的起始位置（对话模式去掉说话人前缀后不为 0） */
+    private var offset = 0
+
+    /** 按显示文本位置索引的 span，不属于任何音节的字（和代理对的后半）为 null */
+    private var spans: Array<FillSpan?> = emptyArray()
+
+    /** 已完全填充的字数（显示文本位置）和正在填充的字的进度 */
+    private var filled = 0
+    private var partial = 0f
+
+    /** 上次所在的音节：播放时间单调递增，从这里往后找 */
+    private var cursor = 0
+
+    /** 是否仍绑定在一个显示着本行文本的 TextView 上 */
+    val isAttached: Boolean
+        get() = text != null && view?.text === text
+
+    /**
+     * 在 [view] 上显示 [shown] 并准备逐字填充
+     * @param offset [shown] 在字幕条目文本中的起始位置
+     */
+    fun attach(view: TextView, shown: String, syllables: List<KaraokeSyllable>, offset: Int = 0) {
+        view.setText(shown, TextView.BufferType.SPANNABLE)
+        val text = view.text as Spannable
+        val spans = arrayOfNulls<FillSpan>(text.length)
+        for (syllable in syllables) {
+            var i = (syllable.start - offset).coerceAtLeast(0)
+            val end = (syllable.end - offset).coerceAtMost(text.length)
+            while (i < end) {
+                val next = i + Character.charCount(Character.codePointAt(text, i))
+                val span = FillSpan()
+                text.setSpan(span, i, next.coerceAtMost(text.length), Spannable.SPAN_EXCLUSIVE_EXCLUSIVE)
+                spans[i] = span
+                i = next
+            }
+        }
+        this.view = view
+        this.text = text
+        this.syllables = syllables
+        this.offset = offset
+        this.spans = spans
+        filled = 0
+        partial = 0f
+        cursor = 0
+    }
+
+    /** [view] 上是否正在显示这组音节（同一行已绑定时不必重新设置文本） */
+    fun isShowing(view: TextView, syllables: List<KaraokeSyllable>): Boolean =
+        isAttached && this.view === view && this.syllables === syllables
+
+    fun detach() {
+        view = null
+        text = null
+        syllables = emptyList()
+        spans = emptyArray()
+    }
+
+    /**
+     * 按字幕时间更新填充进度（每帧调用）
+     */
+    fun update(subtitleMs: Long) {
+        if (!isAttached || syllables.isEmpty()) return
+
+        var i = cursor.coerceAtMost(syllables.size - 1)
+        if (subtitleMs < syllables[i].startMs) i = 0 // 往回跳转，从头找
+        while (i + 1 < syllables.size && syllables[i + 1].startMs <= subtitleMs) i++
+        cursor = i
+
+        val syllable = syllables[i]
+        var full: Int
+        var fraction = 0f
+        when {
+            subtitleMs < syllable.startMs -> full = 0
+            subtitleMs >= syllable.endMs || !syllable.sweep -> full = syllable.end
+            else -> {
+                val progress = (subtitleMs - syllable.startMs).toFloat() /
+                    (syllable.endMs - syllable.startMs) * (syllable.end - syllable.start)
+                full = syllable.start + progress.toInt()
+                fraction = progress - progress.toInt()
+            }
+        }
+        full = (full - offset).coerceIn(0, spans.size)
+        if (full == filled && fraction == partial) return
+
+        // 只改动进度前后之间的字
+        spans.getOrNull(filled)?.fraction = 0f
+        for (k in minOf(filled, full) until maxOf(filled, full)) {
+            spans[k]?.fraction = if (k < full) 1f else 0f
+        }
+        spans.getOrNull(full)?.fraction = fraction
+        filled = full
+        partial = fraction
+        view?.invalidate()
+    }
+}
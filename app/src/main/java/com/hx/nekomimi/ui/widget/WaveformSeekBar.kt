@@ -0,0 +1,168 @@
+package com.hx.nekomimi.ui.widget
+
+import android.annotation.SuppressLint
+import android.content.Context
+import android.graphics.Canvas
+import android.graphics.Paint
+import android.util.AttributeSet
+import android.view.MotionEvent
+import android.view.View
+import androidx.core.content.ContextCompat
+import com.hx.nekomimi.R
+import com.hx.nekomimi.audio.waveform.WaveformData
+import kotlin.math.max
+import kotlin.math.min
+
+/**
+ * 波形进度条
+ *
+ * 每个像素列汇总对应时间段内的桶：外层为峰值包络，内层为 RMS（响度），
+ * 已播放部分高亮。支持点击 / 拖动跳转。
+ */
+class WaveformSeekBar @JvmOverloads constructor(
+    context: Context,
+    attrs: AttributeSet? = null,
+    defStyleAttr: Int = 0
+) : View(context, attrs, defStyleAttr) {
+
+    interface OnSeekListener {
+        fun onSeekStart() {}
+        fun onSeekPreview(positionMs: Long) {}
+        fun onSeek(positionMs: Long)
+        fun onSeekCancel() {}
+    }
+
+    var onSeekListener: OnSeekListener? = null
+
+    private var waveform: WaveformData? = null
+    private var durationMs = 0L
+    private var positionMs = 0L
+    private var isDragging = false
+
+    /** 每个像素列的 [峰值下沿, 峰值上沿, RMS]，尺寸或数据变化时重新计算 */
+    private var columns = FloatArray(0)
+
+    private val playedPeakPaint = paint(R.color.primary_light, 0x99)
+    private val playedRmsPaint = paint(R.color.primary, 0xFF)
+    private val pendingPeakPaint = paint(R.color.player_text_secondary, 0x40)
+    private val pendingRmsPaint = paint(R.color.player_text_secondary, 0x80)
+
+    private fun paint(colorRes: Int, alpha: Int) = Paint(Paint.ANTI_ALIAS_FLAG).apply {
+        color = ContextCompat.getColor(context, colorRes)
+        this.alpha = alpha
+        style = Paint.Style.FILL
+    }
+
+    fun setWaveform(data: WaveformData?) {
+        waveform = data
+        rebuildColumns()
+        invalidate()
+    }
+
+    fun setDuration(durationMs: Long) {
+        if (this.durationMs == durationMs) return
+        this.durationMs = durationMs
+        rebuildColumns()
+        invalidate()
+    }
+
+    fun setPosition(positionMs: Long) {
+        if (isDragging || this.positionMs == positionMs) return
+        this.positionMs = positionMs
+        invalidate()
+    }
+
+    override fun onSizeChanged(w: Int, h: Int, oldw: Int, oldh: Int) {
+        super.onSizeChanged(w, h, oldw, oldh)
+        rebuildColumns()
+    }
+
+    private fun totalMs(): Long {
+        if (durationMs > 0) return durationMs
+        return waveform?.durationMs ?: 0L
+    }
+
+    private fun rebuildColumns() {
+        val data = waveform
+        val width = width
+        val total = totalMs()
+        if (data == null || data.size == 0 || width <= 0 || total <= 0) {
+            columns = FloatArray(0)
+            return
+        }
+
+        val gain = 1f / max(data.peak, 0.05f)
+        columns = FloatArray(width * 3)
+        for (x in 0 until width) {
+            val from = data.indexAt(total * x / width)
+            val to = max(from, data.indexAt(total * (x + 1) / width - 1))
+            var lo = 0f
+            var hi = 0f
+            var rms = 0f
+            for (i in from..to) {
+                lo = min(lo, data.minAt(i))
+                hi = max(hi, data.maxAt(i))
+                rms = max(rms, data.rmsAt(i))
+            }
+            columns[x * 3] = (lo * gain).coerceAtLeast(-1f)
+            columns[x * 3 + 1] = (hi * gain).coerceAtMost(1f)
+            columns[x * 3 + 2] = (rms * gain).coerceAtMost(1f)
+        }
+    }
+
+    override fun onDraw(canvas: Canvas) {
+        super.onDraw(canvas)
+        val width = width
+        if (columns.size != width * 3) return
+
+        val center = height / 2f
+        val half = height / 2f
+        val total = totalMs()
+        val playedX = if (total > 0) (positionMs.toFloat() / total * width) else 0f
+
+        for (x in 0 until width) {
+            val played = x < playedX
+            val lo = columns[x * 3]
+            val hi = columns[x * 3 + 1]
+            val rms = columns[x * 3 + 2]
+            val left = x.toFloat()
+            val right = left + 1f
+            canvas.drawRect(left, center - hi * half, right, center - lo * half + 1f,
+                if (played) playedPeakPaint else pendingPeakPaint)
+            canvas.drawRect(left, center - rms * half, right, center + rms * half + 1f,
+                if (played) playedRmsPaint else pendingRmsPaint)
+        }
+    }
+
+    @SuppressLint("ClickableViewAccessibility")
+    override fun onTouchEvent(event: MotionEvent): Boolean {
+        val total = totalMs()
+        if (total <= 0 || width <= 0) return false
+        val target = (event.x / width).coerceIn(0f, 1f).let { (it * total).toLong() }
+
+        when (event.actionMasked) {
+            MotionEvent.ACTION_DOWN -> {
+                parent?.requestDisallowInterceptTouchEvent(true)
+                isDragging = true
+                onSeekListener?.onSeekStart()
+                positionMs = target
+                onSeekListener?.onSeekPreview(target)
+            }
+            MotionEvent.ACTION_MOVE -> {
+                positionMs = target
+                onSeekListener?.onSeekPreview(target)
+            }
+            MotionEvent.ACTION_UP -> {
+                isDragging = false
+                positionMs = target
+                onSeekListener?.onSeek(target)
+            }
+            MotionEvent.ACTION_CANCEL -> {
+                isDragging = false
+                onSeekListener?.onSeekCancel()
+            }
+        }
+        invalidate()
+        return true
+    }
+}
@@ -0,0 +1,106 @@
+package com.hx.nekomimi.util
+
+import android.content.Context
+import android.net.Uri
+import android.os.Process
+import android.util.Log
+import java.io.FileInputStream
+import java.io.IOException
+import java.nio.ByteBuffer
+import java.nio.channels.FileChannel
+import java.security.MessageDigest
+import java.util.concurrent.Callable
+import java.util.concurrent.Executors
+
+/**
+ * 音频文件的内容指纹（用于识别移动 / 重新导入的同一文件，以及不同书籍间的重复文件）
+ *
+ * 不读取整个文件：文件大小 + 均匀分布的 [SAMPLE_BLOCKS] 个 [BLOCK_SIZE] 字节采样块做 SHA-1，
+ * 采样块用定位读取（FileChannel.read(buffer, position)），每个文件只需几次小读取。
+ * 小于全部采样块之和的文件直接整体计算。
+ */
+object ContentFingerprint {
+
+    private const val TAG = "ContentFingerprint"
+
+    private const val SAMPLE_BLOCKS = 5
+    private const val BLOCK_SIZE = 16 shl 10
+
+    /** 并行计算的线程数（SAF 读取主要在等待 I/O） */
+    private const val PARALLELISM = 4
+
+    private val executor = Executors.newFixedThreadPool(PARALLELISM) { runnable ->
+        Thread({
+            Process.setThreadPriority(Process.THREAD_PRIORITY_BACKGROUND)
+            runnable.run()
+        }, "content-fingerprint").apply { isDaemon = true }
+    }
+
+    /**
+     * 计算单个文件的指纹（本地 / SAF 文件）
+     * @return "大小:SHA-1"；无法读取时返回 null
+     */
+    fun compute(context: Context, uri: Uri): String? {
+        return try {
+            context.contentResolver.openFileDescriptor(uri, "r")?.use { pfd ->
+                FileInputStream(pfd.fileDescriptor).channel.use { channel -> compute(channel) }
+            }
+        } catch (e: Exception) {
+            Log.w(TAG, "计算指纹失败: $uri", e)
+            null
+        }
+    }
+
+    /**
+     * 并行计算多个文件的指纹（阻塞直到全部完成，不要在主线程调用）
+     * @return URI 到指纹的映射，读取失败的文件不在其中
+     */
+    fun computeAll(context: Context, uris: Collection<String>): Map<String, String> {
+        if (uris.isEmpty()) return emptyMap()
+        val tasks = uris.distinct().map { uri ->
+            Callable { uri to compute(context, Uri.parse(uri)) }
+        }
+        return executor.invokeAll(tasks)
+            .mapNotNull { future -> future.get().let { (uri, hash) -> hash?.let { uri to it } } }
+            .toMap()
+    }
+
+    private fun compute(channel: FileChannel): String {
+        val size = channel.size()
+        val digest = MessageDigest.getInstance("SHA-1")
+        digest.update(ByteBuffer.allocate(8).putLong(size).array())
+
+        val buffer = ByteBuffer.allocate(BLOCK_SIZE)
+        if (size <= SAMPLE_BLOCKS.toLong() * BLOCK_SIZE) {
+            var position = 0L
+            while (position < size) {
+                position += readBlock(channel, buffer, position)
+                digest.update(buffer)
+            }
+        } else {
+            val lastOffset = size - BLOCK_SIZE
+            for (i in 0 until SAMPLE_BLOCKS) {
+                readBlock(channel, buffer, lastOffset * i / (SAMPLE_BLOCKS - 1))
+                digest.update(buffer)
+            }
+        }
+        return "$size:" + digest.digest().joinToString("") { "%02x".format(it) }
+    }
+
+    /**
+     * 从 [position] 读满 [buffer]（文件末尾不足时读到结尾），读取后 buffer 处于可读状态
+     * @return 读取的字节数
+     */
+    private fun readBlock(channel: FileChannel, buffer: ByteBuffer, position: Long): Int {
+        buffer.clear()
+        var offset = position
+        while (buffer.hasRemaining()) {
+            val n = channel.read(buffer, offset)
+            if (n < 0) break
+            offset += n
+        }
+        buffer.flip()
+        if (!buffer.hasRemaining()) throw IOException("意外的文件结尾")
+        return buffer.remaining()
+    }
+}
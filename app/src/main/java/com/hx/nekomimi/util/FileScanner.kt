@@ -2,60 +2,238 @@ package com.hx.nekomimi.util
 
 import android.content.Context
 import android.net.Uri
+import android.util.Log
 import androidx.documentfile.provider.DocumentFile
+import com.hx.nekomimi.chapter.ChapterMarkers
+import com.hx.nekomimi.chapter.CueSheetParser
+import com.hx.nekomimi.chapter.Mp4ChapterReader
+import com.hx.nekomimi.data.entity.Book
 import com.hx.nekomimi.data.entity.Chapter
+import com.hx.nekomimi.data.entity.SubtitleTrack
+import com.hx.nekomimi.remote.RemoteFileCache
+import com.hx.nekomimi.remote.RemoteHttp
+import com.hx.nekomimi.remote.WebDavClient
+import com.hx.nekomimi.subtitle.Id3LyricsReader
+import com.hx.nekomimi.subtitle.SubtitleLanguage
+import com.hx.nekomimi.transcribe.GeneratedSubtitles
 
 /**
  * 文件扫描工具
- * 递归扫描目录下的 mp3 文件，并自动匹配同名字幕文件（SRT/ASS）
+ * 递归扫描目录（SAF 或 WebDAV）下的音频文件，并自动匹配同名字幕文件（SRT/ASS/LRC，可带语言标记，一个音频可有多个字幕轨道）
+ * 以及 MP3 内嵌的 ID3 歌词
+ * 单文件有声书（带章节的 M4B、或配有 CUE 的大文件）按章节拆分为虚拟章节
+ * 本地音频同时计算内容指纹（见 ContentFingerprint），用于文件移动 / 重新导入后找回进度
  */
 object FileScanner {
 
-private val AUDIO_EXTENSIONS = setOf("mp3", "m4a", "m4s", "flac", "wav", "ogg", "aac", "wma")
-    private val SUBTITLE_EXTENSIONS = setOf("srt", "ass", "ssa")
+    private const val TAG = "FileScanner"
+
+private val AUDIO_EXTENSIONS = setOf("mp3", "m4a", "m4b", "m4s", "flac", "wav", "ogg", "opus", "mka", "aac", "wma")
+    private val SUBTITLE_EXTENSIONS = setOf("srt", "ass", "ssa", "lrc")
+    private const val CUE_EXTENSION = "cue"
+
+    /** 可能在 ID3v2 标签中内嵌歌词（SYLT / USLT）的格式 */
+    private val ID3_LYRICS_EXTENSIONS = setOf("mp3")
+
+    /** 可能带有内嵌章节（chpl / QuickTime 章节轨道）的 MP4 容器 */
+    private val MP4_CHAPTER_EXTENSIONS = setOf("m4b", "m4a", "mp4")
+
+    /**
+     * 按书籍根目录类型扫描：http(s) 地址走 WebDAV，其余按 SAF 目录树
+     */
+    fun scanBook(context: Context, book: Book): ScanResult {
+        val root = book.rootUri ?: return ScanResult(emptyList(), emptyList())
+        return if (RemoteHttp.isRemote(root)) {
+            scanFromWebDav(context, root, book.id)
+        } else {
+            scanFromUri(context, Uri.parse(root), book.id)
+        }
+    }
 
     /**
      * 通过 SAF Uri 扫描书籍目录
      * @param context 上下文
      * @param treeUri 目录树 URI
      * @param bookId 书籍 ID
-     * @return 扫描到的章节列表
+     * @return 扫描到的章节列表和字幕轨道
      */
-    fun scanFromUri(context: Context, treeUri: Uri, bookId: Long): List<Chapter> {
-        val rootDoc = DocumentFile.fromTreeUri(context, treeUri) ?: return emptyList()
-        val chapters = mutableListOf<ChapterScanResult>()
-        val subtitleMap = mutableMapOf<String, SubtitleInfo>()
-
-        // 第一遍：收集所有音频和字幕文件
-        scanDirectory(context, rootDoc, "", chapters, subtitleMap)
-
-        // 第二遍：匹配字幕文件到章节
-        return chapters.sortedWith(compareBy({ it.parentFolder }, { it.sortOrder }, { it.title }))
-            .mapIndexed { index, result ->
-                // 尝试匹配同名字幕文件
-                val baseName = result.title.substringBeforeLast(".")
-                val subtitleKey = "${result.parentFolder}/$baseName"
-                val subtitle = subtitleMap[subtitleKey]
-
-                Chapter(
-                    bookId = bookId,
-                    title = result.title.substringBeforeLast("."), // 去掉扩展名作为标题
-                    fileUri = result.fileUri,
-                    subtitleUri = subtitle?.uri,
-                    parentFolder = result.parentFolder,
-                    sortOrder = index
-                )
+    fun scanFromUri(context: Context, treeUri: Uri, bookId: Long): ScanResult = Tracing.section("scan.saf") {
+        val rootDoc = DocumentFile.fromTreeUri(context, treeUri) ?: return@section ScanResult(emptyList(), emptyList())
+        scan(context, documentEntry(rootDoc), bookId)
+    }
+
+    /**
+     * 通过 WebDAV 扫描远程书籍目录（逐级 PROPFIND，不要在主线程调用）
+     * @param rootUrl 目录地址
+     * @throws java.io.IOException 网络错误或认证失败
+     */
+    fun scanFromWebDav(context: Context, rootUrl: String, bookId: Long): ScanResult = Tracing.section("scan.webdav") {
+        val client = WebDavClient(context)
+        val url = if (rootUrl.endsWith("/")) rootUrl else "$rootUrl/"
+        scan(context, webDavEntry(context, client, WebDavClient.Entry("", url, true, 0L, 0L)), bookId)
+    }
+
+    private fun documentEntry(file: DocumentFile): ScanEntry =
+        ScanEntry(file.name, file.uri.toString(), file.isDirectory) {
+            file.listFiles().map { documentEntry(it) }
+        }
+
+    private fun webDavEntry(context: Context, client: WebDavClient, entry: WebDavClient.Entry): ScanEntry =
+        ScanEntry(entry.name, entry.url, entry.isDirectory) {
+            client.list(entry.url).map { child ->
+                // 字幕和 CUE 整份缓存在本地，服务器上更新过的需要重新下载
+                if (!child.isDirectory) RemoteFileCache.invalidateIfStale(context, child.url, child.lastModified)
+                webDavEntry(context, client, child)
             }
+        }
+
+    /**
+     * 扫描目录树并匹配字幕、展开单文件有声书（本地与远程共用）
+     */
+    private fun scan(context: Context, root: ScanEntry, bookId: Long): ScanResult {
+        val chapters = mutableListOf<ChapterScanResult>()
+        val subtitleIndex = mutableMapOf<String, MutableList<SubtitleCandidate>>()
+        val cueMap = mutableMapOf<String, MutableList<FileInfo>>()
+
+        // 第一遍：收集所有音频、字幕和 CUE 文件
+        Tracing.section("scan.collect") { scanDirectory(root, "", chapters, subtitleIndex, cueMap) }
+
+        // 内容指纹：采样读取，多个文件并行；远程文件需要多次 Range 请求，不计算
+        val fingerprints = Tracing.section("scan.fingerprint") {
+            ContentFingerprint.computeAll(context, chapters.map { it.fileUri }.filterNot { RemoteHttp.isRemote(it) })
+        }
+
+        // 第二遍：匹配字幕文件到章节，并展开单文件有声书的内部章节
+        val cueCache = mutableMapOf<String, List<CueSheetParser.CueTrack>>()
+        val tracks = mutableListOf<SubtitleTrack>()
+        val scanned = Tracing.section("scan.match") {
+            chapters.sortedWith(compareBy({ it.parentFolder }, { it.sortOrder }, { it.title }))
+                .flatMap { result ->
+                    // 同名（忽略大小写和语言标记）的字幕全部作为候选轨道，默认选择优先级最高的一个
+                    val baseName = result.title.substringBeforeLast(".")
+                    val candidates = subtitleIndex[subtitleKey(result.parentFolder, baseName)].orEmpty()
+                        .sortedWith(compareBy({ SubtitleLanguage.rank(it.language) }, { it.file.fileName }))
+                        .plus(listOfNotNull(findEmbeddedLyrics(context, result)))
+                    candidates.mapTo(tracks) { candidate ->
+                        SubtitleTrack(
+                            bookId = bookId,
+                            audioUri = result.fileUri,
+                            uri = candidate.file.uri,
+                            language = candidate.language,
+                            format = candidate.format,
+                            label = candidate.file.fileName
+                        )
+                    }
+
+                    val chapter = Chapter(
+                        bookId = bookId,
+                        title = result.title.substringBeforeLast("."), // 去掉扩展名作为标题
+                        fileUri = result.fileUri,
+                        // 没有同名字幕时，回落到之前离线转写生成的字幕
+                        subtitleUri = candidates.firstOrNull()?.file?.uri ?: GeneratedSubtitles.find(context, result.fileUri),
+                        parentFolder = result.parentFolder,
+                        contentHash = fingerprints[result.fileUri]
+                    )
+                    val markers = findChapterMarkers(context, result, cueMap[result.parentFolder].orEmpty(), cueCache)
+                    if (markers == null) listOf(chapter) else splitChapter(chapter, markers)
+                }
+                .mapIndexed { index, chapter -> chapter.copy(sortOrder = index) }
+        }
+        return ScanResult(scanned, tracks)
     }
 
-    private fun scanDirectory(
+    /**
+     * 内嵌歌词作为一个字幕轨道，URI 即音频文件本身（排在外部字幕之后）
+     * 需要读取文件开头的标签，远程文件不检查
+     */
+    private fun findEmbeddedLyrics(context: Context, result: ChapterScanResult): SubtitleCandidate? {
+        val ext = result.title.substringAfterLast(".", "").lowercase()
+        if (ext !in ID3_LYRICS_EXTENSIONS || RemoteHttp.isRemote(result.fileUri)) return null
+        val lyrics = Id3LyricsReader.read(context, Uri.parse(result.fileUri)) ?: return null
+        return SubtitleCandidate(FileInfo(result.title, result.fileUri), lyrics.language, Id3LyricsReader.FORMAT)
+    }
+
+    /**
+     * 字幕索引键：目录 + 忽略大小写的文件名
+     * 字幕文件名先去掉语言标记；`01.mp3.srt` 这类带音频扩展名的也能匹配到 `01.mp3`
+     */
+    private fun subtitleKey(folder: String, baseName: String): String =
+        "$folder/${baseName.trim().lowercase()}"
+
+    private fun subtitleBaseName(subtitleName: String): Pair<String, String> {
+        val (base, language) = SubtitleLanguage.split(subtitleName.substringBeforeLast("."))
+        val innerExt = base.substringAfterLast(".", "").lowercase()
+        return (if (innerExt in AUDIO_EXTENSIONS) base.substringBeforeLast(".") else base) to language
+    }
+
+    /**
+     * 查找音频文件的内部章节：MP4 容器读取内嵌章节，其他格式查找同目录下引用它的 CUE
+     * @return 至少两个章节时返回，否则 null（按普通单章节处理）
+     */
+    private fun findChapterMarkers(
         context: Context,
-        dir: DocumentFile,
+        result: ChapterScanResult,
+        cueFiles: List<FileInfo>,
+        cueCache: MutableMap<String, List<CueSheetParser.CueTrack>>
+    ): ChapterMarkers? {
+        val ext = result.title.substringAfterLast(".", "").lowercase()
+        // 内嵌章节需要随机访问文件，远程文件只支持 CUE
+        if (ext in MP4_CHAPTER_EXTENSIONS && !RemoteHttp.isRemote(result.fileUri)) {
+            Mp4ChapterReader.read(context, Uri.parse(result.fileUri))
+                ?.takeIf { it.markers.size >= 2 }
+                ?.let { return it }
+        }
+
+        for (cue in cueFiles) {
+            val tracks = cueCache.getOrPut(cue.uri) { readCueSheet(context, cue.uri) }
+            val markers = CueSheetParser.markersFor(tracks, result.title, cue.fileName)
+            if (markers.size >= 2) return ChapterMarkers(markers)
+        }
+        return null
+    }
+
+    private fun readCueSheet(context: Context, cueUri: String): List<CueSheetParser.CueTrack> {
+        return try {
+            RemoteFileCache.openInputStream(context, Uri.parse(cueUri))?.use { input ->
+                CueSheetParser.parse(CueSheetParser.decode(input.readBytes()))
+            }.orEmpty()
+        } catch (e: Exception) {
+            Log.w(TAG, "CUE 解析失败: $cueUri", e)
+            emptyList()
+        }
+    }
+
+    /**
+     * 把一个文件按章节标记拆分为多个虚拟章节（共享同一个音频和字幕文件）
+     */
+    private fun splitChapter(chapter: Chapter, markers: ChapterMarkers): List<Chapter> {
+        val list = markers.markers
+        return list.mapIndexed { i, marker ->
+            val endMs = if (i + 1 < list.size) list[i + 1].startMs else 0L
+            val fileEndMs = if (endMs > 0) endMs else markers.durationMs
+            Chapter(
+                bookId = chapter.bookId,
+                title = marker.title.ifBlank { "${chapter.title} - ${i + 1}" },
+                fileUri = chapter.fileUri,
+                subtitleUri = chapter.subtitleUri,
+                parentFolder = chapter.parentFolder,
+                durationMs = if (fileEndMs > marker.startMs) fileEndMs - marker.startMs else 0L,
+                startMs = marker.startMs,
+                endMs = endMs,
+                contentHash = chapter.contentHash
+            )
+        }
+    }
+
+    private fun scanDirectory(
+        dir: ScanEntry,
         currentPath: String,
         chapters: MutableList<ChapterScanResult>,
-        subtitleMap: MutableMap<String, SubtitleInfo>
+        subtitleIndex: MutableMap<String, MutableList<SubtitleCandidate>>,
+        cueMap: MutableMap<String, MutableList<FileInfo>>
     ) {
-        val files = dir.listFiles()
+        // 列目录是扫描中主要的 I/O（SAF 查询 / WebDAV PROPFIND）
+        val files = Tracing.section("scan.listDir") { dir.listFiles() }
 
         // 按名称排序
         val sorted = files.sortedBy { it.name?.lowercase() ?: "" }
@@ -66,38 +244,38 @@ private val AUDIO_EXTENSIONS = setOf("mp3", "m4a", "m4s", "flac", "wav", "ogg",
             if (file.isDirectory) {
                 // 递归扫描子目录
                 val subPath = if (currentPath.isEmpty()) name else "$currentPath/$name"
-                scanDirectory(context, file, subPath, chapters, subtitleMap)
+                scanDirectory(file, subPath, chapters, subtitleIndex, cueMap)
             } else {
                 val ext = name.substringAfterLast(".", "").lowercase()
-                val baseName = name.substringBeforeLast(".")
-                val key = if (currentPath.isEmpty()) "/$baseName" else "$currentPath/$baseName"
 
                 if (ext in AUDIO_EXTENSIONS) {
                     chapters.add(
                         ChapterScanResult(
                             title = name,
-                            fileUri = file.uri.toString(),
+                            fileUri = file.uri,
                             parentFolder = currentPath,
                             sortOrder = chapters.size
                         )
                     )
                 } else if (ext in SUBTITLE_EXTENSIONS) {
-                    subtitleMap[key] = SubtitleInfo(
-                        fileName = name,
-                        uri = file.uri.toString()
-                    )
+                    val (baseName, language) = subtitleBaseName(name)
+                    subtitleIndex.getOrPut(subtitleKey(currentPath, baseName)) { mutableListOf() }
+                        .add(SubtitleCandidate(FileInfo(fileName = name, uri = file.uri), language, ext))
+                } else if (ext == CUE_EXTENSION) {
+                    cueMap.getOrPut(currentPath) { mutableListOf() }
+                        .add(FileInfo(fileName = name, uri = file.uri))
                 }
             }
         }
     }
 
     /**
-     * 根据音频文件 URI 读取对应字幕文件内容
+     * 根据音频文件 URI 读取对应字幕文件内容（远程字幕经过本地缓存）
      */
     fun readSubtitleContent(context: Context, subtitleUri: String): String? {
         return try {
             val uri = Uri.parse(subtitleUri)
-            context.contentResolver.openInputStream(uri)?.bufferedReader()?.use { it.readText() }
+            RemoteFileCache.openInputStream(context, uri)?.bufferedReader()?.use { it.readText() }
         } catch (e: Exception) {
             e.printStackTrace()
             null
@@ -111,6 +289,28 @@ private val AUDIO_EXTENSIONS = setOf("mp3", "m4a", "m4s", "flac", "wav", "ogg",
         return chapter.fileUri?.let { Uri.parse(it) }
     }
 
+    /**
+     * 扫描结果
+     * @param subtitleTracks 每个音频文件的全部候选字幕轨道（按默认优先级排序）
+     */
+    data class ScanResult(
+        val chapters: List<Chapter>,
+        val subtitleTracks: List<SubtitleTrack>
+    )
+
+    /**
+     * 目录树节点（SAF DocumentFile 或 WebDAV 目录项）
+     * @param uri 文件 URI 或 URL 字符串
+     */
+    private class ScanEntry(
+        val name: String?,
+        val uri: String,
+        val isDirectory: Boolean,
+        private val children: () -> List<ScanEntry>
+    ) {
+        fun listFiles(): List<ScanEntry> = if (isDirectory) children() else emptyList()
+    }
+
     private data class ChapterScanResult(
         val title: String,
         val fileUri: String,
@@ -118,8 +318,18 @@ private val AUDIO_EXTENSIONS = setOf("mp3", "m4a", "m4s", "flac", "wav", "ogg",
         val sortOrder: Int
     )
 
-    private data class SubtitleInfo(
+    private data class FileInfo(
         val fileName: String,
         val uri: String
     )
+
+    /**
+     * @param language 文件名中的语言标记（见 SubtitleLanguage）
+     * @param format 扩展名（srt / ass / ssa / lrc），内嵌歌词为 Id3LyricsReader.FORMAT
+     */
+    private data class SubtitleCandidate(
+        val file: FileInfo,
+        val language: String,
+        val format: String
+    )
 }
@@ -0,0 +1,17 @@
+package com.hx.nekomimi.util
+
+import java.security.MessageDigest
+
+/**
+ * 哈希工具
+ */
+object HashUtils {
+
+    /**
+     * 字符串的 SHA-1 十六进制摘要，用于把 URI 映射为稳定的缓存文件名
+     */
+    fun sha1Hex(value: String): String {
+        val digest = MessageDigest.getInstance("SHA-1").digest(value.toByteArray())
+        return digest.joinToString("") { "%02x".format(it) }
+    }
+}
@@ -0,0 +1,41 @@
+package com.hx.nekomimi.util
+
+import androidx.tracing.Trace
+import androidx.tracing.trace
+import androidx.tracing.traceAsync
+import java.util.concurrent.atomic.AtomicInteger
+
+/**
+ * Perfetto / systrace 埋点
+ *
+ * 区段名统一以 [PREFIX] 开头，抓取的 trace 用 scripts/trace-summary.sql 按名称汇总各阶段耗时。
+ * - 同步代码用 [section]（同一线程内开始和结束）
+ * - 挂起函数和跨回调的流程用异步区段（可以在其它线程结束，按 cookie 配对）
+ */
+object Tracing {
+
+    const val PREFIX = "neko:"
+
+    private val cookies = AtomicInteger()
+
+    inline fun <T> section(name: String, crossinline block: () -> T): T = trace(PREFIX + name) { block() }
+
+    suspend inline fun <T> async(name: String, crossinline block: suspend () -> T): T =
+        traceAsync(PREFIX + name, nextCookie()) { block() }
+
+    /**
+     * 开始一个手动结束的异步区段（如连接回调、播放器准备完成）
+     * @return 传给 [endAsync] 的 cookie
+     */
+    fun beginAsync(name: String): Int {
+        val cookie = nextCookie()
+        Trace.beginAsyncSection(PREFIX + name, cookie)
+        return cookie
+    }
+
+    fun endAsync(name: String, cookie: Int) {
+        Trace.endAsyncSection(PREFIX + name, cookie)
+    }
+
+    fun nextCookie(): Int = cookies.incrementAndGet()
+}
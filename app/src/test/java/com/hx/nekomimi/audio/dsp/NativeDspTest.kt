@@ -0,0 +1,122 @@
+package com.hx.nekomimi.audio.dsp
+
+import org.junit.Assert.assertArrayEquals
+import org.junit.Assert.assertEquals
+import org.junit.Assert.assertTrue
+import org.junit.BeforeClass
+import org.junit.Test
+import java.nio.ByteBuffer
+import java.nio.ByteOrder
+import kotlin.math.PI
+import kotlin.math.abs
+import kotlin.math.sin
+
+/**
+ * 通过 JNI 调用主机端编译的 libnekodsp（见 app/build.gradle.kts 的 buildHostDsp），
+ * 确认 Kotlin 声明与 neko_dsp_jni.cpp 的符号一一对应；任何一个对不上都会抛 UnsatisfiedLinkError。
+ */
+class NativeDspTest {
+
+    companion object {
+        @BeforeClass
+        @JvmStatic
+        fun loadLibrary() {
+            assertTrue("libnekodsp 未加载（java.library.path 中没有主机端构建）", NativeDsp.isAvailable)
+        }
+
+        private fun floats(vararg values: Float): ByteBuffer =
+            ByteBuffer.allocateDirect(values.size * 4).order(ByteOrder.nativeOrder()).apply {
+                asFloatBuffer().put(values)
+            }
+
+        private fun ByteBuffer.toFloats(count: Int): FloatArray =
+            FloatArray(count).also { duplicate().order(ByteOrder.nativeOrder()).asFloatBuffer().get(it) }
+    }
+
+    @Test
+    fun kernelNameIsKnown() {
+        assertTrue(NativeDsp.kernelName() in setOf("neon", "avx2", "sse2", "scalar"))
+    }
+
+    @Test
+    fun pcmConversionRoundTrips() {
+        val pcm = shortArrayOf(0, 1, -1, 16384, -16384, 32767, -32768, 1234, -4321)
+        val src = ByteBuffer.allocateDirect(pcm.size * 2).order(ByteOrder.nativeOrder())
+        src.asShortBuffer().put(pcm)
+        val floatBuf = ByteBuffer.allocateDirect(pcm.size * 4).order(ByteOrder.nativeOrder())
+        val back = ByteBuffer.allocateDirect(pcm.size * 2).order(ByteOrder.nativeOrder())
+
+        NativeDsp.pcm16ToFloat(src, 0, floatBuf, 0, pcm.size)
+        assertEquals(0.5f, floatBuf.toFloats(pcm.size)[3], 0f)
+        NativeDsp.floatToPcm16(floatBuf, 0, back, 0, pcm.size)
+
+        val result = ShortArray(pcm.size).also { back.asShortBuffer().get(it) }
+        assertArrayEquals(pcm, result)
+    }
+
+    @Test
+    fun gainRampAndEnvelope() {
+        val buf = floats(1f, 1f, 1f, 1f)
+        NativeDsp.gainRamp(buf, 0, 4, 1, 0f, 1f)
+        assertArrayEquals(floatArrayOf(0f, 0.25f, 0.5f, 0.75f), buf.toFloats(4), 1e-6f)
+
+        val rms = FloatArray(2)
+        val peak = FloatArray(2)
+        assertEquals(2, NativeDsp.envelope(buf, 0, 4, 1, 2, rms, peak))
+        assertEquals(0.25f, peak[0], 1e-6f)
+        assertEquals(0.75f, peak[1], 1e-6f)
+    }
+
+    @Test
+    fun biquadFiltersThroughJni() {
+        val sampleRate = 16000
+        val frames = 2048
+        Biquad().use { lowPass ->
+            lowPass.setLowPass(sampleRate, 500f)
+            // 8 kHz 附近的高频正弦应被大幅衰减
+            val values = FloatArray(frames) { sin(2 * PI * 7000 * it / sampleRate).toFloat() }
+            val buf = floats(*values)
+            lowPass.process(buf, 0, frames, 1)
+            val out = buf.toFloats(frames)
+            val tailPeak = out.drop(frames / 2).maxOf { abs(it) }
+            assertTrue("低通后高频残留 $tailPeak", tailPeak < 0.05f)
+        }
+    }
+
+    @Test
+    fun biquadPassesChannelsBeyondEightUntouched() {
+        val channels = 10
+        val frames = 64
+        val values = FloatArray(frames * channels) { if (it % channels >= 8) 0.5f else 1f }
+        val buf = floats(*values)
+        Biquad().use {
+            it.setLowPass(44100, 1000f)
+            it.process(buf, 0, frames, channels)
+        }
+        val out = buf.toFloats(values.size)
+        for (i in 0 until frames) {
+            assertEquals(0.5f, out[i * channels + 8], 0f)
+            assertEquals(0.5f, out[i * channels + 9], 0f)
+        }
+    }
+
+    @Test
+    fun compressorDelaysAndReducesLoudInput() {
+        val sampleRate = 16000
+        val frames = 4000
+        Compressor().use { compressor ->
+            compressor.configure(sampleRate, 2, 5f)
+            compressor.setParams(Compressor.SPEECH_NIGHT)
+            val values = FloatArray(frames * 2) { 0.9f * sin(2 * PI * 220 * (it / 2) / sampleRate).toFloat() }
+            val buf = floats(*values)
+            compressor.process(buf, 0, frames)
+            val out = buf.toFloats(values.size)
+
+            // 前瞻延迟线开头输出静音
+            assertEquals(0f, out[0], 0f)
+            assertTrue(compressor.gainReductionDb() < -3f)
+            // 限幅：输出不超过 -1 dBFS
+            assertTrue(out.maxOf { abs(it) } <= 0.9f)
+        }
+    }
+}
@@ -0,0 +1,58 @@
+package com.hx.nekomimi.audio.processor
+
+import androidx.annotation.OptIn
+import androidx.media3.common.util.UnstableApi
+import com.hx.nekomimi.audio.dsp.NativeDsp
+import org.junit.Assert.assertTrue
+import org.junit.BeforeClass
+import org.junit.Test
+import java.util.Random
+
+/**
+ * 夜间模式压缩器的 JVM 端基准：按播放格式（44.1 kHz 立体声、1024 帧一块）处理 60 秒音频，
+ * 包含 JNI 调用、PCM16 <-> float 转换和压缩本身，输出每秒音频的处理耗时。
+ *
+ * 只对明显退化（例如退回逐采样 JNI 调用）设一个宽松上限；具体数值看测试输出。
+ */
+@OptIn(UnstableApi::class)
+class CompressorAudioProcessorBenchmark {
+
+    companion object {
+        private const val SAMPLE_RATE = 44100
+        private const val CHANNELS = 2
+        private const val SECONDS = 60
+
+        /** 每秒音频允许的最长处理时间（毫秒），即 1% CPU */
+        private const val MAX_MS_PER_AUDIO_SECOND = 10f
+
+        @BeforeClass
+        @JvmStatic
+        fun loadLibrary() {
+            assertTrue("libnekodsp 未加载（java.library.path 中没有主机端构建）", NativeDsp.isAvailable)
+        }
+    }
+
+    @Test
+    fun compressorCostPerAudioSecond() {
+        val random = Random(1)
+        val input = ShortArray(SAMPLE_RATE * SECONDS * CHANNELS) { (random.nextGaussian() * 6000).toInt().toShort() }
+
+        for (enabled in listOf(false, true)) {
+            val processor = CompressorAudioProcessor().apply { setEnabled(enabled) }
+            processor.processAll(input, SAMPLE_RATE, CHANNELS) // 预热 JIT
+            processor.takeCpuCost()
+
+            val start = System.nanoTime()
+            processor.processAll(input, SAMPLE_RATE, CHANNELS)
+            val wallMs = (System.nanoTime() - start) / 1_000_000f / SECONDS
+            val dspMs = processor.takeCpuCost()
+            processor.reset()
+
+            println(
+                "compressor enabled=$enabled kernel=${NativeDsp.kernelName()} " +
+                    "dsp=${"%.3f".format(dspMs)}ms 含转换=${"%.3f".format(wallMs)}ms /每秒音频"
+            )
+            assertTrue("压缩耗时 ${dspMs}ms/每秒音频", dspMs < MAX_MS_PER_AUDIO_SECOND)
+        }
+    }
+}
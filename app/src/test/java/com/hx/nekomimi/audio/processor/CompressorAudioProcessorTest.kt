@@ -0,0 +1,75 @@
+package com.hx.nekomimi.audio.processor
+
+import androidx.annotation.OptIn
+import androidx.media3.common.util.UnstableApi
+import com.hx.nekomimi.audio.dsp.NativeDsp
+import org.junit.After
+import org.junit.Assert.assertEquals
+import org.junit.Assert.assertTrue
+import org.junit.BeforeClass
+import org.junit.Test
+import kotlin.math.PI
+import kotlin.math.sin
+
+@OptIn(UnstableApi::class)
+class CompressorAudioProcessorTest {
+
+    companion object {
+        private const val SAMPLE_RATE = 16000
+        private const val CHANNELS = 2
+
+        @BeforeClass
+        @JvmStatic
+        fun loadLibrary() {
+            assertTrue("libnekodsp 未加载（java.library.path 中没有主机端构建）", NativeDsp.isAvailable)
+        }
+
+        /** 恒为正的立体声信号：输出中出现 0 即说明插入了静音 */
+        private fun positiveTone(frames: Int): ShortArray = ShortArray(frames * CHANNELS) {
+            val t = (it / CHANNELS).toDouble() / SAMPLE_RATE
+            (8000 + 6000 * sin(2 * PI * 220 * t)).toInt().toShort()
+        }
+    }
+
+    private val processor = CompressorAudioProcessor()
+
+    @After
+    fun tearDown() {
+        processor.reset()
+    }
+
+    @Test
+    fun disabledOutputIsDelayedInputIncludingTail() {
+        val input = positiveTone(SAMPLE_RATE)
+        val output = processor.processAll(input, SAMPLE_RATE, CHANNELS)
+
+        val latencySamples = output.size - input.size
+        assertTrue("延迟 $latencySamples 个采样短于前瞻时长", latencySamples >= SAMPLE_RATE * CHANNELS * 5 / 1000)
+        assertEquals(0, latencySamples % CHANNELS)
+        for (i in 0 until latencySamples) assertEquals(0, output[i].toInt())
+        // 最后一个采样也要出来（流结束时排空延迟线）
+        for (i in input.indices) assertEquals("i=$i", input[i], output[i + latencySamples])
+    }
+
+    @Test
+    fun togglingKeepsEverySample() {
+        val input = positiveTone(SAMPLE_RATE * 2)
+        val output = processor.processAll(input, SAMPLE_RATE, CHANNELS, blockFrames = 512) {
+            processor.setEnabled(it % 3 != 0)
+        }
+
+        val latencySamples = output.size - input.size
+        assertTrue(latencySamples > 0)
+        for (i in latencySamples until output.size) {
+            assertTrue("i=$i 输出 ${output[i]}（开关时插入了静音）", output[i] > 0)
+        }
+    }
+
+    @Test
+    fun cpuCostIsTakenOnce() {
+        processor.setEnabled(true)
+        processor.processAll(positiveTone(SAMPLE_RATE), SAMPLE_RATE, CHANNELS)
+        assertTrue(processor.takeCpuCost() > 0f)
+        assertEquals(0f, processor.takeCpuCost(), 0f)
+    }
+}
@@ -0,0 +1,55 @@
+package com.hx.nekomimi.audio.processor
+
+import androidx.media3.common.C
+import androidx.media3.common.audio.AudioProcessor
+import androidx.media3.common.audio.AudioProcessor.AudioFormat
+import java.io.ByteArrayOutputStream
+import java.nio.ByteBuffer
+import java.nio.ByteOrder
+
+/**
+ * 按固定块大小把交错 PCM16 送过单个处理器并收集全部输出（包括流结束时排出的部分）
+ *
+ * @param beforeBlock 每块送入前调用（参数为块序号），用于在播放过程中切换参数
+ */
+fun AudioProcessor.processAll(
+    input: ShortArray,
+    sampleRate: Int,
+    channels: Int,
+    blockFrames: Int = 1024,
+    beforeBlock: (Int) -> Unit = {}
+): ShortArray {
+    configure(AudioFormat(sampleRate, channels, C.ENCODING_PCM_16BIT))
+    flush()
+    val sink = ByteArrayOutputStream(input.size * 2)
+    val copy = ByteArray(64 * 1024)
+    fun drain() {
+        val buf = output
+        while (buf.hasRemaining()) {
+            val n = minOf(copy.size, buf.remaining())
+            buf.get(copy, 0, n)
+            sink.write(copy, 0, n)
+        }
+    }
+
+    val source = ByteBuffer.allocateDirect(input.size * 2).order(ByteOrder.nativeOrder())
+    source.asShortBuffer().put(input)
+    val blockBytes = blockFrames * channels * 2
+    var index = 0
+    while (source.hasRemaining()) {
+        beforeBlock(index++)
+        val block = source.duplicate().order(ByteOrder.nativeOrder())
+        block.limit(minOf(source.position() + blockBytes, source.limit()))
+        while (block.hasRemaining()) {
+            queueInput(block)
+            drain()
+        }
+        source.position(block.limit())
+    }
+    queueEndOfStream()
+    while (!isEnded) drain()
+    val bytes = sink.toByteArray()
+    return ShortArray(bytes.size / 2).also {
+        ByteBuffer.wrap(bytes).order(ByteOrder.nativeOrder()).asShortBuffer().get(it)
+    }
+}
@@ -0,0 +1,191 @@
+package com.hx.nekomimi.audio.render
+
+import androidx.annotation.OptIn
+import androidx.media3.common.C
+import androidx.media3.common.audio.AudioProcessor
+import androidx.media3.common.audio.AudioProcessor.AudioFormat
+import androidx.media3.common.audio.SonicAudioProcessor
+import androidx.media3.common.util.UnstableApi
+import com.hx.nekomimi.audio.PlaybackAudioChain
+import com.hx.nekomimi.audio.dsp.NativeDsp
+import org.junit.Assert.assertEquals
+import org.junit.Assert.assertNotNull
+import org.junit.Assert.assertTrue
+import org.junit.BeforeClass
+import org.junit.Test
+import java.io.File
+import java.security.MessageDigest
+import java.util.Random
+import kotlin.math.PI
+import kotlin.math.abs
+import kotlin.math.cos
+import kotlin.math.log10
+import kotlin.math.max
+import kotlin.math.pow
+import kotlin.math.sin
+import kotlin.math.sqrt
+
+/**
+ * 播放音频处理链的离线回归测试
+ *
+ * 签入的 chain_input.wav 是固定种子生成的类人声测试信号（耳语 / 正常 / 大喊 / 静音每 0.5 秒交替），
+ * 送过与播放服务相同的处理链（夜间模式开启、增益 1.5）后与 chain_golden.wav 逐采样比较，
+ * 超出容差即说明 DSP 行为发生了变化。各 SIMD 内核和 libm 的舍入略有不同，所以输出按容差比较；
+ * chain_fixtures.sha256 只用来确认两个 WAV 文件本身没有被改动（例如被换行符转换破坏）。
+ *
+ * DSP 有意修改后重新生成基准并一起提交三个文件：
+ * `./gradlew testDebugUnitTest -PupdateAudioGolden --tests '*AudioChainGoldenTest'`
+ */
+@OptIn(UnstableApi::class)
+class AudioChainGoldenTest {
+
+    companion object {
+        private const val INPUT_FILE = "chain_input.wav"
+        private const val GOLDEN_FILE = "chain_golden.wav"
+        private const val HASH_FILE = "chain_fixtures.sha256"
+
+        private const val SAMPLE_RATE = 22050
+        private const val CHANNELS = 2
+        private const val FIXTURE_SECONDS = 4
+        private const val FIXTURE_SEED = 20240601L
+
+        /** 测试时开启的处理参数（让每一级都参与处理） */
+        private const val CHECK_GAIN = 1.5f
+        private const val CHECK_SPEED = 1.25f
+
+        /** 容差：逐采样最大差值（LSB）与差值 RMS */
+        private const val MAX_ABS_DIFF = 8
+        private const val MAX_DIFF_RMS_DB = -80f
+
+        /** 设置时（-PupdateAudioGolden）重新生成基准，写回源码目录 */
+        private val updateDir: File? = System.getProperty("neko.audioGoldenDir")?.let(::File)
+
+        @BeforeClass
+        @JvmStatic
+        fun setUp() {
+            assertTrue("libnekodsp 未加载（java.library.path 中没有主机端构建）", NativeDsp.isAvailable)
+            updateDir?.let(::regenerate)
+        }
+
+        private fun regenerate(dir: File) {
+            val input = WavFile.Pcm(speechLikeFixture(), SAMPLE_RATE, CHANNELS)
+            WavFile.write(File(dir, INPUT_FILE), input)
+            val output = render(chainProcessors(), input)
+            WavFile.write(File(dir, GOLDEN_FILE), WavFile.Pcm(output.pcm, output.format.sampleRate, output.format.channelCount))
+            val hashes = listOf(INPUT_FILE, GOLDEN_FILE).joinToString("") { "${sha256(File(dir, it).readBytes())}  $it\n" }
+            File(dir, HASH_FILE).writeText(hashes)
+            println("已重新生成 ${dir.absolutePath} 下的处理链基准")
+        }
+
+        private fun fixtureBytes(name: String): ByteArray {
+            updateDir?.let { return File(it, name).readBytes() }
+            val stream = AudioChainGoldenTest::class.java.getResourceAsStream("/audio/$name")
+            assertNotNull("缺少测试资源 audio/$name", stream)
+            return stream!!.use { it.readBytes() }
+        }
+
+        private fun fixture(name: String): WavFile.Pcm {
+            val pcm = WavFile.read(fixtureBytes(name))
+            assertNotNull("$name 不是 PCM16 WAV", pcm)
+            return pcm!!
+        }
+
+        private fun chainProcessors(): Array<AudioProcessor> = PlaybackAudioChain().apply {
+            compressor.setEnabled(true)
+            gain.setGain(CHECK_GAIN)
+        }.processors()
+
+        private fun render(processors: Array<AudioProcessor>, input: WavFile.Pcm): OfflineRenderer.Result {
+            val format = AudioFormat(input.sampleRate, input.channels, C.ENCODING_PCM_16BIT)
+            val result = OfflineRenderer.render(processors, input.samples, format)
+            result.stages.forEach {
+                println("${it.name} active=${it.active} ${"%.3f".format(it.msPerAudioSecond)}ms/每秒音频")
+            }
+            return result
+        }
+
+        private fun sha256(bytes: ByteArray): String =
+            MessageDigest.getInstance("SHA-256").digest(bytes).joinToString("") { "%02x".format(it) }
+
+        /**
+         * 类人声测试信号：带谐波的基音 + 4 Hz 音节包络 + 少量噪声，
+         * 每 0.5 秒在耳语 / 正常 / 大喊 / 静音之间切换（固定种子，每次生成完全相同）
+         */
+        private fun speechLikeFixture(): ShortArray {
+            val random = Random(FIXTURE_SEED)
+            val levelsDb = floatArrayOf(-40f, -20f, -3f, Float.NEGATIVE_INFINITY)
+            val segmentFrames = SAMPLE_RATE / 2
+            val frames = SAMPLE_RATE * FIXTURE_SECONDS
+            val pcm = ShortArray(frames * CHANNELS)
+            var phase = 0.0
+            for (i in 0 until frames) {
+                val segment = i / segmentFrames
+                val levelDb = levelsDb[segment % levelsDb.size]
+                val amplitude = if (levelDb.isInfinite()) 0.0 else 10.0.pow(levelDb / 20.0)
+                val pitchHz = 140.0 + 40.0 * (segment % 3)
+                phase += 2 * PI * pitchHz / SAMPLE_RATE
+                val t = i.toDouble() / SAMPLE_RATE
+                val syllable = 0.5 - 0.5 * cos(2 * PI * 4.0 * t)
+                val voice = sin(phase) + 0.5 * sin(2 * phase) + 0.25 * sin(3 * phase)
+                val noise = (random.nextFloat() - 0.5) * 0.05
+                val sample = amplitude * syllable * (voice / 1.75 + noise)
+                for (c in 0 until CHANNELS) {
+                    val value = sample * (if (c == 0) 1.0 else 0.9)
+                    pcm[i * CHANNELS + c] = (value * 32767).toInt().coerceIn(-32768, 32767).toShort()
+                }
+            }
+            return pcm
+        }
+    }
+
+    @Test
+    fun fixturesMatchRecordedHashes() {
+        val recorded = String(fixtureBytes(HASH_FILE), Charsets.US_ASCII).lines()
+            .filter { it.isNotBlank() }
+            .associate { line -> line.substringAfter("  ") to line.substringBefore("  ") }
+        for (name in listOf(INPUT_FILE, GOLDEN_FILE)) {
+            assertEquals("$name 与 $HASH_FILE 记录的哈希不一致", recorded[name], sha256(fixtureBytes(name)))
+        }
+    }
+
+    @Test
+    fun chainMatchesGolden() {
+        val input = fixture(INPUT_FILE)
+        val golden = fixture(GOLDEN_FILE)
+        val result = render(chainProcessors(), input)
+
+        assertEquals(golden.sampleRate, result.format.sampleRate)
+        assertEquals(golden.channels, result.format.channelCount)
+        // 压缩器的前瞻延迟在流结束时排空，输出比输入多出延迟的帧数
+        assertEquals(golden.samples.size, result.pcm.size)
+
+        var maxDiff = 0
+        var sumSq = 0.0
+        for (i in golden.samples.indices) {
+            val diff = golden.samples[i] - result.pcm[i]
+            maxDiff = max(maxDiff, abs(diff))
+            sumSq += diff.toDouble() * diff
+        }
+        val rms = sqrt(sumSq / max(golden.samples.size, 1)) / 32768.0
+        val rmsDb = if (rms == 0.0) -200f else (20 * log10(rms)).toFloat()
+        println("与基准比较：最大差值 $maxDiff LSB，差值 RMS ${"%.1f".format(rmsDb)} dBFS（内核 ${NativeDsp.kernelName()}）")
+        assertTrue("最大差值 $maxDiff LSB 超出容差 $MAX_ABS_DIFF", maxDiff <= MAX_ABS_DIFF)
+        assertTrue("差值 RMS $rmsDb dBFS 超出容差 $MAX_DIFF_RMS_DB", rmsDb <= MAX_DIFF_RMS_DB)
+    }
+
+    /** 处理链后接 ExoPlayer 变速用的 Sonic：时长按倍速缩短，不丢也不重复内容 */
+    @Test
+    fun sonicAfterChainScalesDuration() {
+        val input = fixture(INPUT_FILE)
+        val sonic = SonicAudioProcessor().apply {
+            setSpeed(CHECK_SPEED)
+            setPitch(1f)
+        }
+        val chained = render(chainProcessors(), input)
+        val result = render(chainProcessors() + sonic, input)
+
+        val expectedFrames = chained.pcm.size / CHANNELS / CHECK_SPEED
+        val actualFrames = result.pcm.size / CHANNELS
+        assertEquals(expectedFrames, actualFrames.toFloat(), expectedFrames * 0.01f)
+    }
+}
@@ -0,0 +1,115 @@
+package com.hx.nekomimi.audio.render
+
+import androidx.media3.common.C
+import androidx.media3.common.audio.AudioProcessor
+import androidx.media3.common.audio.AudioProcessor.AudioFormat
+import androidx.media3.common.util.UnstableApi
+import java.io.ByteArrayOutputStream
+import java.nio.ByteBuffer
+import java.nio.ByteOrder
+
+/**
+ * 离线运行 AudioProcessor 链
+ *
+ * 不经过 ExoPlayer 和 AudioTrack，按固定块大小把整段 PCM16 依次送过每一级处理器，
+ * 输出与调度时机无关、可重复；同时记录每一级的耗时，用于回归对比和性能观察。
+ * 各级逐个跑完整段输入（而不是逐块串行），这样每一级的耗时互不混杂。
+ */
+@UnstableApi
+object OfflineRenderer {
+
+    /** 每次送入的帧数（与 AudioTrack 常见的写入粒度相当） */
+    const val BLOCK_FRAMES = 1024
+
+    /**
+     * @param name 处理器类名
+     * @param active 该格式下是否参与处理（未激活时输入原样传给下一级）
+     * @param nanos 处理整段音频的耗时
+     */
+    class StageStat(val name: String, val active: Boolean, val nanos: Long, val audioMs: Long) {
+        /** 每秒音频的处理耗时（毫秒） */
+        val msPerAudioSecond: Float get() = if (audioMs == 0L) 0f else nanos / 1_000_000f / (audioMs / 1000f)
+    }
+
+    class Result(val pcm: ShortArray, val format: AudioFormat, val stages: List<StageStat>)
+
+    /**
+     * @param input 交错 PCM16
+     */
+    fun render(processors: Array<AudioProcessor>, input: ShortArray, format: AudioFormat): Result {
+        require(format.encoding == C.ENCODING_PCM_16BIT) { "只支持 PCM16 输入" }
+        var current = toDirectBuffer(input)
+        var currentFormat = format
+        val stages = mutableListOf<StageStat>()
+
+        for (processor in processors) {
+            val name = processor.javaClass.simpleName
+            val audioMs = current.remaining() / currentFormat.bytesPerFrame * 1000L / currentFormat.sampleRate
+            val outputFormat = try {
+                processor.configure(currentFormat)
+            } catch (e: AudioProcessor.UnhandledAudioFormatException) {
+                AudioFormat.NOT_SET
+            }
+            processor.flush()
+            if (!processor.isActive) {
+                stages.add(StageStat(name, active = false, nanos = 0L, audioMs = audioMs))
+                processor.reset()
+                continue
+            }
+
+            val sink = ByteArrayOutputStream(current.remaining())
+            val copy = ByteArray(BLOCK_FRAMES * currentFormat.bytesPerFrame * 4)
+            val blockBytes = BLOCK_FRAMES * currentFormat.bytesPerFrame
+            val start = System.nanoTime()
+            while (current.hasRemaining()) {
+                val block = current.duplicate().order(ByteOrder.nativeOrder())
+                block.limit(minOf(current.position() + blockBytes, current.limit()))
+                while (block.hasRemaining()) {
+                    processor.queueInput(block)
+                    drain(processor, sink, copy)
+                }
+                current.position(block.limit())
+            }
+            processor.queueEndOfStream()
+            while (!processor.isEnded) {
+                if (!drain(processor, sink, copy)) break
+            }
+            val nanos = System.nanoTime() - start
+            processor.reset()
+
+            stages.add(StageStat(name, active = true, nanos = nanos, audioMs = audioMs))
+            current = toDirectBuffer(sink.toByteArray())
+            currentFormat = outputFormat
+        }
+
+        val shorts = ShortArray(current.remaining() / 2)
+        current.asShortBuffer().get(shorts)
+        return Result(shorts, currentFormat, stages)
+    }
+
+    /** @return 是否读到了输出 */
+    private fun drain(processor: AudioProcessor, sink: ByteArrayOutputStream, copy: ByteArray): Boolean {
+        var produced = false
+        while (true) {
+            val output = processor.output
+            if (!output.hasRemaining()) return produced
+            produced = true
+            while (output.hasRemaining()) {
+                val n = minOf(copy.size, output.remaining())
+                output.get(copy, 0, n)
+                sink.write(copy, 0, n)
+            }
+        }
+    }
+
+    private fun toDirectBuffer(pcm: ShortArray): ByteBuffer =
+        ByteBuffer.allocateDirect(pcm.size * 2).order(ByteOrder.nativeOrder()).apply {
+            asShortBuffer().put(pcm)
+        }
+
+    private fun toDirectBuffer(bytes: ByteArray): ByteBuffer =
+        ByteBuffer.allocateDirect(bytes.size).order(ByteOrder.nativeOrder()).apply {
+            put(bytes)
+            flip()
+        }
+}
@@ -0,0 +1,64 @@
+package com.hx.nekomimi.audio.render
+
+import java.io.File
+import java.io.IOException
+import java.nio.ByteBuffer
+import java.nio.ByteOrder
+
+/**
+ * 最简 PCM16 WAV 读写（处理链回归测试的输入和基准文件）
+ */
+object WavFile {
+
+    private const val HEADER_SIZE = 44
+
+    class Pcm(val samples: ShortArray, val sampleRate: Int, val channels: Int)
+
+    fun write(file: File, pcm: Pcm) {
+        val dataSize = pcm.samples.size * 2
+        val buffer = ByteBuffer.allocate(HEADER_SIZE + dataSize).order(ByteOrder.LITTLE_ENDIAN)
+        buffer.put("RIFF".toByteArray(Charsets.US_ASCII))
+        buffer.putInt(36 + dataSize)
+        buffer.put("WAVE".toByteArray(Charsets.US_ASCII))
+        buffer.put("fmt ".toByteArray(Charsets.US_ASCII))
+        buffer.putInt(16)
+        buffer.putShort(1) // PCM
+        buffer.putShort(pcm.channels.toShort())
+        buffer.putInt(pcm.sampleRate)
+        buffer.putInt(pcm.sampleRate * pcm.channels * 2)
+        buffer.putShort((pcm.channels * 2).toShort())
+        buffer.putShort(16)
+        buffer.put("data".toByteArray(Charsets.US_ASCII))
+        buffer.putInt(dataSize)
+        buffer.asShortBuffer().put(pcm.samples)
+
+        file.parentFile?.mkdirs()
+        val temp = File(file.parentFile, file.name + ".tmp")
+        temp.writeBytes(buffer.array())
+        if (!temp.renameTo(file)) {
+            temp.delete()
+            throw IOException("写入失败: $file")
+        }
+    }
+
+    /**
+     * 只读取本类写出的格式（44 字节头 + PCM16），其它格式返回 null
+     */
+    fun read(file: File): Pcm? = if (file.exists()) read(file.readBytes()) else null
+
+    fun read(bytes: ByteArray): Pcm? {
+        if (bytes.size < HEADER_SIZE) return null
+        val buffer = ByteBuffer.wrap(bytes).order(ByteOrder.LITTLE_ENDIAN)
+        if (String(bytes, 0, 4, Charsets.US_ASCII) != "RIFF" || String(bytes, 8, 4, Charsets.US_ASCII) != "WAVE") {
+            return null
+        }
+        if (buffer.getShort(20).toInt() != 1 || buffer.getShort(34).toInt() != 16) return null
+        val channels = buffer.getShort(22).toInt()
+        val sampleRate = buffer.getInt(24)
+        val dataSize = minOf(buffer.getInt(40), bytes.size - HEADER_SIZE)
+        val samples = ShortArray(dataSize / 2)
+        buffer.position(HEADER_SIZE)
+        buffer.asShortBuffer().get(samples)
+        return Pcm(samples, sampleRate, channels)
+    }
+}
@@ -0,0 +1,40 @@
+package com.hx.nekomimi.remote
+
+import org.junit.Assert.assertEquals
+import org.junit.Assert.assertNull
+import org.junit.Rule
+import org.junit.Test
+import org.junit.rules.TemporaryFolder
+import java.io.File
+
+class CredentialStoreTest {
+
+    @get:Rule
+    val folder = TemporaryFolder()
+
+    @Test
+    fun readerInAnotherProcessSeesEveryWrite() {
+        val file = File(folder.root, "credentials.properties")
+        // 两个实例模拟界面进程（写入）和播放进程（只读）
+        val writer = CredentialStore(file)
+        val reader = CredentialStore(file)
+        assertNull(reader.get("https://dav.example.com:443|user"))
+
+        writer.edit { it.setProperty("https://dav.example.com:443|user", "alice") }
+        assertEquals("alice", reader.get("https://dav.example.com:443|user"))
+
+        // 长度相同的连续写入
+        writer.edit { it.setProperty("https://dav.example.com:443|user", "carol") }
+        assertEquals("carol", reader.get("https://dav.example.com:443|user"))
+
+        writer.edit { it.remove("https://dav.example.com:443|user") }
+        assertNull(reader.get("https://dav.example.com:443|user"))
+    }
+
+    @Test
+    fun editLeavesNoTempFiles() {
+        val store = CredentialStore(File(folder.root, "credentials.properties"))
+        repeat(3) { i -> store.edit { it.setProperty("k", "v$i") } }
+        assertEquals(listOf("credentials.properties"), folder.root.list()!!.toList())
+    }
+}
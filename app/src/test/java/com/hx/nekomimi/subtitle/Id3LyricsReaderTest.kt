@@ -0,0 +1,68 @@
+package com.hx.nekomimi.subtitle
+
+import org.junit.Assert.assertEquals
+import org.junit.Assert.assertNotNull
+import org.junit.Test
+import java.io.ByteArrayInputStream
+import java.io.ByteArrayOutputStream
+import java.io.DataOutputStream
+
+class Id3LyricsReaderTest {
+
+    /** ID3v2.3 标签，只含一个 SYLT 帧（UTF-8、毫秒时间戳） */
+    private fun syltTag(vararg syllables: Pair<String, Int>): ByteArray {
+        val frame = ByteArrayOutputStream()
+        DataOutputStream(frame).apply {
+            writeByte(3) // UTF-8
+            write("chi".toByteArray(Charsets.ISO_8859_1))
+            writeByte(2) // 毫秒
+            writeByte(1) // 歌词
+            writeByte(0) // 空描述
+            for ((text, time) in syllables) {
+                write(text.toByteArray(Charsets.UTF_8))
+                writeByte(0)
+                writeInt(time)
+            }
+        }
+        val body = frame.toByteArray()
+        val tag = ByteArrayOutputStream()
+        DataOutputStream(tag).apply {
+            write("ID3".toByteArray(Charsets.ISO_8859_1))
+            writeByte(3)
+            writeByte(0)
+            writeByte(0)
+            val size = 10 + body.size
+            for (shift in intArrayOf(21, 14, 7, 0)) writeByte((size shr shift) and 0x7F)
+            write("SYLT".toByteArray(Charsets.ISO_8859_1))
+            writeInt(body.size)
+            writeShort(0)
+            write(body)
+        }
+        return tag.toByteArray()
+    }
+
+    @Test
+    fun karaokeSyltKeepsSyllableTiming() {
+        val tag = syltTag("\n你" to 1000, "好" to 1400, " 世界" to 1800, "\n再见" to 4000)
+        val lyrics = Id3LyricsReader.read(ByteArrayInputStream(tag))
+        assertNotNull(lyrics)
+        val entries = lyrics!!.entries
+        assertEquals(listOf("你好 世界", "再见"), entries.map { it.text })
+        assertEquals(
+            listOf(
+                KaraokeSyllable(1000, 1400, 0, 1, sweep = true),
+                KaraokeSyllable(1400, 1800, 1, 2, sweep = true),
+                KaraokeSyllable(1800, 4000, 2, 5, sweep = true)
+            ),
+            entries[0].syllables
+        )
+        assertEquals(listOf(KaraokeSyllable(4000, 9000, 0, 2, sweep = true)), entries[1].syllables)
+    }
+
+    @Test
+    fun lineSyltHasNoSyllables() {
+        val tag = syltTag("第一句" to 0, "第二句" to 2000)
+        val entries = Id3LyricsReader.read(ByteArrayInputStream(tag))!!.entries
+        assertEquals(listOf(SubtitleEntry(0, 2000, "第一句"), SubtitleEntry(2000, 7000, "第二句")), entries)
+    }
+}
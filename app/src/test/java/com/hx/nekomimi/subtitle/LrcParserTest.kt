@@ -0,0 +1,66 @@
+package com.hx.nekomimi.subtitle
+
+import org.junit.Assert.assertEquals
+import org.junit.Assert.assertTrue
+import org.junit.Test
+
+class LrcParserTest {
+
+    private val parser = LrcParser()
+
+    @Test
+    fun plainLinesHaveNoSyllables() {
+        val entries = parser.parse("[ti:标题]\n[00:01.00]第一句\n[00:03.50]第二句\n[00:06.00]\n")
+        assertEquals(2, entries.size)
+        assertEquals(SubtitleEntry(1000, 3500, "第一句"), entries[0])
+        assertEquals(SubtitleEntry(3500, 6000, "第二句"), entries[1])
+    }
+
+    @Test
+    fun wordTagsBecomeSweepingSyllables() {
+        val entries = parser.parse("[00:15.20]<00:15.20>逐<00:15.60>字<00:16.00>时间<00:17.00>\n[00:18.00]下一句")
+        val line = entries[0]
+        assertEquals("逐字时间", line.text)
+        assertEquals(15200, line.startMs)
+        assertEquals(18000, line.endMs)
+        assertEquals(
+            listOf(
+                KaraokeSyllable(15200, 15600, 0, 1, sweep = true),
+                KaraokeSyllable(15600, 16000, 1, 2, sweep = true),
+                // 行尾的标签是最后一个词的结束时间
+                KaraokeSyllable(16000, 17000, 2, 4, sweep = true)
+            ),
+            line.syllables
+        )
+    }
+
+    @Test
+    fun textBeforeFirstWordTagStartsWithLine() {
+        val line = parser.parse("[00:10.00] 前奏 <00:11.00>后面")[0]
+        assertEquals("前奏 后面", line.text)
+        assertEquals(
+            listOf(
+                KaraokeSyllable(10000, 11000, 0, 3, sweep = true),
+                // 没有结束标签：持续到句末（最后一句显示 5 秒）
+                KaraokeSyllable(11000, 15000, 3, 5, sweep = true)
+            ),
+            line.syllables
+        )
+    }
+
+    @Test
+    fun offsetAndRepeatedTimesShiftWordTimes() {
+        val entries = parser.parse("[offset:+500]\n[00:10.00][00:20.00]<00:10.00>A<00:10.50>B<00:11.00>\n")
+        assertEquals(2, entries.size)
+        assertEquals(listOf(9500L, 10000L), entries[0].syllables.map { it.startMs })
+        assertEquals(listOf(19500L, 20000L), entries[1].syllables.map { it.startMs })
+        assertEquals(20500L, entries[1].syllables.last().endMs)
+    }
+
+    @Test
+    fun wordTimesAreClampedToLine() {
+        // 标签时间早于行时间、晚于下一句：限制在本句范围内
+        val line = parser.parse("[00:05.00]<00:04.00>早<00:09.00>晚\n[00:07.00]下一句")[0]
+        assertTrue(line.syllables.all { it.startMs >= 5000 && it.endMs <= 7000 && it.endMs >= it.startMs })
+    }
+}
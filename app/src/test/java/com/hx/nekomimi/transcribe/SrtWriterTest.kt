@@ -0,0 +1,48 @@
+package com.hx.nekomimi.transcribe
+
+import org.junit.Assert.assertEquals
+import org.junit.Assert.assertFalse
+import org.junit.Rule
+import org.junit.Test
+import org.junit.rules.TemporaryFolder
+
+class SrtWriterTest {
+
+    @get:Rule
+    val folder = TemporaryFolder()
+
+    private fun cue(startMs: Long, text: String) = WhisperEngine.Segment(startMs, startMs + 900, text)
+
+    @Test
+    fun resumeDropsCuesWrittenAfterRecordedProgress() {
+        val file = folder.newFile("partial.srt")
+        SrtWriter(file).append(listOf(cue(0, "一"), cue(1000, "二")))
+        // 进度记录到 2000 后续传，下一个分块的字幕已追加，但进度还没记录进程就被杀
+        SrtWriter(file, resumeMs = 2000).append(listOf(cue(2000, "三"), cue(3000, "四")))
+
+        val resumed = SrtWriter(file, resumeMs = 2000)
+        resumed.append(listOf(cue(2000, "三"), cue(3000, "四")))
+
+        assertEquals(listOf("一", "二", "三", "四"), SrtWriter.readCues(file).map { it.text })
+        // 序号连续
+        assertEquals(listOf("1", "2", "3", "4"), file.readLines().filter { it.matches(Regex("\\d+")) })
+    }
+
+    @Test
+    fun resumeDropsTruncatedTrailingCue() {
+        val file = folder.newFile("partial.srt")
+        SrtWriter(file).append(listOf(cue(0, "完整")))
+        file.appendText("2\n00:00:01,000 --> 00:00:0")
+
+        SrtWriter(file, resumeMs = 5000)
+        assertEquals(listOf("完整"), SrtWriter.readCues(file).map { it.text })
+    }
+
+    @Test
+    fun startFromZeroClearsFile() {
+        val file = folder.newFile("partial.srt")
+        SrtWriter(file).append(listOf(cue(0, "旧")))
+        SrtWriter(file, resumeMs = 0)
+        assertFalse(file.exists())
+    }
+}
@@ -0,0 +1,59 @@
+#!/usr/bin/env bash
+#
+# 构建 Media3 FFmpeg 音频解码扩展（lib-decoder-ffmpeg），输出 AAR 到 app/libs/
+#
+# 仅启用 Media3 能路由到 FFmpeg 的音频解码器，保持 .so 体积尽量小。
+# 构建完成后无需改代码：DefaultRenderersFactory 会通过反射自动加载 FfmpegAudioRenderer。
+#
+# 用法:
+#   NDK_PATH=/path/to/android-ndk ./scripts/build-ffmpeg-decoder.sh
+#
+# 可选环境变量:
+#   MEDIA3_VERSION   Media3 版本（需与 app/build.gradle.kts 中一致），默认 1.4.1
+#   FFMPEG_BRANCH    FFmpeg 分支，默认 release/6.0
+#   ANDROID_ABI      最低 API，默认 26（与 minSdk 一致）
+#   WORK_DIR         临时工作目录，默认 build/ffmpeg-decoder
+#
+set -euo pipefail
+
+ROOT_DIR="$(cd "$(dirname "$0")/.." && pwd)"
+MEDIA3_VERSION="${MEDIA3_VERSION:-1.4.1}"
+FFMPEG_BRANCH="${FFMPEG_BRANCH:-release/6.0}"
+ANDROID_ABI="${ANDROID_ABI:-26}"
+WORK_DIR="${WORK_DIR:-$ROOT_DIR/build/ffmpeg-decoder}"
+NDK_PATH="${NDK_PATH:?请设置 NDK_PATH 指向 Android NDK 目录}"
+
+case "$(uname -s)" in
+    Linux)  HOST_PLATFORM="linux-x86_64" ;;
+    Darwin) HOST_PLATFORM="darwin-x86_64" ;;
+    *) echo "不支持的构建平台: $(uname -s)" >&2; exit 1 ;;
+esac
+
+# 听书场景需要的解码器：
+# - alac / flac      无损有声书（部分设备平台解码器缺失或有 bug）
+# - opus / vorbis    mka / ogg 封装的广播剧
+# - ac3 / eac3 / dca / truehd  mka 封装的多声道音轨
+# 注意：WMA (ASF) 和 APE 在 Media3 中没有对应的 Extractor，即使启用解码器也无法解封装，故不启用
+ENABLED_DECODERS=(alac flac opus vorbis ac3 eac3 dca truehd)
+
+mkdir -p "$WORK_DIR"
+cd "$WORK_DIR"
+
+if [ ! -d media ]; then
+    git clone --depth 1 --branch "$MEDIA3_VERSION" https://github.com/androidx/media.git media
+fi
+FFMPEG_MODULE_PATH="$WORK_DIR/media/libraries/decoder_ffmpeg/src/main"
+
+if [ ! -d "$FFMPEG_MODULE_PATH/jni/ffmpeg" ]; then
+    git clone --depth 1 --branch "$FFMPEG_BRANCH" https://git.ffmpeg.org/ffmpeg.git "$FFMPEG_MODULE_PATH/jni/ffmpeg"
+fi
+
+cd "$FFMPEG_MODULE_PATH/jni"
+./build_ffmpeg.sh "$FFMPEG_MODULE_PATH" "$NDK_PATH" "$HOST_PLATFORM" "$ANDROID_ABI" "${ENABLED_DECODERS[@]}"
+
+cd "$WORK_DIR/media"
+./gradlew :lib-decoder-ffmpeg:assembleRelease
+
+mkdir -p "$ROOT_DIR/app/libs"
+cp libraries/decoder_ffmpeg/buildout/outputs/aar/lib-decoder-ffmpeg-release.aar "$ROOT_DIR/app/libs/"
+echo "已输出: app/libs/lib-decoder-ffmpeg-release.aar"
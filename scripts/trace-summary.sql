@@ -0,0 +1,29 @@
+-- 汇总 Perfetto trace 中 neko: 前缀区段的各阶段耗时
+--
+-- 用法：
+--   trace_processor_shell -q scripts/trace-summary.sql neko.perfetto-trace
+--
+-- 同步区段（Tracing.section）和异步区段（Tracing.async / beginAsync）都在 slice 表中，
+-- 按名称分组输出次数、总耗时、平均 / P50 / P90 / 最大耗时（毫秒），总耗时高的排在前面。
+-- 未结束的区段（dur = -1，如抓取结束时还没准备好的播放器）不计入。
+
+WITH stage AS (
+  SELECT
+    SUBSTR(name, LENGTH('neko:') + 1) AS stage,
+    dur,
+    ROW_NUMBER() OVER (PARTITION BY name ORDER BY dur) AS rn,
+    COUNT(*) OVER (PARTITION BY name) AS cnt
+  FROM slice
+  WHERE name GLOB 'neko:*' AND dur >= 0
+)
+SELECT
+  stage,
+  cnt AS count,
+  ROUND(SUM(dur) / 1e6, 2) AS total_ms,
+  ROUND(AVG(dur) / 1e6, 2) AS avg_ms,
+  ROUND(MIN(CASE WHEN rn >= (cnt + 1) / 2 THEN dur END) / 1e6, 2) AS p50_ms,
+  ROUND(MIN(CASE WHEN rn >= (cnt * 9 + 9) / 10 THEN dur END) / 1e6, 2) AS p90_ms,
+  ROUND(MAX(dur) / 1e6, 2) AS max_ms
+FROM stage
+GROUP BY stage
+ORDER BY total_ms DESC;